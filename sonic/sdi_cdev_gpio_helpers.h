@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*
+ * filename: sdi_cdev_gpio_helpers.h
+ */
+
+
+/******************************************************************************
+ * @file sdi_cdev_gpio_helpers.h
+ * @brief implements wrappers for requesting gpio lines and reading/writing
+ * their levels via gpio character device (gpio-cdev v2 uapi). Line requests
+ * fail with ENOTSUP when built against kernel headers without the v2 uapi.
+ *****************************************************************************/
+
+#ifndef __SDI_CDEV_GPIO_HELPERS_H__
+#define __SDI_CDEV_GPIO_HELPERS_H__
+
+#include "sdi_gpio.h"
+
+/**
+ * @def Max no. of lines of a line request
+ */
+#define SDI_CDEV_GPIO_MAX_LINES        (64)
+
+/**
+ * @brief sdi_cdev_gpio_line_request
+ * Request lines of a gpio chip with the given configuration
+ * @param[in] gpio_chip - gpio chip name, ex: gpiochip0 for /dev/gpiochip0
+ * @param[in] offsets - line offsets on the chip
+ * @param[in] count - no. of lines, at most SDI_CDEV_GPIO_MAX_LINES
+ * @param[in] consumer - consumer label of the lines
+ * @param[in] line_cfg - configuration of the lines
+ * @param[out] line_fd - line request fd
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) without gpio-cdev v2 uapi
+ */
+t_std_error sdi_cdev_gpio_line_request(const char *gpio_chip,
+                                       const uint_t *offsets, uint_t count,
+                                       const char *consumer,
+                                       const sdi_gpio_line_cfg_t *line_cfg,
+                                       int *line_fd);
+
+/**
+ * @brief sdi_cdev_gpio_line_config
+ * Reconfigure the lines of a line request
+ * @param[in] line_fd - line request fd
+ * @param[in] count - no. of lines of the request
+ * @param[in] line_cfg - configuration of the lines
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_cdev_gpio_line_config(int line_fd, uint_t count,
+                                      const sdi_gpio_line_cfg_t *line_cfg);
+
+/**
+ * @brief sdi_cdev_gpio_values_get
+ * Read the levels of every line of a line request
+ * @param[in] line_fd - line request fd
+ * @param[in] count - no. of lines of the request
+ * @param[out] values - levels, by line index
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_cdev_gpio_values_get(int line_fd, uint_t count,
+                                     uint64_t *values);
+
+/**
+ * @brief sdi_cdev_gpio_values_set
+ * Write the levels of every line of a line request
+ * @param[in] line_fd - line request fd
+ * @param[in] count - no. of lines of the request
+ * @param[in] values - levels, by line index
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_cdev_gpio_values_set(int line_fd, uint_t count,
+                                     uint64_t values);
+
+/**
+ * @brief sdi_cdev_gpio_events_drain
+ * Read every pending edge event of a line request
+ * @param[in] line_fd - line request fd
+ * @param[out] timestamp_ns - CLOCK_MONOTONIC time of the first event read,
+ * left untouched when none, can be NULL
+ * @return no. of events read
+ */
+uint_t sdi_cdev_gpio_events_drain(int line_fd, uint64_t *timestamp_ns);
+
+/**
+ * @brief sdi_cdev_gpio_chip_base_get
+ * Get the sysfs gpio number of the first line of a gpio chip, used to
+ * access its lines via sysfs when the character device can't be used
+ * @param[in] gpio_chip - gpio chip name, ex: gpiochip0
+ * @param[out] base - sysfs gpio number of line 0
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOENT) when the chip is
+ * not exported via sysfs
+ */
+t_std_error sdi_cdev_gpio_chip_base_get(const char *gpio_chip, uint_t *base);
+
+#endif /* __SDI_CDEV_GPIO_HELPERS_H__ */
@@ -31,6 +31,20 @@
  * SDI CPLD driver creates pins and pin groups as specified by platform
  * configuration and registers with pin/pin group framework.
  * Depending on the platform design, CPLD could be accessed over I2C or LPC bus.
+ *
+ * CPLD keeps a shadow copy of registers whose every bit is an output pin or
+ * pin group bit, so that writing a pin level doesn't read the register first.
+ * Registers with input or unconfigured bits are always read before a write.
+ * The shadow copy is read from the register on first write, after a failed
+ * write and once older than shadow_resync_ms, to catch changes made by other
+ * agents.
+ *
+ * With snapshot_ms set, CPLD keeps a snapshot of the registers from
+ * snapshot_start_addr to snapshot_end_addr, refreshed by one block read once
+ * older than snapshot_ms. Reads of pins and pin groups in the snapshot window
+ * are served from the snapshot, so a poll of every presence/status pin costs
+ * one transaction per snapshot_ms. The snapshot window must leave out clear
+ * on read registers (ex: interrupt status), whose reads have side effects.
  *****************************************************************************/
 
 #ifndef __SDI_CPLD_H__
@@ -38,6 +52,46 @@
 
 #include "sdi_pin.h"
 #include "sdi_pin_group.h"
+#include "std_mutex_lock.h"
+#include <stdint.h>
+
+/**
+ * Flags of a cpld register shadow
+ */
+#define SDI_CPLD_REG_INPUT     (1 << 0) /* register has input pin bits */
+#define SDI_CPLD_REG_OUTPUT    (1 << 1) /* register has output pin bits */
+#define SDI_CPLD_REG_VALID     (1 << 2) /* shadow value is in sync */
+
+/**
+ * Default max age of a shadow copy before it is read again from the register
+ */
+#define SDI_CPLD_DEF_SHADOW_RESYNC_MS  (10000)
+
+/**
+ * sdi_cpld_reg_shadow_t
+ * Shadow copy of a cpld register
+ */
+typedef struct sdi_cpld_reg_shadow_ {
+    uint8_t value; /* Register value as last read or written */
+    uint8_t flags; /* SDI_CPLD_REG_* flags */
+    uint8_t out_mask; /* Bits of output pins/pin groups */
+    uint64_t sync_ns; /* Time value was last read from the register */
+} sdi_cpld_reg_shadow_t;
+
+/**
+ * sdi_cpld_shadow_stats_t
+ * CPLD shadow register counters
+ */
+typedef struct sdi_cpld_shadow_stats_ {
+    uint_t writes; /* no. of writes of shadowed registers */
+    uint_t reads; /* no. of reads to (re)sync a shadow copy */
+    uint_t invalidations; /* no. of shadow copies invalidated */
+    uint_t coalesced; /* no. of pin writes merged into another pin's
+                         register write */
+    uint_t snapshot_reads; /* no. of block reads refreshing the snapshot */
+    uint_t snapshot_hits; /* no. of pin/pin group reads served from the
+                             snapshot */
+} sdi_cpld_shadow_stats_t;
 
 /**
  * sdi_cpld_device_t
@@ -47,6 +101,26 @@ typedef struct sdi_cpld_device_ {
     uint_t width; /* Width of every cpld register in bytes */
     uint_t start_addr; /* CPLD Register start offset address for the pin group */
     uint_t end_addr; /* CPLD Register end offset address for the pin group */
+    uint_t block_read; /* Read multi register pin groups in one block
+                          transaction, when the bus supports it */
+    uint_t shadow; /* Keep shadow copy of registers fully covered by output
+                      pins/pin groups */
+    uint_t resync_ms; /* Max age of a shadow copy, 0 for no periodic resync */
+    uint_t snapshot_ms; /* Max age of the register window snapshot, 0 when
+                           snapshot is disabled */
+    std_mutex_type_t shadow_lock; /* Protects regs, snapshot and shadow_stats,
+                                     never held across a bus acquire */
+    sdi_cpld_reg_shadow_t *regs; /* Shadow of registers start_addr..end_addr */
+    uint_t snapshot_start; /* First register of the snapshot window */
+    uint_t snapshot_end; /* Last register of the snapshot window */
+    uint8_t *snapshot; /* Snapshot of registers snapshot_start..snapshot_end */
+    uint8_t *snapshot_buf; /* Block read buffer of a snapshot refresh */
+    uint_t snapshot_valid; /* Snapshot holds the register values */
+    uint_t snapshot_busy; /* Snapshot refresh in progress */
+    uint_t snapshot_gen; /* Bumped by register writes and invalidations, a
+                            refresh started before is dropped */
+    uint64_t snapshot_ns; /* Time of the last snapshot refresh */
+    sdi_cpld_shadow_stats_t shadow_stats; /* Shadow register counters */
 } sdi_cpld_device_t;
 
 /**
@@ -67,6 +141,28 @@ typedef struct sdi_cpld_pin_ {
     sdi_device_hdl_t cpld_hdl; /* CPLD Device Handle */
 } sdi_cpld_pin_t;
 
+/**
+ * Max width in bits of a cpld pin group
+ */
+#define SDI_CPLD_PIN_GROUP_MAX_BITS    (64)
+
+/**
+ * Max no. of cpld registers of a cpld pin group
+ */
+#define SDI_CPLD_PIN_GROUP_MAX_REGS    ((SDI_CPLD_PIN_GROUP_MAX_BITS / 8) + 1)
+
+/**
+ * sdi_cpld_bit_step_t
+ * Step of the bit plan of a cpld pin group: the bits of the pin group held by
+ * one cpld register
+ */
+typedef struct sdi_cpld_bit_step_ {
+    uint_t addr; /* CPLD Register address */
+    uint8_t mask; /* Mask of the pin group bits, once shifted by reg_shift */
+    uint8_t reg_shift; /* Bit offset of the pin group bits in the register */
+    uint8_t level_shift; /* Bit offset of the pin group bits in the level */
+} sdi_cpld_bit_step_t;
+
 /**
  * sdi_cpld_pin_group_t
  * SDI CPLD Pin Group Bus Object Registered by every CPLD Pin Group
@@ -81,6 +177,134 @@ typedef struct sdi_cpld_pin_group_ {
                             group counted from 1 starting LSB */
     uint_t length; /* number of cpld registers in the pin group */
     sdi_device_hdl_t cpld_hdl; /* CPLD Device Handle */
+    uint_t width; /* number of bits in the pin group */
+    uint_t low_addr; /* Lower of start_addr and end_addr */
+    uint64_t invert_mask; /* Bits of level toggled by inverted polarity */
+    sdi_cpld_bit_step_t plan[SDI_CPLD_PIN_GROUP_MAX_REGS]; /* Bit plan, one
+                              step per register from start_addr to end_addr */
 } sdi_cpld_pin_group_t;
 
+/**
+ * @brief sdi_cpld_block_read
+ * Read consecutive cpld registers in one i2c block transaction
+ * @param[in] dev_hdl - cpld device handle
+ * @param[in] addr - first cpld register address
+ * @param[in] count - no. of registers
+ * @param[out] buffer - register values, in address order
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when block read is disabled on cpld or the bus
+ * can't do block reads
+ */
+t_std_error sdi_cpld_block_read(sdi_device_hdl_t dev_hdl, uint_t addr,
+                                uint_t count, uint8_t *buffer);
+
+/**
+ * @brief sdi_cpld_snapshot_read
+ * Read consecutive cpld registers from the register window snapshot,
+ * refreshing the snapshot when older than snapshot_ms
+ * @param[in] dev_hdl - cpld device handle
+ * @param[in] addr - first cpld register address
+ * @param[in] count - no. of registers
+ * @param[out] buffer - register values, in address order
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when snapshot is disabled, registers are out of
+ * the snapshot window, another thread is refreshing the snapshot or the bus
+ * doesn't support block reads
+ */
+t_std_error sdi_cpld_snapshot_read(sdi_device_hdl_t dev_hdl, uint_t addr,
+                                   uint_t count, uint8_t *buffer);
+
+/**
+ * @brief sdi_cpld_reg_update
+ * Update bits of a cpld register, other bits keep their value. The register
+ * is read first unless it has an in sync shadow copy.
+ * @param[in] dev_hdl - cpld device handle
+ * @param[in] addr - cpld register address
+ * @param[in] mask - bits to update
+ * @param[in] bits - new value of bits in mask
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_cpld_reg_update(sdi_device_hdl_t dev_hdl, uint_t addr,
+                                uint8_t mask, uint8_t bits);
+
+/**
+ * @brief sdi_cpld_pin_write_levels
+ * Update the level of several cpld output pins, pins on the same cpld
+ * register are updated with a single register write
+ * @param[in] pins - cpld pin handles
+ * @param[in] levels - level to be written, per pin
+ * @param[in] count - no. of pins
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO of the first failed register
+ * write, SDI_DEVICE_ERRCODE(ENOTSUP) when a pin is not a cpld output pin
+ */
+t_std_error sdi_cpld_pin_write_levels(sdi_pin_bus_hdl_t *pins,
+                                      const sdi_pin_bus_level_t *levels,
+                                      uint_t count);
+
+/**
+ * @brief sdi_cpld_pin_group_read_wide
+ * Read the level of a cpld pin group of upto SDI_CPLD_PIN_GROUP_MAX_BITS.
+ * sdi_pin_group_read_level returns the low 32 bits of the same level.
+ * @param[in] pin_group_hdl - cpld pin group handle
+ * @param[out] value - pin group level
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when not a cpld pin group
+ */
+t_std_error sdi_cpld_pin_group_read_wide(sdi_pin_group_bus_hdl_t pin_group_hdl,
+                                         uint64_t *value);
+
+/**
+ * @brief sdi_cpld_pin_group_write_wide
+ * Update the level of a cpld pin group of upto SDI_CPLD_PIN_GROUP_MAX_BITS
+ * @param[in] pin_group_hdl - cpld pin group handle
+ * @param[in] value - pin group level
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when not a cpld pin group
+ */
+t_std_error sdi_cpld_pin_group_write_wide(sdi_pin_group_bus_hdl_t pin_group_hdl,
+                                          uint64_t value);
+
+/**
+ * @brief sdi_cpld_pin_group_read_levels
+ * Read the level of several cpld pin groups. Pin groups of the same cpld
+ * are read in one pass over the registers they span.
+ * @param[in] pin_group_hdls - cpld pin group handles
+ * @param[out] values - level, per pin group
+ * @param[in] count - no. of pin groups
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO of the first failed read,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when a pin group is not a cpld pin group
+ */
+t_std_error sdi_cpld_pin_group_read_levels(sdi_pin_group_bus_hdl_t *pin_group_hdls,
+                                           uint64_t *values, uint_t count);
+
+/**
+ * @brief sdi_cpld_pin_group_refresh
+ * Invalidate the register window snapshot of the cpld of a pin group, so that
+ * the next read of the pin group reads the cpld, ex: on an interrupt raised by
+ * a change of the pin group level
+ * @param[in] pin_group_hdl - cpld pin group handle
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when not a cpld
+ * pin group
+ */
+t_std_error sdi_cpld_pin_group_refresh(sdi_pin_group_bus_hdl_t pin_group_hdl);
+
+/**
+ * @brief sdi_cpld_shadow_invalidate
+ * Invalidate the shadow copy of every register of a cpld and its snapshot,
+ * ex: after a cpld reset, so that they are read again on next access
+ * @param[in] dev_hdl - cpld device handle
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when not a cpld
+ */
+t_std_error sdi_cpld_shadow_invalidate(sdi_device_hdl_t dev_hdl);
+
+/**
+ * @brief sdi_cpld_shadow_stats_get
+ * Get the shadow register counters of a cpld
+ * @param[in] dev_hdl - cpld device handle
+ * @param[out] stats - shadow register counters
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when not a cpld
+ */
+t_std_error sdi_cpld_shadow_stats_get(sdi_device_hdl_t dev_hdl,
+                                      sdi_cpld_shadow_stats_t *stats);
+
 #endif /* __SDI_CPLD_H__ */
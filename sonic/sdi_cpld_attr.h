@@ -67,6 +67,39 @@
  */
 #define SDI_DEV_ATTR_CPLD_WIDTH         "width"
 
+/*
+ * Attribute used for disabling block reads of multi register cpld pin
+ * groups, "no" when the cpld doesn't auto increment the register address on
+ * sequential reads
+ */
+#define SDI_DEV_ATTR_CPLD_BLOCK_READ    "block_read"
+
+/*
+ * Attribute used for disabling shadow copies of cpld output registers, "no"
+ * to read every register before write
+ */
+#define SDI_DEV_ATTR_CPLD_SHADOW        "shadow"
+
+/*
+ * Attribute used for representing the max age in ms of a shadow copy of a
+ * cpld register before it is read again, 0 for no periodic resync
+ */
+#define SDI_DEV_ATTR_CPLD_SHADOW_RESYNC "shadow_resync_ms"
+
+/*
+ * Attribute used for representing the max age in ms of the snapshot of cpld
+ * register window serving pin/pin group reads, 0 (default) disables snapshot
+ */
+#define SDI_DEV_ATTR_CPLD_SNAPSHOT      "snapshot_ms"
+
+/*
+ * Attributes used for representing the first and last register of the cpld
+ * snapshot window. Both are required with snapshot_ms, the window must not
+ * hold clear on read (ex: interrupt) registers
+ */
+#define SDI_DEV_ATTR_CPLD_SNAPSHOT_START "snapshot_start_addr"
+#define SDI_DEV_ATTR_CPLD_SNAPSHOT_END   "snapshot_end_addr"
+
 /*
  * Default cpld register's width in bytes
  */
@@ -27,6 +27,8 @@
 #define __SDI_DEVICE_COMMON
 #include "std_error_codes.h"
 #include "event_log.h"
+#include <stdint.h>
+#include <time.h>
 
 /**
   * @def Attribute used to define the maximum key size
@@ -66,4 +68,17 @@
  */
 #define SYSFS_PATH      "/sys"
 
+/**
+ * @brief sdi_device_now_ns
+ * Get monotonic time stamp, for latencies and deadlines
+ * @return time in nano seconds
+ */
+static inline uint64_t sdi_device_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (((uint64_t) now.tv_sec) * 1000000000ULL) + now.tv_nsec;
+}
+
 #endif /* __SDI_DEVICE_COMMON */
@@ -29,10 +29,13 @@
 #ifndef __SDI_GPIO_H___
 #define __SDI_GPIO_H___
 
+#include "std_error_codes.h"
 #include "sdi_pin.h"
 #include "sdi_pin_group.h"
 
 #include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 /**
  * For every supported gpio chip, Linux exports the gpio pins via sysfs interface
@@ -47,6 +50,18 @@
  * file.
  * For more details on accessing GPIO from user-space for Kernel driven gpio bus
  * refer to https://www.kernel.org/doc/Documentation/gpio/sysfs.txt
+ *
+ * gpio pins and pin groups naming their gpio chip (gpio_chip attribute) are
+ * accessed via the gpio character device /dev/gpiochip<N> instead: the pins
+ * are requested as lines of the chip with their direction and polarity once
+ * on init, and levels of every pin of a group are read or written by one
+ * ioctl. pin numbers are then line offsets on the chip.
+ *
+ * Direction, polarity and output levels of pins accessed via sysfs are
+ * shadowed in memory once written: getters and level reads of output pins are
+ * served from the shadow without any sysfs access. gpio pins and pin groups
+ * with shadow_verify="yes" attribute (debug) read sysfs anyway and report
+ * every mismatch with the shadow.
  */
 
 /**
@@ -59,6 +74,22 @@
  * Used while writing value to gpio sysfs value/invert_low file.
  */
 #define MAX_VALUE_STR_LEN        3
+/**
+ * @def Edge none/rising/falling/both string maximum length includes null
+ * terminator, \n. Used while writing edge to gpio sysfs edge file.
+ */
+#define MAX_EDGE_STR_LEN         9
+
+/**
+ * @enum sdi_gpio_edge_t
+ * Edges of a gpio input pin reported as events
+ */
+typedef enum {
+    SDI_GPIO_EDGE_NONE, /**< no event */
+    SDI_GPIO_EDGE_RISING, /**< event on rising edge */
+    SDI_GPIO_EDGE_FALLING, /**< event on falling edge */
+    SDI_GPIO_EDGE_BOTH, /**< event on either edge */
+} sdi_gpio_edge_t;
 
 /**
  * @struct sdi_gpio_file_fd_tbl_t
@@ -71,6 +102,18 @@ typedef struct sdi_gpio_file_descriptor_table {
     int polarity_fd; /**< SDI GPIO Pin polarity file descriptor */
 } sdi_gpio_file_fd_tbl_t;
 
+/**
+ * @struct sdi_gpio_line_cfg_t
+ * Configuration of the lines of a gpio character device line request, or
+ * shadow of the configuration of gpio pins accessed via sysfs
+ */
+typedef struct sdi_gpio_line_cfg {
+    sdi_pin_bus_direction_t direction; /**< direction of the lines */
+    sdi_pin_bus_polarity_t polarity; /**< polarity of the lines */
+    sdi_gpio_edge_t edge; /**< edges reported as events, input lines */
+    uint64_t values; /**< levels of output lines, by line index */
+} sdi_gpio_line_cfg_t;
+
 /**
  * @struct sdi_gpio_pin_t
  * SDI PIN Bus Structure Registered by every exported GPIO PIN
@@ -79,6 +122,13 @@ typedef struct sdi_gpio_pin {
     sdi_pin_bus_t bus; /**< SDI Pin Bus Object */
     uint_t gpio_num; /**< SDI GPIO Pin number */
     sdi_gpio_file_fd_tbl_t *gpio_file_tbl; /**< SDI GPIO File hdl table */
+    char *gpio_chip; /**< gpio chip of the pin, NULL for sysfs access */
+    int line_fd; /**< line request fd, -1 for sysfs access */
+    sdi_gpio_line_cfg_t line_cfg; /**< configuration of the line request,
+                                       shadow of sysfs configuration otherwise */
+    bool shadow_valid; /**< line_cfg shadows sysfs configuration */
+    bool shadow_verify; /**< verify shadow against sysfs on every get */
+    uint_t shadow_mismatches; /**< no. of mismatches found on verify */
 } sdi_gpio_pin_t;
 
 /**
@@ -91,6 +141,83 @@ typedef struct sdi_gpio_pingroup {
     sdi_gpio_file_fd_tbl_t **gpio_file_tbl; /**< Pointer to SDI GPIO
         File hdl table Pointers of each GPIO in group */
     uint_t gpio_count; /**< Number of gpio pins in the group */
+    char *gpio_chip; /**< gpio chip of the pins, NULL for sysfs access */
+    int line_fd; /**< line request fd, -1 for sysfs access */
+    sdi_gpio_line_cfg_t line_cfg; /**< configuration of the line request,
+                                       shadow of sysfs configuration otherwise */
+    bool shadow_valid; /**< line_cfg shadows sysfs configuration */
+    bool shadow_verify; /**< verify shadow against sysfs on every get */
+    uint_t shadow_mismatches; /**< no. of mismatches found on verify */
 } sdi_gpio_group_t;
 
+/**
+ * @struct sdi_gpio_event_t
+ * Edge event of a gpio pin or pin group
+ */
+typedef struct sdi_gpio_event {
+    sdi_bus_hdl_t bus; /**< gpio pin or pin group bus */
+    uint_t level; /**< level of the pin or pin group once cleared */
+    uint_t edges; /**< no. of edges cleared, 0 when not known (sysfs) */
+    uint64_t timestamp_ns; /**< CLOCK_MONOTONIC time of the first edge, 0 when
+                                not known (sysfs) */
+    uint64_t dispatch_ns; /**< CLOCK_MONOTONIC time of the delivery */
+} sdi_gpio_event_t;
+
+/**
+ * @brief sdi_gpio_event_enable
+ * Enable edge events on a gpio input pin. Once an edge occurs, the returned
+ * fd reports poll_events (poll/epoll) until the event is cleared.
+ * @param[in] bus - gpio pin bus handle
+ * @param[in] edge - edges to report, SDI_GPIO_EDGE_NONE disables events
+ * @param[out] fd - file descriptor to poll for events
+ * @param[out] poll_events - poll events reported by fd on an event
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when bus is not
+ * a gpio pin, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_gpio_event_enable(sdi_pin_bus_hdl_t bus, sdi_gpio_edge_t edge,
+                                  int *fd, short *poll_events);
+
+/**
+ * @brief sdi_gpio_event_clear
+ * Clear the pending event of a gpio pin, reading its current level
+ * @param[in] bus - gpio pin bus handle, events enabled
+ * @param[out] event - bus, level, edges and timestamp_ns filled, can be NULL
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when bus is not
+ * a gpio pin, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_gpio_event_clear(sdi_pin_bus_hdl_t bus,
+                                 sdi_gpio_event_t *event);
+
+/**
+ * @brief sdi_gpio_group_event_enable
+ * Enable edge events on every pin of a gpio input pin group. Once an edge
+ * occurs on a pin, one of the returned fds reports poll_events until the
+ * event of the group is cleared. Pins of a group accessed via sysfs have an
+ * fd each, a group accessed via character device has one.
+ * @param[in] bus - gpio pin group bus handle
+ * @param[in] edge - edges to report, SDI_GPIO_EDGE_NONE disables events
+ * @param[out] fds - file descriptors to poll for events
+ * @param[in] max_fds - size of fds
+ * @param[out] count - no. of fds filled
+ * @param[out] poll_events - poll events reported by fds on an event
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when bus is not
+ * a gpio pin group, SDI_DEVICE_ERRCODE(EINVAL) when fds is too small,
+ * SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_gpio_group_event_enable(sdi_pin_group_bus_hdl_t bus,
+                                        sdi_gpio_edge_t edge, int *fds,
+                                        uint_t max_fds, uint_t *count,
+                                        short *poll_events);
+
+/**
+ * @brief sdi_gpio_group_event_clear
+ * Clear the pending events of a gpio pin group, reading its current level
+ * @param[in] bus - gpio pin group bus handle, events enabled
+ * @param[out] event - bus, level, edges and timestamp_ns filled, can be NULL
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when bus is not
+ * a gpio pin group, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_gpio_group_event_clear(sdi_pin_group_bus_hdl_t bus,
+                                       sdi_gpio_event_t *event);
+
 #endif /* __SDI_GPIO_H___ */
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*
+ * filename: sdi_gpio_event.h
+ */
+
+
+/******************************************************************************
+ * Defines the gpio edge event dispatcher. gpio pins and pin groups (see
+ * sdi_gpio.h) subscribed for edge events are watched by a single dispatcher
+ * thread on one epoll set: sysfs value files (edge + POLLPRI) and character
+ * device line requests (line events) alike.
+ *
+ * Events ready on one wakeup are handled as a batch: every subscribed pin or
+ * pin group of the batch is cleared once, its level read, and then the
+ * callbacks are called in order, so a burst of edges on a pin group is
+ * delivered as one event. Events are timestamped with the edge time reported
+ * by the kernel (character device) or the wakeup time (sysfs), and the
+ * delivery time, for measuring detection latency.
+ *
+ * Callbacks run on the dispatcher thread and must not block: a consumer that
+ * reads devices on an event (ex: a CPLD over i2c) hands the event over to its
+ * own thread. Subscriptions live as long as the process.
+ *****************************************************************************/
+
+#ifndef __SDI_GPIO_EVENT_H__
+#define __SDI_GPIO_EVENT_H__
+
+#include "std_error_codes.h"
+#include "sdi_bus.h"
+#include "sdi_gpio.h"
+#include <stdint.h>
+
+/**
+ * Max no. of ready fds handled per dispatcher wakeup
+ */
+#define SDI_GPIO_EVENT_MAX_BATCH       (32)
+
+/**
+ * Dispatcher back off in milli seconds after a failed epoll wait
+ */
+#define SDI_GPIO_EVENT_ERROR_BACKOFF_MS (100)
+
+/**
+ * @typedef sdi_gpio_event_callback_t
+ * Event callback, called from the dispatcher thread
+ * @param[in] event - event of the subscribed pin or pin group
+ * @param[in] data - data given at subscription
+ * @return none
+ */
+typedef void (*sdi_gpio_event_callback_t)(const sdi_gpio_event_t *event,
+                                          void *data);
+
+/**
+ * @struct sdi_gpio_event_stats_t
+ * @brief dispatcher counters
+ */
+typedef struct sdi_gpio_event_stats_ {
+    uint_t subscriptions; /**< no. of subscribed pins and pin groups */
+    uint64_t wakeups; /**< no. of dispatcher wakeups */
+    uint64_t events; /**< no. of events delivered */
+    uint64_t edges; /**< no. of edges reported by the kernel (character
+                         device only), coalesced into events */
+    uint64_t clear_errors; /**< no. of events whose level can't be read */
+    uint64_t wait_errors; /**< no. of failed epoll waits */
+    uint_t last_depth; /**< no. of events of last wakeup */
+    uint_t max_depth; /**< max no. of events of a wakeup */
+    uint64_t last_timestamp_ns; /**< timestamp of last event */
+    uint64_t latency_total_ns; /**< sum of delivery - timestamp of events */
+    uint64_t latency_max_ns; /**< max delivery - timestamp of an event */
+} sdi_gpio_event_stats_t;
+
+/**
+ * @brief sdi_gpio_event_subscribe
+ * Enable edge events on a gpio input pin or pin group and deliver them to a
+ * callback. The dispatcher thread is started on first subscription.
+ * @param[in] bus - gpio pin or gpio pin group bus handle
+ * @param[in] edge - edges to report
+ * @param[in] callback - event callback
+ * @param[in] data - passed to callback
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when bus is not
+ * a gpio pin or pin group, SDI_DEVICE_ERRNO or SDI_DEVICE_ERRCODE of pthread
+ * error on failure
+ */
+t_std_error sdi_gpio_event_subscribe(sdi_bus_hdl_t bus, sdi_gpio_edge_t edge,
+                                     sdi_gpio_event_callback_t callback,
+                                     void *data);
+
+/**
+ * @brief sdi_gpio_event_stats_get
+ * Get the dispatcher counters
+ * @param[out] stats - dispatcher counters
+ * @return none
+ */
+void sdi_gpio_event_stats_get(sdi_gpio_event_stats_t *stats);
+
+#endif /* __SDI_GPIO_EVENT_H__ */
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_i2c_arb.h
+ */
+
+
+/******************************************************************************
+ * Defines the priority aware I2C bus arbiter used as bus lock by i2c bus
+ * drivers and i2c muxes.
+ *
+ * Every thread has an i2c priority class, SDI_I2C_PRIO_DEFAULT unless set
+ * with sdi_i2c_priority_set. When the bus is released, it is handed to the
+ * oldest waiter of the highest class waiting, so a fan speed write waits for
+ * at most the transaction in progress instead of every queued EEPROM read.
+ * Threads of the same class are served in arrival order.
+ *
+ * Long operations yield at transaction boundaries by releasing the bus, which
+ * hands it over when a higher class is waiting (see sdi_i2c_batch_execute).
+ *****************************************************************************/
+
+#ifndef __SDI_I2C_ARB_H__
+#define __SDI_I2C_ARB_H__
+
+#include "std_error_codes.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @enum sdi_i2c_prio_t
+ * I2C priority classes, in increasing order of priority
+ */
+typedef enum {
+    SDI_I2C_PRIO_INVENTORY, /* FRU EEPROM, media vendor info */
+    SDI_I2C_PRIO_MONITOR, /* sensor and media DOM monitoring */
+    SDI_I2C_PRIO_PRESENCE, /* presence and status polling */
+    SDI_I2C_PRIO_CONTROL, /* thermal and fan control */
+    SDI_I2C_PRIO_MAX /* always last */
+} sdi_i2c_prio_t;
+
+/**
+ * Priority class of threads which never set one
+ */
+#define SDI_I2C_PRIO_DEFAULT           (SDI_I2C_PRIO_MONITOR)
+
+/**
+ * @struct sdi_i2c_arb_t
+ * @brief priority aware bus lock
+ */
+typedef struct sdi_i2c_arb_ {
+    pthread_mutex_t lock; /**< protects arbiter state */
+    pthread_cond_t cond[SDI_I2C_PRIO_MAX]; /**< waiters of each class */
+    bool held; /**< bus acquired */
+    sdi_i2c_prio_t holder_prio; /**< class of bus owner */
+    uint_t waiters[SDI_I2C_PRIO_MAX]; /**< no. of waiters of each class */
+    uint_t next_ticket[SDI_I2C_PRIO_MAX]; /**< arrival order within class */
+    uint_t serving[SDI_I2C_PRIO_MAX]; /**< ticket to be served next */
+    uint64_t acquired_ns; /**< time of acquisition, for hold time */
+} sdi_i2c_arb_t;
+
+/**
+ * @brief sdi_i2c_priority_get
+ * Get the i2c priority class of calling thread
+ * @return priority class
+ */
+sdi_i2c_prio_t sdi_i2c_priority_get(void);
+
+/**
+ * @brief sdi_i2c_priority_set
+ * Set the i2c priority class of calling thread, used for all bus
+ * acquisitions of the thread until changed
+ * @param[in] prio - priority class
+ * @return previous priority class, to be restored by callers scoping a class
+ * to an operation
+ */
+sdi_i2c_prio_t sdi_i2c_priority_set(sdi_i2c_prio_t prio);
+
+/**
+ * @brief sdi_i2c_arb_init
+ * Initialize a bus arbiter
+ * @param[out] arb - bus arbiter
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE of pthread error otherwise
+ */
+t_std_error sdi_i2c_arb_init(sdi_i2c_arb_t *arb);
+
+/**
+ * @brief sdi_i2c_arb_acquire
+ * Acquire the bus with the priority class of calling thread, waiting for
+ * the bus owner and every waiter of a higher class
+ * @param[in] arb - bus arbiter
+ * @param[out] prio - priority class used, can be NULL
+ * @param[out] wait_ns - time spent waiting, can be NULL
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE of pthread error otherwise
+ */
+t_std_error sdi_i2c_arb_acquire(sdi_i2c_arb_t *arb, sdi_i2c_prio_t *prio,
+                                uint64_t *wait_ns);
+
+/**
+ * @brief sdi_i2c_arb_release
+ * Release the bus, handing it to the highest class waiting
+ * @param[in] arb - bus arbiter
+ * @return time the bus was held in nano seconds
+ */
+uint64_t sdi_i2c_arb_release(sdi_i2c_arb_t *arb);
+
+/**
+ * @brief sdi_i2c_arb_contended
+ * Check if a thread of a higher class than the bus owner is waiting. Used
+ * by long operations to decide on yielding the bus.
+ * @param[in] arb - bus arbiter
+ * @return true if a higher class is waiting
+ */
+bool sdi_i2c_arb_contended(sdi_i2c_arb_t *arb);
+
+#endif /* __SDI_I2C_ARB_H__ */
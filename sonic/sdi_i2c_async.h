@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_i2c_async.h
+ */
+
+
+/******************************************************************************
+ * Defines the asynchronous I2C request API. A request is a batch (see
+ * sdi_i2c_batch.h) submitted to the queue of an i2c bus and executed by the
+ * worker thread of that bus, so that requests on independent buses overlap
+ * while requests on one bus execute in submission order.
+ *
+ * The worker thread of a bus is started on first submission. A request
+ * with a callback completes by calling the callback from the worker thread,
+ * which then owns the request (ex: may free it). A request without callback
+ * is waited for by the submitter (sdi_i2c_async_wait), like a future.
+ *
+ * Requests are allocated by the caller and must stay valid until completed.
+ * The i2c priority class of the submitting thread is applied to the request.
+ *****************************************************************************/
+
+#ifndef __SDI_I2C_ASYNC_H__
+#define __SDI_I2C_ASYNC_H__
+
+#include "std_error_codes.h"
+#include "sdi_i2c.h"
+#include "sdi_i2c_batch.h"
+#include "sdi_i2c_arb.h"
+#include <stdbool.h>
+
+struct sdi_i2c_async_req_;
+struct sdi_i2c_async_queue_;
+
+/**
+ * @typedef sdi_i2c_async_callback_t
+ * Completion callback of a request, called from the worker thread of the bus
+ * @param[in] req - completed request, status and ops status filled
+ * @param[in] data - data given at request initialization
+ * @return none
+ */
+typedef void (*sdi_i2c_async_callback_t)(struct sdi_i2c_async_req_ *req,
+                                         void *data);
+
+/**
+ * @struct sdi_i2c_async_req_t
+ * @brief asynchronous i2c request
+ */
+typedef struct sdi_i2c_async_req_ {
+    sdi_i2c_batch_op_t *ops; /**< operations of the request */
+    uint_t count; /**< no. of operations */
+    sdi_i2c_async_callback_t callback; /**< completion callback, can be NULL */
+    void *data; /**< passed to callback */
+    t_std_error status; /**< status of the request, valid once completed */
+    sdi_i2c_prio_t prio; /**< i2c priority class of submitter */
+    bool done; /**< request completed, protected by queue lock */
+    struct sdi_i2c_async_queue_ *queue; /**< queue the request is submitted to */
+    struct sdi_i2c_async_req_ *next; /**< next request in queue */
+} sdi_i2c_async_req_t;
+
+/**
+ * @brief sdi_i2c_async_req_init
+ * Initialize a request
+ * @param[out] req - request
+ * @param[in] ops - operations of the request, must stay valid until completed
+ * @param[in] count - no. of operations
+ * @param[in] callback - completion callback, can be NULL
+ * @param[in] data - passed to callback
+ * @return none
+ */
+void sdi_i2c_async_req_init(sdi_i2c_async_req_t *req, sdi_i2c_batch_op_t *ops,
+                            uint_t count, sdi_i2c_async_callback_t callback,
+                            void *data);
+
+/**
+ * @brief sdi_i2c_async_submit
+ * Submit a request to the queue of an i2c bus
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[inout] req - initialized request
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE of pthread error when the
+ * worker thread of the bus can't be started
+ */
+t_std_error sdi_i2c_async_submit(sdi_i2c_bus_hdl_t i2c_bus,
+                                 sdi_i2c_async_req_t *req);
+
+/**
+ * @brief sdi_i2c_async_wait
+ * Wait for a submitted request without callback to complete. Must not be
+ * called from a completion callback.
+ * @param[in] req - submitted request
+ * @return status of the request
+ */
+t_std_error sdi_i2c_async_wait(sdi_i2c_async_req_t *req);
+
+#endif /* __SDI_I2C_ASYNC_H__ */
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_i2c_batch.h
+ */
+
+
+/******************************************************************************
+ * Defines the I2C transaction batch API. A batch is a vector of i2c read/write
+ * operations across one or more i2c slaves of an i2c bus, executed under a
+ * single bus acquisition.
+ *
+ * sdi_i2c_bus_ops_t is owned by the sdi framework, hence i2c bus drivers
+ * able to execute a batch natively (ex: as a single I2C_RDWR ioctl) register
+ * their batch operation against the bus handle using sdi_i2c_batch_register.
+ * Batches on other i2c buses are executed one operation at a time. Likewise
+ * i2c bus drivers register the arbiter taken by their bus acquisition using
+ * sdi_i2c_batch_arb_register, so that long batches can yield the bus.
+ *****************************************************************************/
+
+#ifndef __SDI_I2C_BATCH_H__
+#define __SDI_I2C_BATCH_H__
+
+#include "std_error_codes.h"
+#include "sdi_i2c.h"
+#include "sdi_i2c_arb.h"
+
+/**
+ * Max no. of offset bytes of a batch operation
+ */
+#define SDI_I2C_BATCH_MAX_CMD_LEN      (4)
+
+/**
+ * @struct sdi_i2c_batch_op_t
+ * @brief one i2c operation of a batch
+ * - i2c slave address and operation (read/write)
+ * - offset bytes sent ahead of data
+ * - data buffer read from/written to slave
+ * - status of this operation, filled on execution of the batch
+ */
+typedef struct sdi_i2c_batch_op_ {
+    sdi_i2c_addr_t address; /**< i2c slave address */
+    sdi_i2c_operation_t operation; /**< SDI_I2C_READ or SDI_I2C_WRITE */
+    uint8_t cmd[SDI_I2C_BATCH_MAX_CMD_LEN]; /**< offset, msb first */
+    uint_t cmdlen; /**< no. of offset bytes, can be 0 */
+    void *buffer; /**< data read from/written to slave */
+    uint_t buflen; /**< no. of bytes to read/write */
+    t_std_error status; /**< status of this operation */
+} sdi_i2c_batch_op_t;
+
+/**
+ * @typedef sdi_i2c_batch_execute_t
+ * Batch operation of an i2c bus driver. Called with the i2c bus acquired.
+ * Must fill status of every operation in ops.
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[inout] ops - list of operations
+ * @param[in] count - no. of operations
+ * @return STD_ERR_OK when every operation succeeded, error of the first
+ * failed operation otherwise
+ */
+typedef t_std_error (*sdi_i2c_batch_execute_t)(sdi_i2c_bus_hdl_t i2c_bus,
+                                               sdi_i2c_batch_op_t *ops,
+                                               uint_t count);
+
+/**
+ * @brief sdi_i2c_batch_op_init
+ * Fill an operation of a batch with an offset of offset_len bytes
+ * @param[out] op - operation to be filled
+ * @param[in] address - i2c slave address
+ * @param[in] operation - SDI_I2C_READ or SDI_I2C_WRITE
+ * @param[in] offset - offset in slave
+ * @param[in] offset_len - no. of offset bytes, upto SDI_I2C_BATCH_MAX_CMD_LEN
+ * @param[in] buffer - data read from/written to slave
+ * @param[in] buflen - no. of bytes to read/write
+ * @return none
+ */
+void sdi_i2c_batch_op_init(sdi_i2c_batch_op_t *op, sdi_i2c_addr_t address,
+                           sdi_i2c_operation_t operation, uint_t offset,
+                           uint_t offset_len, void *buffer, uint_t buflen);
+
+/**
+ * @brief sdi_i2c_batch_register
+ * Register the batch operation of an i2c bus. Called by i2c bus drivers
+ * during bus registration/initialization.
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[in] execute - batch operation of the i2c bus
+ * @return STD_ERR_OK on success
+ */
+t_std_error sdi_i2c_batch_register(sdi_i2c_bus_hdl_t i2c_bus,
+                                   sdi_i2c_batch_execute_t execute);
+
+/**
+ * @brief sdi_i2c_batch_arb_register
+ * Register the arbiter of an i2c bus. Called by i2c bus drivers during bus
+ * registration/initialization.
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[in] arb - arbiter taken by bus acquisition (for an i2c mux channel,
+ * the arbiter of the mux)
+ * @return STD_ERR_OK on success
+ */
+t_std_error sdi_i2c_batch_arb_register(sdi_i2c_bus_hdl_t i2c_bus,
+                                       sdi_i2c_arb_t *arb);
+
+/**
+ * @brief sdi_i2c_batch_execute_locked
+ * Execute a batch on an i2c bus already acquired by the caller
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[inout] ops - list of operations, status filled on return
+ * @param[in] count - no. of operations
+ * @return STD_ERR_OK when every operation succeeded, error of the first
+ * failed operation otherwise
+ */
+t_std_error sdi_i2c_batch_execute_locked(sdi_i2c_bus_hdl_t i2c_bus,
+                                         sdi_i2c_batch_op_t *ops, uint_t count);
+
+/**
+ * @brief sdi_i2c_batch_execute
+ * Acquire the i2c bus, execute a batch and release the i2c bus. Batches of
+ * threads below SDI_I2C_PRIO_CONTROL check the arbiter of the bus every few
+ * operations, and release the bus at that operation boundary when a higher
+ * priority class is waiting for it, so that it doesn't wait for the whole
+ * batch. Uncontended batches keep the bus. Buses without a registered
+ * arbiter run the batch under one acquisition.
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[inout] ops - list of operations, status filled on return
+ * @param[in] count - no. of operations
+ * @return STD_ERR_OK when every operation succeeded, error of bus
+ * acquisition or of the first failed operation otherwise
+ */
+t_std_error sdi_i2c_batch_execute(sdi_i2c_bus_hdl_t i2c_bus,
+                                  sdi_i2c_batch_op_t *ops, uint_t count);
+
+#endif /* __SDI_I2C_BATCH_H__ */
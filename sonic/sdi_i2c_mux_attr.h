@@ -46,6 +46,11 @@
  * @def Attribute used for representing i2c mux channel
  */
 #define SDI_DEV_ATTR_SDI_I2CMUX_CHANNEL          "channel"
+/**
+ * @def Attribute used for disabling the channel selection cache of i2cmux,
+ * "no" when the mux pins are also driven by another agent
+ */
+#define SDI_DEV_ATTR_SDI_I2CMUX_SELECT_CACHE     "select_cache"
 
 /**
  * @}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_i2c_sched.h
+ */
+
+
+/******************************************************************************
+ * Defines the mux aware I2C transaction scheduler. A sweep (ex: a poller
+ * walking every sensor of the platform) hands its pending batches (see
+ * sdi_i2c_batch.h) to the scheduler at once instead of executing them in
+ * config order. Batches are grouped by i2c bus, groups on channels of the
+ * same i2c mux are run back to back, and every group runs under one bus
+ * acquisition, i.e. one mux channel selection.
+ *
+ * Fairness: a group runs at most max_ops operations per turn, the remaining
+ * ones run in the next round, after every other group had its turn. Batches
+ * of a group run in submission order, operations of a batch in order.
+ *****************************************************************************/
+
+#ifndef __SDI_I2C_SCHED_H__
+#define __SDI_I2C_SCHED_H__
+
+#include "std_error_codes.h"
+#include "sdi_i2c.h"
+#include "sdi_i2c_batch.h"
+
+/**
+ * Default max no. of operations of a group per turn
+ */
+#define SDI_I2C_SCHED_DEF_MAX_OPS      (32)
+
+/**
+ * @struct sdi_i2c_sched_req_t
+ * @brief batch of a sweep
+ */
+typedef struct sdi_i2c_sched_req_ {
+    sdi_i2c_bus_hdl_t i2c_bus; /**< i2c bus (or i2c mux channel) of the batch */
+    sdi_i2c_batch_op_t *ops; /**< operations of the batch */
+    uint_t count; /**< no. of operations */
+    t_std_error status; /**< status of the batch, filled on execution */
+} sdi_i2c_sched_req_t;
+
+/**
+ * @struct sdi_i2c_sched_stats_t
+ * @brief counters of a sweep
+ */
+typedef struct sdi_i2c_sched_stats_ {
+    uint_t groups; /**< no. of i2c buses of the sweep */
+    uint_t turns; /**< no. of bus acquisitions */
+    uint_t mux_switches; /**< no. of mux channel selections written during
+                              the sweep, measured on the muxes of the sweep
+                              (see sdi_i2cmux_pin_select_stats_get), includes
+                              selections of concurrent users of those muxes */
+    uint_t mux_switches_in_order; /**< no. of mux channel selections, had
+                                       the batches run in submission order,
+                                       computed from the batches */
+} sdi_i2c_sched_stats_t;
+
+/**
+ * @brief sdi_i2c_sched_execute
+ * Execute the batches of a sweep grouped by i2c bus and mux channel
+ * @param[inout] reqs - batches of the sweep, status filled on return
+ * @param[in] count - no. of batches
+ * @param[in] max_ops - max no. of operations of a group per turn, 0 for
+ * SDI_I2C_SCHED_DEF_MAX_OPS
+ * @param[out] stats - counters of the sweep, can be NULL
+ * @return STD_ERR_OK when every batch succeeded, status of the first failed
+ * batch otherwise
+ */
+t_std_error sdi_i2c_sched_execute(sdi_i2c_sched_req_t *reqs, uint_t count,
+                                  uint_t max_ops, sdi_i2c_sched_stats_t *stats);
+
+#endif /* __SDI_I2C_SCHED_H__ */
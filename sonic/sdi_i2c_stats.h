@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_i2c_stats.h
+ */
+
+
+/******************************************************************************
+ * Defines I2C transaction telemetry kept by i2c bus drivers: per bus and per
+ * (bus, slave address) counters of transactions, bytes, retries, errors by
+ * errno and a log2 bucketed latency histogram, plus bus lock wait time by
+ * i2c priority class and bus lock hold time.
+ *
+ * Counters are updated by the bus driver with the bus acquired, so there is
+ * a single writer per bus and no atomic operations on the hot path. Readers
+ * don't take the bus lock, every counter is an aligned 64bit value which is
+ * read consistently on its own.
+ *
+ * Stats of a bus are kept in process memory, or optionally in a POSIX shared
+ * memory object SDI_I2C_STATS_SHM_PREFIX<bus_name> which external tools can
+ * map read only.
+ *****************************************************************************/
+
+#ifndef __SDI_I2C_STATS_H__
+#define __SDI_I2C_STATS_H__
+
+#include "std_error_codes.h"
+#include "sdi_i2c.h"
+#include "sdi_i2c_arb.h"
+#include "sdi_device_common.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * Attribute used for enabling shared memory stats of an i2c bus
+ */
+#define SDI_DEV_ATTR_STATS_SHM         "stats_shm"
+
+/**
+ * Name prefix of the shared memory object of an i2c bus
+ */
+#define SDI_I2C_STATS_SHM_PREFIX       "/sdi_i2c_stats."
+
+/**
+ * Magic and version of the stats block, to be validated by external readers
+ */
+#define SDI_I2C_STATS_MAGIC            (0x53493243) /* "SI2C" */
+#define SDI_I2C_STATS_VERSION          (2)
+
+/**
+ * No. of latency histogram buckets. Bucket n counts latencies in
+ * [2^n, 2^(n+1)) nano seconds, last bucket counts everything above.
+ */
+#define SDI_I2C_STATS_LAT_BUCKETS      (32)
+
+/**
+ * No. of slave addresses tracked per bus
+ */
+#define SDI_I2C_STATS_MAX_ADDR         (128)
+
+/**
+ * Max length of a bus name in stats block
+ */
+#define SDI_I2C_STATS_NAME_LEN         (64)
+
+/**
+ * Errors tracked by errno
+ */
+typedef enum {
+    SDI_I2C_STATS_ERR_NXIO, /* ENXIO: no ack */
+    SDI_I2C_STATS_ERR_REMOTEIO, /* EREMOTEIO: no ack */
+    SDI_I2C_STATS_ERR_AGAIN, /* EAGAIN: arbitration lost */
+    SDI_I2C_STATS_ERR_BUSY, /* EBUSY: bus busy */
+    SDI_I2C_STATS_ERR_TIMEDOUT, /* ETIMEDOUT: timeout */
+    SDI_I2C_STATS_ERR_IO, /* EIO: adapter error */
+    SDI_I2C_STATS_ERR_PROTO, /* EPROTO: protocol violation */
+    SDI_I2C_STATS_ERR_BADMSG, /* EBADMSG: PEC error */
+    SDI_I2C_STATS_ERR_OTHER, /* any other errno */
+    SDI_I2C_STATS_ERR_MAX /* always last */
+} sdi_i2c_stats_err_t;
+
+/**
+ * @struct sdi_i2c_counters_t
+ * @brief transaction counters of a bus or of a slave on a bus
+ */
+typedef struct sdi_i2c_counters_ {
+    uint64_t transactions; /**< no. of transactions, including failed ones */
+    uint64_t bytes; /**< no. of data bytes transferred */
+    uint64_t retries; /**< no. of retried transactions */
+    uint64_t errors[SDI_I2C_STATS_ERR_MAX]; /**< failed attempts by errno */
+    uint64_t latency_ns; /**< sum of transaction latency */
+    uint64_t latency_hist[SDI_I2C_STATS_LAT_BUCKETS]; /**< latency histogram */
+} sdi_i2c_counters_t;
+
+/**
+ * @struct sdi_i2c_stats_t
+ * @brief stats block of an i2c bus
+ */
+typedef struct sdi_i2c_stats_ {
+    uint32_t magic; /**< SDI_I2C_STATS_MAGIC */
+    uint32_t version; /**< SDI_I2C_STATS_VERSION */
+    uint32_t size; /**< sizeof(sdi_i2c_stats_t) */
+    uint32_t bus_id; /**< bus instance */
+    char bus_name[SDI_I2C_STATS_NAME_LEN]; /**< bus name */
+    uint64_t lock_acquisitions; /**< no. of bus acquisitions */
+    uint64_t lock_wait_ns; /**< sum of time spent waiting for bus lock */
+    uint64_t lock_wait_hist[SDI_I2C_STATS_LAT_BUCKETS]; /**< lock wait
+                                                          histogram */
+    uint64_t prio_acquisitions[SDI_I2C_PRIO_MAX]; /**< no. of bus
+                                                    acquisitions by class */
+    uint64_t prio_wait_ns[SDI_I2C_PRIO_MAX]; /**< lock wait time by class */
+    uint64_t prio_wait_max_ns[SDI_I2C_PRIO_MAX]; /**< worst lock wait time
+                                                   by class */
+    uint64_t lock_hold_ns; /**< sum of time bus lock was held */
+    uint64_t lock_hold_max_ns; /**< longest time bus lock was held */
+    uint64_t lock_hold_hist[SDI_I2C_STATS_LAT_BUCKETS]; /**< lock hold
+                                                          histogram */
+    sdi_i2c_counters_t bus; /**< counters of all slaves on bus */
+    sdi_i2c_counters_t addr[SDI_I2C_STATS_MAX_ADDR]; /**< counters per slave */
+} sdi_i2c_stats_t;
+
+/**
+ * @brief sdi_i2c_stats_now_ns
+ * Get monotonic time stamp for latency measurement
+ * @return time in nano seconds
+ */
+static inline uint64_t sdi_i2c_stats_now_ns(void)
+{
+    return sdi_device_now_ns();
+}
+
+/**
+ * @brief sdi_i2c_stats_errno
+ * Get the errno to be recorded for a transaction from its return code
+ * @param[in] error - return code of the transaction
+ * @return 0 on success, errno carried by error on failure, EIO when error
+ * doesn't carry one
+ */
+static inline int sdi_i2c_stats_errno(t_std_error error)
+{
+    int err = 0;
+
+    if (error == STD_ERR_OK) {
+        return 0;
+    }
+    err = STD_ERR_EXT_PRIV(error);
+    return (err != 0) ? err : EIO;
+}
+
+/**
+ * @brief sdi_i2c_stats_bucket
+ * Get the latency histogram bucket of a latency
+ * @param[in] ns - latency in nano seconds
+ * @return bucket index
+ */
+static inline uint_t sdi_i2c_stats_bucket(uint64_t ns)
+{
+    uint_t bucket = 63 - __builtin_clzll(ns | 1);
+
+    return (bucket < SDI_I2C_STATS_LAT_BUCKETS) ? bucket :
+        (SDI_I2C_STATS_LAT_BUCKETS - 1);
+}
+
+/**
+ * @brief sdi_i2c_stats_create
+ * Create the stats block of an i2c bus and register it for look up by bus
+ * handle. Called by i2c bus drivers during bus registration.
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[in] shared - true to keep stats in shared memory
+ * @return stats block of the bus
+ */
+sdi_i2c_stats_t *sdi_i2c_stats_create(sdi_i2c_bus_hdl_t i2c_bus, bool shared);
+
+/**
+ * @brief sdi_i2c_stats_record
+ * Record a transaction. Called with bus acquired.
+ * @param[in] stats - stats block of the bus, can be NULL
+ * @param[in] address - i2c slave address
+ * @param[in] bytes - no. of data bytes transferred
+ * @param[in] latency_ns - transaction latency
+ * @param[in] err - errno of failed transaction, 0 on success
+ * @return none
+ */
+void sdi_i2c_stats_record(sdi_i2c_stats_t *stats, sdi_i2c_addr_t address,
+                          size_t bytes, uint64_t latency_ns, int err);
+
+/**
+ * @brief sdi_i2c_stats_record_retry
+ * Record a retry of a failed transaction. Called with bus acquired.
+ * @param[in] stats - stats block of the bus, can be NULL
+ * @param[in] address - i2c slave address
+ * @param[in] err - errno of the failed attempt
+ * @return none
+ */
+void sdi_i2c_stats_record_retry(sdi_i2c_stats_t *stats, sdi_i2c_addr_t address,
+                                int err);
+
+/**
+ * @brief sdi_i2c_stats_record_lock_wait
+ * Record the time spent waiting for bus lock. Called with bus acquired.
+ * @param[in] stats - stats block of the bus, can be NULL
+ * @param[in] prio - i2c priority class of the acquisition
+ * @param[in] wait_ns - lock wait time
+ * @return none
+ */
+void sdi_i2c_stats_record_lock_wait(sdi_i2c_stats_t *stats, sdi_i2c_prio_t prio,
+                                    uint64_t wait_ns);
+
+/**
+ * @brief sdi_i2c_stats_record_lock_hold
+ * Record the time bus lock was held. Called when releasing the bus.
+ * @param[in] stats - stats block of the bus, can be NULL
+ * @param[in] hold_ns - lock hold time
+ * @return none
+ */
+void sdi_i2c_stats_record_lock_hold(sdi_i2c_stats_t *stats, uint64_t hold_ns);
+
+/**
+ * @brief sdi_i2c_stats_get
+ * Get the stats block of an i2c bus
+ * @param[in] i2c_bus - i2c bus handle
+ * @return stats block of the bus, NULL if the bus keeps no stats
+ */
+const sdi_i2c_stats_t *sdi_i2c_stats_get(sdi_i2c_bus_hdl_t i2c_bus);
+
+/**
+ * @brief sdi_i2c_stats_for_each
+ * Walk the stats block of every i2c bus keeping stats
+ * @param[in] callback - called for every stats block
+ * @param[in] data - passed to callback
+ * @return none
+ */
+void sdi_i2c_stats_for_each(void (*callback)(const sdi_i2c_stats_t *stats,
+                                             void *data), void *data);
+
+/**
+ * @brief sdi_i2c_stats_percentile
+ * Get a latency percentile from a latency histogram
+ * @param[in] hist - latency histogram with SDI_I2C_STATS_LAT_BUCKETS buckets
+ * @param[in] percentile - percentile, 1 to 100
+ * @return upper bound in nano seconds of the bucket holding the percentile,
+ * 0 if histogram is empty
+ */
+uint64_t sdi_i2c_stats_percentile(const uint64_t *hist, uint_t percentile);
+
+/**
+ * @brief sdi_i2c_stats_reset
+ * Reset the counters of an i2c bus. Called with bus acquired.
+ * @param[in] i2c_bus - i2c bus handle
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOENT) if the bus keeps
+ * no stats
+ */
+t_std_error sdi_i2c_stats_reset(sdi_i2c_bus_hdl_t i2c_bus);
+
+#endif /* __SDI_I2C_STATS_H__ */
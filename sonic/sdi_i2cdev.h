@@ -27,7 +27,12 @@
 #ifndef __SDI_I2CDEV_H___
 #define __SDI_I2CDEV_H___
 #include "sdi_i2c.h"
+#include "std_config_node.h"
+#include "sdi_i2c_stats.h"
+#include "sdi_i2c_arb.h"
 #include <linux/limits.h>
+#include <linux/i2c.h>
+#include <stdbool.h>
 
 /**
  * Defines Data Structures to access I2C bus exported by kernel i2c
@@ -55,12 +60,146 @@
  */
 #define SDI_DEV_ATTR_SYSFS_NAME        "sysfs_name"
 
+/**
+ * Attribute used for representing the settle time in micro seconds to be
+ * applied after every transaction. Valid on sys_i2c node (bus default) and
+ * on i2c slave device nodes (device specific)
+ */
+#define SDI_DEV_ATTR_POST_XFER_DELAY   "post_xfer_delay_us"
+
+/**
+ * Attribute used for representing the settle time in micro seconds to be
+ * applied after every write transaction to an i2c slave device
+ */
+#define SDI_DEV_ATTR_WRITE_SETTLE      "write_settle_us"
+
+/**
+ * Attribute used for enabling ack polling for the write cycle of an i2c slave
+ * device (ex: 24Cxx eeprom). When enabled, write_settle_us is the upper bound
+ * of the poll instead of a fixed sleep.
+ */
+#define SDI_DEV_ATTR_WRITE_ACK_POLL    "write_ack_poll"
+
+/**
+ * Attribute used for representing the write page size in bytes of an i2c
+ * slave device (ex: 24Cxx eeprom). I2C block writes are split on page
+ * boundaries, with write settle time applied between the pages. Without it,
+ * i2c block writes longer than a single smbus block are rejected.
+ */
+#define SDI_DEV_ATTR_WRITE_PAGE_SIZE   "write_page_size"
+
+/**
+ * Attribute used for representing the max no. of retries of a failed
+ * transaction with a transient error (arbitration lost, timeout, bus busy).
+ * Transactions failed with device absent (NACK) are not retried, except
+ * within write_settle_us of a write completed to the same slave, on the same
+ * bus segment (mux channel), as the slave may be in its write cycle.
+ */
+#define SDI_DEV_ATTR_MAX_RETRIES       "max_retries"
+
+/**
+ * Attribute used for representing the back off in micro seconds before the
+ * first retry. Back off doubles with every retry upto retry_backoff_max_us.
+ */
+#define SDI_DEV_ATTR_RETRY_BACKOFF     "retry_backoff_us"
+
+/**
+ * Attribute used for representing the max back off in micro seconds between
+ * retries
+ */
+#define SDI_DEV_ATTR_RETRY_BACKOFF_MAX "retry_backoff_max_us"
+
+/**
+ * Default retry policy of an i2c slave
+ */
+#define SDI_I2C_DEF_MAX_RETRIES        (4)
+#define SDI_I2C_DEF_RETRY_BACKOFF      (250) /* 250us */
+#define SDI_I2C_DEF_RETRY_BACKOFF_MAX  (4000) /* 4ms */
+
+/**
+ * Attribute used for representing the max time in milli seconds to wait for
+ * the kernel i2c adapter named sysfs_name to appear, for adapters created
+ * late during boot (ex: by i2c mux drivers)
+ */
+#define SDI_DEV_ATTR_ADAPTER_WAIT      "adapter_wait_ms"
+
+/**
+ * Default wait for a kernel i2c adapter to appear
+ */
+#define SDI_I2C_DEF_ADAPTER_WAIT_MS    (1000) /* 1s */
+
+/**
+ * SMBUS block process call transaction size. Values of sdi_smbus_data_type_t
+ * are same as kernel smbus transaction sizes, sdi framework doesn't export
+ * this one.
+ */
+#define SDI_SYS_SMBUS_BLOCK_PROC_CALL  ((sdi_smbus_data_type_t) I2C_SMBUS_BLOCK_PROC_CALL)
+
+/**
+ * Number of 7bit i2c slave addresses
+ */
+#define SDI_I2C_MAX_SLAVE_ADDR         (128)
+
+/**
+ * SDI I2C transaction settle time and retry policy
+ */
+typedef struct sdi_i2c_dev_policy_ {
+    uint_t post_xfer_delay_us; /* Settle time after every transaction */
+    uint_t write_settle_us; /* Settle time (or max ack poll time, if
+        write_ack_poll is set) after every write transaction */
+    bool write_ack_poll; /* Poll the device for ack instead of sleeping
+        write_settle_us after a write transaction */
+    uint_t write_page_size; /* Write page size of the device, 0 when
+        block writes must not be split */
+    uint_t max_retries; /* Max retries of a transaction failed with a
+        transient error */
+    uint_t retry_backoff_us; /* Back off before first retry */
+    uint_t retry_backoff_max_us; /* Upper bound of back off between retries */
+} sdi_i2c_dev_policy_t;
+
+/**
+ * SDI I2C transaction retry counters of an i2c bus
+ */
+typedef struct sdi_i2c_retry_stats_ {
+    uint64_t retries; /* No. of retried transactions */
+    uint64_t retry_wait_us; /* Time spent in back off between retries */
+    uint64_t absent_failures; /* Transactions failed fast, device absent */
+    uint64_t transient_failures; /* Transactions failed after exhausting
+        retries */
+    uint64_t fatal_failures; /* Transactions failed with non retriable
+        error */
+} sdi_i2c_retry_stats_t;
+
+/**
+ * Counters of i2c-dev client setup ioctls (slave address, PEC) of an i2c bus.
+ * i2c-dev keeps both per file descriptor, so they are only set when they
+ * differ from the previous transaction.
+ */
+typedef struct sdi_i2c_client_stats_ {
+    uint64_t slave_set; /* No. of I2C_SLAVE ioctls issued */
+    uint64_t slave_skipped; /* No. of I2C_SLAVE ioctls avoided */
+    uint64_t pec_set; /* No. of I2C_PEC ioctls issued */
+    uint64_t pec_skipped; /* No. of I2C_PEC ioctls avoided */
+} sdi_i2c_client_stats_t;
+
+/**
+ * Counters of the kernel i2c adapter index, shared by all kernel driven i2c
+ * buses
+ */
+typedef struct sdi_i2c_adapter_index_stats_ {
+    uint_t adapters; /* No. of adapters indexed */
+    uint_t scans; /* No. of scans of sysfs i2c-dev class */
+    uint_t skipped; /* No. of adapters skipped by a scan, name not readable */
+    uint64_t discovery_ns; /* Time spent scanning sysfs */
+    uint64_t wait_ns; /* Time spent waiting for adapters to appear */
+} sdi_i2c_adapter_index_stats_t;
+
 /**
  * SDI I2C BUS Object for Kernel driver I2C Bus
  */
 typedef struct sdi_sys_i2c_bus_ {
     sdi_i2c_bus_t bus; /* Common SDI I2C Bus Object used as bus handle */
-    std_mutex_type_t lock; /* Mutex for bus lock  */
+    sdi_i2c_arb_t lock; /* Priority aware bus lock */
     char kernel_i2cdev_name[PATH_MAX]; /* Kernel /dev/i2cN interface backed by
         this I2C Bus */
     int i2cdev_fd; /* File descriptor opened on Kernel /dev/i2cN device file */
@@ -68,6 +207,139 @@ typedef struct sdi_sys_i2c_bus_ {
         Bus */
     sdi_i2c_bus_capability_t capability; /* Funcionality supported by the i2c
         bus. Data type is unsigned long as expected by ioctl call */
+    sdi_i2c_dev_policy_t policy; /* Default settle time and retry policy of
+        this bus */
+    sdi_i2c_dev_policy_t *dev_policy[SDI_I2C_MAX_SLAVE_ADDR]; /* Settle time
+        and retry policy of i2c slaves, indexed by slave address. NULL when
+        the slave uses the bus default policy */
+    uint64_t write_ns[SDI_I2C_MAX_SLAVE_ADDR]; /* Completion time of the
+        last write to a slave, indexed by slave address. 0 when none */
+    const void *write_segment[SDI_I2C_MAX_SLAVE_ADDR]; /* Bus segment of the
+        last write to a slave, indexed by slave address */
+    const void *cur_segment; /* Bus segment (ex: mux channel) of the
+        transaction in progress, NULL for the bus itself */
+    const sdi_i2c_dev_policy_t *cur_policy; /* Policy of the slave addressed
+        by the transaction in progress */
+    sdi_i2c_addr_t cur_address; /* Slave addressed by the transaction in
+        progress */
+    sdi_i2c_retry_stats_t retry_stats; /* Retry counters, updated with bus
+        acquired */
+    sdi_i2c_stats_t *stats; /* Transaction telemetry of this bus */
+    uint_t adapter_wait_ms; /* Max wait for the kernel i2c adapter to
+        appear */
+    bool client_valid; /* client_address and client_pec are programmed on
+        i2cdev_fd */
+    sdi_i2c_addr_t client_address; /* Slave address programmed on
+        i2cdev_fd */
+    bool client_pec; /* PEC mode programmed on i2cdev_fd */
+    sdi_i2c_client_stats_t client_stats; /* Client setup ioctl counters,
+        updated with bus acquired */
 } sdi_sys_i2c_bus_t;
 
+/**
+ * @brief sdi_sys_i2c_device_policy_init
+ * Initialize an i2c slave policy with default settle time and retry policy
+ * @param[out] policy - policy to be initialized
+ * @return none
+ */
+void sdi_sys_i2c_device_policy_init(sdi_i2c_dev_policy_t *policy);
+
+/**
+ * @brief sdi_sys_i2c_device_policy_parse
+ * Parse settle time and retry policy attributes of an i2c slave device node
+ * @param[in] node - i2c slave device config node
+ * @param[out] policy - filled with parsed policy, attributes not present in
+ * node are left unmodified
+ * @return true if node has any policy attribute, false otherwise
+ */
+bool sdi_sys_i2c_device_policy_parse(std_config_node_t node,
+                                     sdi_i2c_dev_policy_t *policy);
+
+/**
+ * @brief sdi_sys_i2c_device_policy_merge
+ * Merge two policies of the same i2c slave, the larger of both settle
+ * times and retry budgets is retained
+ * @param[inout] policy - policy to be updated
+ * @param[in] other - policy merged in to policy
+ * @return none
+ */
+void sdi_sys_i2c_device_policy_merge(sdi_i2c_dev_policy_t *policy,
+                                     const sdi_i2c_dev_policy_t *other);
+
+/**
+ * @brief sdi_sys_i2c_retry_stats_get
+ * Get the retry counters of a kernel driven i2c bus
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[out] stats - retry counters
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a kernel driven i2c bus
+ */
+t_std_error sdi_sys_i2c_retry_stats_get(sdi_i2c_bus_hdl_t i2c_bus,
+                                        sdi_i2c_retry_stats_t *stats);
+
+/**
+ * @brief sdi_sys_i2c_client_stats_get
+ * Get the client setup ioctl counters of a kernel driven i2c bus
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[out] stats - client setup ioctl counters
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a kernel driven i2c bus
+ */
+t_std_error sdi_sys_i2c_client_stats_get(sdi_i2c_bus_hdl_t i2c_bus,
+                                         sdi_i2c_client_stats_t *stats);
+
+/**
+ * @brief sdi_sys_i2c_bus_policy_get
+ * Get the default settle time and retry policy of a kernel driven i2c bus.
+ * Used by drivers (ex: i2c mux) to seed the policy of slaves multiplexed on
+ * to a kernel driven i2c bus.
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[out] policy - default policy of the bus
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a kernel driven i2c bus
+ */
+t_std_error sdi_sys_i2c_bus_policy_get(sdi_i2c_bus_hdl_t i2c_bus,
+                                       sdi_i2c_dev_policy_t *policy);
+
+/**
+ * @brief sdi_sys_i2c_device_policy_set
+ * Set the settle time and retry policy of an i2c slave attached to a kernel
+ * driven i2c bus. Used by drivers (ex: i2c mux) exporting i2c buses
+ * multiplexed on to a kernel driven i2c bus. When the slave already has a
+ * policy, the larger of both settle times and retry budgets is retained.
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[in] address - i2c slave address
+ * @param[in] policy - settle time and retry policy for the slave
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a kernel driven i2c bus, SDI_DEVICE_ERR_PARAM on invalid address
+ */
+t_std_error sdi_sys_i2c_device_policy_set(sdi_i2c_bus_hdl_t i2c_bus,
+                                          sdi_i2c_addr_t address,
+                                          const sdi_i2c_dev_policy_t *policy);
+
+/**
+ * @brief sdi_sys_i2c_segment_set
+ * Set the bus segment the slaves addressed on a kernel driven i2c bus sit on,
+ * until set again. Slaves of different segments share their addresses on the
+ * bus, write cycle of a slave is tracked per segment. Used by drivers (ex:
+ * i2c mux) exporting i2c buses multiplexed on to a kernel driven i2c bus,
+ * with the bus acquired.
+ * @param[in] i2c_bus - i2c bus handle
+ * @param[in] segment - bus segment, ex: mux channel bus handle, NULL for the
+ * bus itself
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a kernel driven i2c bus
+ */
+t_std_error sdi_sys_i2c_segment_set(sdi_i2c_bus_hdl_t i2c_bus,
+                                    const void *segment);
+
+/**
+ * @brief sdi_sys_i2c_adapter_index_stats_get
+ * Get the counters of the kernel i2c adapter index used to find /dev/i2c-N
+ * of kernel driven i2c buses
+ * @param[out] stats - adapter index counters
+ * @return none
+ */
+void sdi_sys_i2c_adapter_index_stats_get(sdi_i2c_adapter_index_stats_t *stats);
+
 #endif /* __SDI_I2CDEV_H___ */
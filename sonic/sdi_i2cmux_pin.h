@@ -52,6 +52,21 @@
 
 #include "sdi_i2c.h"
 #include "sdi_pin_group.h"
+#include "sdi_i2cdev.h"
+#include "sdi_i2c_stats.h"
+#include "sdi_i2c_arb.h"
+
+/**
+ * @struct sdi_i2cmux_select_stats_t
+ * @brief channel selection counters of an i2c mux
+ */
+typedef struct sdi_i2cmux_select_stats_ {
+    uint64_t writes; /**< no. of channel selections written to pin group */
+    uint64_t skipped; /**< no. of channel selections skipped, channel already
+                           selected */
+    uint64_t invalidations; /**< no. of times the selected channel became
+                                 unknown */
+} sdi_i2cmux_select_stats_t;
 
 /**
  * @struct sdi_i2cmux_pin_t
@@ -67,8 +82,19 @@ typedef struct sdi_i2cmux_pin_ {
     char pingroup_bus_name[SDI_MAX_NAME_LEN]; /**< pin group bus name */
     sdi_i2c_bus_hdl_t i2cbus_hdl; /**< parent i2c bus handle */
     char i2c_bus_name[SDI_MAX_NAME_LEN]; /**< parent i2c bus name */
-    std_mutex_type_t mux_lock; /**< lock to synchronize accessing i2c mux */
+    sdi_i2c_arb_t mux_lock; /**< priority aware lock to synchronize
+                                accessing i2c mux */
     sdi_bus_list_t channel_list; /**< list to maintain i2c mux channel */
+    bool stats_shm; /**< keep telemetry of mux channels in shared memory */
+    sdi_i2c_dev_policy_t *dev_policy[SDI_I2C_MAX_SLAVE_ADDR]; /**< settle
+                            time policy of slaves on all mux channels, applied
+                            on parent i2c bus during init */
+    bool select_cache; /**< skip selecting the channel already selected */
+    bool cur_channel_valid; /**< cur_channel is selected on the mux,
+                                 protected by mux_lock */
+    uint_t cur_channel; /**< channel selected on the mux */
+    sdi_i2cmux_select_stats_t select_stats; /**< channel selection counters,
+                                                 protected by mux_lock */
 } sdi_i2cmux_pin_t;
 
 /**
@@ -91,6 +117,7 @@ typedef struct sdi_i2cmuxchan_bus_ {
     uint_t i2c_mux_channel; /**< channel number used to select this i2c mux channel */
     sdi_i2cmux_pin_t *i2c_mux; /**< reference to i2c mux pin device to access i2c
                                 bus handle and pin group bus handle */
+    sdi_i2c_stats_t *stats; /**< transaction telemetry of this mux channel */
 } sdi_i2cmux_pin_chan_bus_t;
 
 /**
@@ -99,4 +126,34 @@ typedef struct sdi_i2cmuxchan_bus_ {
  */
 typedef sdi_i2cmux_pin_chan_bus_t *sdi_i2cmux_pin_chan_bus_handle_t;
 
+/**
+ * @brief sdi_i2cmux_pin_chan_mux_get
+ * Get the mux of an i2c mux channel
+ * @param[in] i2c_bus - i2c bus handle
+ * @return mux of the channel, NULL when i2c_bus is not an i2c mux channel
+ */
+sdi_i2cmux_pin_hdl_t sdi_i2cmux_pin_chan_mux_get(sdi_i2c_bus_hdl_t i2c_bus);
+
+/**
+ * @brief sdi_i2cmux_pin_select_invalidate
+ * Forget the channel selected on the mux of an i2c mux channel, so that the
+ * next transaction selects its channel again. Used when the mux pins may
+ * have been changed by another agent (ex: mux reset).
+ * @param[in] i2c_bus - i2c mux channel bus handle
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not an i2c mux channel
+ */
+t_std_error sdi_i2cmux_pin_select_invalidate(sdi_i2c_bus_hdl_t i2c_bus);
+
+/**
+ * @brief sdi_i2cmux_pin_select_stats_get
+ * Get the channel selection counters of the mux of an i2c mux channel
+ * @param[in] i2c_bus - i2c mux channel bus handle
+ * @param[out] stats - channel selection counters
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not an i2c mux channel
+ */
+t_std_error sdi_i2cmux_pin_select_stats_get(sdi_i2c_bus_hdl_t i2c_bus,
+                                            sdi_i2cmux_select_stats_t *stats);
+
 #endif /* __SDI_I2CMUX_PIN_H__ */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_init_sched.h
+ */
+
+
+/******************************************************************************
+ * Defines the device tree init scheduler. The devices attached to a bus
+ * (and every mux, channel and device below them) form a subtree, which is
+ * initialized once the bus itself is initialized. By default subtrees are
+ * initialized in config order by the thread initializing the bus, as the
+ * bus framework does.
+ *
+ * init_mode attribute of a bus node selects how its subtree is initialized:
+ * - serial : in config order, the default
+ * - parallel : by a pool of init threads, overlapping with the subtrees of
+ *   other buses. Used on top level i2c buses (sys_i2c, sim_i2c): subtrees of
+ *   different i2c controllers share no wire.
+ * - deferred : on first use of the bus, for non-critical devices (ex: FRU
+ *   EEPROMs, LEDs on their own mux channel). Used on i2c buses and i2c mux
+ *   channels.
+ * parallel and deferred are honoured on i2c buses only, whose acquire path
+ * waits for the subtree (sdi_init_sched_bus_ready). On gpio, io and pseudo
+ * buses they are logged and the subtree is initialized in config order.
+ *
+ * A thread acquiring a bus whose subtree is not initialized yet waits for it
+ * (or initializes it, when not started yet), so users of the devices never
+ * see a partially initialized subtree. Init threads wait as well for subtrees
+ * initialized by other threads (ex: the subtree of the parent bus of a mux
+ * channel), but not for buses not initialized yet, which resolve as in config
+ * order. Platform init returns once the last bus following a parallel bus is
+ * initialized and init threads are done.
+ *
+ * Init threads only run device init callbacks concurrently. Buses and
+ * resources are registered by the driver *_register callbacks, which the
+ * framework runs serially before platform init starts, so device init only
+ * looks them up. A bus registered once init started keeps the serial mode.
+ *
+ * <sys_i2c instance="0" sysfs_name="SMBus I801 adapter" init_mode="parallel">
+ *   <i2cmux_channel ... init_mode="deferred">
+ *****************************************************************************/
+
+#ifndef __SDI_INIT_SCHED_H__
+#define __SDI_INIT_SCHED_H__
+
+#include "std_error_codes.h"
+#include "std_config_node.h"
+#include "sdi_bus.h"
+#include <stdint.h>
+
+/**
+ * Attribute used for representing the init mode of the subtree of a bus
+ */
+#define SDI_DEV_ATTR_INIT_MODE         "init_mode"
+
+/**
+ * Values of init_mode attribute
+ */
+#define SDI_INIT_MODE_STR_SERIAL       "serial"
+#define SDI_INIT_MODE_STR_PARALLEL     "parallel"
+#define SDI_INIT_MODE_STR_DEFERRED     "deferred"
+
+/**
+ * Max no. of init threads
+ */
+#define SDI_INIT_SCHED_MAX_THREADS     (4)
+
+/**
+ * @enum sdi_init_mode_t
+ * Init modes of the subtree of a bus
+ */
+typedef enum {
+    SDI_INIT_MODE_SERIAL,
+    SDI_INIT_MODE_PARALLEL,
+    SDI_INIT_MODE_DEFERRED,
+} sdi_init_mode_t;
+
+/**
+ * @struct sdi_init_sched_stats_t
+ * @brief init scheduler counters
+ */
+typedef struct sdi_init_sched_stats_ {
+    uint_t serial; /**< no. of subtrees initialized in config order */
+    uint_t parallel; /**< no. of subtrees given to init threads */
+    uint_t deferred; /**< no. of subtrees deferred to first use */
+    uint_t deferred_done; /**< no. of deferred subtrees initialized */
+    uint_t inline_done; /**< no. of parallel subtrees initialized by the
+        first thread using them, before an init thread got to them */
+    uint64_t ready_ns; /**< time from first subtree init until every serial
+        and parallel subtree is initialized, 0 while in progress */
+} sdi_init_sched_stats_t;
+
+/**
+ * @brief sdi_init_sched_register
+ * Register the init mode of a bus, from init_mode attribute of its node.
+ * Called by bus drivers on bus registration, before platform init starts.
+ * @param[in] bus - bus handle
+ * @param[in] node - bus config node
+ * @return none
+ */
+void sdi_init_sched_register(sdi_bus_hdl_t bus, std_config_node_t node);
+
+/**
+ * @brief sdi_init_sched_device_list
+ * Initialize the devices of a bus according to its init mode. Called by bus
+ * drivers at the end of bus init, instead of sdi_bus_init_device_list.
+ * @param[in] bus - bus handle
+ * @return none
+ */
+void sdi_init_sched_device_list(sdi_bus_hdl_t bus);
+
+/**
+ * @brief sdi_init_sched_bus_ready
+ * Wait for the devices of a bus to be initialized, initializing them when
+ * deferred or not started yet. Called by bus drivers before acquiring a bus.
+ * @param[in] bus - bus handle
+ * @return none
+ */
+void sdi_init_sched_bus_ready(sdi_bus_hdl_t bus);
+
+/**
+ * @brief sdi_init_sched_wait
+ * Wait for every subtree given to init threads to be initialized. Deferred
+ * subtrees are not waited for.
+ * @return none
+ */
+void sdi_init_sched_wait(void);
+
+/**
+ * @brief sdi_init_sched_framework_lock
+ * Serialize bus framework lookups of device init callbacks running on init
+ * threads (ex: sdi_i2cmux_pin_driver_init looking up its parent bus and pin
+ * group). Registrations don't need it, they all happen serially in driver
+ * *_register callbacks. Never held across a bus acquire.
+ * @return none
+ */
+void sdi_init_sched_framework_lock(void);
+
+/**
+ * @brief sdi_init_sched_framework_unlock
+ * Unlock the bus framework and resource registry
+ * @return none
+ */
+void sdi_init_sched_framework_unlock(void);
+
+/**
+ * @brief sdi_init_sched_stats_get
+ * Get the init scheduler counters
+ * @param[out] stats - init scheduler counters
+ * @return none
+ */
+void sdi_init_sched_stats_get(sdi_init_sched_stats_t *stats);
+
+#endif /* __SDI_INIT_SCHED_H__ */
@@ -70,6 +70,21 @@
  * status
  */
 #define SDI_MEDIA_MODULE_PRESENCE_BITMASK   "mod_pres_bitmask"
+/**
+ * @def Attribute used for representing pin group bus for module interrupt
+ * status
+ */
+#define SDI_MEDIA_MODULE_INTERRUPT_BUS      "mod_int_bus"
+/**
+ * @def Attribute used for representing bit number for getting module
+ * interrupt status
+ */
+#define SDI_MEDIA_MODULE_INTERRUPT_BITMASK  "mod_int_bitmask"
+/**
+ * @def Attribute used for representing gpio pin bus of the summary interrupt
+ * of module presence and interrupt status
+ */
+#define SDI_MEDIA_MODULE_EVENT_PIN          "mod_event_pin"
 /**
  * @def Attribute used for representing pin group bus for module reset
  */
@@ -91,6 +106,11 @@
  * @def Attribute used for representing delay after module selection
  */
 #define SDI_MEDIA_MODULE_SELECTION_DELAY_IN_MILLI_SECONDS    "mod_sel_delay"
+/**
+ * @def Attribute used for skipping module selection and its delay when the
+ * module is already selected, "no" to select and wait on every access
+ */
+#define SDI_MEDIA_MODULE_SELECTION_CACHE     "mod_sel_cache"
 /**
  * @def Attribute used for representing pin group bus for controlling
  * transmitter
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*
+ * filename: sdi_media_sel.h
+ */
+
+
+/******************************************************************************
+ * Defines the module selection cache of media (sfp/qsfp) drivers. Media
+ * modules sharing an i2c address are selected by writing their selection
+ * value (mod_sel_value, mux_sel_value) on a pin group bus shared by all of
+ * them. The cache of a pin group remembers the value last written on it, so
+ * that selecting the module already selected writes nothing and the media
+ * driver skips the settle delay (mod_sel_delay) of a selection change.
+ *
+ * Every media driver writing a selection pin group goes through its cache,
+ * with the pin group bus acquired. A failed write forgets the selection.
+ *****************************************************************************/
+
+#ifndef __SDI_MEDIA_SEL_H__
+#define __SDI_MEDIA_SEL_H__
+
+#include "std_error_codes.h"
+#include "sdi_pin_group.h"
+#include <stdbool.h>
+
+/**
+ * @struct sdi_media_sel_stats_t
+ * @brief selection counters of a pin group
+ */
+typedef struct sdi_media_sel_stats_ {
+    uint_t writes; /**< no. of selection values written */
+    uint_t skipped; /**< no. of selections of the value already written */
+    uint_t invalidations; /**< no. of selections forgotten on write failure
+                               or module transition */
+} sdi_media_sel_stats_t;
+
+/**
+ * @struct sdi_media_sel_t
+ * @brief selection cache of a pin group, protected by the pin group bus
+ */
+typedef struct sdi_media_sel_ {
+    sdi_pin_group_bus_hdl_t hdl; /**< selection pin group bus */
+    bool valid; /**< value is written on the pin group */
+    uint_t value; /**< value last written on the pin group */
+    sdi_media_sel_stats_t stats; /**< selection counters */
+    struct sdi_media_sel_ *next; /**< next pin group */
+} sdi_media_sel_t;
+
+/**
+ * @brief sdi_media_sel_get
+ * Get the selection cache of a pin group, created on first use. Called by
+ * media drivers on device registration.
+ * @param[in] hdl - selection pin group bus
+ * @return selection cache of the pin group
+ */
+sdi_media_sel_t *sdi_media_sel_get(sdi_pin_group_bus_hdl_t hdl);
+
+/**
+ * @brief sdi_media_sel_write
+ * Write a selection value on a pin group, unless already written. Called with
+ * the pin group bus acquired.
+ * @param[in] sel - selection cache of the pin group
+ * @param[in] value - selection value
+ * @param[in] cache - skip writing the value already written
+ * @param[out] changed - set to true when the value got written, left as is
+ * otherwise
+ * @return STD_ERR_OK on success, error of pin group write otherwise
+ */
+t_std_error sdi_media_sel_write(sdi_media_sel_t *sel, uint_t value, bool cache,
+                                bool *changed);
+
+/**
+ * @brief sdi_media_sel_invalidate
+ * Forget the value written on a pin group, the next selection writes it and
+ * waits for the module again. Called on module reset, low power mode and
+ * presence transitions, the module has to settle again on selection.
+ * @param[in] sel - selection cache of the pin group
+ * @return STD_ERR_OK on success, error of pin group bus acquire otherwise
+ */
+t_std_error sdi_media_sel_invalidate(sdi_media_sel_t *sel);
+
+/**
+ * @brief sdi_media_sel_stats_get
+ * Get the selection counters of a pin group
+ * @param[in] hdl - selection pin group bus
+ * @param[out] stats - selection counters
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOENT) when no media
+ * driver selects on the pin group
+ */
+t_std_error sdi_media_sel_stats_get(sdi_pin_group_bus_hdl_t hdl,
+                                    sdi_media_sel_stats_t *stats);
+
+#endif /* __SDI_MEDIA_SEL_H__ */
@@ -43,6 +43,16 @@
  * @def Attribute used for representing the pin group
  */
 #define SDI_DEV_ATTR_PIN_GROUP             "pingroup"
+/**
+ * @def Attribute used for representing the gpio chip of the pin or pin group,
+ * accessed via its character device /dev/<gpio_chip>
+ */
+#define SDI_DEV_ATTR_GPIO_CHIP             "gpio_chip"
+/**
+ * @def Attribute used for enabling verification of the in-memory shadow of a
+ * sysfs gpio pin or pin group against sysfs, "yes" to enable (debug)
+ */
+#define SDI_DEV_ATTR_GPIO_SHADOW_VERIFY    "shadow_verify"
 /**
  * @def Attribute used for representing the pin direction
  */
@@ -28,6 +28,7 @@
 #define __SDI_QSFP_H_
 #include "sdi_resource_internal.h"
 #include "sdi_media.h"
+#include "sdi_media_sel.h"
 
 /**
  * @struct qsfp_device_t
@@ -52,6 +53,13 @@ typedef struct qsfp_device {
                                               group bus handler*/
     uint_t mod_lpmode_bitmask; /**<qsfp devie lpmode bitmask*/
     uint_t delay; /**<delay in milli seconds*/
+    sdi_media_sel_t *mux_sel; /**<selection cache of mux_sel_hdl, NULL if no
+                                mux selection*/
+    sdi_media_sel_t *mod_sel; /**<selection cache of mod_sel_hdl*/
+    bool mod_sel_cache; /**<skip selection and delay when module is already
+                          selected*/
+    bool pres_valid; /**<pres holds the presence last read*/
+    bool pres; /**<presence last read, ports not watched for events only*/
 } qsfp_device_t;
 
 /**
@@ -228,6 +236,15 @@ t_std_error sdi_qsfp_channel_monitor_get (sdi_resource_hdl_t resource_hdl, uint_
 t_std_error sdi_qsfp_feature_support_status_get (sdi_resource_hdl_t resource_hdl,
                                                  sdi_media_supported_feature_t *feature_support);
 
+/**
+ * @brief Forget the module selection of a qsfp, so that the module is
+ * selected and waited for again on next access. Called on module reset, low
+ * power mode and presence transitions.
+ * @param[in] resource_hdl - handle to the qsfp
+ * @return - standard @ref t_std_error
+ */
+t_std_error sdi_qsfp_module_sel_invalidate(sdi_resource_hdl_t resource_hdl);
+
 /**
  * @brief raw read from qsfp eeprom
  * @param[in] resource_hdl - handle to the qsfp
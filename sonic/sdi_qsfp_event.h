@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*
+ * filename: sdi_qsfp_event.h
+ */
+
+
+/******************************************************************************
+ * Defines the QSFP presence and fault change notification. Ports sharing a
+ * summary interrupt (a gpio pin asserted by the CPLD when any presence or
+ * interrupt bit below it changes) are watched by one thread, which is woken
+ * up on edges of the pin by the gpio event dispatcher (see sdi_gpio_event.h)
+ * and reads the presence and interrupt pin groups of its ports only when the
+ * summary interrupt fires, or on a periodic resync. Changes are
+ * delivered per port to the registered callback as insert, remove and fault
+ * events, and the presence seen by the watcher is served to
+ * sdi_qsfp_presence_get without touching the bus.
+ *
+ * Ports are watched when their qsfp node names the summary interrupt pin:
+ * <qsfp instance="1" ... mod_pres_bus="qsfp_presence1" mod_pres_bitmask="0x1"
+ *       mod_int_bus="qsfp_interrupt1" mod_int_bitmask="0x1"
+ *       mod_event_pin="qsfp_int_summary1" />
+ * - mod_int_bus, mod_int_bitmask : interrupt pin group and bit of the port,
+ *   optional, fault events are reported when given
+ * - mod_event_pin : gpio pin bus of the summary interrupt
+ *
+ * Watcher threads are started on callback registration, or on first
+ * presence query of one of their ports.
+ *****************************************************************************/
+
+#ifndef __SDI_QSFP_EVENT_H__
+#define __SDI_QSFP_EVENT_H__
+
+#include "std_error_codes.h"
+#include "sdi_resource_internal.h"
+#include "sdi_pin_group.h"
+#include <stdbool.h>
+
+/**
+ * Period in milli seconds of the resync of a watcher whose summary interrupt
+ * is armed, covers edges lost by the gpio controller
+ */
+#define SDI_QSFP_EVENT_RESYNC_MS       (10000)
+
+/**
+ * Period in milli seconds of the scan of a watcher whose summary interrupt
+ * can't be armed
+ */
+#define SDI_QSFP_EVENT_POLL_MS         (1000)
+
+/**
+ * @enum sdi_qsfp_event_t
+ * Per port events
+ */
+typedef enum {
+    SDI_QSFP_EVENT_INSERT, /**< module inserted */
+    SDI_QSFP_EVENT_REMOVE, /**< module removed */
+    SDI_QSFP_EVENT_FAULT, /**< interrupt of present module asserted */
+} sdi_qsfp_event_t;
+
+/**
+ * @typedef sdi_qsfp_event_callback_t
+ * Event callback, called from the watcher thread of the port
+ * @param[in] resource_hdl - handle of the qsfp resource
+ * @param[in] event - event of the port
+ * @param[in] data - data given at callback registration
+ * @return none
+ */
+typedef void (*sdi_qsfp_event_callback_t)(sdi_resource_hdl_t resource_hdl,
+                                          sdi_qsfp_event_t event, void *data);
+
+/**
+ * @struct sdi_qsfp_event_stats_t
+ * @brief counters of every watcher
+ */
+typedef struct sdi_qsfp_event_stats_ {
+    uint_t watchers; /**< no. of watcher threads running */
+    uint_t armed; /**< no. of watchers sleeping on their summary interrupt */
+    uint_t wakeups; /**< no. of summary interrupts */
+    uint_t resyncs; /**< no. of scans on timeout */
+    uint_t group_reads; /**< no. of pin group reads */
+    uint_t read_errors; /**< no. of failed pin group reads */
+    uint_t inserts; /**< no. of insert events */
+    uint_t removes; /**< no. of remove events */
+    uint_t faults; /**< no. of fault events */
+    uint_t cached_presence; /**< no. of presence queries served by watchers */
+} sdi_qsfp_event_stats_t;
+
+/**
+ * @brief sdi_qsfp_event_port_add
+ * Watch a qsfp port. Called by qsfp driver on device registration.
+ * @param[in] resource_hdl - handle of the qsfp resource
+ * @param[in] event_pin - name of gpio pin bus of the summary interrupt
+ * @param[in] pres_hdl - presence pin group of the port
+ * @param[in] pres_bit - presence bit number of the port
+ * @param[in] int_hdl - interrupt pin group of the port, can be NULL
+ * @param[in] int_bit - interrupt bit number of the port
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOENT) when event_pin is
+ * not a registered pin bus
+ */
+t_std_error sdi_qsfp_event_port_add(sdi_resource_hdl_t resource_hdl,
+                                    const char *event_pin,
+                                    sdi_pin_group_bus_hdl_t pres_hdl,
+                                    uint_t pres_bit,
+                                    sdi_pin_group_bus_hdl_t int_hdl,
+                                    uint_t int_bit);
+
+/**
+ * @brief sdi_qsfp_event_register
+ * Register the event callback, replacing the previous one, and start the
+ * watchers. Events are reported for changes after the first scan of a
+ * watcher, current presence is read with sdi_qsfp_presence_get.
+ * @param[in] callback - event callback, NULL to stop reporting events
+ * @param[in] data - passed to callback
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE of pthread error when a
+ * watcher thread can't be started
+ */
+t_std_error sdi_qsfp_event_register(sdi_qsfp_event_callback_t callback,
+                                    void *data);
+
+/**
+ * @brief sdi_qsfp_event_presence_get
+ * Get the presence of a watched port as last seen by its watcher
+ * @param[in] resource_hdl - handle of the qsfp resource
+ * @param[out] pres - presence status
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when the port
+ * is not watched or its watcher is not armed on the summary interrupt yet
+ */
+t_std_error sdi_qsfp_event_presence_get(sdi_resource_hdl_t resource_hdl,
+                                        bool *pres);
+
+/**
+ * @brief sdi_qsfp_event_stats_get
+ * Get the counters of every watcher
+ * @param[out] stats - watcher counters
+ * @return none
+ */
+void sdi_qsfp_event_stats_get(sdi_qsfp_event_stats_t *stats);
+
+#endif /* __SDI_QSFP_EVENT_H__ */
@@ -30,6 +30,7 @@
 #include "sdi_media.h"
 #include "sdi_resource_internal.h"
 #include "sdi_pin_group.h"
+#include "sdi_media_sel.h"
 
 #define SDI_SFP_CHANNEL_NUM 0
 
@@ -55,6 +56,8 @@ typedef struct sfp_device {
     sdi_pin_group_bus_hdl_t mod_sel_hdl;
     /** value needs to be written on pin group bus for selecting module */
     uint_t mod_sel_value;
+    /** selection cache of mod_sel_hdl, NULL if module always enabled */
+    sdi_media_sel_t *mod_sel;
     /** sfp device module presence pin group bus handler */
     sdi_pin_group_bus_hdl_t mod_pres_hdl;
     /** sfp devie presence bit mask */
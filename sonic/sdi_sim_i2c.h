@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_sim_i2c.h
+ */
+
+
+/******************************************************************************
+ * Defines Data Structures for SDI simulated I2C Bus driver. Every i2c slave
+ * on a simulated bus is an in-memory register file loaded from a register
+ * map file, so that device drivers can be exercised without hardware.
+ *****************************************************************************/
+
+#ifndef __SDI_SIM_I2C_H__
+#define __SDI_SIM_I2C_H__
+
+#include "sdi_i2c.h"
+#include "sdi_i2cdev.h"
+#include "sdi_i2c_stats.h"
+#include "sdi_i2c_arb.h"
+#include <stdbool.h>
+
+/**
+ * Attribute used for representing the register map file of a simulated i2c
+ * slave, on i2c slave device nodes
+ */
+#define SDI_DEV_ATTR_SIM_REGMAP        "sim_regmap"
+
+/**
+ * Attributes used for representing a second address of a simulated i2c
+ * slave and its register map file, on i2c slave device nodes. Used for
+ * devices answering on two addresses (ex: SFP A0h/A2h).
+ */
+#define SDI_DEV_ATTR_SIM_AUX_ADDRESS   "sim_aux_addr"
+#define SDI_DEV_ATTR_SIM_AUX_REGMAP    "sim_aux_regmap"
+
+/**
+ * Attribute used for representing the directory of register map files, on
+ * sim_i2c node. Relative sim_regmap paths are resolved against it.
+ */
+#define SDI_DEV_ATTR_SIM_REGMAP_DIR    "sim_regmap_dir"
+
+/**
+ * Environment variable overriding sim_regmap_dir of every simulated bus, to
+ * run a simulated platform from a source tree (ex: make benchmark)
+ */
+#define SDI_SIM_I2C_REGMAP_DIR_ENV     "SDI_SIM_REGMAP_DIR"
+
+/**
+ * Attribute used for representing the latency in micro seconds injected in
+ * every transaction. Valid on sim_i2c node (all slaves) and on i2c slave
+ * device nodes.
+ */
+#define SDI_DEV_ATTR_SIM_LATENCY       "sim_latency_us"
+
+/**
+ * Attribute used for injecting a failure in every Nth transaction. 0 disables
+ * error injection.
+ */
+#define SDI_DEV_ATTR_SIM_ERROR_EVERY   "sim_error_every"
+
+/**
+ * Attribute used for representing the errno of injected failures, EIO if not
+ * specified
+ */
+#define SDI_DEV_ATTR_SIM_ERROR_ERRNO   "sim_error_errno"
+
+/**
+ * Size of a page of paged upper memory (SFF-8436/SFF-8636/SFF-8472)
+ */
+#define SDI_SIM_I2C_PAGE_SIZE          (128)
+
+/**
+ * Max no. of pages of paged upper memory
+ */
+#define SDI_SIM_I2C_MAX_PAGES          (256)
+
+/**
+ * No. of registers/commands of a slave with 8bit offset
+ */
+#define SDI_SIM_I2C_MAX_REGS           (256)
+
+/**
+ * Slave address used to address every slave of a simulated bus
+ */
+#define SDI_SIM_I2C_ALL_SLAVES         (0xffff)
+
+/**
+ * @enum sdi_sim_i2c_width_t
+ * Register file layout of a simulated i2c slave
+ */
+typedef enum {
+    SDI_SIM_I2C_WIDTH_BYTE, /* 8bit offset, byte registers with auto
+        increment (sensors, fan controllers, SFP/QSFP, 24C02 eeprom) */
+    SDI_SIM_I2C_WIDTH_WORD, /* 8bit offset, 16bit registers/commands
+        (TMP75, PMBus) */
+    SDI_SIM_I2C_WIDTH_ADDR16, /* 16bit offset, byte memory with auto
+        increment (24C32 and larger eeprom) */
+} sdi_sim_i2c_width_t;
+
+/**
+ * @struct sdi_sim_i2c_fault_t
+ * Latency and error injection of a simulated bus or slave
+ */
+typedef struct sdi_sim_i2c_fault_ {
+    uint_t latency_us; /* latency added to every transaction */
+    uint_t error_every; /* fail every Nth transaction, 0 to disable */
+    int error_errno; /* errno of injected failure */
+    uint64_t count; /* no. of transactions so far */
+} sdi_sim_i2c_fault_t;
+
+/**
+ * @struct sdi_sim_i2c_block_t
+ * SMBus block returned for a command (ex: PMBus MFR_ID)
+ */
+typedef struct sdi_sim_i2c_block_ {
+    uint8_t len; /* no. of bytes in block */
+    uint8_t data[I2C_SMBUS_BLOCK_MAX]; /* block data */
+} sdi_sim_i2c_block_t;
+
+/**
+ * @struct sdi_sim_i2c_slave_t
+ * Register file of a simulated i2c slave
+ */
+typedef struct sdi_sim_i2c_slave_ {
+    sdi_sim_i2c_width_t width; /* register file layout */
+    uint8_t *mem; /* byte memory, byte and addr16 layouts */
+    size_t size; /* size of byte memory */
+    uint16_t regs[SDI_SIM_I2C_MAX_REGS]; /* 16bit registers, word layout */
+    int page_select; /* offset of page select register, -1 if not paged */
+    uint8_t *pages[SDI_SIM_I2C_MAX_PAGES]; /* paged upper memory, NULL when
+        page is not populated */
+    uint_t cur_page; /* selected page */
+    sdi_sim_i2c_block_t *blocks[SDI_SIM_I2C_MAX_REGS]; /* smbus block
+        responses per command */
+    uint_t pointer; /* current address pointer */
+    bool has_fault; /* slave specific fault injection configured */
+    sdi_sim_i2c_fault_t fault; /* slave specific fault injection */
+} sdi_sim_i2c_slave_t;
+
+/**
+ * SDI I2C BUS Object for simulated I2C Bus
+ */
+typedef struct sdi_sim_i2c_bus_ {
+    sdi_i2c_bus_t bus; /* Common SDI I2C Bus Object used as bus handle */
+    sdi_i2c_arb_t lock; /* Priority aware bus lock */
+    sdi_sim_i2c_fault_t fault; /* Fault injection for all slaves */
+    sdi_sim_i2c_slave_t *slave[SDI_I2C_MAX_SLAVE_ADDR]; /* Simulated slaves,
+        NULL when no slave is present at address */
+    sdi_i2c_stats_t *stats; /* Transaction telemetry of this bus */
+    char *regmap_dir; /* Register map directory, NULL if not configured */
+} sdi_sim_i2c_bus_t;
+
+/**
+ * @brief sdi_sim_i2c_bus_is_sim
+ * Check whether an i2c bus is a simulated bus
+ * @param[in] i2c_bus - i2c bus handle
+ * @return true for a sim_i2c bus, false otherwise
+ */
+bool sdi_sim_i2c_bus_is_sim(sdi_i2c_bus_hdl_t i2c_bus);
+
+/**
+ * @brief sdi_sim_i2c_regmap_load
+ * Load the register map file of a simulated i2c slave, replacing the slave
+ * if already present.
+ * Register map file format, one directive per line, '#' starts a comment:
+ *   width byte|word|addr16 : register file layout, byte if not specified
+ *   size <n>              : byte memory size, 256 if not specified
+ *   page_select <offset>  : offset of page select register, upper 128 bytes
+ *                           are paged (SFF-8436 uses 127)
+ *   page <n>              : following data lines fill upper memory of page n
+ *   <offset>: <v> <v> ..  : bytes (words in word layout) from offset
+ *   block <cmd>: <v> <v> ..  : smbus block returned for command
+ * Values are in C notation (0x.. for hex). Word values are as returned by
+ * smbus read word.
+ * @param[in] i2c_bus - simulated i2c bus handle
+ * @param[in] address - i2c slave address
+ * @param[in] path - register map file
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a simulated bus, SDI_DEVICE_ERRNO on file errors,
+ * SDI_DEVICE_ERR_PARAM on invalid address or file contents
+ */
+t_std_error sdi_sim_i2c_regmap_load(sdi_i2c_bus_hdl_t i2c_bus,
+                                    sdi_i2c_addr_t address, const char *path);
+
+/**
+ * @brief sdi_sim_i2c_slaves_load
+ * Load the register maps of the i2c slaves configured under a config node
+ * (sim_regmap attributes) on a simulated bus. Used by i2c muxes attached to
+ * a simulated bus: channel gating is not simulated, the slaves of every
+ * channel answer on the parent bus, hence need distinct addresses.
+ * @param[in] i2c_bus - simulated i2c bus handle
+ * @param[in] node - config node of the slaves, ex: i2c mux channel node
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a simulated bus
+ */
+t_std_error sdi_sim_i2c_slaves_load(sdi_i2c_bus_hdl_t i2c_bus,
+                                    std_config_node_t node);
+
+/**
+ * @brief sdi_sim_i2c_fault_set
+ * Set latency and error injection of a simulated bus or slave
+ * @param[in] i2c_bus - simulated i2c bus handle
+ * @param[in] address - i2c slave address, SDI_SIM_I2C_ALL_SLAVES for bus
+ * @param[in] latency_us - latency added to every transaction
+ * @param[in] error_every - fail every Nth transaction, 0 to disable
+ * @param[in] error_errno - errno of injected failure
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a simulated bus, SDI_DEVICE_ERR_PARAM when slave is not present
+ */
+t_std_error sdi_sim_i2c_fault_set(sdi_i2c_bus_hdl_t i2c_bus, uint_t address,
+                                  uint_t latency_us, uint_t error_every,
+                                  int error_errno);
+
+/**
+ * @brief sdi_sim_i2c_poke
+ * Write bytes in to the register file of a simulated slave, bypassing the
+ * bus (ex: to change a sensor reading). Offset is a byte offset in byte and
+ * addr16 layouts, a register in word layout with one word per 2 bytes.
+ * @param[in] i2c_bus - simulated i2c bus handle
+ * @param[in] address - i2c slave address
+ * @param[in] offset - offset in register file
+ * @param[in] buf - data
+ * @param[in] len - no. of bytes
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a simulated bus, SDI_DEVICE_ERR_PARAM when slave is not present
+ */
+t_std_error sdi_sim_i2c_poke(sdi_i2c_bus_hdl_t i2c_bus, sdi_i2c_addr_t address,
+                             uint_t offset, const uint8_t *buf, size_t len);
+
+#endif /* __SDI_SIM_I2C_H__ */
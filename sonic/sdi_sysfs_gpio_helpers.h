@@ -29,6 +29,30 @@
 
 #include "sdi_gpio.h"
 
+/**
+ * Max time for /sys/class/gpio/gpio<num> of an exported gpio pin to show up,
+ * in milli seconds
+ */
+#define SDI_GPIO_EXPORT_TIMEOUT_MS      (1000)
+
+/**
+ * Interval of checking for /sys/class/gpio/gpio<num> of exported gpio pins
+ * between inotify events, in milli seconds
+ */
+#define SDI_GPIO_EXPORT_RECHECK_MS      (10)
+
+/**
+ * @struct sdi_sysfs_gpio_export_stats_t
+ * @brief gpio export counters
+ */
+typedef struct sdi_sysfs_gpio_export_stats_ {
+    uint_t passes; /**< no. of export passes */
+    uint_t exported; /**< no. of gpio pins exported */
+    uint_t timeouts; /**< no. of gpio pins not showing up in time */
+    uint64_t export_ns_total; /**< sum of export time of exported pins */
+    uint64_t export_ns_max; /**< max export time of a pin */
+} sdi_sysfs_gpio_export_stats_t;
+
 /**
  * @brief sdi_gpio_is_exported
  * Verify whether the given gpio pin is already exported by checking for
@@ -47,14 +71,48 @@ bool sdi_gpio_is_exported(uint_t gpio_no);
  */
 t_std_error sdi_sysfs_gpio_export(uint_t gpio_no);
 
+/**
+ * @brief sdi_sysfs_gpio_export_queue
+ * Queue a gpio pin for export. Queued pins are exported at once, by the
+ * first sdi_export_gpio call following their registration.
+ * @param[in] gpio_no - gpio number
+ * @return none
+ */
+void sdi_sysfs_gpio_export_queue(uint_t gpio_no);
+
 /**
  * @brief sdi_export_gpio
- * Export a gpio pin if not already exported.
+ * Export a gpio pin if not already exported. Every gpio pin queued for export
+ * is exported along in one pass, through one export file descriptor, and the
+ * pass waits for /sys/class/gpio/gpio<num> of all of them to show up. Pins
+ * of another thread's pass in progress are waited for, not exported again.
+ * A pin whose export failed or timed out is exported again on next call.
  * @param[in] gpio_no - gpio number
- * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ETIMEDOUT) when the pin doesn't show up within
+ * SDI_GPIO_EXPORT_TIMEOUT_MS
  */
 t_std_error sdi_export_gpio(uint_t gpio_no);
 
+/**
+ * @brief sdi_sysfs_gpio_export_time_get
+ * Get the time a gpio pin took to show up once exported
+ * @param[in] gpio_no - gpio number
+ * @param[out] export_ns - time from start of its export pass until
+ * /sys/class/gpio/gpio<num> showed up, 0 when it was already exported
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOENT) when the pin was
+ * not exported by this driver, export status when export failed
+ */
+t_std_error sdi_sysfs_gpio_export_time_get(uint_t gpio_no, uint64_t *export_ns);
+
+/**
+ * @brief sdi_sysfs_gpio_export_stats_get
+ * Get the gpio export counters
+ * @param[out] stats - gpio export counters
+ * @return none
+ */
+void sdi_sysfs_gpio_export_stats_get(sdi_sysfs_gpio_export_stats_t *stats);
+
 /**
  * @brief sdi_gpio_file_table_init
  * Initialize file table with file pointers for gpio sysfs direction, polarity
@@ -108,4 +166,14 @@ t_std_error sdi_sysfs_gpio_direction_read(int gpio_file_fd,
 t_std_error sdi_sysfs_gpio_direction_write(int gpio_file_fd,
                                           sdi_pin_bus_direction_t direction);
 
+/**
+ * @brief sdi_sysfs_gpio_edge_write
+ * Write edges reported as events to sysfs gpio edge file
+ * /sys/class/gpio/gpio<num>/edge
+ * @param[in] gpio_num - gpio number
+ * @param[in] edge - edges to report
+ * @return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_sysfs_gpio_edge_write(uint_t gpio_num, sdi_gpio_edge_t edge);
+
 #endif /* __SDI_SYSFS_GPIO_HELPERS_H__ */
@@ -0,0 +1,629 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_bench.c
+ */
+
+
+/******************************************************************************
+ * Benchmark of the SDI callbacks of every resource in the platform
+ * configuration: temperature sensors, fans, entity info (EEPROM parsers),
+ * LEDs, digit display LEDs and media. Meant to be run against simulated
+ * (sim_i2c) or loopback (i2c-stub) buses.
+ *
+ * For every (resource, call) pair it reports, per call:
+ *  - i2c transactions, bytes and retries, from the i2c bus telemetry
+ *  - sleeps, as voluntary context switches of the calling thread. Drivers
+ *    only block in std_usleep on simulated buses, so a new sleep on a hot
+ *    path shows up here.
+ *  - wall time mean/min/max in nano seconds
+ *
+ * Platform init time is reported once: init_ns includes waiting for subtrees
+ * initialized in parallel, init_ready_ns is the time to ready measured by the
+ * init scheduler (see sdi_init_sched.h).
+ *
+ * The asynchronous i2c request queues (see sdi_i2c_async.h) are exercised by
+ * a sweep reading one byte of every simulated slave, one request per bus, all
+ * buses in flight at once. async_sweep_ns is the wall time of the sweep.
+ *
+ * Benchmarked calls write to LEDs and media, so the benchmark refuses to run
+ * when any i2c bus of the platform is not a sim_i2c bus, unless -f is given
+ * (ex: loopback i2c-stub buses). conf/sim is the simulated platform
+ * configuration, its register maps are found through $SDI_SIM_REGMAP_DIR.
+ *
+ * Usage: sdi_bench [-f] [-n iterations] [-o output.json]
+ * Results are written as JSON, to stdout by default.
+ *****************************************************************************/
+
+#define _GNU_SOURCE /* RUSAGE_THREAD */
+
+#include "sdi_entity.h"
+#include "sdi_thermal.h"
+#include "sdi_fan.h"
+#include "sdi_led.h"
+#include "sdi_media.h"
+#include "sdi_entity_info.h"
+#include "sdi_i2c_stats.h"
+#include "sdi_i2c_bus_framework.h"
+#include "sdi_sim_i2c.h"
+#include "sdi_i2cmux_pin.h"
+#include "sdi_init_sched.h"
+#include "sdi_i2c_async.h"
+#include "std_error_codes.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+/**
+ * Default no. of iterations of every call
+ */
+#define SDI_BENCH_DEF_ITERATIONS       (100)
+
+/**
+ * Size of buffer for string results of calls
+ */
+#define SDI_BENCH_BUF_LEN              (256)
+
+/**
+ * No. of calls in a call table
+ */
+#define SDI_BENCH_CALLS(calls)         (sizeof(calls) / sizeof((calls)[0]))
+
+/**
+ * @struct sdi_bench_counters_t
+ * Counters sampled before and after a call
+ */
+typedef struct sdi_bench_counters_ {
+    uint64_t transactions; /* i2c transactions, all buses */
+    uint64_t bytes; /* i2c data bytes, all buses */
+    uint64_t retries; /* i2c retries, all buses */
+    uint64_t sleeps; /* voluntary context switches of this thread */
+} sdi_bench_counters_t;
+
+/**
+ * @struct sdi_bench_sweep_bus_t
+ * Asynchronous sweep request of an i2c bus
+ */
+typedef struct sdi_bench_sweep_bus_ {
+    sdi_i2c_async_req_t req; /* request of this bus */
+    sdi_i2c_batch_op_t ops[SDI_I2C_MAX_SLAVE_ADDR]; /* one read per slave */
+    uint8_t data[SDI_I2C_MAX_SLAVE_ADDR]; /* byte read from every slave */
+    struct sdi_bench_sweep_bus_ *next; /* next bus of the sweep */
+} sdi_bench_sweep_bus_t;
+
+/**
+ * @struct sdi_bench_sweep_t
+ * Asynchronous sweep state
+ */
+typedef struct sdi_bench_sweep_ {
+    sdi_bench_sweep_bus_t *buses; /* submitted requests */
+    uint_t bus_count; /* no. of buses swept */
+    uint_t ops; /* no. of reads submitted */
+    uint_t errors; /* no. of failed reads and submissions */
+} sdi_bench_sweep_t;
+
+/**
+ * @struct sdi_bench_call_t
+ * A benchmarked SDI call
+ */
+typedef struct sdi_bench_call_ {
+    const char *name; /* name of the call in results */
+    t_std_error (*call)(sdi_resource_hdl_t hdl); /* the call */
+} sdi_bench_call_t;
+
+/**
+ * @struct sdi_bench_ctx_t
+ * Benchmark run state
+ */
+typedef struct sdi_bench_ctx_ {
+    FILE *out; /* results */
+    uint_t iterations; /* no. of iterations of every call */
+    uint_t results; /* no. of results written */
+    const char *entity; /* alias of entity being benchmarked */
+    uint_t non_sim_buses; /* no. of i2c buses which are not simulated */
+} sdi_bench_ctx_t;
+
+/**
+ * sdi_bench_stats_add
+ * Add the bus counters of an i2c bus to the sampled counters
+ * param[in] stats - stats block of i2c bus
+ * param[inout] data - sampled counters
+ * return none
+ */
+static void sdi_bench_stats_add(const sdi_i2c_stats_t *stats, void *data)
+{
+    sdi_bench_counters_t *counters = (sdi_bench_counters_t *) data;
+
+    counters->transactions += stats->bus.transactions;
+    counters->bytes += stats->bus.bytes;
+    counters->retries += stats->bus.retries;
+}
+
+/**
+ * sdi_bench_sample
+ * Sample the counters
+ * param[out] counters - sampled counters
+ * return none
+ */
+static void sdi_bench_sample(sdi_bench_counters_t *counters)
+{
+    struct rusage usage;
+
+    memset(counters, 0, sizeof(*counters));
+    sdi_i2c_stats_for_each(sdi_bench_stats_add, counters);
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        counters->sleeps = usage.ru_nvcsw;
+    }
+}
+
+/**
+ * sdi_bench_bus_check
+ * Count an i2c bus which is not a simulated bus, nor an i2c mux channel
+ * of a simulated bus
+ * param[in] stats - stats block of i2c bus
+ * param[inout] data - benchmark run state
+ * return none
+ */
+static void sdi_bench_bus_check(const sdi_i2c_stats_t *stats, void *data)
+{
+    sdi_bench_ctx_t *ctx = (sdi_bench_ctx_t *) data;
+    sdi_i2c_bus_hdl_t i2c_bus = sdi_get_i2c_bus_handle_by_name(stats->bus_name);
+    sdi_i2cmux_pin_hdl_t i2c_mux = NULL;
+
+    /* i2c mux channels pass their transactions through to the parent bus */
+    while ((i2c_bus != NULL)
+           && ((i2c_mux = sdi_i2cmux_pin_chan_mux_get(i2c_bus)) != NULL)) {
+        i2c_bus = i2c_mux->i2cbus_hdl;
+    }
+
+    if ((i2c_bus == NULL) || !sdi_sim_i2c_bus_is_sim(i2c_bus)) {
+        fprintf(stderr, "i2c bus %s is not a simulated bus\n", stats->bus_name);
+        ctx->non_sim_buses++;
+    }
+}
+
+/**
+ * sdi_bench_sweep_submit
+ * Submit a read of one byte of every slave of a simulated i2c bus
+ * param[in] stats - stats block of i2c bus
+ * param[inout] data - sweep state
+ * return none
+ */
+static void sdi_bench_sweep_submit(const sdi_i2c_stats_t *stats, void *data)
+{
+    sdi_bench_sweep_t *sweep = (sdi_bench_sweep_t *) data;
+    sdi_i2c_bus_hdl_t i2c_bus = sdi_get_i2c_bus_handle_by_name(stats->bus_name);
+    sdi_sim_i2c_bus_t *sim_bus = NULL;
+    sdi_bench_sweep_bus_t *sweep_bus = NULL;
+    sdi_sim_i2c_slave_t *slave = NULL;
+    uint_t count = 0;
+    uint_t address = 0;
+
+    if ((i2c_bus == NULL) || !sdi_sim_i2c_bus_is_sim(i2c_bus)) {
+        return;
+    }
+    sim_bus = (sdi_sim_i2c_bus_t *) i2c_bus;
+
+    sweep_bus = calloc(1, sizeof(*sweep_bus));
+    if (sweep_bus == NULL) {
+        sweep->errors++;
+        return;
+    }
+    for (address = 0; address < SDI_I2C_MAX_SLAVE_ADDR; address++) {
+        slave = sim_bus->slave[address];
+        if (slave == NULL) {
+            continue;
+        }
+        sdi_i2c_batch_op_init(&sweep_bus->ops[count], address, SDI_I2C_READ, 0,
+                              (slave->width == SDI_SIM_I2C_WIDTH_ADDR16) ? 2 : 1,
+                              &sweep_bus->data[count], 1);
+        count++;
+    }
+    if (count == 0) {
+        free(sweep_bus);
+        return;
+    }
+
+    sdi_i2c_async_req_init(&sweep_bus->req, sweep_bus->ops, count, NULL, NULL);
+    if (sdi_i2c_async_submit(i2c_bus, &sweep_bus->req) != STD_ERR_OK) {
+        sweep->errors += count;
+        free(sweep_bus);
+        return;
+    }
+    sweep_bus->next = sweep->buses;
+    sweep->buses = sweep_bus;
+    sweep->bus_count++;
+    sweep->ops += count;
+}
+
+/**
+ * sdi_bench_sweep
+ * Read one byte of every simulated slave through the asynchronous i2c
+ * request queues, all buses in flight at once
+ * param[out] sweep - sweep state
+ * return wall time of the sweep in nano seconds
+ */
+static uint64_t sdi_bench_sweep(sdi_bench_sweep_t *sweep)
+{
+    sdi_bench_sweep_bus_t *sweep_bus = NULL;
+    uint64_t start_ns = sdi_i2c_stats_now_ns();
+    uint_t index = 0;
+
+    memset(sweep, 0, sizeof(*sweep));
+    sdi_i2c_stats_for_each(sdi_bench_sweep_submit, sweep);
+
+    while (sweep->buses != NULL) {
+        sweep_bus = sweep->buses;
+        sweep->buses = sweep_bus->next;
+        if (sdi_i2c_async_wait(&sweep_bus->req) != STD_ERR_OK) {
+            for (index = 0; index < sweep_bus->req.count; index++) {
+                if (sweep_bus->ops[index].status != STD_ERR_OK) {
+                    sweep->errors++;
+                }
+            }
+        }
+        free(sweep_bus);
+    }
+
+    return sdi_i2c_stats_now_ns() - start_ns;
+}
+
+/**
+ * sdi_bench_json_string
+ * Write a string as a JSON string, with quotes and escapes
+ * param[in] out - output file
+ * param[in] str - string, NULL is written as an empty string
+ * return none
+ */
+static void sdi_bench_json_string(FILE *out, const char *str)
+{
+    const unsigned char *c = (const unsigned char *) ((str != NULL) ? str : "");
+
+    fputc('"', out);
+    for (; *c != '\0'; c++) {
+        if ((*c == '"') || (*c == '\\')) {
+            fprintf(out, "\\%c", *c);
+        } else if (*c < 0x20) {
+            fprintf(out, "\\u%04x", *c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+/* Temperature sensor calls */
+static t_std_error sdi_bench_temperature_get(sdi_resource_hdl_t hdl)
+{
+    int temperature = 0;
+
+    return sdi_temperature_get(hdl, &temperature);
+}
+
+static t_std_error sdi_bench_temperature_status_get(sdi_resource_hdl_t hdl)
+{
+    bool alert_on = false;
+
+    return sdi_temperature_status_get(hdl, &alert_on);
+}
+
+static t_std_error sdi_bench_temperature_threshold_get(sdi_resource_hdl_t hdl)
+{
+    int threshold = 0;
+
+    return sdi_temperature_threshold_get(hdl, SDI_HIGH_THRESHOLD, &threshold);
+}
+
+static const sdi_bench_call_t sdi_bench_temperature_calls[] = {
+    { "temperature_get", sdi_bench_temperature_get },
+    { "temperature_status_get", sdi_bench_temperature_status_get },
+    { "temperature_threshold_get", sdi_bench_temperature_threshold_get },
+};
+
+/* Fan calls */
+static t_std_error sdi_bench_fan_speed_get(sdi_resource_hdl_t hdl)
+{
+    uint_t speed = 0;
+
+    return sdi_fan_speed_get(hdl, &speed);
+}
+
+static t_std_error sdi_bench_fan_status_get(sdi_resource_hdl_t hdl)
+{
+    bool alert_on = false;
+
+    return sdi_fan_status_get(hdl, &alert_on);
+}
+
+static const sdi_bench_call_t sdi_bench_fan_calls[] = {
+    { "fan_speed_get", sdi_bench_fan_speed_get },
+    { "fan_status_get", sdi_bench_fan_status_get },
+};
+
+/* Entity info calls */
+static t_std_error sdi_bench_entity_info_read(sdi_resource_hdl_t hdl)
+{
+    sdi_entity_info_t info;
+
+    memset(&info, 0, sizeof(info));
+    return sdi_entity_info_read(hdl, &info);
+}
+
+static const sdi_bench_call_t sdi_bench_entity_info_calls[] = {
+    { "entity_info_read", sdi_bench_entity_info_read },
+};
+
+/* LED calls */
+static const sdi_bench_call_t sdi_bench_led_calls[] = {
+    { "led_on", sdi_led_on },
+    { "led_off", sdi_led_off },
+};
+
+/* Digit display LED calls */
+static t_std_error sdi_bench_digital_display_led_set(sdi_resource_hdl_t hdl)
+{
+    return sdi_digital_display_led_set(hdl, "1");
+}
+
+static const sdi_bench_call_t sdi_bench_digit_display_led_calls[] = {
+    { "digital_display_led_set", sdi_bench_digital_display_led_set },
+    { "digital_display_led_on", sdi_digital_display_led_on },
+};
+
+/* Media calls */
+static t_std_error sdi_bench_media_presence_get(sdi_resource_hdl_t hdl)
+{
+    bool present = false;
+
+    return sdi_media_presence_get(hdl, &present);
+}
+
+static t_std_error sdi_bench_media_identifier_get(sdi_resource_hdl_t hdl)
+{
+    uint_t value = 0;
+
+    return sdi_media_parameter_get(hdl, SDI_MEDIA_IDENTIFIER, &value);
+}
+
+static t_std_error sdi_bench_media_vendor_name_get(sdi_resource_hdl_t hdl)
+{
+    char buf[SDI_BENCH_BUF_LEN];
+
+    return sdi_media_vendor_info_get(hdl, SDI_MEDIA_VENDOR_NAME, buf, sizeof(buf));
+}
+
+static t_std_error sdi_bench_media_temperature_get(sdi_resource_hdl_t hdl)
+{
+    float value = 0;
+
+    return sdi_media_module_monitor_get(hdl, SDI_MEDIA_TEMP, &value);
+}
+
+static const sdi_bench_call_t sdi_bench_media_calls[] = {
+    { "media_presence_get", sdi_bench_media_presence_get },
+    { "media_identifier_get", sdi_bench_media_identifier_get },
+    { "media_vendor_name_get", sdi_bench_media_vendor_name_get },
+    { "media_temperature_get", sdi_bench_media_temperature_get },
+};
+
+/**
+ * sdi_bench_run
+ * Run a call for configured iterations and write its result
+ * param[in] ctx - benchmark run state
+ * param[in] hdl - resource handle
+ * param[in] call - benchmarked call
+ * return none
+ */
+static void sdi_bench_run(sdi_bench_ctx_t *ctx, sdi_resource_hdl_t hdl,
+                          const sdi_bench_call_t *call)
+{
+    sdi_bench_counters_t before;
+    sdi_bench_counters_t after;
+    uint64_t start_ns = 0;
+    uint64_t ns = 0;
+    uint64_t total_ns = 0;
+    uint64_t min_ns = UINT64_MAX;
+    uint64_t max_ns = 0;
+    uint_t errors = 0;
+    uint_t index = 0;
+    double n = ctx->iterations;
+
+    sdi_bench_sample(&before);
+    for (index = 0; index < ctx->iterations; index++) {
+        start_ns = sdi_i2c_stats_now_ns();
+        if (call->call(hdl) != STD_ERR_OK) {
+            errors++;
+        }
+        ns = sdi_i2c_stats_now_ns() - start_ns;
+        total_ns += ns;
+        min_ns = (ns < min_ns) ? ns : min_ns;
+        max_ns = (ns > max_ns) ? ns : max_ns;
+    }
+    sdi_bench_sample(&after);
+
+    fprintf(ctx->out, "%s\n    {\"entity\": ", (ctx->results == 0) ? "" : ",");
+    sdi_bench_json_string(ctx->out, ctx->entity);
+    fprintf(ctx->out, ", \"resource\": ");
+    sdi_bench_json_string(ctx->out, sdi_resource_alias_get(hdl));
+    fprintf(ctx->out, ", \"call\": ");
+    sdi_bench_json_string(ctx->out, call->name);
+    fprintf(ctx->out, ", \"iterations\": %u, \"errors\": %u, "
+            "\"transactions\": %.2f, \"bytes\": %.2f, \"retries\": %.2f, "
+            "\"sleeps\": %.2f, \"wall_ns_mean\": %.0f, "
+            "\"wall_ns_min\": %llu, \"wall_ns_max\": %llu}",
+            ctx->iterations, errors,
+            (after.transactions - before.transactions) / n,
+            (after.bytes - before.bytes) / n,
+            (after.retries - before.retries) / n,
+            (after.sleeps - before.sleeps) / n,
+            total_ns / n,
+            (unsigned long long) min_ns, (unsigned long long) max_ns);
+    ctx->results++;
+}
+
+/**
+ * sdi_bench_resource
+ * Benchmark the calls of a resource as per its type
+ * param[in] hdl - resource handle
+ * param[in] user_data - benchmark run state
+ * return none
+ */
+static void sdi_bench_resource(sdi_resource_hdl_t hdl, void *user_data)
+{
+    sdi_bench_ctx_t *ctx = (sdi_bench_ctx_t *) user_data;
+    const sdi_bench_call_t *calls = NULL;
+    uint_t count = 0;
+    uint_t index = 0;
+
+    switch (sdi_resource_type_get(hdl)) {
+        case SDI_RESOURCE_TEMPERATURE:
+            calls = sdi_bench_temperature_calls;
+            count = SDI_BENCH_CALLS(sdi_bench_temperature_calls);
+            break;
+        case SDI_RESOURCE_FAN:
+            calls = sdi_bench_fan_calls;
+            count = SDI_BENCH_CALLS(sdi_bench_fan_calls);
+            break;
+        case SDI_RESOURCE_ENTITY_INFO:
+            calls = sdi_bench_entity_info_calls;
+            count = SDI_BENCH_CALLS(sdi_bench_entity_info_calls);
+            break;
+        case SDI_RESOURCE_LED:
+            calls = sdi_bench_led_calls;
+            count = SDI_BENCH_CALLS(sdi_bench_led_calls);
+            break;
+        case SDI_RESOURCE_DIGIT_DISPLAY_LED:
+            calls = sdi_bench_digit_display_led_calls;
+            count = SDI_BENCH_CALLS(sdi_bench_digit_display_led_calls);
+            break;
+        case SDI_RESOURCE_MEDIA:
+            calls = sdi_bench_media_calls;
+            count = SDI_BENCH_CALLS(sdi_bench_media_calls);
+            break;
+        default:
+            return;
+    }
+
+    for (index = 0; index < count; index++) {
+        sdi_bench_run(ctx, hdl, &calls[index]);
+    }
+}
+
+/**
+ * sdi_bench_entities
+ * Benchmark every resource of every entity of a type
+ * param[in] ctx - benchmark run state
+ * param[in] type - entity type
+ * return none
+ */
+static void sdi_bench_entities(sdi_bench_ctx_t *ctx, sdi_entity_type_t type)
+{
+    sdi_entity_hdl_t entity_hdl = NULL;
+    uint_t count = sdi_entity_count_get(type);
+    uint_t instance = 0;
+
+    for (instance = 1; instance <= count; instance++) {
+        if (sdi_entity_lookup(type, instance, &entity_hdl) != STD_ERR_OK) {
+            continue;
+        }
+        ctx->entity = sdi_entity_name_get(entity_hdl);
+        sdi_entity_init(entity_hdl);
+        sdi_entity_for_each_resource(entity_hdl, sdi_bench_resource, ctx);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    sdi_bench_ctx_t ctx = { .out = stdout, .iterations = SDI_BENCH_DEF_ITERATIONS };
+    sdi_init_sched_stats_t init_stats;
+    sdi_bench_sweep_t sweep;
+    uint64_t start_ns = 0;
+    uint64_t sweep_ns = 0;
+    bool force = false;
+    int opt = 0;
+
+    while ((opt = getopt(argc, argv, "fn:o:")) != -1) {
+        switch (opt) {
+            case 'f':
+                force = true;
+                break;
+            case 'n':
+                ctx.iterations = (uint_t) strtoul(optarg, NULL, 0);
+                break;
+            case 'o':
+                ctx.out = fopen(optarg, "w");
+                if (ctx.out == NULL) {
+                    perror(optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-f] [-n iterations] [-o output.json]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (ctx.iterations == 0) {
+        ctx.iterations = 1;
+    }
+
+    start_ns = sdi_i2c_stats_now_ns();
+    if (sdi_sys_init() != STD_ERR_OK) {
+        fprintf(stderr, "sdi_sys_init failed\n");
+        return EXIT_FAILURE;
+    }
+    /* parallel subtrees may still be initializing */
+    sdi_init_sched_wait();
+    sdi_init_sched_stats_get(&init_stats);
+
+    sdi_i2c_stats_for_each(sdi_bench_bus_check, &ctx);
+    if ((ctx.non_sim_buses != 0) && !force) {
+        fprintf(stderr, "refusing to benchmark %u non simulated i2c buses, "
+                "use the simulated platform (conf/sim) or -f\n", ctx.non_sim_buses);
+        if (ctx.out != stdout) {
+            fclose(ctx.out);
+        }
+        return EXIT_FAILURE;
+    }
+
+    fprintf(ctx.out, "{\n  \"init_ns\": %llu,\n  \"init_ready_ns\": %llu,\n"
+            "  \"init_parallel\": %u,\n  \"init_deferred\": %u,\n",
+            (unsigned long long) (sdi_i2c_stats_now_ns() - start_ns),
+            (unsigned long long) init_stats.ready_ns,
+            init_stats.parallel, init_stats.deferred);
+
+    sweep_ns = sdi_bench_sweep(&sweep);
+    fprintf(ctx.out, "  \"async_sweep_ns\": %llu,\n  \"async_sweep_buses\": %u,\n"
+            "  \"async_sweep_ops\": %u,\n  \"async_sweep_errors\": %u,\n"
+            "  \"results\": [",
+            (unsigned long long) sweep_ns, sweep.bus_count, sweep.ops, sweep.errors);
+
+    sdi_bench_entities(&ctx, SDI_ENTITY_SYSTEM_BOARD);
+    sdi_bench_entities(&ctx, SDI_ENTITY_FAN_TRAY);
+    sdi_bench_entities(&ctx, SDI_ENTITY_PSU_TRAY);
+
+    fprintf(ctx.out, "\n  ]\n}\n");
+
+    if (ctx.out != stdout) {
+        fclose(ctx.out);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -41,6 +41,20 @@
  * support to 'n' width when required.
  * - inverted polarity is handled by cpld driver now and not by cpld, when cpld
  * supports invert polarity push the logic to cpld
+ * - pin groups spanning more than one cpld register are read in one i2c block
+ * transaction when the i2c bus supports it, register by register otherwise.
+ * block_read="no" on cpld node disables block reads for cplds not auto
+ * incrementing the register address.
+ * - registers whose every bit is an output pin/pin group bit have a shadow
+ * copy, writes update it instead of reading the register first. Registers with
+ * input or unconfigured bits are read before every write. shadow="no" on cpld node
+ * disables shadow copies, shadow_resync_ms sets how long a shadow copy is
+ * trusted before the register is read again.
+ * - snapshot_ms on cpld node enables the register window snapshot: pin and pin
+ * group reads are served from a snapshot of snapshot_start_addr..
+ * snapshot_end_addr, read in one block transaction once older than
+ * snapshot_ms. Status pins may then report a level upto snapshot_ms old. The
+ * window must leave out clear on read registers.
  *
  * note
  * - CPLD pin corresponds to a bit in a CPLD register. In configuration,
@@ -73,6 +87,12 @@
  *        <!- end_offset is cpld pin group's bit offset within end_addr --!>
  *
  *      <!-- width of cpld register is optional if its 1byte --!>
+ *      <!-- block_read is optional, "no" to read pin groups register by
+ *           register --!>
+ *      <!-- shadow is optional, "no" to read registers before every write,
+ *           shadow_resync_ms is optional --!>
+ *      <!-- snapshot_ms is optional, snapshot is disabled by default.
+ *           snapshot_start_addr and snapshot_end_addr are required with it --!>
  *        <!-- level is optional for input pin --!>
  * </cpld>
  *****************************************************************************/
@@ -80,6 +100,7 @@
 #include "sdi_cpld.h"
 #include "sdi_device_common.h"
 #include "sdi_bus_framework.h"
+#include "sdi_bus_api.h"
 #include "sdi_i2c_bus_api.h"
 #include "sdi_pin_bus_framework.h"
 #include "sdi_pin_group_bus_framework.h"
@@ -94,6 +115,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <linux/i2c.h>
 
 /* cpld device driver registration function */
 static t_std_error sdi_cpld_register(std_config_node_t node, void *bus_handle,
@@ -110,6 +132,324 @@ sdi_driver_t sdi_cpld_entry = {
     sdi_cpld_init
 };
 
+/*
+ * Mark the bits of a cpld register used by a pin or pin group with its
+ * direction
+ * param[in] cpld_dev_hdl - cpld device handle
+ * param[in] addr - register address
+ * param[in] mask - register bits of the pin/pin group
+ * param[in] direction - direction of pin/pin group
+ * return none
+ */
+static void sdi_cpld_reg_mark(sdi_cpld_dev_hdl_t cpld_dev_hdl, uint_t addr,
+                              uint8_t mask, sdi_pin_bus_direction_t direction)
+{
+    sdi_cpld_reg_shadow_t *reg = &cpld_dev_hdl->regs[addr - cpld_dev_hdl->start_addr];
+
+    if (direction == SDI_PIN_BUS_OUTPUT) {
+        reg->flags |= SDI_CPLD_REG_OUTPUT;
+        reg->out_mask |= mask;
+    } else {
+        reg->flags |= SDI_CPLD_REG_INPUT;
+    }
+}
+
+/*
+ * Check whether writes of a cpld register may use its shadow copy: every bit
+ * of the register belongs to an output pin/pin group, so no bit may change
+ * under the shadow copy but by the cpld driver
+ * param[in] cpld_dev_hdl - cpld device handle
+ * param[in] reg - register shadow
+ * return true when shadow copy is used
+ */
+static inline bool sdi_cpld_reg_shadowed(sdi_cpld_dev_hdl_t cpld_dev_hdl,
+                                         const sdi_cpld_reg_shadow_t *reg)
+{
+    return (cpld_dev_hdl->shadow && (!(reg->flags & SDI_CPLD_REG_INPUT))
+            && (reg->out_mask == 0xff));
+}
+
+/*
+ * Read consecutive cpld registers in one i2c block transaction
+ * param[in] dev_hdl - cpld device handle
+ * param[in] addr - first cpld register address
+ * param[in] count - no. of registers
+ * param[out] buffer - register values, in address order
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when block read is disabled on cpld or the bus
+ * can't do block reads
+ */
+t_std_error sdi_cpld_block_read(sdi_device_hdl_t dev_hdl, uint_t addr,
+                                uint_t count, uint8_t *buffer)
+{
+    sdi_bus_hdl_t bus_hdl = (sdi_bus_hdl_t) dev_hdl->bus_hdl;
+    sdi_cpld_dev_hdl_t cpld_dev_hdl = (sdi_cpld_dev_hdl_t) dev_hdl->private_data;
+    sdi_i2c_bus_hdl_t i2c_bus = NULL;
+    sdi_i2c_bus_capability_t capability = 0;
+    size_t len = count;
+    t_std_error error = STD_ERR_OK;
+
+    if ((!cpld_dev_hdl->block_read) || (bus_hdl->bus_type != SDI_I2C_BUS)) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    i2c_bus = (sdi_i2c_bus_hdl_t) bus_hdl;
+    sdi_i2c_bus_get_capability(i2c_bus, &capability);
+    if (!(capability & (I2C_FUNC_SMBUS_READ_I2C_BLOCK | I2C_FUNC_I2C))) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    error = sdi_i2c_acquire_bus(i2c_bus);
+    if (error != STD_ERR_OK) {
+        return error;
+    }
+    error = sdi_smbus_read_i2c_block_data(i2c_bus, dev_hdl->addr.i2c_addr, addr,
+                                          buffer, &len, SDI_I2C_FLAG_NONE);
+    sdi_i2c_release_bus(i2c_bus);
+    if ((error == STD_ERR_OK) && (len != count)) {
+        error = SDI_DEVICE_ERRCODE(EIO);
+    }
+    return error;
+}
+
+/*
+ * Read consecutive cpld registers from the register window snapshot,
+ * refreshing the snapshot when older than snapshot_ms. shadow_lock is dropped
+ * while the snapshot is read from the cpld, other readers meanwhile read the
+ * registers themselves.
+ * param[in] dev_hdl - cpld device handle
+ * param[in] addr - first cpld register address
+ * param[in] count - no. of registers
+ * param[out] buffer - register values, in address order
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when snapshot is disabled, registers are out of
+ * the snapshot window, another thread is refreshing the snapshot or the bus
+ * doesn't support block reads
+ */
+t_std_error sdi_cpld_snapshot_read(sdi_device_hdl_t dev_hdl, uint_t addr,
+                                   uint_t count, uint8_t *buffer)
+{
+    sdi_cpld_dev_hdl_t cpld_dev_hdl = (sdi_cpld_dev_hdl_t) dev_hdl->private_data;
+    uint_t len = 0;
+    uint_t gen = 0;
+    uint64_t now_ns = 0;
+    t_std_error error = STD_ERR_OK;
+
+    if ((cpld_dev_hdl->snapshot_ms == 0) || (addr < cpld_dev_hdl->snapshot_start)
+        || ((addr + count) > (cpld_dev_hdl->snapshot_end + 1))) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    len = (cpld_dev_hdl->snapshot_end - cpld_dev_hdl->snapshot_start) + 1;
+
+    std_mutex_lock(&cpld_dev_hdl->shadow_lock);
+
+    now_ns = sdi_device_now_ns();
+    if ((cpld_dev_hdl->snapshot_valid)
+        && ((now_ns - cpld_dev_hdl->snapshot_ns) < (cpld_dev_hdl->snapshot_ms * 1000000ULL))) {
+        cpld_dev_hdl->shadow_stats.snapshot_hits++;
+        memcpy(buffer, &cpld_dev_hdl->snapshot[addr - cpld_dev_hdl->snapshot_start], count);
+        std_mutex_unlock(&cpld_dev_hdl->shadow_lock);
+        return STD_ERR_OK;
+    }
+    if (cpld_dev_hdl->snapshot_busy) {
+        std_mutex_unlock(&cpld_dev_hdl->shadow_lock);
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    cpld_dev_hdl->snapshot_valid = 0;
+    cpld_dev_hdl->snapshot_busy = 1;
+    gen = cpld_dev_hdl->snapshot_gen;
+    std_mutex_unlock(&cpld_dev_hdl->shadow_lock);
+
+    error = sdi_cpld_block_read(dev_hdl, cpld_dev_hdl->snapshot_start, len,
+                                cpld_dev_hdl->snapshot_buf);
+
+    std_mutex_lock(&cpld_dev_hdl->shadow_lock);
+    cpld_dev_hdl->snapshot_busy = 0;
+    if (error == STD_ERR_OK) {
+        cpld_dev_hdl->shadow_stats.snapshot_reads++;
+        /* a register written during the refresh may hold its old value in
+           the block read, serve this read but don't keep the snapshot */
+        if (gen == cpld_dev_hdl->snapshot_gen) {
+            memcpy(cpld_dev_hdl->snapshot, cpld_dev_hdl->snapshot_buf, len);
+            cpld_dev_hdl->snapshot_valid = 1;
+            cpld_dev_hdl->snapshot_ns = now_ns;
+        }
+        memcpy(buffer, &cpld_dev_hdl->snapshot_buf[addr - cpld_dev_hdl->snapshot_start], count);
+    }
+    std_mutex_unlock(&cpld_dev_hdl->shadow_lock);
+    return error;
+}
+
+/*
+ * Keep the register window snapshot in line with a register write. Called
+ * with shadow_lock held.
+ * param[in] cpld_dev_hdl - cpld device handle
+ * param[in] addr - cpld register address
+ * param[in] value - value written, valid when error is STD_ERR_OK
+ * param[in] error - status of the write
+ * return none
+ */
+static void sdi_cpld_snapshot_written(sdi_cpld_dev_hdl_t cpld_dev_hdl, uint_t addr,
+                                      uint8_t value, t_std_error error)
+{
+    if ((addr < cpld_dev_hdl->snapshot_start) || (addr > cpld_dev_hdl->snapshot_end)) {
+        return;
+    }
+    cpld_dev_hdl->snapshot_gen++;
+    if (!cpld_dev_hdl->snapshot_valid) {
+        return;
+    }
+    if (error == STD_ERR_OK) {
+        cpld_dev_hdl->snapshot[addr - cpld_dev_hdl->snapshot_start] = value;
+    } else {
+        cpld_dev_hdl->snapshot_valid = 0;
+    }
+}
+
+/*
+ * Update bits of a cpld register, other bits keep their value. Registers fully
+ * covered by output pins use their shadow copy instead of reading the
+ * register, unless the shadow copy is not in sync or older than resync_ms.
+ * The i2c bus is held across the read-modify-write, so updates of the cpld
+ * are serialized while shadow_lock is only taken around shadow accesses.
+ * param[in] dev_hdl - cpld device handle
+ * param[in] addr - cpld register address
+ * param[in] mask - bits to update
+ * param[in] bits - new value of bits in mask
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_cpld_reg_update(sdi_device_hdl_t dev_hdl, uint_t addr,
+                                uint8_t mask, uint8_t bits)
+{
+    sdi_bus_hdl_t bus_hdl = (sdi_bus_hdl_t) dev_hdl->bus_hdl;
+    sdi_cpld_dev_hdl_t cpld_dev_hdl = (sdi_cpld_dev_hdl_t) dev_hdl->private_data;
+    sdi_i2c_bus_hdl_t i2c_bus = NULL;
+    sdi_cpld_reg_shadow_t *reg = NULL;
+    bool shadowed = false;
+    bool sync = true;
+    uint8_t buffer = 0;
+    uint64_t now_ns = 0;
+    t_std_error error = STD_ERR_OK;
+
+    STD_ASSERT((addr >= cpld_dev_hdl->start_addr) && (addr <= cpld_dev_hdl->end_addr));
+
+    reg = &cpld_dev_hdl->regs[addr - cpld_dev_hdl->start_addr];
+    if (bus_hdl->bus_type != SDI_I2C_BUS) {
+        /* no shadow copy without a bus to serialize updates on */
+        error = sdi_bus_read_byte(bus_hdl, dev_hdl->addr, addr, &buffer);
+        if (error != STD_ERR_OK) {
+            return error;
+        }
+        buffer = (buffer & ~mask) | (bits & mask);
+        return sdi_bus_write_byte(bus_hdl, dev_hdl->addr, addr, buffer);
+    }
+
+    i2c_bus = (sdi_i2c_bus_hdl_t) bus_hdl;
+    error = sdi_i2c_acquire_bus(i2c_bus);
+    if (error != STD_ERR_OK) {
+        return error;
+    }
+
+    shadowed = sdi_cpld_reg_shadowed(cpld_dev_hdl, reg);
+    now_ns = sdi_device_now_ns();
+    if (shadowed) {
+        std_mutex_lock(&cpld_dev_hdl->shadow_lock);
+        sync = ((!(reg->flags & SDI_CPLD_REG_VALID))
+                || ((cpld_dev_hdl->resync_ms != 0)
+                    && ((now_ns - reg->sync_ns) >= (cpld_dev_hdl->resync_ms * 1000000ULL))));
+        buffer = reg->value;
+        std_mutex_unlock(&cpld_dev_hdl->shadow_lock);
+    }
+
+    do {
+        if (sync) {
+            error = sdi_smbus_read_byte(i2c_bus, dev_hdl->addr.i2c_addr, addr,
+                                        &buffer, SDI_I2C_FLAG_NONE);
+            if (error != STD_ERR_OK) {
+                break;
+            }
+        }
+        buffer = (buffer & ~mask) | (bits & mask);
+        error = sdi_smbus_write_byte(i2c_bus, dev_hdl->addr.i2c_addr, addr,
+                                     buffer, SDI_I2C_FLAG_NONE);
+    } while (0);
+
+    std_mutex_lock(&cpld_dev_hdl->shadow_lock);
+    if (shadowed) {
+        if (error == STD_ERR_OK) {
+            reg->value = buffer;
+            reg->flags |= SDI_CPLD_REG_VALID;
+            if (sync) {
+                reg->sync_ns = now_ns;
+                cpld_dev_hdl->shadow_stats.reads++;
+            }
+            cpld_dev_hdl->shadow_stats.writes++;
+        } else if (reg->flags & SDI_CPLD_REG_VALID) {
+            /* register may or may not hold the new value, read it on next write */
+            reg->flags &= ~SDI_CPLD_REG_VALID;
+            cpld_dev_hdl->shadow_stats.invalidations++;
+        }
+    }
+    sdi_cpld_snapshot_written(cpld_dev_hdl, addr, buffer, error);
+    std_mutex_unlock(&cpld_dev_hdl->shadow_lock);
+
+    sdi_i2c_release_bus(i2c_bus);
+    return error;
+}
+
+/*
+ * Invalidate the shadow copy of every register of a cpld and its snapshot
+ * param[in] dev_hdl - cpld device handle
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when not a cpld
+ */
+t_std_error sdi_cpld_shadow_invalidate(sdi_device_hdl_t dev_hdl)
+{
+    sdi_cpld_dev_hdl_t cpld_dev_hdl = NULL;
+    uint_t index = 0;
+
+    STD_ASSERT(dev_hdl != NULL);
+    if (dev_hdl->callbacks != &sdi_cpld_entry) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    cpld_dev_hdl = (sdi_cpld_dev_hdl_t) dev_hdl->private_data;
+
+    std_mutex_lock(&cpld_dev_hdl->shadow_lock);
+    for (index = 0; index <= (cpld_dev_hdl->end_addr - cpld_dev_hdl->start_addr); index++) {
+        if (cpld_dev_hdl->regs[index].flags & SDI_CPLD_REG_VALID) {
+            cpld_dev_hdl->regs[index].flags &= ~SDI_CPLD_REG_VALID;
+            cpld_dev_hdl->shadow_stats.invalidations++;
+        }
+    }
+    cpld_dev_hdl->snapshot_valid = 0;
+    cpld_dev_hdl->snapshot_gen++;
+    std_mutex_unlock(&cpld_dev_hdl->shadow_lock);
+    return STD_ERR_OK;
+}
+
+/*
+ * Get the shadow register counters of a cpld
+ * param[in] dev_hdl - cpld device handle
+ * param[out] stats - shadow register counters
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when not a cpld
+ */
+t_std_error sdi_cpld_shadow_stats_get(sdi_device_hdl_t dev_hdl,
+                                      sdi_cpld_shadow_stats_t *stats)
+{
+    sdi_cpld_dev_hdl_t cpld_dev_hdl = NULL;
+
+    STD_ASSERT(dev_hdl != NULL);
+    STD_ASSERT(stats != NULL);
+    if (dev_hdl->callbacks != &sdi_cpld_entry) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    cpld_dev_hdl = (sdi_cpld_dev_hdl_t) dev_hdl->private_data;
+
+    std_mutex_lock(&cpld_dev_hdl->shadow_lock);
+    *stats = cpld_dev_hdl->shadow_stats;
+    std_mutex_unlock(&cpld_dev_hdl->shadow_lock);
+    return STD_ERR_OK;
+}
+
 /*
  * Create cpld device and register cpld pin/pin group bus attached to the
  * cpld device
@@ -122,6 +462,7 @@ static t_std_error sdi_cpld_register(std_config_node_t node, void *bus_handle,
                                      sdi_device_hdl_t* device_hdl)
 {
     char *node_attr = NULL;
+    char *end_attr = NULL;
     std_config_node_t cur_node = NULL;
     sdi_device_hdl_t dev_hdl = NULL;
     sdi_bus_driver_t *bus_driver = NULL;
@@ -130,6 +471,8 @@ static t_std_error sdi_cpld_register(std_config_node_t node, void *bus_handle,
     sdi_cpld_pin_t *cpld_pin = NULL;
     sdi_cpld_pin_group_t *cpld_pin_group = NULL;
     sdi_cpld_dev_hdl_t cpld_dev_hdl = NULL;
+    const sdi_cpld_bit_step_t *step = NULL;
+    uint_t index = 0;
 
     dev_hdl = (sdi_device_hdl_t) calloc(sizeof(sdi_device_entry_t), 1);
     STD_ASSERT(dev_hdl != NULL);
@@ -169,6 +512,60 @@ static t_std_error sdi_cpld_register(std_config_node_t node, void *bus_handle,
         STD_ASSERT(cpld_dev_hdl->width == SDI_CPLD_DEFAULT_REGISTER_WIDTH);
     }
 
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_CPLD_BLOCK_READ);
+    cpld_dev_hdl->block_read = ((node_attr == NULL) || (strcmp(node_attr, "no") != 0));
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_CPLD_SHADOW);
+    cpld_dev_hdl->shadow = ((node_attr == NULL) || (strcmp(node_attr, "no") != 0));
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_CPLD_SHADOW_RESYNC);
+    if (node_attr == NULL) {
+        cpld_dev_hdl->resync_ms = SDI_CPLD_DEF_SHADOW_RESYNC_MS;
+    } else {
+        cpld_dev_hdl->resync_ms = (uint_t) strtoul (node_attr, NULL, 0);
+    }
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_CPLD_SNAPSHOT);
+    if (node_attr != NULL) {
+        cpld_dev_hdl->snapshot_ms = (uint_t) strtoul (node_attr, NULL, 0);
+    }
+
+    if (cpld_dev_hdl->snapshot_ms != 0) {
+        node_attr = std_config_attr_get(node, SDI_DEV_ATTR_CPLD_SNAPSHOT_START);
+        end_attr = std_config_attr_get(node, SDI_DEV_ATTR_CPLD_SNAPSHOT_END);
+        if ((node_attr == NULL) || (end_attr == NULL)) {
+            SDI_DEVICE_ERRMSG_LOG("%s:%d cpld %s snapshot window not set, snapshot disabled\n",
+                                  __FUNCTION__, __LINE__, dev_hdl->alias);
+            cpld_dev_hdl->snapshot_ms = 0;
+        } else {
+            cpld_dev_hdl->snapshot_start = (uint_t) strtoul (node_attr, NULL, 0);
+            cpld_dev_hdl->snapshot_end = (uint_t) strtoul (end_attr, NULL, 0);
+            STD_ASSERT(cpld_dev_hdl->snapshot_start >= cpld_dev_hdl->start_addr);
+            STD_ASSERT(cpld_dev_hdl->snapshot_end <= cpld_dev_hdl->end_addr);
+            STD_ASSERT(cpld_dev_hdl->snapshot_start <= cpld_dev_hdl->snapshot_end);
+        }
+    }
+    if (cpld_dev_hdl->snapshot_ms == 0) {
+        /* empty window */
+        cpld_dev_hdl->snapshot_start = cpld_dev_hdl->end_addr + 1;
+        cpld_dev_hdl->snapshot_end = cpld_dev_hdl->end_addr;
+    } else {
+        cpld_dev_hdl->snapshot = (uint8_t *)
+            calloc((cpld_dev_hdl->snapshot_end - cpld_dev_hdl->snapshot_start) + 1,
+                   sizeof(uint8_t));
+        STD_ASSERT(cpld_dev_hdl->snapshot != NULL);
+        cpld_dev_hdl->snapshot_buf = (uint8_t *)
+            calloc((cpld_dev_hdl->snapshot_end - cpld_dev_hdl->snapshot_start) + 1,
+                   sizeof(uint8_t));
+        STD_ASSERT(cpld_dev_hdl->snapshot_buf != NULL);
+    }
+
+    cpld_dev_hdl->regs = (sdi_cpld_reg_shadow_t *)
+        calloc((cpld_dev_hdl->end_addr - cpld_dev_hdl->start_addr) + 1,
+               sizeof(sdi_cpld_reg_shadow_t));
+    STD_ASSERT(cpld_dev_hdl->regs != NULL);
+    std_mutex_lock_init_non_recursive(&cpld_dev_hdl->shadow_lock);
+
     dev_hdl->callbacks = &sdi_cpld_entry;
 
     dev_hdl->private_data = cpld_dev_hdl;
@@ -201,6 +598,9 @@ static t_std_error sdi_cpld_register(std_config_node_t node, void *bus_handle,
             cpld_pin->cpld_hdl = dev_hdl;
             STD_ASSERT(cpld_pin->addr >= cpld_dev_hdl->start_addr);
             STD_ASSERT(cpld_pin->addr <= cpld_dev_hdl->end_addr);
+            sdi_cpld_reg_mark(cpld_dev_hdl, cpld_pin->addr,
+                              (uint8_t) (1 << cpld_pin->offset),
+                              cpld_pin->bus.default_direction);
         } else if (bus->bus_type == SDI_PIN_GROUP_BUS) {
             cpld_pin_group = (sdi_cpld_pin_group_t *) bus;
             cpld_pin_group->cpld_hdl = dev_hdl;
@@ -208,6 +608,12 @@ static t_std_error sdi_cpld_register(std_config_node_t node, void *bus_handle,
             STD_ASSERT(cpld_pin_group->start_addr <= cpld_dev_hdl->end_addr);
             STD_ASSERT(cpld_pin_group->end_addr >= cpld_dev_hdl->start_addr);
             STD_ASSERT(cpld_pin_group->end_addr <= cpld_dev_hdl->end_addr);
+            for (index = 0; index < cpld_pin_group->length; index++) {
+                step = &cpld_pin_group->plan[index];
+                sdi_cpld_reg_mark(cpld_dev_hdl, step->addr,
+                                  (uint8_t) (step->mask << step->reg_shift),
+                                  cpld_pin_group->bus.default_direction);
+            }
         } else {
             STD_ASSERT(false);
         }
@@ -52,7 +52,8 @@
 /*
  * Read the cpld pin level.
  * sequence of operation:
- * 1. Read value of cpld register using bus read operation.
+ * 1. Read value of cpld register from cpld snapshot when enabled, using bus
+ * read operation otherwise.
  * 2. Mask the value with bit corresponding to cpld pin
  * param[in] pin_hdl cpld pin handle
  * param[out] value cpld pin level is read into value
@@ -71,9 +72,13 @@ static t_std_error sdi_cpld_pin_read_level (sdi_pin_bus_hdl_t pin_hdl,
 
     STD_ASSERT(cpld_dev_hdl->width == SDI_CPLD_DEFAULT_REGISTER_WIDTH);
 
-    /* Read the cpld register on which this cpld pin is just a bit */
-    error = sdi_bus_read_byte(bus_hdl, dev_hdl->addr,
-                             cpld_pin->addr, &buffer);
+    /* Read the cpld register on which this cpld pin is just a bit, from
+     * cpld snapshot when enabled */
+    error = sdi_cpld_snapshot_read(dev_hdl, cpld_pin->addr, 1, &buffer);
+    if (error == SDI_DEVICE_ERRCODE(ENOTSUP)) {
+        error = sdi_bus_read_byte(bus_hdl, dev_hdl->addr,
+                                 cpld_pin->addr, &buffer);
+    }
     if (error != STD_ERR_OK) {
         return error;
     }
@@ -98,13 +103,51 @@ static t_std_error sdi_cpld_pin_read_level (sdi_pin_bus_hdl_t pin_hdl,
     return error;
 }
 
+/*
+ * Set the bit of a cpld pin in mask and its value for given level in bits
+ * param[in] pin_hdl cpld pin handle
+ * param[in] value cpld pin level to be written
+ * param[inout] mask register bits to be updated
+ * param[inout] bits register bits value
+ * return none
+ */
+static void sdi_cpld_pin_level_bits(sdi_pin_bus_hdl_t pin_hdl,
+                                    sdi_pin_bus_level_t value,
+                                    uint8_t *mask, uint8_t *bits)
+{
+    sdi_cpld_pin_t *cpld_pin = (sdi_cpld_pin_t *) pin_hdl;
+
+    STD_BIT_SET(*mask, (cpld_pin->offset));
+
+    if (pin_hdl->default_polarity == SDI_PIN_POLARITY_NORMAL) {
+        /* When pin's polarity is normal,
+        * - if pin level to be set is high, set the cpld pin offset in cpld
+        * register (bits)
+        * - if the pin level to be set is low, clear the cpld pin offset in cpld
+        * register (bits)
+        */
+        (value == SDI_PIN_LEVEL_HIGH) ?
+        STD_BIT_SET(*bits, (cpld_pin->offset)) :
+            STD_BIT_CLEAR(*bits, (cpld_pin->offset));
+    } else {
+        /* When pin's polarity is inverted,
+        * - if pin level to be set is high, clear the cpld pin offset in cpld
+        * register (bits)
+        * - if the pin level to be set is low, set the cpld pin offset in cpld
+        * register (bits)
+        */
+        (value == SDI_PIN_LEVEL_HIGH) ?
+        STD_BIT_CLEAR(*bits, (cpld_pin->offset)) :
+            STD_BIT_SET(*bits, (cpld_pin->offset));
+    }
+}
+
 /*
  * Update the cpld pin level with given value
  * sequence of operation:
- * 1. Read cpld register using bus read operation.
- * 2. Mask the register value with bit corresponding to cpld pin and set bit with
- * given input level
- * 3. Write new value onto cpld register
+ * 1. Set the bit corresponding to cpld pin with given input level
+ * 2. Update the bit in cpld register, the register is read first unless it
+ * has a shadow copy (see sdi_cpld_reg_update)
  * param[in] pin_hdl cpld pin handle
  * param[in] value cpld pin level to be written
  * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
@@ -115,9 +158,8 @@ static t_std_error sdi_cpld_pin_write_level(sdi_pin_bus_hdl_t pin_hdl,
 {
     sdi_cpld_pin_t *cpld_pin = (sdi_cpld_pin_t *) pin_hdl;
     sdi_device_hdl_t dev_hdl = cpld_pin->cpld_hdl;
-    sdi_bus_hdl_t bus_hdl = (sdi_bus_hdl_t) dev_hdl->bus_hdl;
-    uint8_t buffer = 0;
-    t_std_error error = STD_ERR_OK;
+    uint8_t mask = 0;
+    uint8_t bits = 0;
     sdi_cpld_dev_hdl_t cpld_dev_hdl = (sdi_cpld_dev_hdl_t) dev_hdl->private_data;
 
     STD_ASSERT(cpld_dev_hdl->width == SDI_CPLD_DEFAULT_REGISTER_WIDTH);
@@ -128,41 +170,10 @@ static t_std_error sdi_cpld_pin_write_level(sdi_pin_bus_hdl_t pin_hdl,
         return SDI_DEVICE_ERRCODE(ENOTSUP);
     }
 
-    /* Read the cpld register (on which this cpld pin is just a bit)
-     * value to buffer */
-    error = sdi_bus_read_byte(bus_hdl, dev_hdl->addr,
-                             cpld_pin->addr, &buffer);
-    if (error != STD_ERR_OK) {
-        return error;
-    }
-
-    if (pin_hdl->default_polarity == SDI_PIN_POLARITY_NORMAL) {
-        /* When pin's polarity is normal,
-        * - if pin level to be set is high, set the cpld pin offset in cpld
-        * register (buffer)
-        * - if the pin level to be set is low, clear the cpld pin offset in cpld
-        * register (buffer)
-        */
-        (value == SDI_PIN_LEVEL_HIGH) ?
-        STD_BIT_SET(buffer, (cpld_pin->offset)) :
-            STD_BIT_CLEAR(buffer, (cpld_pin->offset));
-    } else {
-        /* When pin's polarity is inverted,
-        * - if pin level to be set is high, clear the cpld pin offset in cpld
-        * register (buffer)
-        * - if the pin level to be set is low, set the cpld pin offset in cpld
-        * register (buffer)
-        */
-        (value == SDI_PIN_LEVEL_HIGH) ?
-        STD_BIT_CLEAR(buffer, (cpld_pin->offset)) :
-            STD_BIT_SET(buffer, (cpld_pin->offset));
-    }
+    sdi_cpld_pin_level_bits(pin_hdl, value, &mask, &bits);
 
-    /* Write the modified value of cpld regiter to effect the pin level
-     * change */
-    error = sdi_bus_write_byte(bus_hdl, dev_hdl->addr,
-                              cpld_pin->addr, buffer);
-    return error;
+    /* Update the cpld register to effect the pin level change */
+    return sdi_cpld_reg_update(dev_hdl, cpld_pin->addr, mask, bits);
 }
 
 /*
@@ -225,6 +236,79 @@ static sdi_pin_bus_ops_t sdi_cpld_pin_ops = {
     .sdi_pin_bus_get_polarity = sdi_cpld_pin_get_polarity,
 };
 
+/*
+ * Update the level of several cpld output pins, pins on the same cpld
+ * register are updated with a single register write
+ * param[in] pins - cpld pin handles
+ * param[in] levels - level to be written, per pin
+ * param[in] count - no. of pins
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO of the first failed register
+ * write, SDI_DEVICE_ERRCODE(ENOTSUP) when a pin is not a cpld output pin
+ */
+t_std_error sdi_cpld_pin_write_levels(sdi_pin_bus_hdl_t *pins,
+                                      const sdi_pin_bus_level_t *levels,
+                                      uint_t count)
+{
+    sdi_cpld_pin_t *cpld_pin = NULL;
+    sdi_cpld_pin_t *other_pin = NULL;
+    sdi_cpld_dev_hdl_t cpld_dev_hdl = NULL;
+    uint8_t *done = NULL;
+    uint8_t mask = 0;
+    uint8_t bits = 0;
+    uint_t index = 0;
+    uint_t other = 0;
+    t_std_error error = STD_ERR_OK;
+    t_std_error rc = STD_ERR_OK;
+
+    STD_ASSERT((pins != NULL) || (count == 0));
+    STD_ASSERT((levels != NULL) || (count == 0));
+
+    for (index = 0; index < count; index++) {
+        if ((pins[index]->ops != &sdi_cpld_pin_ops)
+            || (pins[index]->default_direction != SDI_PIN_BUS_OUTPUT)) {
+            return SDI_DEVICE_ERRCODE(ENOTSUP);
+        }
+    }
+
+    if (count == 0) {
+        return STD_ERR_OK;
+    }
+    done = (uint8_t *) calloc(count, sizeof(uint8_t));
+    STD_ASSERT(done != NULL);
+
+    for (index = 0; index < count; index++) {
+        if (done[index]) {
+            continue;
+        }
+        cpld_pin = (sdi_cpld_pin_t *) pins[index];
+        mask = 0;
+        bits = 0;
+        /* merge every later pin on the same cpld register */
+        for (other = index; other < count; other++) {
+            other_pin = (sdi_cpld_pin_t *) pins[other];
+            if ((done[other]) || (other_pin->cpld_hdl != cpld_pin->cpld_hdl)
+                || (other_pin->addr != cpld_pin->addr)) {
+                continue;
+            }
+            sdi_cpld_pin_level_bits(pins[other], levels[other], &mask, &bits);
+            done[other] = 1;
+            if (other != index) {
+                cpld_dev_hdl = (sdi_cpld_dev_hdl_t) cpld_pin->cpld_hdl->private_data;
+                std_mutex_lock(&cpld_dev_hdl->shadow_lock);
+                cpld_dev_hdl->shadow_stats.coalesced++;
+                std_mutex_unlock(&cpld_dev_hdl->shadow_lock);
+            }
+        }
+        rc = sdi_cpld_reg_update(cpld_pin->cpld_hdl, cpld_pin->addr, mask, bits);
+        if ((rc != STD_ERR_OK) && (error == STD_ERR_OK)) {
+            error = rc;
+        }
+    }
+
+    free(done);
+    return error;
+}
+
 /*
  * Initialize cpld ouput pin to configured default level
  * param[in] bus_hdl - cpld pin bus handle
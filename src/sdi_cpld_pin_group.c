@@ -51,343 +51,381 @@
 #include <string.h>
 #include <stdlib.h>
 
-/* Mask given 'bitfield' with bits from 'start_offset' to 'end_offset' */
-#define SDI_CPLD_BIT_MASK(bitfield, start_offset, end_offset) \
-    bitfield &= ((1 << ((end_offset - start_offset) + 1)) - 1);
+/* cpld pin group operations object */
+static sdi_pin_group_bus_ops_t sdi_cpld_pin_group_ops;
 
-/* Toggle 'dst_target' bitstream of given 'type' and mask with bits from
- * 'start_bit_offset' and 'end_bit_offset'
- */
-#define SDI_CPLD_TOGGLE_AND_MASK(type, dst_target, start_bit_offset, end_bit_offset) \
-do { \
-    dst_target = (((type)~dst_target) & ((1 << ((end_bit_offset - start_bit_offset) + 1)) - 1)); \
-} while (0)
+/* Max no. of registers read at once for several pin groups, one i2c block */
+#define SDI_CPLD_PIN_GROUP_MAX_WINDOW  (32)
 
 /*
- * Read configured pin group level.
- * sequence of operation:
- * 1. set dec_counter_flag to 1 if start_addr of cpld pin group is greater than
- * end_addr. Set offset to start_addr
- * 2. Read cpld register at'offset'u'sing bus read api (starting from start_addr) onto buffer
- * 3. Read the register value with bits from : start_offset (applicable only while
- * reading start_addr, to end_offset (applicable only while reading end_addr or
- * while reading start_addr and the number of registers in pin group is 1) by masking
- * other bits
- * data = buffer with just bits from (start_offset to end offset)
- * 4. If the polarity is inverted, valid data is inverted.
- * 5. If the cpld register is not start_addr, left shift data by 8bits.
- * 5. Update level with data.
- * level |= data
- * 7. Increment offset if dec_counter_flag is not set, otherwise decrement offset.
- * 6. Repeat steps from 2 to 5 until end_addr of cpld pin group is read.
- * param[in] pin_group_hdl - pin group bus handle
- * param[in] value - configured pin group level
- * return STD_ERR_OK on success, SDI_DEVICE_ERRNO no failure
+ * Compile the bit plan of a cpld pin group: for every register from
+ * start_addr to end_addr, the register bits holding pin group bits and their
+ * position in the pin group level. Bits start_offset of start_addr upto
+ * end_offset of end_addr form the level, least significant bit first.
+ *  ---------------------------------------------------------
+ *  | end_addr | start_addr + 2 | start_addr + 1 | start_addr |
+ *  |          |                |                |            |
+ *  |   byte4  |     byte3      |     byte2      |   byte1    |
+ *  ---------------------------------------------------------
+ * or, when end_addr < start_addr, start_addr - 1 and start_addr - 2.
+ * param[inout] cpld_pin_group - cpld pin group, with addresses, offsets and
+ * polarity configured
+ * return none
  */
-static t_std_error sdi_cpld_pin_group_read_level (sdi_pin_group_bus_hdl_t pin_group_hdl,
-                                                  uint_t *value)
+static void sdi_cpld_pin_group_plan_compile(sdi_cpld_pin_group_t *cpld_pin_group)
 {
-    sdi_cpld_pin_group_t *cpld_pin_group = (sdi_cpld_pin_group_t *) pin_group_hdl;
-    sdi_device_hdl_t dev_hdl = cpld_pin_group->cpld_hdl;
-    sdi_bus_hdl_t bus_hdl = (sdi_bus_hdl_t) dev_hdl->bus_hdl;
-    uint8_t buffer = 0;
-    uint8_t data = 0;
-    t_std_error error = STD_ERR_OK;
-    uint_t level = 0;
-    uint_t offset = 0;
+    sdi_cpld_bit_step_t *step = NULL;
     uint_t reg_count = 0;
-    uint_t dec_counter_flag = 0;
-    uint_t start_offset = cpld_pin_group->start_offset;
-    uint_t end_offset = cpld_pin_group->end_offset;
-    sdi_cpld_dev_hdl_t cpld_dev_hdl = (sdi_cpld_dev_hdl_t) dev_hdl->private_data;
+    uint_t low_bit = 0;
+    uint_t high_bit = 0;
+    uint_t width = 0;
 
-    STD_ASSERT(cpld_dev_hdl->width == SDI_CPLD_DEFAULT_REGISTER_WIDTH);
+    STD_ASSERT(cpld_pin_group->length <= SDI_CPLD_PIN_GROUP_MAX_REGS);
+    STD_ASSERT(cpld_pin_group->start_offset < BITS_PER_BYTE);
+    STD_ASSERT(cpld_pin_group->end_offset < BITS_PER_BYTE);
 
-    /* CPLD pin group can span across more than one cpld register in which case:
-     * start_addr marks Least Significant Byte register address in pin group and
-     * end_addr marks Most Significant Byte) register address in pin group.
-     * If end_addr > start_addr, value read from cpld pin group will reflect below:
-     *  ---------------------------------------------------------
-     *  | end_addr | start_addr + 2 | start_addr + 1 | start_addr |
-     *  |          |                |                |            |
-     *  |   byte4  |     byte3      |     byte2      |   byte1    |
-     *  ---------------------------------------------------------
-     * or
-     * If end_addr < start_addr, value read from cpld pin group will reflect below:
-     *  ---------------------------------------------------------
-     *  | end_addr | start_addr - 2 | start_addr - 1 | start_addr |
-     *  |          |                |                |            |
-     *  |   byte4  |     byte3      |     byte2      |   byte1    |
-     *  ---------------------------------------------------------
-     * Main Logic:
-     * Read byte1 from cpld using bus read api and store it in data.
-     * Update level = data.
-     * Read byte2 from cpld using bus read api and store it in data.
-     * Update level |= data << 8
-     * Repeat above until all 4 bytes are read.
-     */
-
-
-    /* Set offset to start_addr. */
-    offset = cpld_pin_group->start_addr;
-    /* Depending on platform configuration, start_addr can be greater or lesser
-     * than end_addr in pin group.
-     * if end_addr > start_addr, above offset needs to be decremented in below loop
-     * otherwise offset needs to be incremented
-     */
-    if (cpld_pin_group->start_addr >= cpld_pin_group->end_addr) {
-        dec_counter_flag = 1;
-    }
-
-    /* Loop: until we read all cpld registers (indicated by length) in pin group */
-    for (reg_count = 1; reg_count <= cpld_pin_group->length; reg_count++) {
-        /* Read the cpld register (that's part of pin group) value to buffer */
-        error = sdi_bus_read_byte(bus_hdl, dev_hdl->addr, offset, &buffer);
-        if (error != STD_ERR_OK) {
-            return error;
-        }
-        /* case a) For first and only cpld register(start_addr: byte1 as in figure) in pin group
-         * (first and last are same), mask buffer with start_offset to end_offset and
-         * store it in data. If polarity is inverted, toggle the data bits (only
-         * between start_offset and end_offset */
-        if (cpld_pin_group->length == 1) {
-            data = (buffer >> (cpld_pin_group->start_offset));
-            SDI_CPLD_BIT_MASK(data, start_offset, end_offset);
-            if (pin_group_hdl->default_polarity == SDI_PIN_POLARITY_INVERTED) {
-                SDI_CPLD_TOGGLE_AND_MASK(uint_t, data, start_offset, end_offset);
-            }
-            /* Store the cpld register onto level*/
-            level = data;
-        } else {
-            if (reg_count == cpld_pin_group->length) {
-                /* case c) For last cpld register in pin group(end_addr: byte4),
-                 * mask buffer with start_offset to cpld register bit length
-                 * (BITS_PER_BYTE) and store it in data.If polarity is inverted,
-                 * toggle the data bits (only between start_offset and
-                 * BITS_PER_BYTE.*/
-                data = buffer & ( (1 << (cpld_pin_group->end_offset + 1)) - 1 );
-                if (pin_group_hdl->default_polarity == SDI_PIN_POLARITY_INVERTED) {
-                    SDI_CPLD_TOGGLE_AND_MASK(uint_t, data, 0, end_offset);
-                }
-                /* Left Shift the data to last byte position and Accumulate the
-                 * result in level */
-                level |= (data << ((reg_count - 1) * BITS_PER_BYTE));
-
-                /* Shift the accumulated register value by start_offset */
-                level = level >> start_offset;
-            } else if (reg_count == 1) {
-                /* case b) For first cpld register in pin group(start_addr:
-                 * byte1), mask buffer with start_offset to cpld register bit
-                 * length (BITS_PER_BYTE) and store it in data. If polarity is
-                 * inverted, toggle the data bits (only between start_offset
-                 * and BITS_PER_BYTE. */
-                data = buffer;
-                if (pin_group_hdl->default_polarity == SDI_PIN_POLARITY_INVERTED) {
-                    SDI_CPLD_TOGGLE_AND_MASK(uint_t, data, start_offset, (BITS_PER_BYTE -1));
-                }
-                /* Store data to Level */
-                level = data;
-            } else  {
-                /* case d) For the cpld register (!first and !last) in pin
-                 * group(byte2 and byte3), set data to buffer. If polarity is
-                 * inverted, toggle the data bits. */
-                data = buffer;
-                if (pin_group_hdl->default_polarity == SDI_PIN_POLARITY_INVERTED) {
-                    SDI_CPLD_TOGGLE_AND_MASK(uint_t, data, 0, (BITS_PER_BYTE - 1));
-                }
-                 /*Left shift data based on byte position * 8 and accumulate it to level */
-                level |= (data << ((reg_count -1) * BITS_PER_BYTE));
-            }
-        }
-        /* if end_addr > start_addr, offset needs to be decremented
-         * otherwise offset needs to be incremented
-         */
-        if (dec_counter_flag) {
-            offset--;
+    for (reg_count = 0; reg_count < cpld_pin_group->length; reg_count++) {
+        step = &cpld_pin_group->plan[reg_count];
+        if (cpld_pin_group->start_addr > cpld_pin_group->end_addr) {
+            step->addr = cpld_pin_group->start_addr - reg_count;
         } else {
-            offset++;
+            step->addr = cpld_pin_group->start_addr + reg_count;
         }
+        low_bit = (reg_count == 0) ? cpld_pin_group->start_offset : 0;
+        high_bit = (reg_count == (cpld_pin_group->length - 1)) ?
+            cpld_pin_group->end_offset : (BITS_PER_BYTE - 1);
+        STD_ASSERT(low_bit <= high_bit);
+
+        step->mask = (uint8_t) ((1 << ((high_bit - low_bit) + 1)) - 1);
+        step->reg_shift = (uint8_t) low_bit;
+        step->level_shift = (uint8_t) width;
+        width += (high_bit - low_bit) + 1;
+    }
+    STD_ASSERT(width <= SDI_CPLD_PIN_GROUP_MAX_BITS);
+
+    cpld_pin_group->width = width;
+    cpld_pin_group->low_addr = (cpld_pin_group->start_addr > cpld_pin_group->end_addr) ?
+        cpld_pin_group->end_addr : cpld_pin_group->start_addr;
+    cpld_pin_group->invert_mask = 0;
+    if (cpld_pin_group->bus.default_polarity == SDI_PIN_POLARITY_INVERTED) {
+        cpld_pin_group->invert_mask = (width == SDI_CPLD_PIN_GROUP_MAX_BITS) ?
+            ~((uint64_t) 0) : ((((uint64_t) 1) << width) - 1);
     }
-    /* Set the cpld pin group register value to value */
-    *value = level;
-    return error;
 }
 
 /*
- * Make 'src_bit_stream' part of 'dst_target' starting from start_bit_offset to
- * end_bit_offset
- * Ex: With dst_target 0xFFFF33FF, src_bit_stream 0x11, start_bit_offset 8,
- * end_bit_offset 16 as inputs, this function will modify dst_target to 0xFFFF11FF
- *
- * @param[in] dst_target : value that has to be modified
- * @param[in] src_bit_stream: value to be set in dst_target between
- * start_bit_offset and end_bit_offset
- * @param[in] start_bit_offset : start offset (counting from 0) at which
- *  src_bit_stream needs to be set in dst_target.
- * @param[in] end_bit_offset : end offset (counting from 0) till which
- * src_bit_stream needs to be set in dst_target.
- * @return dst_target modified with 'src_bit_stream' set between
- * 'start_bit_offset' and 'end_bit_offset'
+ * Run the bit plan of a cpld pin group on register values
+ * param[in] cpld_pin_group - cpld pin group
+ * param[in] window - register values, window[0] from register base
+ * param[in] base - register address of window[0]
+ * return pin group level
  */
-uint64_t sdi_cpld_bit_set_sub_bitstream(uint64_t dst_target, uint64_t src_bit_stream,
-                                        uint64_t start_bit_offset,
-                                        uint64_t end_bit_offset)
+static uint64_t sdi_cpld_pin_group_plan_read(const sdi_cpld_pin_group_t *cpld_pin_group,
+                                             const uint8_t *window, uint_t base)
 {
-    uint64_t left = 0;
-    uint64_t right = 0;
-    uint64_t mask = 0;
+    const sdi_cpld_bit_step_t *step = cpld_pin_group->plan;
+    const sdi_cpld_bit_step_t *last = &cpld_pin_group->plan[cpld_pin_group->length];
+    uint64_t level = 0;
 
-    STD_ASSERT(start_bit_offset <= (sizeof(uint64_t) * BITS_PER_BYTE));
-    STD_ASSERT(end_bit_offset <= (sizeof(uint64_t) * BITS_PER_BYTE));
+    for (; step < last; step++) {
+        level |= ((uint64_t) ((window[step->addr - base] >> step->reg_shift)
+                              & step->mask)) << step->level_shift;
+    }
+    return level ^ cpld_pin_group->invert_mask;
+}
 
-    left = (((uint64_t)~0) - ((1 << end_bit_offset) - 1));
-    right = ((1 << start_bit_offset) - 1);
-    mask = (left | right);
+/*
+ * Read consecutive cpld registers from the cpld snapshot or in one i2c block
+ * transaction
+ * param[in] dev_hdl - cpld device handle
+ * param[in] base - first register address
+ * param[in] count - no. of registers
+ * param[out] window - register values, in address order
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when neither snapshot nor block read applies
+ */
+static t_std_error sdi_cpld_pin_group_read_window(sdi_device_hdl_t dev_hdl, uint_t base,
+                                                  uint_t count, uint8_t *window)
+{
+    t_std_error error = STD_ERR_OK;
 
-    return (dst_target & mask) | (src_bit_stream << start_bit_offset);
+    error = sdi_cpld_snapshot_read(dev_hdl, base, count, window);
+    if ((error == SDI_DEVICE_ERRCODE(ENOTSUP)) && (count > 1)) {
+        error = sdi_cpld_block_read(dev_hdl, base, count, window);
+    }
+    return error;
 }
 
+/*
+ * Read consecutive cpld registers one at a time.
+ * param[in] dev_hdl - cpld device handle
+ * param[in] base - first register address
+ * param[in] count - no. of registers
+ * param[out] window - register values, in address order
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+static t_std_error sdi_cpld_pin_group_read_regs(sdi_device_hdl_t dev_hdl, uint_t base,
+                                                uint_t count, uint8_t *window)
+{
+    sdi_bus_hdl_t bus_hdl = (sdi_bus_hdl_t) dev_hdl->bus_hdl;
+    t_std_error error = STD_ERR_OK;
+    uint_t index = 0;
+
+    for (index = 0; index < count; index++) {
+        error = sdi_bus_read_byte(bus_hdl, dev_hdl->addr, base + index, &window[index]);
+        if (error != STD_ERR_OK) {
+            return error;
+        }
+    }
+    return STD_ERR_OK;
+}
 
 /*
- * Update the cpld pin group level with given value
- * Sequence of operation is same as in sdi_cpld_pin_group_read_level, except
- * that value to be set on to pin group is additionlly masked as per start_offset
- * and end_offset and the cpld register is updated by using bus write api.
+ * Read the level of a cpld pin group of upto SDI_CPLD_PIN_GROUP_MAX_BITS.
+ * sequence of operation:
+ * 1. Read the cpld registers of pin group onto window, from cpld snapshot or
+ * in one block transaction when supported, one register at a time otherwise.
+ * 2. Run the bit plan of pin group on window, which extracts the pin group
+ * bits of every register and toggles them when polarity is inverted.
  * param[in] pin_group_hdl - cpld pin group handle
- * param[in] value - level to be configured on cpld pin group
+ * param[out] value - pin group level
  * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
- * SDI_DEVICE_ERRCODE(ENOTSUP) if un-supported
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when not a cpld pin group
  */
-static t_std_error sdi_cpld_pin_group_write_level (sdi_pin_group_bus_hdl_t pin_group_hdl,
-                                                   uint_t value)
+t_std_error sdi_cpld_pin_group_read_wide(sdi_pin_group_bus_hdl_t pin_group_hdl,
+                                         uint64_t *value)
 {
     sdi_cpld_pin_group_t *cpld_pin_group = (sdi_cpld_pin_group_t *) pin_group_hdl;
-    sdi_device_hdl_t dev_hdl = cpld_pin_group->cpld_hdl;
-    sdi_bus_hdl_t bus_hdl = (sdi_bus_hdl_t) dev_hdl->bus_hdl;
-    uint8_t buffer = 0;
-    uint8_t level = 0;
-    uint_t data = value;
+    sdi_device_hdl_t dev_hdl = NULL;
+    sdi_cpld_dev_hdl_t cpld_dev_hdl = NULL;
+    uint8_t window[SDI_CPLD_PIN_GROUP_MAX_REGS];
     t_std_error error = STD_ERR_OK;
-    uint_t offset = 0;
-    uint_t reg_count = 0;
-    uint_t dec_counter_flag = 0;
-    uint64_t start_offset = (uint64_t) cpld_pin_group->start_offset;
-    uint64_t end_offset = (uint64_t) cpld_pin_group->end_offset;
-    sdi_cpld_dev_hdl_t cpld_dev_hdl = (sdi_cpld_dev_hdl_t) dev_hdl->private_data;
 
+    STD_ASSERT(pin_group_hdl != NULL);
+    STD_ASSERT(value != NULL);
+    if (pin_group_hdl->ops != &sdi_cpld_pin_group_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    dev_hdl = cpld_pin_group->cpld_hdl;
+    cpld_dev_hdl = (sdi_cpld_dev_hdl_t) dev_hdl->private_data;
     STD_ASSERT(cpld_dev_hdl->width == SDI_CPLD_DEFAULT_REGISTER_WIDTH);
 
-    /* CPLD pin group can span across more than one cpld register in which case:
-     * start_addr marks Least Significant Byte register address in pin group and
-     * end_addr marks Most Significant Byte) register address in pin group.
-     * If end_addr > start_addr, value(byte4 : byte3: byte2: byte1) Written to
-     * cpld pin group will reflect below:
-     *  ---------------------------------------------------------
-     *  | end_addr | start_addr + 2 | start_addr + 1 | start_addr |
-     *  |          |                |                |            |
-     *  |   byte4  |     byte3      |     byte2      |   byte1    |
-     *  ---------------------------------------------------------
-     * or
-     * If end_addr < start_addr, value read from cpld pin group will reflect below:
-     *  ---------------------------------------------------------
-     *  | end_addr | start_addr - 2 | start_addr - 1 | start_addr |
-     *  |          |                |                |            |
-     *  |   byte4  |     byte3      |     byte2      |   byte1    |
-     *  ---------------------------------------------------------
-     * Main Logic:
-     * Set data = value (to be written to cpld pin group)
-     * Read a byte from start_addr of cpld using bus read api and store it in
-     * buffer. Mask last byte of data and bit-wise & with buffer, write it to
-     * cpld start_addr.
-     * Read next byte from cpld using bus read api and store it in buffer. Shift
-     * data by a byte, mask last byte of data and bit-wise & with buffer, write
-     * it to cpld next address.
-     * Repeat above until all bytes are updated.
-     */
-
-    /* Set offset to start_addr.*/
-    offset = cpld_pin_group->start_addr;
-    if (cpld_pin_group->start_addr >= cpld_pin_group->end_addr) {
-        /* Depending on platform configuration, start_addr can be greater or lesser
-         * than end_addr in pin group.
-         * if end_addr > start_addr, above offset needs to be decremented in below loop
-         * otherwise offset needs to be incremented
-         */
-        dec_counter_flag = 1;
+    error = sdi_cpld_pin_group_read_window(dev_hdl, cpld_pin_group->low_addr,
+                                           cpld_pin_group->length, window);
+    if (error == SDI_DEVICE_ERRCODE(ENOTSUP)) {
+        error = sdi_cpld_pin_group_read_regs(dev_hdl, cpld_pin_group->low_addr,
+                                             cpld_pin_group->length, window);
+    }
+    if (error != STD_ERR_OK) {
+        return error;
     }
 
-    /* Loop: until all cpld registers of pin group are written */
-    for (reg_count = cpld_pin_group->length; reg_count != 0; reg_count--) {
-        /* Read the cpld register at offset into buffer. */
-        error = sdi_bus_read_byte(bus_hdl, dev_hdl->addr, offset, &buffer);
-        if (error != STD_ERR_OK) {
-            return error;
+    *value = sdi_cpld_pin_group_plan_read(cpld_pin_group, window,
+                                          cpld_pin_group->low_addr);
+    return STD_ERR_OK;
+}
+
+/*
+ * Read configured pin group level, low 32 bits of the level for wider pin
+ * groups (see sdi_cpld_pin_group_read_wide)
+ * param[in] pin_group_hdl - pin group bus handle
+ * param[in] value - configured pin group level
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO no failure
+ */
+static t_std_error sdi_cpld_pin_group_read_level (sdi_pin_group_bus_hdl_t pin_group_hdl,
+                                                  uint_t *value)
+{
+    uint64_t level = 0;
+    t_std_error error = STD_ERR_OK;
+
+    error = sdi_cpld_pin_group_read_wide(pin_group_hdl, &level);
+    if (error != STD_ERR_OK) {
+        return error;
+    }
+    /* Set the cpld pin group register value to value */
+    *value = (uint_t) level;
+    return error;
+}
+
+/*
+ * Read the level of several cpld pin groups. The registers spanned by pin
+ * groups of the same cpld are read at once, from cpld snapshot or in one block
+ * transaction of upto SDI_CPLD_PIN_GROUP_MAX_WINDOW registers; pin groups are
+ * read one by one when neither applies.
+ * param[in] pin_group_hdls - cpld pin group handles
+ * param[out] values - level, per pin group
+ * param[in] count - no. of pin groups
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO of the first failed read,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when a pin group is not a cpld pin group
+ */
+t_std_error sdi_cpld_pin_group_read_levels(sdi_pin_group_bus_hdl_t *pin_group_hdls,
+                                           uint64_t *values, uint_t count)
+{
+    sdi_cpld_pin_group_t *cpld_pin_group = NULL;
+    sdi_cpld_pin_group_t *other_group = NULL;
+    uint8_t window[SDI_CPLD_PIN_GROUP_MAX_WINDOW];
+    uint8_t *done = NULL;
+    uint_t low = 0;
+    uint_t high = 0;
+    uint_t other_low = 0;
+    uint_t other_high = 0;
+    uint_t index = 0;
+    uint_t other = 0;
+    t_std_error error = STD_ERR_OK;
+    t_std_error rc = STD_ERR_OK;
+
+    STD_ASSERT((pin_group_hdls != NULL) || (count == 0));
+    STD_ASSERT((values != NULL) || (count == 0));
+
+    for (index = 0; index < count; index++) {
+        if (pin_group_hdls[index]->ops != &sdi_cpld_pin_group_ops) {
+            return SDI_DEVICE_ERRCODE(ENOTSUP);
+        }
+    }
+
+    if (count == 0) {
+        return STD_ERR_OK;
+    }
+    done = (uint8_t *) calloc(count, sizeof(uint8_t));
+    STD_ASSERT(done != NULL);
+
+    for (index = 0; index < count; index++) {
+        if (done[index]) {
+            continue;
         }
-        /* Fetch the value to be written to the cpld register 'offset' */
-        level = data & 0xFF;
-        /* case a) For first and only cpld register (start_addr: byte1)
-         * in pin group, mask last byte of data (level) and bit-wise & with buffer,
-         * If polarity is inverted, toggle the last byte of data (level)
-         * bits between start_offset and end_offset.
-         */
-        if (cpld_pin_group->length == 1) {
-            if (pin_group_hdl->default_polarity == SDI_PIN_POLARITY_INVERTED) {
-                SDI_CPLD_TOGGLE_AND_MASK(uint8_t, level, start_offset, end_offset);
+        cpld_pin_group = (sdi_cpld_pin_group_t *) pin_group_hdls[index];
+
+        /* registers spanned by the pin groups of this cpld, as long as they
+           fit in one window. Pin groups left out get a window of their own */
+        low = cpld_pin_group->low_addr;
+        high = low + cpld_pin_group->length - 1;
+        for (other = index + 1; other < count; other++) {
+            other_group = (sdi_cpld_pin_group_t *) pin_group_hdls[other];
+            if ((done[other]) || (other_group->cpld_hdl != cpld_pin_group->cpld_hdl)) {
+                continue;
             }
-            buffer = (uint8_t) sdi_cpld_bit_set_sub_bitstream((uint64_t)buffer, (uint64_t)level, start_offset, (end_offset + 1));
-        } else {
-            if (reg_count == cpld_pin_group->length) {
-                /* case b) For first cpld register (start_addr: byte1)
-                 * in pin group, mask last byte of data (level) and bit-wise & with buffer
-                 * If polarity is inverted, toggle the last byte of data (level)
-                 * bits between start_offset and BITS_PER_BYTE.
-                 */
-                if (pin_group_hdl->default_polarity == SDI_PIN_POLARITY_INVERTED) {
-                    SDI_CPLD_TOGGLE_AND_MASK(uint8_t, level, start_offset, (BITS_PER_BYTE - 1));
-                }
-                buffer = (uint8_t) sdi_cpld_bit_set_sub_bitstream((uint64_t)buffer, (uint64_t)level, start_offset, BITS_PER_BYTE);
+            other_low = (other_group->low_addr < low) ? other_group->low_addr : low;
+            other_high = other_group->low_addr + other_group->length - 1;
+            if (other_high < high) {
+                other_high = high;
             }
-            else if (reg_count == 1) {
-                /* case c) For last cpld register (end_addr: byte4)
-                 * in pin group, mask MSB of data (level) and bit-wise & with buffer
-                 * If polarity is inverted, toggle the level from first bit till
-                 * end_offset
-                 */
-                if (pin_group_hdl->default_polarity == SDI_PIN_POLARITY_INVERTED) {
-                    SDI_CPLD_TOGGLE_AND_MASK(uint8_t, level, 0, end_offset);
-                }
-                buffer = (uint8_t)
-                sdi_cpld_bit_set_sub_bitstream((uint64_t)buffer, (uint64_t)level, 0, (end_offset + 1));
-            } else  {
-                /* case d) For and !first !last cpld register (say byte2)
-                 * in pin group, mask second byte of data (level) and bit-wise & with buffer
-                 * If polarity is inverted, toggle all the bits of level
-                 */
-                if (pin_group_hdl->default_polarity == SDI_PIN_POLARITY_INVERTED) {
-                    level = ~level;
+            if (((other_high - other_low) + 1) <= SDI_CPLD_PIN_GROUP_MAX_WINDOW) {
+                low = other_low;
+                high = other_high;
+            }
+        }
+
+        rc = sdi_cpld_pin_group_read_window(cpld_pin_group->cpld_hdl, low,
+                                            (high - low) + 1, window);
+        for (other = index; other < count; other++) {
+            other_group = (sdi_cpld_pin_group_t *) pin_group_hdls[other];
+            if ((done[other]) || (other_group->cpld_hdl != cpld_pin_group->cpld_hdl)
+                || (other_group->low_addr < low)
+                || ((other_group->low_addr + other_group->length - 1) > high)) {
+                continue;
+            }
+            done[other] = 1;
+            if (rc == SDI_DEVICE_ERRCODE(ENOTSUP)) {
+                rc = sdi_cpld_pin_group_read_wide(pin_group_hdls[other], &values[other]);
+                if ((rc != STD_ERR_OK) && (error == STD_ERR_OK)) {
+                    error = rc;
                 }
-                buffer = (uint8_t) sdi_cpld_bit_set_sub_bitstream((uint64_t)buffer, (uint64_t)level, 0, BITS_PER_BYTE);
+                rc = SDI_DEVICE_ERRCODE(ENOTSUP);
+            } else if (rc == STD_ERR_OK) {
+                values[other] = sdi_cpld_pin_group_plan_read(other_group, window, low);
+            } else if (error == STD_ERR_OK) {
+                error = rc;
             }
         }
-        /* Write modified value of buffer to cpld offset */
-        error = sdi_bus_write_byte(bus_hdl, dev_hdl->addr, offset, buffer);
+    }
+
+    free(done);
+    return error;
+}
+
+/*
+ * Update the level of a cpld pin group of upto SDI_CPLD_PIN_GROUP_MAX_BITS.
+ * Runs the bit plan of pin group: the level, toggled when polarity is
+ * inverted, is split into the pin group bits of every register, which are
+ * updated by sdi_cpld_reg_update (register read first unless it has a shadow
+ * copy), from start_addr to end_addr.
+ * param[in] pin_group_hdl - cpld pin group handle
+ * param[in] value - pin group level
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when not a cpld pin group
+ */
+t_std_error sdi_cpld_pin_group_write_wide(sdi_pin_group_bus_hdl_t pin_group_hdl,
+                                          uint64_t value)
+{
+    sdi_cpld_pin_group_t *cpld_pin_group = (sdi_cpld_pin_group_t *) pin_group_hdl;
+    const sdi_cpld_bit_step_t *step = NULL;
+    const sdi_cpld_bit_step_t *last = NULL;
+    sdi_device_hdl_t dev_hdl = NULL;
+    sdi_cpld_dev_hdl_t cpld_dev_hdl = NULL;
+    uint64_t data = 0;
+    t_std_error error = STD_ERR_OK;
+
+    STD_ASSERT(pin_group_hdl != NULL);
+    if (pin_group_hdl->ops != &sdi_cpld_pin_group_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    dev_hdl = cpld_pin_group->cpld_hdl;
+    cpld_dev_hdl = (sdi_cpld_dev_hdl_t) dev_hdl->private_data;
+    STD_ASSERT(cpld_dev_hdl->width == SDI_CPLD_DEFAULT_REGISTER_WIDTH);
+
+    data = value ^ cpld_pin_group->invert_mask;
+    last = &cpld_pin_group->plan[cpld_pin_group->length];
+    for (step = cpld_pin_group->plan; step < last; step++) {
+        error = sdi_cpld_reg_update(dev_hdl, step->addr,
+                    (uint8_t) (step->mask << step->reg_shift),
+                    (uint8_t) (((data >> step->level_shift) & step->mask) << step->reg_shift));
         if (error != STD_ERR_OK) {
             return error;
         }
-        /* Right Shift data by 8bits to fetch next byte of value to be written */
-        data = data >> BITS_PER_BYTE;
-
-        /* if end_addr > start_addr, dec_counter_flag needs to be decremented
-         * otherwise offset needs to be incremented */
-        if (dec_counter_flag) {
-            offset--;
-        } else {
-            offset++;
-        }
     }
     return error;
 }
 
+/*
+ * Invalidate the register window snapshot of the cpld of a pin group
+ * param[in] pin_group_hdl - cpld pin group handle
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when not a cpld
+ * pin group
+ */
+t_std_error sdi_cpld_pin_group_refresh(sdi_pin_group_bus_hdl_t pin_group_hdl)
+{
+    sdi_cpld_pin_group_t *cpld_pin_group = (sdi_cpld_pin_group_t *) pin_group_hdl;
+    sdi_cpld_dev_hdl_t cpld_dev_hdl = NULL;
+
+    STD_ASSERT(pin_group_hdl != NULL);
+    if (pin_group_hdl->ops != &sdi_cpld_pin_group_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    cpld_dev_hdl = (sdi_cpld_dev_hdl_t) cpld_pin_group->cpld_hdl->private_data;
+
+    std_mutex_lock(&cpld_dev_hdl->shadow_lock);
+    cpld_dev_hdl->snapshot_valid = 0;
+    /* a refresh in progress may have read the old level */
+    cpld_dev_hdl->snapshot_gen++;
+    std_mutex_unlock(&cpld_dev_hdl->shadow_lock);
+    return STD_ERR_OK;
+}
+
+/*
+ * Update the cpld pin group level with given value. Bits of pin groups wider
+ * than 32 bits above the given value are cleared, use
+ * sdi_cpld_pin_group_write_wide for them.
+ * param[in] pin_group_hdl - cpld pin group handle
+ * param[in] value - level to be configured on cpld pin group
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) if un-supported
+ */
+static t_std_error sdi_cpld_pin_group_write_level (sdi_pin_group_bus_hdl_t pin_group_hdl,
+                                                   uint_t value)
+{
+    return sdi_cpld_pin_group_write_wide(pin_group_hdl, (uint64_t) value);
+}
+
 
 /*
  * CPLD pin group direction can't be changed.
@@ -573,6 +611,8 @@ static t_std_error sdi_cpld_pin_group_driver_register(std_config_node_t node,
     STD_ASSERT(node_attr != NULL);
     safestrncpy(pin_group_bus->bus.bus_name, node_attr, SDI_MAX_NAME_LEN);
 
+    sdi_cpld_pin_group_plan_compile(cpld_pin_group);
+
     std_mutex_lock_init_non_recursive(&(pin_group_bus->lock));
     pin_group_bus->ops = &sdi_cpld_pin_group_ops;
 
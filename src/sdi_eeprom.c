@@ -39,6 +39,7 @@
 #include "sdi_dell_eeprom.h"
 #include "sdi_extreme_eeprom.h"
 #include "sdi_i2c_bus_api.h"
+#include "sdi_i2c_arb.h"
 #include "std_assert.h"
 #include "sdi_bus_framework.h"
 #include "sdi_entity_info_resource_attr.h"
@@ -116,6 +117,7 @@ static t_std_error sdi_eeprom_read(const struct sdi_device_entry *hdl, uint_t of
     entity_info_device_t *eeprom_data = NULL;
     uint_t counter=0;
     t_std_error error=STD_ERR_OK;
+    sdi_i2c_prio_t prev_prio = SDI_I2C_PRIO_DEFAULT;
 
     if ((hdl == NULL) || (data == NULL))
     {
@@ -128,6 +130,9 @@ static t_std_error sdi_eeprom_read(const struct sdi_device_entry *hdl, uint_t of
         return SDI_ERRCODE(EINVAL);
     }
 
+    /* FRU reads are bulk, let control and monitoring transactions go first */
+    prev_prio = sdi_i2c_priority_set(SDI_I2C_PRIO_INVENTORY);
+
     switch (eeprom_data->entity_size)
     {
         case 16384: /* 128K bits*/
@@ -194,12 +199,17 @@ static t_std_error sdi_eeprom_read(const struct sdi_device_entry *hdl, uint_t of
             break;
 
         case 256:
-            return sdi_smbus_read_multi_byte(hdl->bus_hdl, hdl->addr.i2c_addr,
+            error = sdi_smbus_read_multi_byte(hdl->bus_hdl, hdl->addr.i2c_addr,
                     offset, data, len, SDI_I2C_FLAG_NONE);
+            break;
 
         default:
-            return SDI_DEVICE_ERRCODE(EINVAL);
+            error = SDI_DEVICE_ERRCODE(EINVAL);
+            break;
     }
+
+    sdi_i2c_priority_set(prev_prio);
+
     return error;
 }
 
@@ -42,6 +42,7 @@
 #include "sdi_common_attr.h"
 #include "sdi_fan_resource_attr.h"
 #include "sdi_i2c_bus_api.h"
+#include "sdi_i2c_arb.h"
 #include "sdi_device_common.h"
 #include "std_assert.h"
 #include "std_utils.h"
@@ -348,14 +349,14 @@ static uint16_t sdi_rpm_to_tach_count (emc2305_fan_data_t *fan_data, uint_t spee
 }
 
 /*
- * Callback function to set the speed of the fan referred by resource
+ * Write the speed of the fan referred by resource
  * Parameters:
  * resource_hdl[in] - callback data
  * speed[in]        - Speed to be set
  * Return           - STD_ERR_OK for success or the respective error code from
  *                    i2c API in case of failure
  */
-static t_std_error sdi_emc2305_fan_speed_set(void *resource_hdl, uint_t speed)
+static t_std_error sdi_emc2305_fan_speed_write(void *resource_hdl, uint_t speed)
 {
     uint_t fan_id = 0;
     uint8_t setting= 0;
@@ -431,6 +432,27 @@ static t_std_error sdi_emc2305_fan_speed_set(void *resource_hdl, uint_t speed)
     return rc;
 }
 
+/*
+ * Callback function to set the speed of the fan referred by resource
+ * Parameters:
+ * resource_hdl[in] - callback data
+ * speed[in]        - Speed to be set
+ * Return           - STD_ERR_OK for success or the respective error code from
+ *                    i2c API in case of failure
+ */
+static t_std_error sdi_emc2305_fan_speed_set(void *resource_hdl, uint_t speed)
+{
+    t_std_error rc = STD_ERR_OK;
+    sdi_i2c_prio_t prev_prio = SDI_I2C_PRIO_DEFAULT;
+
+    /* fan control must not wait behind bulk reads on the bus */
+    prev_prio = sdi_i2c_priority_set(SDI_I2C_PRIO_CONTROL);
+    rc = sdi_emc2305_fan_speed_write(resource_hdl, speed);
+    sdi_i2c_priority_set(prev_prio);
+
+    return rc;
+}
+
 /*
  * Callback function to retrieve the fault status of the fan referred by resource
  * it will check the stall, spin, drive fail status
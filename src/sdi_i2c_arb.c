@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_i2c_arb.c
+ */
+
+
+/******************************************************************************
+ * Implements the priority aware I2C bus arbiter and the per thread i2c
+ * priority class.
+ *****************************************************************************/
+
+#include "sdi_i2c_arb.h"
+#include "sdi_i2c_stats.h"
+#include "sdi_device_common.h"
+#include "std_assert.h"
+
+#include <pthread.h>
+#include <string.h>
+
+/**
+ * I2C priority class of calling thread
+ */
+static __thread sdi_i2c_prio_t sdi_i2c_cur_prio = SDI_I2C_PRIO_DEFAULT;
+
+/**
+ * sdi_i2c_priority_get
+ * Get the i2c priority class of calling thread
+ * return priority class
+ */
+sdi_i2c_prio_t sdi_i2c_priority_get(void)
+{
+    return sdi_i2c_cur_prio;
+}
+
+/**
+ * sdi_i2c_priority_set
+ * Set the i2c priority class of calling thread
+ * param[in] prio - priority class
+ * return previous priority class
+ */
+sdi_i2c_prio_t sdi_i2c_priority_set(sdi_i2c_prio_t prio)
+{
+    sdi_i2c_prio_t prev = sdi_i2c_cur_prio;
+
+    STD_ASSERT(prio < SDI_I2C_PRIO_MAX);
+
+    sdi_i2c_cur_prio = prio;
+    return prev;
+}
+
+/**
+ * sdi_i2c_arb_init
+ * Initialize a bus arbiter
+ * param[out] arb - bus arbiter
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE of pthread error otherwise
+ */
+t_std_error sdi_i2c_arb_init(sdi_i2c_arb_t *arb)
+{
+    pthread_condattr_t attr;
+    uint_t prio = 0;
+    int rc = 0;
+
+    STD_ASSERT(arb != NULL);
+
+    memset(arb, 0, sizeof(*arb));
+
+    rc = pthread_mutex_init(&arb->lock, NULL);
+    if (rc != 0) {
+        return SDI_DEVICE_ERRCODE(rc);
+    }
+
+    pthread_condattr_init(&attr);
+    for (prio = 0; (prio < SDI_I2C_PRIO_MAX) && (rc == 0); prio++) {
+        rc = pthread_cond_init(&arb->cond[prio], &attr);
+    }
+    pthread_condattr_destroy(&attr);
+
+    return (rc == 0) ? STD_ERR_OK : SDI_DEVICE_ERRCODE(rc);
+}
+
+/**
+ * sdi_i2c_arb_higher_waiting
+ * Check if a class higher than prio is waiting. Called with arbiter locked.
+ * param[in] arb - bus arbiter
+ * param[in] prio - priority class
+ * return true if a higher class is waiting
+ */
+static inline bool sdi_i2c_arb_higher_waiting(const sdi_i2c_arb_t *arb,
+                                              sdi_i2c_prio_t prio)
+{
+    uint_t higher = 0;
+
+    for (higher = prio + 1; higher < SDI_I2C_PRIO_MAX; higher++) {
+        if (arb->waiters[higher] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * sdi_i2c_arb_acquire
+ * Acquire the bus with the priority class of calling thread
+ * param[in] arb - bus arbiter
+ * param[out] prio - priority class used, can be NULL
+ * param[out] wait_ns - time spent waiting, can be NULL
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE of pthread error otherwise
+ */
+t_std_error sdi_i2c_arb_acquire(sdi_i2c_arb_t *arb, sdi_i2c_prio_t *prio,
+                                uint64_t *wait_ns)
+{
+    sdi_i2c_prio_t cur_prio = sdi_i2c_cur_prio;
+    uint64_t start_ns = sdi_i2c_stats_now_ns();
+    uint_t ticket = 0;
+    int rc = 0;
+
+    STD_ASSERT(arb != NULL);
+
+    rc = pthread_mutex_lock(&arb->lock);
+    if (rc != 0) {
+        return SDI_DEVICE_ERRCODE(rc);
+    }
+
+    if (arb->held || (arb->waiters[cur_prio] != 0)
+            || sdi_i2c_arb_higher_waiting(arb, cur_prio)) {
+        ticket = arb->next_ticket[cur_prio]++;
+        arb->waiters[cur_prio]++;
+        while (arb->held || (arb->serving[cur_prio] != ticket)
+                || sdi_i2c_arb_higher_waiting(arb, cur_prio)) {
+            pthread_cond_wait(&arb->cond[cur_prio], &arb->lock);
+        }
+        arb->waiters[cur_prio]--;
+        arb->serving[cur_prio]++;
+    }
+
+    arb->held = true;
+    arb->holder_prio = cur_prio;
+    arb->acquired_ns = sdi_i2c_stats_now_ns();
+
+    pthread_mutex_unlock(&arb->lock);
+
+    if (prio != NULL) {
+        *prio = cur_prio;
+    }
+    if (wait_ns != NULL) {
+        *wait_ns = arb->acquired_ns - start_ns;
+    }
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_i2c_arb_release
+ * Release the bus, handing it to the highest class waiting
+ * param[in] arb - bus arbiter
+ * return time the bus was held in nano seconds
+ */
+uint64_t sdi_i2c_arb_release(sdi_i2c_arb_t *arb)
+{
+    uint64_t hold_ns = 0;
+    int prio = 0;
+
+    STD_ASSERT(arb != NULL);
+
+    pthread_mutex_lock(&arb->lock);
+
+    hold_ns = sdi_i2c_stats_now_ns() - arb->acquired_ns;
+    arb->held = false;
+
+    for (prio = SDI_I2C_PRIO_MAX - 1; prio >= 0; prio--) {
+        if (arb->waiters[prio] != 0) {
+            /* waiters of the class re-check their ticket */
+            pthread_cond_broadcast(&arb->cond[prio]);
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&arb->lock);
+
+    return hold_ns;
+}
+
+/**
+ * sdi_i2c_arb_contended
+ * Check if a thread of a higher class than the bus owner is waiting
+ * param[in] arb - bus arbiter
+ * return true if a higher class is waiting
+ */
+bool sdi_i2c_arb_contended(sdi_i2c_arb_t *arb)
+{
+    bool contended = false;
+
+    STD_ASSERT(arb != NULL);
+
+    pthread_mutex_lock(&arb->lock);
+    contended = arb->held && sdi_i2c_arb_higher_waiting(arb, arb->holder_prio);
+    pthread_mutex_unlock(&arb->lock);
+
+    return contended;
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_i2c_async.c
+ */
+
+
+/******************************************************************************
+ * Implements the asynchronous I2C request API: a FIFO request queue and a
+ * worker thread per i2c bus, keyed by i2c bus handle.
+ *****************************************************************************/
+
+#include "sdi_i2c_async.h"
+#include "sdi_device_common.h"
+#include "sdi_i2c_bus_framework.h"
+#include "std_mutex_lock.h"
+#include "std_assert.h"
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdint.h>
+
+/**
+ * No. of buckets in queue registry, power of 2
+ */
+#define SDI_I2C_ASYNC_REGISTRY_SIZE    (64)
+
+/**
+ * @struct sdi_i2c_async_queue_t
+ * @brief request queue and worker thread of an i2c bus
+ */
+typedef struct sdi_i2c_async_queue_ {
+    sdi_i2c_bus_hdl_t i2c_bus; /**< i2c bus handle */
+    pthread_mutex_t lock; /**< protects queue */
+    pthread_cond_t work_cond; /**< signalled on submission */
+    pthread_cond_t done_cond; /**< signalled on completion */
+    sdi_i2c_async_req_t *head; /**< oldest request */
+    sdi_i2c_async_req_t *tail; /**< newest request */
+    pthread_t worker; /**< worker thread */
+    struct sdi_i2c_async_queue_ *next; /**< next queue in bucket */
+} sdi_i2c_async_queue_t;
+
+/**
+ * Queue registry. Queues live as long as the process.
+ */
+static sdi_i2c_async_queue_t *sdi_i2c_async_registry[SDI_I2C_ASYNC_REGISTRY_SIZE];
+static std_mutex_type_t sdi_i2c_async_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * sdi_i2c_async_hash
+ * Get the registry bucket of an i2c bus
+ * param[in] i2c_bus - i2c bus handle
+ * return bucket index
+ */
+static inline uint_t sdi_i2c_async_hash(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    uintptr_t key = (uintptr_t) i2c_bus;
+
+    /* bus objects are heap allocated, drop the alignment bits */
+    return (uint_t) ((key >> 4) ^ (key >> 10)) & (SDI_I2C_ASYNC_REGISTRY_SIZE - 1);
+}
+
+/**
+ * sdi_i2c_async_worker
+ * Worker thread of an i2c bus: execute requests in submission order
+ * param[in] arg - request queue of the bus
+ * return none
+ */
+static void *sdi_i2c_async_worker(void *arg)
+{
+    sdi_i2c_async_queue_t *queue = (sdi_i2c_async_queue_t *) arg;
+    sdi_i2c_async_req_t *req = NULL;
+
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        while (queue->head == NULL) {
+            pthread_cond_wait(&queue->work_cond, &queue->lock);
+        }
+        req = queue->head;
+        queue->head = req->next;
+        if (queue->head == NULL) {
+            queue->tail = NULL;
+        }
+        pthread_mutex_unlock(&queue->lock);
+
+        sdi_i2c_priority_set(req->prio);
+        req->status = sdi_i2c_batch_execute(queue->i2c_bus, req->ops, req->count);
+
+        if (req->callback != NULL) {
+            /* req belongs to the callback from here on, may be freed */
+            req->callback(req, req->data);
+            continue;
+        }
+
+        pthread_mutex_lock(&queue->lock);
+        req->done = true;
+        pthread_cond_broadcast(&queue->done_cond);
+        pthread_mutex_unlock(&queue->lock);
+    }
+
+    return NULL;
+}
+
+/**
+ * sdi_i2c_async_queue_get
+ * Get the request queue of an i2c bus, starting its worker thread on first
+ * use
+ * param[in] i2c_bus - i2c bus handle
+ * param[out] queue - request queue of the bus
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE of pthread error otherwise
+ */
+static t_std_error sdi_i2c_async_queue_get(sdi_i2c_bus_hdl_t i2c_bus,
+                                           sdi_i2c_async_queue_t **queue)
+{
+    sdi_i2c_async_queue_t *entry = NULL;
+    uint_t bucket = sdi_i2c_async_hash(i2c_bus);
+    pthread_attr_t attr;
+    int rc = 0;
+
+    entry = __atomic_load_n(&sdi_i2c_async_registry[bucket], __ATOMIC_ACQUIRE);
+    for (; entry != NULL; entry = entry->next) {
+        if (entry->i2c_bus == i2c_bus) {
+            *queue = entry;
+            return STD_ERR_OK;
+        }
+    }
+
+    std_mutex_lock(&sdi_i2c_async_registry_lock);
+
+    for (entry = sdi_i2c_async_registry[bucket]; entry != NULL; entry = entry->next) {
+        if (entry->i2c_bus == i2c_bus) {
+            break;
+        }
+    }
+
+    if (entry == NULL) {
+        entry = (sdi_i2c_async_queue_t *) calloc(sizeof(sdi_i2c_async_queue_t), 1);
+        STD_ASSERT(entry != NULL);
+        entry->i2c_bus = i2c_bus;
+        pthread_mutex_init(&entry->lock, NULL);
+        pthread_cond_init(&entry->work_cond, NULL);
+        pthread_cond_init(&entry->done_cond, NULL);
+
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        rc = pthread_create(&entry->worker, &attr, sdi_i2c_async_worker, entry);
+        pthread_attr_destroy(&attr);
+
+        if (rc != 0) {
+            std_mutex_unlock(&sdi_i2c_async_registry_lock);
+            SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %u worker create failed %d\n",
+                __FUNCTION__, __LINE__, i2c_bus->bus.bus_id, rc);
+            pthread_cond_destroy(&entry->done_cond);
+            pthread_cond_destroy(&entry->work_cond);
+            pthread_mutex_destroy(&entry->lock);
+            free(entry);
+            return SDI_DEVICE_ERRCODE(rc);
+        }
+
+        entry->next = sdi_i2c_async_registry[bucket];
+        __atomic_store_n(&sdi_i2c_async_registry[bucket], entry, __ATOMIC_RELEASE);
+    }
+
+    std_mutex_unlock(&sdi_i2c_async_registry_lock);
+
+    *queue = entry;
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_i2c_async_req_init
+ * Initialize a request
+ * param[out] req - request
+ * param[in] ops - operations of the request
+ * param[in] count - no. of operations
+ * param[in] callback - completion callback, can be NULL
+ * param[in] data - passed to callback
+ * return none
+ */
+void sdi_i2c_async_req_init(sdi_i2c_async_req_t *req, sdi_i2c_batch_op_t *ops,
+                            uint_t count, sdi_i2c_async_callback_t callback,
+                            void *data)
+{
+    STD_ASSERT(req != NULL);
+    STD_ASSERT((ops != NULL) || (count == 0));
+
+    req->ops = ops;
+    req->count = count;
+    req->callback = callback;
+    req->data = data;
+    req->status = STD_ERR_OK;
+    req->prio = SDI_I2C_PRIO_DEFAULT;
+    req->done = false;
+    req->queue = NULL;
+    req->next = NULL;
+}
+
+/**
+ * sdi_i2c_async_submit
+ * Submit a request to the queue of an i2c bus
+ * param[in] i2c_bus - i2c bus handle
+ * param[inout] req - initialized request
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE of pthread error otherwise
+ */
+t_std_error sdi_i2c_async_submit(sdi_i2c_bus_hdl_t i2c_bus,
+                                 sdi_i2c_async_req_t *req)
+{
+    sdi_i2c_async_queue_t *queue = NULL;
+    t_std_error error = STD_ERR_OK;
+
+    STD_ASSERT(i2c_bus != NULL);
+    STD_ASSERT(req != NULL);
+
+    error = sdi_i2c_async_queue_get(i2c_bus, &queue);
+    if (error != STD_ERR_OK) {
+        return error;
+    }
+
+    req->prio = sdi_i2c_priority_get();
+    req->done = false;
+    req->queue = queue;
+    req->next = NULL;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->tail != NULL) {
+        queue->tail->next = req;
+    } else {
+        queue->head = req;
+    }
+    queue->tail = req;
+    pthread_cond_signal(&queue->work_cond);
+    pthread_mutex_unlock(&queue->lock);
+
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_i2c_async_wait
+ * Wait for a submitted request to complete
+ * param[in] req - submitted request
+ * return status of the request
+ */
+t_std_error sdi_i2c_async_wait(sdi_i2c_async_req_t *req)
+{
+    sdi_i2c_async_queue_t *queue = NULL;
+
+    STD_ASSERT(req != NULL);
+    STD_ASSERT(req->queue != NULL);
+
+    queue = req->queue;
+
+    pthread_mutex_lock(&queue->lock);
+    while (!req->done) {
+        pthread_cond_wait(&queue->done_cond, &queue->lock);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return req->status;
+}
@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_i2c_batch.c
+ */
+
+
+/******************************************************************************
+ * Implements the I2C transaction batch API. Keeps the batch operation and
+ * bus arbiter registered by i2c bus drivers, keyed by i2c bus handle, and
+ * falls back to one operation at a time for i2c buses without a batch
+ * operation.
+ *****************************************************************************/
+
+#include "sdi_i2c_batch.h"
+#include "sdi_device_common.h"
+#include "sdi_i2c_bus_api.h"
+#include "sdi_i2c_bus_framework.h"
+#include "sdi_i2c_arb.h"
+#include "std_mutex_lock.h"
+#include "std_assert.h"
+#include "std_utils.h"
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdint.h>
+
+/**
+ * No. of buckets in batch operation registry, power of 2
+ */
+#define SDI_I2C_BATCH_REGISTRY_SIZE    (64)
+
+/**
+ * No. of operations after which a batch below control priority checks for
+ * waiters of a higher i2c priority class, and yields the bus to them
+ */
+#define SDI_I2C_BATCH_YIELD_OPS        (16)
+
+/**
+ * @struct sdi_i2c_batch_entry_t
+ * @brief batch operation registered for an i2c bus
+ */
+typedef struct sdi_i2c_batch_entry_ {
+    sdi_i2c_bus_hdl_t i2c_bus; /**< i2c bus handle */
+    sdi_i2c_batch_execute_t execute; /**< batch operation of i2c bus */
+    sdi_i2c_arb_t *arb; /**< arbiter of i2c bus */
+    struct sdi_i2c_batch_entry_ *next; /**< next entry in bucket */
+} sdi_i2c_batch_entry_t;
+
+/**
+ * Batch operation registry. Entries are never removed, and are published
+ * with release semantics, so lookups don't need the registry lock.
+ */
+static sdi_i2c_batch_entry_t *sdi_i2c_batch_registry[SDI_I2C_BATCH_REGISTRY_SIZE];
+static std_mutex_type_t sdi_i2c_batch_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * sdi_i2c_batch_hash
+ * Get the registry bucket of an i2c bus
+ * param[in] i2c_bus - i2c bus handle
+ * return bucket index
+ */
+static inline uint_t sdi_i2c_batch_hash(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    uintptr_t key = (uintptr_t) i2c_bus;
+
+    /* bus objects are heap allocated, drop the alignment bits */
+    return (uint_t) ((key >> 4) ^ (key >> 10)) & (SDI_I2C_BATCH_REGISTRY_SIZE - 1);
+}
+
+/**
+ * sdi_i2c_batch_entry_lookup
+ * Get the registry entry of an i2c bus
+ * param[in] i2c_bus - i2c bus handle
+ * return registry entry if registered, NULL otherwise
+ */
+static sdi_i2c_batch_entry_t *sdi_i2c_batch_entry_lookup(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    sdi_i2c_batch_entry_t *entry = NULL;
+
+    entry = __atomic_load_n(&sdi_i2c_batch_registry[sdi_i2c_batch_hash(i2c_bus)],
+                            __ATOMIC_ACQUIRE);
+    for (; entry != NULL; entry = entry->next) {
+        if (entry->i2c_bus == i2c_bus) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * sdi_i2c_batch_lookup
+ * Get the batch operation registered for an i2c bus
+ * param[in] i2c_bus - i2c bus handle
+ * return batch operation if registered, NULL otherwise
+ */
+static sdi_i2c_batch_execute_t sdi_i2c_batch_lookup(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    sdi_i2c_batch_entry_t *entry = sdi_i2c_batch_entry_lookup(i2c_bus);
+
+    return (entry != NULL) ? __atomic_load_n(&entry->execute, __ATOMIC_ACQUIRE) : NULL;
+}
+
+/**
+ * sdi_i2c_batch_arb_lookup
+ * Get the arbiter registered for an i2c bus
+ * param[in] i2c_bus - i2c bus handle
+ * return arbiter if registered, NULL otherwise
+ */
+static sdi_i2c_arb_t *sdi_i2c_batch_arb_lookup(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    sdi_i2c_batch_entry_t *entry = sdi_i2c_batch_entry_lookup(i2c_bus);
+
+    return (entry != NULL) ? __atomic_load_n(&entry->arb, __ATOMIC_ACQUIRE) : NULL;
+}
+
+/**
+ * sdi_i2c_batch_entry_get
+ * Get the registry entry of an i2c bus, adding it if not registered yet.
+ * Called with registry lock held.
+ * param[in] i2c_bus - i2c bus handle
+ * return registry entry
+ */
+static sdi_i2c_batch_entry_t *sdi_i2c_batch_entry_get(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    sdi_i2c_batch_entry_t *entry = NULL;
+    uint_t bucket = sdi_i2c_batch_hash(i2c_bus);
+
+    for (entry = sdi_i2c_batch_registry[bucket]; entry != NULL; entry = entry->next) {
+        if (entry->i2c_bus == i2c_bus) {
+            return entry;
+        }
+    }
+
+    entry = (sdi_i2c_batch_entry_t *) calloc(sizeof(sdi_i2c_batch_entry_t), 1);
+    STD_ASSERT(entry != NULL);
+    entry->i2c_bus = i2c_bus;
+    entry->next = sdi_i2c_batch_registry[bucket];
+    __atomic_store_n(&sdi_i2c_batch_registry[bucket], entry, __ATOMIC_RELEASE);
+
+    return entry;
+}
+
+/**
+ * sdi_i2c_batch_op_init
+ * Fill an operation of a batch with an offset of offset_len bytes
+ * param[out] op - operation to be filled
+ * param[in] address - i2c slave address
+ * param[in] operation - SDI_I2C_READ or SDI_I2C_WRITE
+ * param[in] offset - offset in slave
+ * param[in] offset_len - no. of offset bytes, upto SDI_I2C_BATCH_MAX_CMD_LEN
+ * param[in] buffer - data read from/written to slave
+ * param[in] buflen - no. of bytes to read/write
+ * return none
+ */
+void sdi_i2c_batch_op_init(sdi_i2c_batch_op_t *op, sdi_i2c_addr_t address,
+                           sdi_i2c_operation_t operation, uint_t offset,
+                           uint_t offset_len, void *buffer, uint_t buflen)
+{
+    uint_t index = 0;
+
+    STD_ASSERT(op != NULL);
+    STD_ASSERT(offset_len <= SDI_I2C_BATCH_MAX_CMD_LEN);
+
+    op->address = address;
+    op->operation = operation;
+    op->cmdlen = offset_len;
+    for (index = 0; index < offset_len; index++) {
+        op->cmd[index] = (uint8_t) (offset >> (BITS_PER_BYTE * (offset_len - index - 1)));
+    }
+    op->buffer = buffer;
+    op->buflen = buflen;
+    op->status = STD_ERR_OK;
+}
+
+/**
+ * sdi_i2c_batch_register
+ * Register the batch operation of an i2c bus
+ * param[in] i2c_bus - i2c bus handle
+ * param[in] execute - batch operation of the i2c bus
+ * return STD_ERR_OK on success
+ */
+t_std_error sdi_i2c_batch_register(sdi_i2c_bus_hdl_t i2c_bus,
+                                   sdi_i2c_batch_execute_t execute)
+{
+    sdi_i2c_batch_entry_t *entry = NULL;
+
+    STD_ASSERT(i2c_bus != NULL);
+    STD_ASSERT(execute != NULL);
+
+    std_mutex_lock(&sdi_i2c_batch_registry_lock);
+    entry = sdi_i2c_batch_entry_get(i2c_bus);
+    __atomic_store_n(&entry->execute, execute, __ATOMIC_RELEASE);
+    std_mutex_unlock(&sdi_i2c_batch_registry_lock);
+
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_i2c_batch_arb_register
+ * Register the arbiter of an i2c bus
+ * param[in] i2c_bus - i2c bus handle
+ * param[in] arb - arbiter taken by bus acquisition
+ * return STD_ERR_OK on success
+ */
+t_std_error sdi_i2c_batch_arb_register(sdi_i2c_bus_hdl_t i2c_bus,
+                                       sdi_i2c_arb_t *arb)
+{
+    sdi_i2c_batch_entry_t *entry = NULL;
+
+    STD_ASSERT(i2c_bus != NULL);
+    STD_ASSERT(arb != NULL);
+
+    std_mutex_lock(&sdi_i2c_batch_registry_lock);
+    entry = sdi_i2c_batch_entry_get(i2c_bus);
+    __atomic_store_n(&entry->arb, arb, __ATOMIC_RELEASE);
+    std_mutex_unlock(&sdi_i2c_batch_registry_lock);
+
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_i2c_batch_execute_op
+ * Execute one operation of a batch using i2c bus operations, for i2c buses
+ * without a registered batch operation
+ * param[in] i2c_bus - i2c bus handle
+ * param[inout] op - operation, status filled on return
+ * return status of the operation
+ */
+static t_std_error sdi_i2c_batch_execute_op(sdi_i2c_bus_hdl_t i2c_bus,
+                                            sdi_i2c_batch_op_t *op)
+{
+    sdi_smbus_operation_t smbus_op = (op->operation == SDI_I2C_READ) ?
+        SDI_SMBUS_READ : SDI_SMBUS_WRITE;
+    size_t block_len = op->buflen;
+
+    if (i2c_bus->ops->sdi_i2c_execute != NULL) {
+        op->status = sdi_i2c_execute(i2c_bus, op->address, op->operation,
+                                     op->cmd, op->cmdlen, op->buffer,
+                                     op->buflen, SDI_I2C_FLAG_NONE);
+    } else if ((op->cmdlen == 1) && (op->buflen == 1)) {
+        op->status = sdi_smbus_execute(i2c_bus, op->address, smbus_op,
+                                       SDI_SMBUS_BYTE_DATA, op->cmd[0],
+                                       op->buffer, NULL, SDI_I2C_FLAG_NONE);
+    } else if (op->cmdlen == 1) {
+        op->status = sdi_smbus_execute(i2c_bus, op->address, smbus_op,
+                                       SDI_SMBUS_I2C_BLOCK_DATA, op->cmd[0],
+                                       op->buffer, &block_len, SDI_I2C_FLAG_NONE);
+    } else if ((op->cmdlen == 0) && (op->buflen == 1)) {
+        /* send byte carries data in command field */
+        op->status = sdi_smbus_execute(i2c_bus, op->address, smbus_op,
+                                       SDI_SMBUS_BYTE,
+                                       *(uint8_t *) op->buffer, op->buffer,
+                                       NULL, SDI_I2C_FLAG_NONE);
+    } else {
+        op->status = SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    return op->status;
+}
+
+/**
+ * sdi_i2c_batch_execute_locked
+ * Execute a batch on an i2c bus already acquired by the caller
+ * param[in] i2c_bus - i2c bus handle
+ * param[inout] ops - list of operations, status filled on return
+ * param[in] count - no. of operations
+ * return STD_ERR_OK when every operation succeeded, error of the first
+ * failed operation otherwise
+ */
+t_std_error sdi_i2c_batch_execute_locked(sdi_i2c_bus_hdl_t i2c_bus,
+                                         sdi_i2c_batch_op_t *ops, uint_t count)
+{
+    sdi_i2c_batch_execute_t execute = NULL;
+    t_std_error error = STD_ERR_OK;
+    uint_t index = 0;
+
+    STD_ASSERT(i2c_bus != NULL);
+    STD_ASSERT((ops != NULL) || (count == 0));
+
+    execute = sdi_i2c_batch_lookup(i2c_bus);
+    if (execute != NULL) {
+        return execute(i2c_bus, ops, count);
+    }
+
+    for (index = 0; index < count; index++) {
+        if ((sdi_i2c_batch_execute_op(i2c_bus, &ops[index]) != STD_ERR_OK)
+                && (error == STD_ERR_OK)) {
+            error = ops[index].status;
+        }
+    }
+    return error;
+}
+
+/**
+ * sdi_i2c_batch_execute
+ * Acquire the i2c bus, execute a batch and release the i2c bus. Batches
+ * below control priority check the bus arbiter every SDI_I2C_BATCH_YIELD_OPS
+ * operations, and yield the bus when a higher class is waiting.
+ * param[in] i2c_bus - i2c bus handle
+ * param[inout] ops - list of operations, status filled on return
+ * param[in] count - no. of operations
+ * return STD_ERR_OK when every operation succeeded, error of bus
+ * acquisition or of the first failed operation otherwise
+ */
+t_std_error sdi_i2c_batch_execute(sdi_i2c_bus_hdl_t i2c_bus,
+                                  sdi_i2c_batch_op_t *ops, uint_t count)
+{
+    t_std_error error = STD_ERR_OK;
+    t_std_error rc = STD_ERR_OK;
+    sdi_i2c_arb_t *arb = NULL;
+    uint_t index = 0;
+    uint_t chunk = count;
+    bool acquired = false;
+
+    STD_ASSERT(i2c_bus != NULL);
+
+    if (sdi_i2c_priority_get() < SDI_I2C_PRIO_CONTROL) {
+        arb = sdi_i2c_batch_arb_lookup(i2c_bus);
+    }
+    if (arb != NULL) {
+        chunk = SDI_I2C_BATCH_YIELD_OPS;
+    }
+
+    for (index = 0; index < count; index += chunk) {
+        if (chunk > (count - index)) {
+            chunk = count - index;
+        }
+
+        if (!acquired) {
+            rc = sdi_i2c_acquire_bus(i2c_bus);
+            if (rc != STD_ERR_OK) {
+                for (; index < count; index++) {
+                    ops[index].status = rc;
+                }
+                return (error != STD_ERR_OK) ? error : rc;
+            }
+            acquired = true;
+        }
+
+        rc = sdi_i2c_batch_execute_locked(i2c_bus, &ops[index], chunk);
+        if ((rc != STD_ERR_OK) && (error == STD_ERR_OK)) {
+            error = rc;
+        }
+
+        if ((arb != NULL) && sdi_i2c_arb_contended(arb)) {
+            /* hand the bus to the higher class, continue once back */
+            sdi_i2c_release_bus(i2c_bus);
+            acquired = false;
+        }
+    }
+
+    if (acquired) {
+        sdi_i2c_release_bus(i2c_bus);
+    }
+
+    return error;
+}
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_i2c_sched.c
+ */
+
+
+/******************************************************************************
+ * Implements the mux aware I2C transaction scheduler: batches of a sweep are
+ * grouped by i2c bus, groups ordered by i2c mux and run round robin, at most
+ * max_ops operations of a group per bus acquisition.
+ *****************************************************************************/
+
+#include "sdi_i2c_sched.h"
+#include "sdi_i2cmux_pin.h"
+#include "sdi_device_common.h"
+#include "sdi_i2c_bus_api.h"
+#include "std_assert.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/**
+ * @struct sdi_i2c_sched_group_t
+ * @brief batches of a sweep on one i2c bus
+ */
+typedef struct sdi_i2c_sched_group_ {
+    sdi_i2c_bus_hdl_t i2c_bus; /**< i2c bus of the group */
+    sdi_i2cmux_pin_hdl_t mux; /**< mux of i2c_bus, NULL if not a mux channel */
+    uint_t mux_leader; /**< first group on the same mux, keeps last_bus */
+    sdi_i2c_bus_hdl_t last_bus; /**< channel last selected on mux, valid in
+                                     mux leader */
+    uint64_t mux_writes; /**< channel selections written on mux before the
+                              sweep, valid in mux leader */
+    int head; /**< next batch to run, -1 once done */
+    int tail; /**< last batch */
+    uint_t done; /**< no. of operations of head batch already run */
+} sdi_i2c_sched_group_t;
+
+/**
+ * sdi_i2c_sched_switch
+ * Account the selection of the channel of a group on its mux, for the
+ * channel selections had the batches run in submission order
+ * param[in] groups - groups of the sweep
+ * param[in] group - group whose channel gets selected
+ * return 1 if the mux switches channel, 0 otherwise
+ */
+static uint_t sdi_i2c_sched_switch(sdi_i2c_sched_group_t *groups,
+                                   sdi_i2c_sched_group_t *group)
+{
+    sdi_i2c_sched_group_t *leader = NULL;
+
+    if (group->mux == NULL) {
+        return 0;
+    }
+    leader = &groups[group->mux_leader];
+    if (leader->last_bus == group->i2c_bus) {
+        return 0;
+    }
+    leader->last_bus = group->i2c_bus;
+    return 1;
+}
+
+/**
+ * sdi_i2c_sched_mux_writes
+ * Get the no. of channel selections written on the mux of a group
+ * param[in] group - group on an i2c mux channel
+ * return no. of channel selections written so far
+ */
+static uint64_t sdi_i2c_sched_mux_writes(const sdi_i2c_sched_group_t *group)
+{
+    sdi_i2cmux_select_stats_t select_stats;
+
+    if (sdi_i2cmux_pin_select_stats_get(group->i2c_bus, &select_stats) != STD_ERR_OK) {
+        return 0;
+    }
+    return select_stats.writes;
+}
+
+/**
+ * sdi_i2c_sched_group_fail
+ * Fail every remaining batch of a group
+ * param[in] reqs - batches of the sweep
+ * param[in] next - next batch of the same group, by batch index
+ * param[inout] group - group to fail
+ * param[in] error - error of bus acquisition
+ * return none
+ */
+static void sdi_i2c_sched_group_fail(sdi_i2c_sched_req_t *reqs, const int *next,
+                                     sdi_i2c_sched_group_t *group,
+                                     t_std_error error)
+{
+    sdi_i2c_sched_req_t *req = NULL;
+    uint_t index = 0;
+
+    for (; group->head >= 0; group->head = next[group->head], group->done = 0) {
+        req = &reqs[group->head];
+        for (index = group->done; index < req->count; index++) {
+            req->ops[index].status = error;
+        }
+        if (req->status == STD_ERR_OK) {
+            req->status = error;
+        }
+    }
+}
+
+/**
+ * sdi_i2c_sched_turn
+ * Run upto max_ops operations of a group under one bus acquisition
+ * param[in] reqs - batches of the sweep
+ * param[in] next - next batch of the same group, by batch index
+ * param[inout] group - group to run
+ * param[in] max_ops - max no. of operations of the turn
+ * return none
+ */
+static void sdi_i2c_sched_turn(sdi_i2c_sched_req_t *reqs, const int *next,
+                               sdi_i2c_sched_group_t *group, uint_t max_ops)
+{
+    sdi_i2c_sched_req_t *req = NULL;
+    t_std_error rc = STD_ERR_OK;
+    uint_t chunk = 0;
+
+    rc = sdi_i2c_acquire_bus(group->i2c_bus);
+    if (rc != STD_ERR_OK) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %u acquire failed %d\n",
+            __FUNCTION__, __LINE__, group->i2c_bus->bus.bus_id, rc);
+        sdi_i2c_sched_group_fail(reqs, next, group, rc);
+        return;
+    }
+
+    while ((max_ops != 0) && (group->head >= 0)) {
+        req = &reqs[group->head];
+        chunk = req->count - group->done;
+        if (chunk > max_ops) {
+            chunk = max_ops;
+        }
+
+        rc = sdi_i2c_batch_execute_locked(group->i2c_bus, &req->ops[group->done],
+                                          chunk);
+        if ((rc != STD_ERR_OK) && (req->status == STD_ERR_OK)) {
+            req->status = rc;
+        }
+
+        max_ops -= chunk;
+        group->done += chunk;
+        if (group->done == req->count) {
+            group->head = next[group->head];
+            group->done = 0;
+        }
+    }
+
+    sdi_i2c_release_bus(group->i2c_bus);
+}
+
+/**
+ * sdi_i2c_sched_execute
+ * Execute the batches of a sweep grouped by i2c bus and mux channel
+ * param[inout] reqs - batches of the sweep
+ * param[in] count - no. of batches
+ * param[in] max_ops - max no. of operations of a group per turn
+ * param[out] stats - counters of the sweep, can be NULL
+ * return STD_ERR_OK when every batch succeeded, status of the first failed
+ * batch otherwise
+ */
+t_std_error sdi_i2c_sched_execute(sdi_i2c_sched_req_t *reqs, uint_t count,
+                                  uint_t max_ops, sdi_i2c_sched_stats_t *stats)
+{
+    sdi_i2c_sched_group_t *groups = NULL;
+    sdi_i2c_sched_group_t *group = NULL;
+    sdi_i2c_sched_stats_t sweep_stats;
+    uint_t *order = NULL;
+    uint_t *req_group = NULL;
+    int *next = NULL;
+    uint_t ngroups = 0;
+    uint_t nordered = 0;
+    uint_t index = 0;
+    uint_t other = 0;
+    bool pending = true;
+
+    STD_ASSERT((reqs != NULL) || (count == 0));
+
+    memset(&sweep_stats, 0, sizeof(sweep_stats));
+    if (max_ops == 0) {
+        max_ops = SDI_I2C_SCHED_DEF_MAX_OPS;
+    }
+
+    if (count != 0) {
+        groups = (sdi_i2c_sched_group_t *) calloc(count, sizeof(sdi_i2c_sched_group_t));
+        order = (uint_t *) calloc(count, sizeof(uint_t));
+        req_group = (uint_t *) calloc(count, sizeof(uint_t));
+        next = (int *) calloc(count, sizeof(int));
+        STD_ASSERT((groups != NULL) && (order != NULL) && (req_group != NULL)
+                   && (next != NULL));
+    }
+
+    /* group batches by i2c bus, in order of first appearance */
+    for (index = 0; index < count; index++) {
+        STD_ASSERT(reqs[index].i2c_bus != NULL);
+        reqs[index].status = STD_ERR_OK;
+        next[index] = -1;
+
+        for (other = 0; other < ngroups; other++) {
+            if (groups[other].i2c_bus == reqs[index].i2c_bus) {
+                break;
+            }
+        }
+        group = &groups[other];
+        if (other == ngroups) {
+            ngroups++;
+            group->i2c_bus = reqs[index].i2c_bus;
+            group->mux = sdi_i2cmux_pin_chan_mux_get(reqs[index].i2c_bus);
+            group->mux_leader = other;
+            group->head = -1;
+            group->tail = -1;
+        }
+        req_group[index] = other;
+
+        if (reqs[index].count == 0) {
+            continue;
+        }
+        if (group->tail >= 0) {
+            next[group->tail] = (int) index;
+        } else {
+            group->head = (int) index;
+        }
+        group->tail = (int) index;
+    }
+
+    /* run groups on channels of the same mux back to back */
+    for (index = 0; index < ngroups; index++) {
+        if ((groups[index].mux != NULL) && (groups[index].mux_leader != index)) {
+            continue;
+        }
+        order[nordered++] = index;
+        if (groups[index].mux == NULL) {
+            continue;
+        }
+        for (other = index + 1; other < ngroups; other++) {
+            if (groups[other].mux == groups[index].mux) {
+                groups[other].mux_leader = index;
+                order[nordered++] = other;
+            }
+        }
+    }
+
+    /* channel selections of the sweep in submission order, for comparison */
+    for (index = 0; index < count; index++) {
+        if (reqs[index].count != 0) {
+            sweep_stats.mux_switches_in_order +=
+                sdi_i2c_sched_switch(groups, &groups[req_group[index]]);
+        }
+    }
+    /* channel selections of the sweep are measured on its muxes */
+    for (index = 0; index < ngroups; index++) {
+        if ((groups[index].mux != NULL) && (groups[index].mux_leader == index)) {
+            groups[index].mux_writes = sdi_i2c_sched_mux_writes(&groups[index]);
+        }
+    }
+
+    while (pending) {
+        pending = false;
+        for (index = 0; index < nordered; index++) {
+            group = &groups[order[index]];
+            if (group->head < 0) {
+                continue;
+            }
+            sweep_stats.turns++;
+            sdi_i2c_sched_turn(reqs, next, group, max_ops);
+            pending = pending || (group->head >= 0);
+        }
+    }
+
+    for (index = 0; index < ngroups; index++) {
+        if ((groups[index].mux != NULL) && (groups[index].mux_leader == index)) {
+            sweep_stats.mux_switches += (uint_t) (sdi_i2c_sched_mux_writes(&groups[index])
+                                                  - groups[index].mux_writes);
+        }
+    }
+
+    sweep_stats.groups = ngroups;
+    if (stats != NULL) {
+        *stats = sweep_stats;
+    }
+
+    free(next);
+    free(req_group);
+    free(order);
+    free(groups);
+
+    for (index = 0; index < count; index++) {
+        if (reqs[index].status != STD_ERR_OK) {
+            return reqs[index].status;
+        }
+    }
+    return STD_ERR_OK;
+}
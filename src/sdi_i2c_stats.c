@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_i2c_stats.c
+ */
+
+
+/******************************************************************************
+ * Implements I2C transaction telemetry: allocation of per bus stats blocks,
+ * in process or shared memory, hot path counter updates and queries.
+ *****************************************************************************/
+
+#include "sdi_i2c_stats.h"
+#include "sdi_device_common.h"
+#include "std_mutex_lock.h"
+#include "std_assert.h"
+#include "std_utils.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @struct sdi_i2c_stats_entry_t
+ * @brief stats block registered for an i2c bus
+ */
+typedef struct sdi_i2c_stats_entry_ {
+    sdi_i2c_bus_hdl_t i2c_bus; /**< i2c bus handle */
+    sdi_i2c_stats_t *stats; /**< stats block of i2c bus */
+    struct sdi_i2c_stats_entry_ *next; /**< next entry */
+} sdi_i2c_stats_entry_t;
+
+static sdi_i2c_stats_entry_t *sdi_i2c_stats_list = NULL;
+static std_mutex_type_t sdi_i2c_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * sdi_i2c_stats_err_index
+ * Get the error counter of an errno
+ * param[in] err - errno
+ * return error counter index
+ */
+static inline sdi_i2c_stats_err_t sdi_i2c_stats_err_index(int err)
+{
+    switch (err) {
+        case ENXIO: return SDI_I2C_STATS_ERR_NXIO;
+        case EREMOTEIO: return SDI_I2C_STATS_ERR_REMOTEIO;
+        case EAGAIN: return SDI_I2C_STATS_ERR_AGAIN;
+        case EBUSY: return SDI_I2C_STATS_ERR_BUSY;
+        case ETIMEDOUT: return SDI_I2C_STATS_ERR_TIMEDOUT;
+        case EIO: return SDI_I2C_STATS_ERR_IO;
+        case EPROTO: return SDI_I2C_STATS_ERR_PROTO;
+        case EBADMSG: return SDI_I2C_STATS_ERR_BADMSG;
+        default: return SDI_I2C_STATS_ERR_OTHER;
+    }
+}
+
+/**
+ * sdi_i2c_stats_shm_alloc
+ * Allocate stats block in a shared memory object named after the bus
+ * param[in] bus_name - i2c bus name
+ * return stats block on success, NULL on failure
+ */
+static sdi_i2c_stats_t *sdi_i2c_stats_shm_alloc(const char *bus_name)
+{
+    char shm_name[NAME_MAX];
+    sdi_i2c_stats_t *stats = NULL;
+    int fd = -1;
+
+    snprintf(shm_name, sizeof(shm_name), "%s%s", SDI_I2C_STATS_SHM_PREFIX,
+             bus_name);
+
+    fd = shm_open(shm_name, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d shm_open %s failed %d\n",
+                              __FUNCTION__, __LINE__, shm_name, errno);
+        return NULL;
+    }
+
+    if (ftruncate(fd, sizeof(sdi_i2c_stats_t)) != 0) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d ftruncate %s failed %d\n",
+                              __FUNCTION__, __LINE__, shm_name, errno);
+        close(fd);
+        return NULL;
+    }
+
+    stats = (sdi_i2c_stats_t *) mmap(NULL, sizeof(sdi_i2c_stats_t),
+                                     PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (stats == MAP_FAILED) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d mmap %s failed %d\n",
+                              __FUNCTION__, __LINE__, shm_name, errno);
+        return NULL;
+    }
+
+    /* stale contents from a previous run */
+    memset(stats, 0, sizeof(sdi_i2c_stats_t));
+    return stats;
+}
+
+/**
+ * sdi_i2c_stats_create
+ * Create the stats block of an i2c bus and register it for look up by bus
+ * handle
+ * param[in] i2c_bus - i2c bus handle
+ * param[in] shared - true to keep stats in shared memory
+ * return stats block of the bus
+ */
+sdi_i2c_stats_t *sdi_i2c_stats_create(sdi_i2c_bus_hdl_t i2c_bus, bool shared)
+{
+    sdi_i2c_stats_entry_t *entry = NULL;
+    sdi_i2c_stats_t *stats = NULL;
+
+    STD_ASSERT(i2c_bus != NULL);
+
+    if (shared) {
+        stats = sdi_i2c_stats_shm_alloc(i2c_bus->bus.bus_name);
+    }
+    if (stats == NULL) {
+        /* in process stats, also when shared memory is not available */
+        stats = (sdi_i2c_stats_t *) calloc(sizeof(sdi_i2c_stats_t), 1);
+        STD_ASSERT(stats != NULL);
+    }
+
+    stats->version = SDI_I2C_STATS_VERSION;
+    stats->size = sizeof(sdi_i2c_stats_t);
+    stats->bus_id = i2c_bus->bus.bus_id;
+    safestrncpy(stats->bus_name, i2c_bus->bus.bus_name, sizeof(stats->bus_name));
+    /* magic last, marks the block valid for external readers */
+    __atomic_store_n(&stats->magic, SDI_I2C_STATS_MAGIC, __ATOMIC_RELEASE);
+
+    entry = (sdi_i2c_stats_entry_t *) calloc(sizeof(sdi_i2c_stats_entry_t), 1);
+    STD_ASSERT(entry != NULL);
+    entry->i2c_bus = i2c_bus;
+    entry->stats = stats;
+
+    std_mutex_lock(&sdi_i2c_stats_lock);
+    entry->next = sdi_i2c_stats_list;
+    sdi_i2c_stats_list = entry;
+    std_mutex_unlock(&sdi_i2c_stats_lock);
+
+    return stats;
+}
+
+/**
+ * sdi_i2c_stats_record
+ * Record a transaction. Called with bus acquired.
+ * param[in] stats - stats block of the bus, can be NULL
+ * param[in] address - i2c slave address
+ * param[in] bytes - no. of data bytes transferred
+ * param[in] latency_ns - transaction latency
+ * param[in] err - errno of failed transaction, 0 on success
+ * return none
+ */
+void sdi_i2c_stats_record(sdi_i2c_stats_t *stats, sdi_i2c_addr_t address,
+                          size_t bytes, uint64_t latency_ns, int err)
+{
+    uint_t bucket = 0;
+    sdi_i2c_counters_t *addr_counters = NULL;
+
+    if (stats == NULL) {
+        return;
+    }
+
+    bucket = sdi_i2c_stats_bucket(latency_ns);
+
+    stats->bus.transactions++;
+    stats->bus.latency_ns += latency_ns;
+    stats->bus.latency_hist[bucket]++;
+
+    if (address < SDI_I2C_STATS_MAX_ADDR) {
+        addr_counters = &stats->addr[address];
+        addr_counters->transactions++;
+        addr_counters->latency_ns += latency_ns;
+        addr_counters->latency_hist[bucket]++;
+    }
+
+    if (err != 0) {
+        stats->bus.errors[sdi_i2c_stats_err_index(err)]++;
+        if (addr_counters != NULL) {
+            addr_counters->errors[sdi_i2c_stats_err_index(err)]++;
+        }
+        return;
+    }
+
+    stats->bus.bytes += bytes;
+    if (addr_counters != NULL) {
+        addr_counters->bytes += bytes;
+    }
+}
+
+/**
+ * sdi_i2c_stats_record_retry
+ * Record a retry of a failed transaction. Called with bus acquired.
+ * param[in] stats - stats block of the bus, can be NULL
+ * param[in] address - i2c slave address
+ * param[in] err - errno of the failed attempt
+ * return none
+ */
+void sdi_i2c_stats_record_retry(sdi_i2c_stats_t *stats, sdi_i2c_addr_t address,
+                                int err)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->bus.retries++;
+    stats->bus.errors[sdi_i2c_stats_err_index(err)]++;
+    if (address < SDI_I2C_STATS_MAX_ADDR) {
+        stats->addr[address].retries++;
+        stats->addr[address].errors[sdi_i2c_stats_err_index(err)]++;
+    }
+}
+
+/**
+ * sdi_i2c_stats_record_lock_wait
+ * Record the time spent waiting for bus lock. Called with bus acquired.
+ * param[in] stats - stats block of the bus, can be NULL
+ * param[in] prio - i2c priority class of the acquisition
+ * param[in] wait_ns - lock wait time
+ * return none
+ */
+void sdi_i2c_stats_record_lock_wait(sdi_i2c_stats_t *stats, sdi_i2c_prio_t prio,
+                                    uint64_t wait_ns)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->lock_acquisitions++;
+    stats->lock_wait_ns += wait_ns;
+    stats->lock_wait_hist[sdi_i2c_stats_bucket(wait_ns)]++;
+
+    if (prio < SDI_I2C_PRIO_MAX) {
+        stats->prio_acquisitions[prio]++;
+        stats->prio_wait_ns[prio] += wait_ns;
+        if (wait_ns > stats->prio_wait_max_ns[prio]) {
+            stats->prio_wait_max_ns[prio] = wait_ns;
+        }
+    }
+}
+
+/**
+ * sdi_i2c_stats_record_lock_hold
+ * Record the time bus lock was held. Called when releasing the bus.
+ * param[in] stats - stats block of the bus, can be NULL
+ * param[in] hold_ns - lock hold time
+ * return none
+ */
+void sdi_i2c_stats_record_lock_hold(sdi_i2c_stats_t *stats, uint64_t hold_ns)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->lock_hold_ns += hold_ns;
+    stats->lock_hold_hist[sdi_i2c_stats_bucket(hold_ns)]++;
+    if (hold_ns > stats->lock_hold_max_ns) {
+        stats->lock_hold_max_ns = hold_ns;
+    }
+}
+
+/**
+ * sdi_i2c_stats_get
+ * Get the stats block of an i2c bus
+ * param[in] i2c_bus - i2c bus handle
+ * return stats block of the bus, NULL if the bus keeps no stats
+ */
+const sdi_i2c_stats_t *sdi_i2c_stats_get(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    sdi_i2c_stats_entry_t *entry = NULL;
+    sdi_i2c_stats_t *stats = NULL;
+
+    std_mutex_lock(&sdi_i2c_stats_lock);
+    for (entry = sdi_i2c_stats_list; entry != NULL; entry = entry->next) {
+        if (entry->i2c_bus == i2c_bus) {
+            stats = entry->stats;
+            break;
+        }
+    }
+    std_mutex_unlock(&sdi_i2c_stats_lock);
+
+    return stats;
+}
+
+/**
+ * sdi_i2c_stats_for_each
+ * Walk the stats block of every i2c bus keeping stats
+ * param[in] callback - called for every stats block
+ * param[in] data - passed to callback
+ * return none
+ */
+void sdi_i2c_stats_for_each(void (*callback)(const sdi_i2c_stats_t *stats,
+                                             void *data), void *data)
+{
+    sdi_i2c_stats_entry_t *entry = NULL;
+
+    STD_ASSERT(callback != NULL);
+
+    std_mutex_lock(&sdi_i2c_stats_lock);
+    for (entry = sdi_i2c_stats_list; entry != NULL; entry = entry->next) {
+        callback(entry->stats, data);
+    }
+    std_mutex_unlock(&sdi_i2c_stats_lock);
+}
+
+/**
+ * sdi_i2c_stats_percentile
+ * Get a latency percentile from a latency histogram
+ * param[in] hist - latency histogram with SDI_I2C_STATS_LAT_BUCKETS buckets
+ * param[in] percentile - percentile, 1 to 100
+ * return upper bound in nano seconds of the bucket holding the percentile,
+ * 0 if histogram is empty
+ */
+uint64_t sdi_i2c_stats_percentile(const uint64_t *hist, uint_t percentile)
+{
+    uint64_t total = 0;
+    uint64_t rank = 0;
+    uint64_t count = 0;
+    uint_t bucket = 0;
+
+    STD_ASSERT(hist != NULL);
+
+    for (bucket = 0; bucket < SDI_I2C_STATS_LAT_BUCKETS; bucket++) {
+        total += hist[bucket];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    if (percentile > 100) {
+        percentile = 100;
+    }
+    /* rank of the sample at percentile, rounded up */
+    rank = ((total * percentile) + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    for (bucket = 0; bucket < SDI_I2C_STATS_LAT_BUCKETS; bucket++) {
+        count += hist[bucket];
+        if (count >= rank) {
+            break;
+        }
+    }
+    if (bucket >= SDI_I2C_STATS_LAT_BUCKETS) {
+        bucket = SDI_I2C_STATS_LAT_BUCKETS - 1;
+    }
+    return (1ULL << (bucket + 1));
+}
+
+/**
+ * sdi_i2c_stats_reset
+ * Reset the counters of an i2c bus. Called with bus acquired.
+ * param[in] i2c_bus - i2c bus handle
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOENT) if the bus keeps
+ * no stats
+ */
+t_std_error sdi_i2c_stats_reset(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    sdi_i2c_stats_t *stats = (sdi_i2c_stats_t *) sdi_i2c_stats_get(i2c_bus);
+
+    if (stats == NULL) {
+        return SDI_DEVICE_ERRCODE(ENOENT);
+    }
+
+    stats->lock_acquisitions = 0;
+    stats->lock_wait_ns = 0;
+    memset(stats->lock_wait_hist, 0, sizeof(stats->lock_wait_hist));
+    memset(stats->prio_acquisitions, 0, sizeof(stats->prio_acquisitions));
+    memset(stats->prio_wait_ns, 0, sizeof(stats->prio_wait_ns));
+    memset(stats->prio_wait_max_ns, 0, sizeof(stats->prio_wait_max_ns));
+    stats->lock_hold_ns = 0;
+    stats->lock_hold_max_ns = 0;
+    memset(stats->lock_hold_hist, 0, sizeof(stats->lock_hold_hist));
+    memset(&stats->bus, 0, sizeof(stats->bus));
+    memset(stats->addr, 0, sizeof(stats->addr));
+
+    return STD_ERR_OK;
+}
@@ -51,6 +51,9 @@ For ex: gpio pin1 and gpio pin2 are used to enable a particular i2c mux channel:
 **/
 
 #include "sdi_i2cmux_pin.h"
+#include "sdi_i2c_batch.h"
+#include "sdi_sim_i2c.h"
+#include "sdi_init_sched.h"
 #include "sdi_i2c_mux_attr.h"
 #include "sdi_common_attr.h"
 #include "sdi_bus_attr.h"
@@ -63,17 +66,111 @@ For ex: gpio pin1 and gpio pin2 are used to enable a particular i2c mux channel:
 #include "std_assert.h"
 
 #include <stdlib.h>
+#include <errno.h>
 #include <string.h>
 #include <stdio.h>
 
+sdi_i2c_bus_ops_t sdi_i2cmux_chan_bus_operations;
+
+/**
+ * sdi_i2cmux_pin_select_invalid
+ * Forget the channel selected on the mux. Called with mux lock acquired.
+ * param[in] mux - i2c mux
+ * return none
+ */
+static inline void sdi_i2cmux_pin_select_invalid(sdi_i2cmux_pin_hdl_t mux)
+{
+    if (mux->cur_channel_valid) {
+        mux->cur_channel_valid = false;
+        mux->select_stats.invalidations++;
+    }
+}
+
+/**
+ * sdi_i2cmux_pin_bus_error
+ * Check whether a failed transaction on the parent i2c bus may have left the
+ * mux pins unknown: adapter and bus errors (lost arbitration, bus busy or
+ * stuck, timeout, protocol violation). A slave not acking its address
+ * (ENXIO, EREMOTEIO, ENODEV) or a rejected request says nothing about the mux.
+ * param[in] error - return code of the transaction
+ * return true when the selected channel must be forgotten, false otherwise
+ */
+static bool sdi_i2cmux_pin_bus_error(t_std_error error)
+{
+    switch (sdi_i2c_stats_errno(error)) {
+        case EAGAIN:
+        case EBUSY:
+        case ETIMEDOUT:
+        case EIO:
+        case EPROTO:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * sdi_i2cmux_pin_select
+ * Select a channel on the mux, unless already selected. A failed pin group
+ * write leaves the mux pins unknown. Called with mux lock and pin group bus
+ * acquired.
+ * param[in] mux - i2c mux
+ * param[in] channel - channel to select
+ * return STD_ERR_OK on success, error of pin group write otherwise
+ */
+static t_std_error sdi_i2cmux_pin_select(sdi_i2cmux_pin_hdl_t mux, uint_t channel)
+{
+    t_std_error error = STD_ERR_OK;
+
+    if (mux->select_cache && mux->cur_channel_valid && (mux->cur_channel == channel)) {
+        mux->select_stats.skipped++;
+        return STD_ERR_OK;
+    }
+
+    mux->select_stats.writes++;
+    error = sdi_pin_group_write_level(mux->pingroup_hdl, channel);
+    if (error != STD_ERR_OK) {
+        sdi_i2cmux_pin_select_invalid(mux);
+        return error;
+    }
+    mux->cur_channel = channel;
+    mux->cur_channel_valid = true;
+
+    return error;
+}
+
+/**
+ * sdi_i2cmux_pin_segment_set
+ * Set the bus segment of the slaves addressed on the kernel driven i2c bus a
+ * mux is attached to, through the muxes in between. Called with the parent
+ * i2c bus acquired.
+ * param[in] i2c_bus - parent i2c bus of a mux
+ * param[in] segment - mux channel bus handle, NULL for none
+ * return none
+ */
+static void sdi_i2cmux_pin_segment_set(sdi_i2c_bus_hdl_t i2c_bus,
+                                       const void *segment)
+{
+    while (sdi_sys_i2c_segment_set(i2c_bus, segment) != STD_ERR_OK) {
+        if (i2c_bus->ops != &sdi_i2cmux_chan_bus_operations) {
+            /* ex: simulated i2c bus, no write cycle tracking */
+            break;
+        }
+        i2c_bus = ((sdi_i2cmux_pin_chan_bus_handle_t) i2c_bus)->i2c_mux->i2cbus_hdl;
+    }
+}
+
 /**
  * sdi_i2cmux_pin_chan_acquire_bus
  * acquire i2c mux channel bus
  * sequence of operations:
- *  1. acquire mux device lock to prevent other access to mux device
- *  2. select the channel by updating the pin group with channel id for this bus.
+ *  1. acquire mux device lock to prevent other access to mux device, with
+ *     i2c priority class of calling thread
+ *  2. select the channel by updating the pin group with channel id for this bus,
+ *     unless the channel is already selected.
  *  3. acquire this mux channel's bus lock
- *  4. acquire i2c bus to which this mux is attached.
+ *  4. acquire i2c bus to which this mux is attached, slaves addressed on it
+ *     sit on this channel.
  * param[in] bus_handle - i2c mux channel bus handle
  * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
  */
@@ -83,8 +180,15 @@ static t_std_error sdi_i2cmux_pin_chan_acquire_bus(sdi_i2c_bus_hdl_t bus_handle)
     sdi_i2cmux_pin_chan_bus_handle_t bus = (sdi_i2cmux_pin_chan_bus_handle_t) bus_handle;
     sdi_i2cmux_pin_hdl_t mux = bus->i2c_mux;
     bool is_pin_group_bus_acquired = false;
+    sdi_i2c_prio_t prio = SDI_I2C_PRIO_DEFAULT;
+    uint64_t start_ns = sdi_i2c_stats_now_ns();
+
+    /* wait for deferred devices of the channel and the devices of parent bus
+       before taking mux lock, their init uses the mux too */
+    sdi_init_sched_bus_ready((sdi_bus_hdl_t) bus_handle);
+    sdi_init_sched_bus_ready((sdi_bus_hdl_t) mux->i2cbus_hdl);
 
-    error = std_mutex_lock(&(mux->mux_lock));
+    error = sdi_i2c_arb_acquire(&(mux->mux_lock), &prio, NULL);
     if (error != STD_ERR_OK) {
         error = SDI_DEVICE_ERRNO;
         SDI_DEVICE_ERRMSG_LOG("%s:%d acquiring lock failed with error %d\n",
@@ -100,7 +204,7 @@ static t_std_error sdi_i2cmux_pin_chan_acquire_bus(sdi_i2c_bus_hdl_t bus_handle)
 
         is_pin_group_bus_acquired = true;
 
-        error = sdi_pin_group_write_level(mux->pingroup_hdl, bus->i2c_mux_channel);
+        error = sdi_i2cmux_pin_select(mux, bus->i2c_mux_channel);
         if (error != STD_ERR_OK) {
             SDI_DEVICE_ERRMSG_LOG("%s:%d channel select failed with error %d\n",
                     __FUNCTION__, __LINE__, error);
@@ -113,13 +217,18 @@ static t_std_error sdi_i2cmux_pin_chan_acquire_bus(sdi_i2c_bus_hdl_t bus_handle)
                     __FUNCTION__, __LINE__, error);
             break;
         }
+        sdi_i2cmux_pin_segment_set(mux->i2cbus_hdl, bus);
     } while(0);
 
     if (error != STD_ERR_OK) {
         if(is_pin_group_bus_acquired == true ) {
             sdi_pin_group_release_bus((sdi_pin_group_bus_hdl_t)mux->pingroup_hdl);
         }
-        std_mutex_unlock (&(mux->mux_lock));
+        sdi_i2c_arb_release(&(mux->mux_lock));
+    } else {
+        /* includes channel selection and parent bus acquisition */
+        sdi_i2c_stats_record_lock_wait(bus->stats, prio,
+                                       sdi_i2c_stats_now_ns() - start_ns);
     }
 
     return error;
@@ -140,9 +249,10 @@ static void sdi_i2cmux_pin_chan_release_bus(sdi_i2c_bus_hdl_t bus_handle)
     sdi_i2cmux_pin_chan_bus_handle_t bus = (sdi_i2cmux_pin_chan_bus_handle_t) bus_handle;
     sdi_i2cmux_pin_hdl_t mux = bus->i2c_mux;
 
+    sdi_i2cmux_pin_segment_set(mux->i2cbus_hdl, NULL);
     sdi_i2c_release_bus((mux->i2cbus_hdl));
     sdi_pin_group_release_bus((sdi_pin_group_bus_hdl_t)mux->pingroup_hdl);
-    std_mutex_unlock (&(mux->mux_lock));
+    sdi_i2c_stats_record_lock_hold(bus->stats, sdi_i2c_arb_release(&(mux->mux_lock)));
 }
 
 /**
@@ -180,9 +290,129 @@ static t_std_error sdi_i2cmux_pin_chan_execute (sdi_i2c_bus_hdl_t bus_handle,
                                                 size_t *block_len, uint_t flags)
 {
     sdi_i2cmux_pin_chan_bus_handle_t bus = (sdi_i2cmux_pin_chan_bus_handle_t) bus_handle;
+    t_std_error error = STD_ERR_OK;
+    uint64_t start_ns = 0;
+    size_t bytes = 0;
+
+    start_ns = sdi_i2c_stats_now_ns();
+    error = sdi_smbus_execute(bus->i2c_mux->i2cbus_hdl, address, operation, data_type,
+                              commandbuf, buffer, block_len, flags);
+    if (sdi_i2cmux_pin_bus_error(error)) {
+        /* mux may have been reset or reselected behind our back */
+        sdi_i2cmux_pin_select_invalid(bus->i2c_mux);
+    }
+
+    if (bus->stats == NULL) {
+        return error;
+    }
+
+    switch (data_type) {
+        case SDI_SMBUS_BYTE:
+        case SDI_SMBUS_BYTE_DATA:
+            bytes = 1;
+            break;
+        case SDI_SMBUS_WORD_DATA:
+            bytes = 2;
+            break;
+        default:
+            bytes = (block_len != NULL) ? *block_len : 0;
+            break;
+    }
+    sdi_i2c_stats_record(bus->stats, address, bytes,
+                         sdi_i2c_stats_now_ns() - start_ns,
+                         sdi_i2c_stats_errno(error));
+
+    return error;
+}
+
+/**
+ * sdi_i2cmux_pin_chan_i2c_execute
+ * execute i2c transaction on i2c mux channel bus, passed through to parent
+ * i2c bus
+ * param[in] bus_handle - i2c mux channel bus handle
+ * param[in] address - i2c address of slave device
+ * param[in] operation - i2c bus operation (read/write)
+ * param[in] cmd - list of read/write offsets
+ * param[in] cmdlen - no. of offsets
+ * param[out] buffer - data read from/written to i2c slave
+ * param[in] buflen - no. of bytes to read/write
+ * param[in] flags - options if any to be send to i2c execute
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when parent i2c
+ * bus doesn't support i2c transactions, SDI_DEVICE_ERRNO on failure
+ */
+static t_std_error sdi_i2cmux_pin_chan_i2c_execute(sdi_i2c_bus_hdl_t bus_handle,
+                                                   sdi_i2c_addr_t address,
+                                                   sdi_i2c_operation_t operation,
+                                                   const uint8_t *cmd, uint_t cmdlen,
+                                                   void *buffer, uint_t buflen,
+                                                   uint_t flags)
+{
+    sdi_i2cmux_pin_chan_bus_handle_t bus = (sdi_i2cmux_pin_chan_bus_handle_t) bus_handle;
+    sdi_i2c_bus_hdl_t parent = bus->i2c_mux->i2cbus_hdl;
+    t_std_error error = STD_ERR_OK;
+    uint64_t start_ns = 0;
+
+    if (parent->ops->sdi_i2c_execute == NULL) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    start_ns = sdi_i2c_stats_now_ns();
+    error = sdi_i2c_execute(parent, address, operation, cmd, cmdlen,
+                            buffer, buflen, flags);
+    if (sdi_i2cmux_pin_bus_error(error)) {
+        /* mux may have been reset or reselected behind our back */
+        sdi_i2cmux_pin_select_invalid(bus->i2c_mux);
+    }
+
+    if (bus->stats != NULL) {
+        sdi_i2c_stats_record(bus->stats, address, cmdlen + buflen,
+                             sdi_i2c_stats_now_ns() - start_ns,
+                             sdi_i2c_stats_errno(error));
+    }
+
+    return error;
+}
+
+/**
+ * sdi_i2cmux_pin_chan_batch_execute
+ * execute a batch of i2c operations on i2c mux channel bus. Channel is
+ * selected and parent i2c bus acquired as part of channel bus acquisition,
+ * so the batch is passed through to parent i2c bus.
+ * param[in] bus_handle - i2c mux channel bus handle
+ * param[inout] ops - list of batch operations
+ * param[in] count - no. of batch operations
+ * return STD_ERR_OK when every operation succeeded, error of the first
+ * failed operation otherwise
+ */
+static t_std_error sdi_i2cmux_pin_chan_batch_execute(sdi_i2c_bus_hdl_t bus_handle,
+                                                     sdi_i2c_batch_op_t *ops,
+                                                     uint_t count)
+{
+    sdi_i2cmux_pin_chan_bus_handle_t bus = (sdi_i2cmux_pin_chan_bus_handle_t) bus_handle;
+    t_std_error error = STD_ERR_OK;
+    uint64_t start_ns = sdi_i2c_stats_now_ns();
+    uint64_t latency_ns = 0;
+    uint_t index = 0;
+
+    error = sdi_i2c_batch_execute_locked(bus->i2c_mux->i2cbus_hdl, ops, count);
+    for (index = 0; index < count; index++) {
+        if (sdi_i2cmux_pin_bus_error(ops[index].status)) {
+            sdi_i2cmux_pin_select_invalid(bus->i2c_mux);
+            break;
+        }
+    }
 
-    return sdi_smbus_execute(bus->i2c_mux->i2cbus_hdl, address, operation, data_type,
-                             commandbuf, buffer, block_len, flags);
+    if ((bus->stats != NULL) && (count != 0)) {
+        /* batch latency is shared evenly by its operations */
+        latency_ns = (sdi_i2c_stats_now_ns() - start_ns) / count;
+        for (index = 0; index < count; index++) {
+            sdi_i2c_stats_record(bus->stats, ops[index].address,
+                                 ops[index].cmdlen + ops[index].buflen, latency_ns,
+                                 sdi_i2c_stats_errno(ops[index].status));
+        }
+    }
+
+    return error;
 }
 
 /**
@@ -192,6 +422,7 @@ static t_std_error sdi_i2cmux_pin_chan_execute (sdi_i2c_bus_hdl_t bus_handle,
 sdi_i2c_bus_ops_t sdi_i2cmux_chan_bus_operations = {
     .sdi_i2c_acquire_bus = sdi_i2cmux_pin_chan_acquire_bus,
     .sdi_smbus_execute = sdi_i2cmux_pin_chan_execute,
+    .sdi_i2c_execute = sdi_i2cmux_pin_chan_i2c_execute,
     .sdi_i2c_release_bus = sdi_i2cmux_pin_chan_release_bus,
     .sdi_i2c_get_capability = sdi_i2cmux_pin_chan_get_capability,
 };
@@ -233,12 +464,72 @@ static t_std_error sdi_i2cmux_channel_init(sdi_bus_hdl_t bus_handle)
     STD_ASSERT(i2cmux_chan_bus != NULL);
 
     i2cmux_chan_bus->i2c_bus.ops = &sdi_i2cmux_chan_bus_operations;
+    sdi_i2c_batch_register(&i2cmux_chan_bus->i2c_bus,
+                           sdi_i2cmux_pin_chan_batch_execute);
+    sdi_i2c_batch_arb_register(&i2cmux_chan_bus->i2c_bus,
+                               &(i2cmux_chan_bus->i2c_mux->mux_lock));
 
-    sdi_bus_init_device_list(bus_handle);
+    sdi_init_sched_device_list(bus_handle);
 
     return STD_ERR_OK;
 }
 
+/**
+ * sdi_i2cmux_pin_policy_register
+ * Collect settle time and retry policy of slaves configured on an i2c mux channel.
+ * Slaves with same address on different channels share a merged policy,
+ * as mux channels are not visible to the parent i2c bus. Attributes not
+ * configured on a slave are inherited from the parent i2c bus.
+ * param[in] i2cmux - i2c mux device
+ * param[in] node - i2c mux channel config node
+ * return none
+ */
+static void sdi_i2cmux_pin_policy_register(sdi_i2cmux_pin_t *i2cmux,
+                                           std_config_node_t node)
+{
+    std_config_node_t cur_node = NULL;
+    char *node_attr = NULL;
+    sdi_i2c_dev_policy_t policy;
+    sdi_i2c_dev_policy_t parent_policy;
+    sdi_i2c_bus_hdl_t parent_bus = NULL;
+    sdi_i2c_addr_t address = 0;
+
+    /* Parent bus is registered ahead of the mux, when it is not a kernel
+     * driven bus there is no bus default to inherit */
+    sdi_sys_i2c_device_policy_init(&parent_policy);
+    parent_bus = sdi_get_i2c_bus_handle_by_name(i2cmux->i2c_bus_name);
+    if (parent_bus != NULL) {
+        sdi_sys_i2c_bus_policy_get(parent_bus, &parent_policy);
+    }
+
+    for (cur_node = std_config_get_child(node); cur_node != NULL;
+            cur_node = std_config_next_node(cur_node)) {
+        node_attr = std_config_attr_get(cur_node, SDI_DEV_ATTR_ADDRESS);
+        if (node_attr == NULL) {
+            continue;
+        }
+        address = (sdi_i2c_addr_t) strtoul(node_attr, NULL, 0);
+        if (address >= SDI_I2C_MAX_SLAVE_ADDR) {
+            continue;
+        }
+
+        /* Attributes not configured on device are inherited from parent bus */
+        policy = parent_policy;
+        if (!sdi_sys_i2c_device_policy_parse(cur_node, &policy)) {
+            continue;
+        }
+
+        if (i2cmux->dev_policy[address] == NULL) {
+            i2cmux->dev_policy[address] = (sdi_i2c_dev_policy_t *)
+                calloc(sizeof(sdi_i2c_dev_policy_t), 1);
+            STD_ASSERT(i2cmux->dev_policy[address] != NULL);
+            *(i2cmux->dev_policy[address]) = policy;
+        } else {
+            sdi_sys_i2c_device_policy_merge(i2cmux->dev_policy[address], &policy);
+        }
+    }
+}
+
 /**
  * sdi_i2cmux_pin_driver_register
  * Register i2c mux device and register every i2c mux channel on this i2c mux
@@ -257,6 +548,7 @@ static t_std_error sdi_i2cmux_pin_driver_register(std_config_node_t node,
     std_config_node_t cur_node = NULL;
     sdi_i2cmux_pin_chan_bus_handle_t i2cmux_chan_bus = NULL;
     sdi_device_hdl_t dev = NULL;
+    sdi_i2c_bus_hdl_t parent_bus = NULL;
 
     sdi_i2cmux_pin_t *i2cmux = (sdi_i2cmux_pin_t *)
         calloc (sizeof(sdi_i2cmux_pin_t), 1);
@@ -296,10 +588,18 @@ static t_std_error sdi_i2cmux_pin_driver_register(std_config_node_t node,
     STD_ASSERT(node_attr != NULL);
     safestrncpy(i2cmux->pingroup_bus_name, node_attr, SDI_MAX_NAME_LEN);
 
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_STATS_SHM);
+    i2cmux->stats_shm = ((node_attr != NULL) && (strcmp(node_attr, "yes") == 0));
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_SDI_I2CMUX_SELECT_CACHE);
+    i2cmux->select_cache = ((node_attr == NULL) || (strcmp(node_attr, "no") != 0));
+
     if (device_hdl != NULL) {
         *device_hdl = dev;
     }
 
+    parent_bus = sdi_get_i2c_bus_handle_by_name(i2cmux->i2c_bus_name);
+
     for (cur_node = std_config_get_child(node); cur_node != NULL;
             cur_node = std_config_next_node(cur_node)) {
 
@@ -329,11 +629,23 @@ static t_std_error sdi_i2cmux_pin_driver_register(std_config_node_t node,
 
         i2cmux_chan_bus->i2c_mux = i2cmux;
 
+        i2cmux_chan_bus->stats = sdi_i2c_stats_create(
+            (sdi_i2c_bus_hdl_t) i2cmux_chan_bus, i2cmux->stats_shm);
+
         sdi_i2c_bus_register((sdi_i2c_bus_hdl_t) i2cmux_chan_bus);
 
+        sdi_init_sched_register(bus, cur_node);
+
         sdi_bus_enqueue_list(&i2cmux->channel_list,
                              (sdi_bus_hdl_t)i2cmux_chan_bus);
 
+        sdi_i2cmux_pin_policy_register(i2cmux, cur_node);
+
+        /* slaves of a mux on a simulated bus are simulated on the parent bus */
+        if (parent_bus != NULL) {
+            sdi_sim_i2c_slaves_load(parent_bus, cur_node);
+        }
+
         sdi_bus_register_device_list(cur_node, (sdi_bus_hdl_t)i2cmux_chan_bus);
 
     }
@@ -353,15 +665,18 @@ static t_std_error sdi_i2cmux_pin_driver_init(sdi_device_hdl_t device_hdl)
     t_std_error error = STD_ERR_OK;
     sdi_i2cmux_pin_hdl_t i2cmux = (sdi_i2cmux_pin_hdl_t) (device_hdl->private_data);
     sdi_i2c_bus_hdl_t i2c_bus = NULL;
+    sdi_i2c_addr_t address = 0;
 
+    sdi_init_sched_framework_lock();
     i2c_bus = sdi_get_i2c_bus_handle_by_name(i2cmux->i2c_bus_name);
+    i2cmux->pingroup_hdl = sdi_get_pin_group_bus_handle_by_name(i2cmux->pingroup_bus_name);
+    sdi_init_sched_framework_unlock();
+
     STD_ASSERT(i2c_bus != NULL);
     i2cmux->i2cbus_hdl = i2c_bus;
-
-    i2cmux->pingroup_hdl = sdi_get_pin_group_bus_handle_by_name(i2cmux->pingroup_bus_name);
     STD_ASSERT(i2cmux->pingroup_hdl != NULL);
 
-    error = std_mutex_lock_init_non_recursive(&(i2cmux->mux_lock));
+    error = sdi_i2c_arb_init(&(i2cmux->mux_lock));
     if (error != STD_ERR_OK) {
         error = SDI_DEVICE_ERRNO;
         SDI_DEVICE_ERRMSG_LOG("%s:%d lock init failed with error %d\n",
@@ -369,9 +684,85 @@ static t_std_error sdi_i2cmux_pin_driver_init(sdi_device_hdl_t device_hdl)
         return error;
     }
 
+    for (address = 0; address < SDI_I2C_MAX_SLAVE_ADDR; address++) {
+        if (i2cmux->dev_policy[address] == NULL) {
+            continue;
+        }
+        /* Parent bus not driven by kernel has no settle time to apply */
+        sdi_sys_i2c_device_policy_set(i2c_bus, address,
+                                      i2cmux->dev_policy[address]);
+    }
+
     sdi_init_bus_for_each_bus_in_list(&i2cmux->channel_list,
                                       sdi_i2cmux_channel_init, NULL);
 
     return error;
 }
 
+/**
+ * sdi_i2cmux_pin_chan_mux_get
+ * Get the mux of an i2c mux channel
+ * param[in] i2c_bus - i2c bus handle
+ * return mux of the channel, NULL when i2c_bus is not an i2c mux channel
+ */
+sdi_i2cmux_pin_hdl_t sdi_i2cmux_pin_chan_mux_get(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    STD_ASSERT(i2c_bus != NULL);
+
+    if (i2c_bus->ops != &sdi_i2cmux_chan_bus_operations) {
+        return NULL;
+    }
+    return ((sdi_i2cmux_pin_chan_bus_handle_t) i2c_bus)->i2c_mux;
+}
+
+/**
+ * sdi_i2cmux_pin_select_invalidate
+ * Forget the channel selected on the mux of an i2c mux channel
+ * param[in] i2c_bus - i2c mux channel bus handle
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not an i2c mux channel
+ */
+t_std_error sdi_i2cmux_pin_select_invalidate(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    sdi_i2cmux_pin_chan_bus_handle_t bus = (sdi_i2cmux_pin_chan_bus_handle_t) i2c_bus;
+    t_std_error error = STD_ERR_OK;
+
+    STD_ASSERT(i2c_bus != NULL);
+
+    if (i2c_bus->ops != &sdi_i2cmux_chan_bus_operations) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    error = sdi_i2c_arb_acquire(&(bus->i2c_mux->mux_lock), NULL, NULL);
+    if (error != STD_ERR_OK) {
+        return error;
+    }
+    sdi_i2cmux_pin_select_invalid(bus->i2c_mux);
+    sdi_i2c_arb_release(&(bus->i2c_mux->mux_lock));
+
+    return error;
+}
+
+/**
+ * sdi_i2cmux_pin_select_stats_get
+ * Get the channel selection counters of the mux of an i2c mux channel.
+ * Counters are updated with mux lock acquired, read without it.
+ * param[in] i2c_bus - i2c mux channel bus handle
+ * param[out] stats - channel selection counters
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not an i2c mux channel
+ */
+t_std_error sdi_i2cmux_pin_select_stats_get(sdi_i2c_bus_hdl_t i2c_bus,
+                                            sdi_i2cmux_select_stats_t *stats)
+{
+    sdi_i2cmux_pin_chan_bus_handle_t bus = (sdi_i2cmux_pin_chan_bus_handle_t) i2c_bus;
+
+    STD_ASSERT(i2c_bus != NULL);
+    STD_ASSERT(stats != NULL);
+
+    if (i2c_bus->ops != &sdi_i2cmux_chan_bus_operations) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    *stats = bus->i2c_mux->select_stats;
+    return STD_ERR_OK;
+}
@@ -0,0 +1,534 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_init_sched.c
+ */
+
+
+/******************************************************************************
+ * Implements the device tree init scheduler: a registry of buses with a
+ * parallel or deferred subtree, keyed by bus handle, and a pool of init
+ * threads started on demand, which exit once no subtree is left to
+ * initialize.
+ *
+ * Init threads only run the device init callbacks of their subtree: the bus
+ * framework walk of a bus reads its device list, complete once the platform
+ * is registered, and device init only looks up buses and resources, all
+ * registered serially by driver register callbacks beforehand.
+ *****************************************************************************/
+
+#include "sdi_init_sched.h"
+#include "sdi_bus_framework.h"
+#include "sdi_device_common.h"
+#include "std_mutex_lock.h"
+#include "std_assert.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdbool.h>
+
+/**
+ * No. of buckets in subtree registry, power of 2
+ */
+#define SDI_INIT_SCHED_REGISTRY_SIZE   (64)
+
+/**
+ * @enum sdi_init_state_t
+ * States of a subtree
+ */
+typedef enum {
+    SDI_INIT_STATE_IDLE, /* bus not initialized yet */
+    SDI_INIT_STATE_PENDING, /* queued to init threads */
+    SDI_INIT_STATE_DEFERRED, /* waiting for first use */
+    SDI_INIT_STATE_RUNNING, /* being initialized */
+    SDI_INIT_STATE_DONE, /* initialized */
+} sdi_init_state_t;
+
+/**
+ * @struct sdi_init_subtree_t
+ * @brief subtree of a bus with a parallel or deferred init mode
+ */
+typedef struct sdi_init_subtree_ {
+    sdi_bus_hdl_t bus; /**< bus handle */
+    sdi_init_mode_t mode; /**< init mode */
+    sdi_init_state_t state; /**< protected by scheduler lock, read without
+        lock only to check for SDI_INIT_STATE_DONE */
+    struct sdi_init_subtree_ *outer; /**< subtree being initialized by the
+        same thread when this one was started, while running */
+    struct sdi_init_subtree_ *next; /**< next subtree in bucket */
+    struct sdi_init_subtree_ *queue_next; /**< next subtree in run queue */
+} sdi_init_subtree_t;
+
+/**
+ * Subtree registry. Subtrees live as long as the process.
+ */
+static sdi_init_subtree_t *sdi_init_sched_registry[SDI_INIT_SCHED_REGISTRY_SIZE];
+
+/**
+ * Scheduler state, protected by sdi_init_sched_lock
+ */
+static std_mutex_type_t sdi_init_sched_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sdi_init_sched_cond = PTHREAD_COND_INITIALIZER;
+static sdi_init_subtree_t *sdi_init_sched_head = NULL; /* run queue */
+static sdi_init_subtree_t *sdi_init_sched_tail = NULL;
+static uint_t sdi_init_sched_threads = 0; /* running init threads */
+static uint_t sdi_init_sched_outstanding = 0; /* parallel subtrees not done */
+static uint64_t sdi_init_sched_start_ns = 0; /* first subtree init */
+static std_config_node_t sdi_init_sched_last_node = NULL; /* last sibling of
+    parallel buses */
+static sdi_bus_hdl_t sdi_init_sched_last_bus = NULL; /* bus of last node */
+static sdi_init_sched_stats_t sdi_init_sched_stats;
+
+/**
+ * No. of subtrees not done, read without lock by the bus acquire fast path
+ */
+static uint_t sdi_init_sched_unready = 0;
+
+/**
+ * Serializes bus framework lookups of device init between init threads,
+ * leaf lock
+ */
+static std_mutex_type_t sdi_init_sched_framework_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Innermost subtree being initialized by calling thread, NULL when none
+ */
+static __thread sdi_init_subtree_t *sdi_init_sched_current = NULL;
+
+/**
+ * sdi_init_sched_hash
+ * Get the registry bucket of a bus
+ * param[in] bus - bus handle
+ * return bucket index
+ */
+static inline uint_t sdi_init_sched_hash(sdi_bus_hdl_t bus)
+{
+    uintptr_t key = (uintptr_t) bus;
+
+    /* bus objects are heap allocated, drop the alignment bits */
+    return (uint_t) ((key >> 4) ^ (key >> 10)) & (SDI_INIT_SCHED_REGISTRY_SIZE - 1);
+}
+
+/**
+ * sdi_init_sched_find
+ * Find the subtree of a bus
+ * param[in] bus - bus handle
+ * return subtree, NULL when the bus has a serial init mode
+ */
+static sdi_init_subtree_t *sdi_init_sched_find(sdi_bus_hdl_t bus)
+{
+    sdi_init_subtree_t *entry = NULL;
+
+    entry = __atomic_load_n(&sdi_init_sched_registry[sdi_init_sched_hash(bus)],
+                            __ATOMIC_ACQUIRE);
+    for (; entry != NULL; entry = entry->next) {
+        if (entry->bus == bus) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * sdi_init_sched_ready_update
+ * Update time to ready after a subtree is done. Called with scheduler locked.
+ * return none
+ */
+static void sdi_init_sched_ready_update(void)
+{
+    if (sdi_init_sched_outstanding != 0) {
+        return;
+    }
+    sdi_init_sched_stats.ready_ns = sdi_device_now_ns() - sdi_init_sched_start_ns;
+}
+
+/**
+ * sdi_init_sched_run
+ * Initialize a subtree claimed by calling thread, i.e. set to
+ * SDI_INIT_STATE_RUNNING. Called with scheduler locked, unlocks it
+ * while initializing.
+ * param[in] entry - subtree
+ * return none
+ */
+static void sdi_init_sched_run(sdi_init_subtree_t *entry)
+{
+    entry->outer = sdi_init_sched_current;
+
+    std_mutex_unlock(&sdi_init_sched_lock);
+
+    sdi_init_sched_current = entry;
+    sdi_bus_init_device_list(entry->bus);
+    sdi_init_sched_current = entry->outer;
+
+    std_mutex_lock(&sdi_init_sched_lock);
+
+    entry->outer = NULL;
+    __atomic_store_n(&entry->state, SDI_INIT_STATE_DONE, __ATOMIC_RELEASE);
+    __atomic_sub_fetch(&sdi_init_sched_unready, 1, __ATOMIC_RELEASE);
+    if (entry->mode == SDI_INIT_MODE_PARALLEL) {
+        sdi_init_sched_outstanding--;
+        sdi_init_sched_ready_update();
+    } else {
+        sdi_init_sched_stats.deferred_done++;
+    }
+    pthread_cond_broadcast(&sdi_init_sched_cond);
+
+    SDI_DEVICE_TRACEMSG_LOG("%s:%d bus %s initialized\n",
+        __FUNCTION__, __LINE__, entry->bus->bus_name);
+}
+
+/**
+ * sdi_init_sched_thread
+ * Init thread: initialize queued subtrees, exit when none is left
+ * param[in] arg - unused
+ * return none
+ */
+static void *sdi_init_sched_thread(void *arg)
+{
+    sdi_init_subtree_t *entry = NULL;
+
+    std_mutex_lock(&sdi_init_sched_lock);
+
+    while ((entry = sdi_init_sched_head) != NULL) {
+        sdi_init_sched_head = entry->queue_next;
+        if (sdi_init_sched_head == NULL) {
+            sdi_init_sched_tail = NULL;
+        }
+        /* already initialized by a thread using the bus */
+        if (entry->state != SDI_INIT_STATE_PENDING) {
+            continue;
+        }
+        entry->state = SDI_INIT_STATE_RUNNING;
+        sdi_init_sched_run(entry);
+    }
+
+    sdi_init_sched_threads--;
+    std_mutex_unlock(&sdi_init_sched_lock);
+
+    return NULL;
+}
+
+/**
+ * sdi_init_sched_is_current
+ * Check whether a subtree is being initialized by calling thread
+ * param[in] entry - subtree
+ * return true when calling thread initializes entry, or a subtree it
+ * was started from
+ */
+static bool sdi_init_sched_is_current(sdi_init_subtree_t *entry)
+{
+    sdi_init_subtree_t *cur = NULL;
+
+    for (cur = sdi_init_sched_current; cur != NULL; cur = cur->outer) {
+        if (cur == entry) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * sdi_init_sched_register
+ * Register the init mode of a bus, from init_mode attribute of its node
+ * param[in] bus - bus handle
+ * param[in] node - bus config node
+ * return none
+ */
+void sdi_init_sched_register(sdi_bus_hdl_t bus, std_config_node_t node)
+{
+    sdi_init_subtree_t *entry = NULL;
+    sdi_init_mode_t mode = SDI_INIT_MODE_SERIAL;
+    uint_t bucket = 0;
+    char *node_attr = NULL;
+
+    STD_ASSERT(bus != NULL);
+
+    std_mutex_lock(&sdi_init_sched_lock);
+    if ((node != NULL) && (node == sdi_init_sched_last_node)) {
+        sdi_init_sched_last_bus = bus;
+    }
+    std_mutex_unlock(&sdi_init_sched_lock);
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_INIT_MODE);
+    if (node_attr == NULL) {
+        return;
+    }
+    if (strcmp(node_attr, SDI_INIT_MODE_STR_PARALLEL) == 0) {
+        mode = SDI_INIT_MODE_PARALLEL;
+    } else if (strcmp(node_attr, SDI_INIT_MODE_STR_DEFERRED) == 0) {
+        mode = SDI_INIT_MODE_DEFERRED;
+    } else if (strcmp(node_attr, SDI_INIT_MODE_STR_SERIAL) != 0) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d bus %s invalid init mode %s\n",
+            __FUNCTION__, __LINE__, bus->bus_name, node_attr);
+    }
+    if (mode == SDI_INIT_MODE_SERIAL) {
+        return;
+    }
+    if (bus->bus_type != SDI_I2C_BUS) {
+        /* only i2c bus acquisition waits for the subtree to be initialized */
+        SDI_DEVICE_ERRMSG_LOG("%s:%d bus %s init mode %s not supported, initialized in config order\n",
+            __FUNCTION__, __LINE__, bus->bus_name, node_attr);
+        return;
+    }
+    if (sdi_init_sched_start_ns != 0) {
+        /* devices of a bus registered from device init would be registered
+           by init threads, concurrently with the bus framework walk */
+        SDI_DEVICE_ERRMSG_LOG("%s:%d bus %s registered after init start, init mode ignored\n",
+            __FUNCTION__, __LINE__, bus->bus_name);
+        return;
+    }
+
+    entry = (sdi_init_subtree_t *) calloc(sizeof(sdi_init_subtree_t), 1);
+    STD_ASSERT(entry != NULL);
+    entry->bus = bus;
+    entry->mode = mode;
+    entry->state = SDI_INIT_STATE_IDLE;
+
+    bucket = sdi_init_sched_hash(bus);
+
+    std_mutex_lock(&sdi_init_sched_lock);
+    if (mode == SDI_INIT_MODE_PARALLEL) {
+        /* platform init returns once the buses following this one are
+           initialized, wait for init threads there */
+        for (sdi_init_sched_last_node = node;
+             std_config_next_node(sdi_init_sched_last_node) != NULL;
+             sdi_init_sched_last_node = std_config_next_node(sdi_init_sched_last_node)) {
+        }
+        if (sdi_init_sched_last_node == node) {
+            sdi_init_sched_last_bus = bus;
+        }
+    }
+    entry->next = sdi_init_sched_registry[bucket];
+    __atomic_store_n(&sdi_init_sched_registry[bucket], entry, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&sdi_init_sched_unready, 1, __ATOMIC_RELEASE);
+    std_mutex_unlock(&sdi_init_sched_lock);
+}
+
+/**
+ * sdi_init_sched_start
+ * Initialize the devices of a bus, or hand them to init threads or first use,
+ * according to its init mode
+ * param[in] bus - bus handle
+ * return none
+ */
+static void sdi_init_sched_start(sdi_bus_hdl_t bus)
+{
+    sdi_init_subtree_t *entry = NULL;
+    pthread_attr_t attr;
+    pthread_t thread;
+    int rc = 0;
+
+    STD_ASSERT(bus != NULL);
+
+    entry = sdi_init_sched_find(bus);
+
+    std_mutex_lock(&sdi_init_sched_lock);
+
+    if (sdi_init_sched_start_ns == 0) {
+        sdi_init_sched_start_ns = sdi_device_now_ns();
+    }
+
+    if ((entry == NULL) || (entry->state != SDI_INIT_STATE_IDLE)) {
+        sdi_init_sched_stats.serial++;
+        std_mutex_unlock(&sdi_init_sched_lock);
+
+        sdi_bus_init_device_list(bus);
+
+        std_mutex_lock(&sdi_init_sched_lock);
+        sdi_init_sched_ready_update();
+        std_mutex_unlock(&sdi_init_sched_lock);
+        return;
+    }
+
+    if (entry->mode == SDI_INIT_MODE_DEFERRED) {
+        entry->state = SDI_INIT_STATE_DEFERRED;
+        sdi_init_sched_stats.deferred++;
+        pthread_cond_broadcast(&sdi_init_sched_cond);
+        std_mutex_unlock(&sdi_init_sched_lock);
+        return;
+    }
+
+    entry->state = SDI_INIT_STATE_PENDING;
+    entry->queue_next = NULL;
+    if (sdi_init_sched_tail != NULL) {
+        sdi_init_sched_tail->queue_next = entry;
+    } else {
+        sdi_init_sched_head = entry;
+    }
+    sdi_init_sched_tail = entry;
+    sdi_init_sched_outstanding++;
+    sdi_init_sched_stats.parallel++;
+
+    if (sdi_init_sched_threads < SDI_INIT_SCHED_MAX_THREADS) {
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        rc = pthread_create(&thread, &attr, sdi_init_sched_thread, NULL);
+        pthread_attr_destroy(&attr);
+        if (rc == 0) {
+            sdi_init_sched_threads++;
+        } else if (sdi_init_sched_threads == 0) {
+            /* no init thread, the subtree is initialized on first use or
+               by sdi_init_sched_wait */
+            SDI_DEVICE_ERRMSG_LOG("%s:%d bus %s init thread create failed %d\n",
+                __FUNCTION__, __LINE__, bus->bus_name, rc);
+        }
+    }
+
+    std_mutex_unlock(&sdi_init_sched_lock);
+}
+
+/**
+ * sdi_init_sched_device_list
+ * Initialize the devices of a bus according to its init mode. Once the last
+ * bus of the platform is initialized, wait for init threads, so platform init
+ * returns with every subtree but the deferred ones initialized.
+ * param[in] bus - bus handle
+ * return none
+ */
+void sdi_init_sched_device_list(sdi_bus_hdl_t bus)
+{
+    STD_ASSERT(bus != NULL);
+
+    sdi_init_sched_start(bus);
+
+    if ((bus == sdi_init_sched_last_bus) && (sdi_init_sched_current == NULL)) {
+        sdi_init_sched_wait();
+    }
+}
+
+/**
+ * sdi_init_sched_bus_ready
+ * Wait for the devices of a bus to be initialized
+ * param[in] bus - bus handle
+ * return none
+ */
+void sdi_init_sched_bus_ready(sdi_bus_hdl_t bus)
+{
+    sdi_init_subtree_t *entry = NULL;
+
+    if (__atomic_load_n(&sdi_init_sched_unready, __ATOMIC_ACQUIRE) == 0) {
+        return;
+    }
+
+    entry = sdi_init_sched_find(bus);
+    if ((entry == NULL)
+            || (__atomic_load_n(&entry->state, __ATOMIC_ACQUIRE) == SDI_INIT_STATE_DONE)) {
+        return;
+    }
+
+    std_mutex_lock(&sdi_init_sched_lock);
+
+    for (;;) {
+        if (entry->state == SDI_INIT_STATE_DONE) {
+            break;
+        }
+        if ((entry->state == SDI_INIT_STATE_PENDING)
+                || (entry->state == SDI_INIT_STATE_DEFERRED)) {
+            if (entry->state == SDI_INIT_STATE_PENDING) {
+                sdi_init_sched_stats.inline_done++;
+            }
+            entry->state = SDI_INIT_STATE_RUNNING;
+            sdi_init_sched_run(entry);
+            break;
+        }
+        if ((entry->state == SDI_INIT_STATE_RUNNING) && sdi_init_sched_is_current(entry)) {
+            /* devices of the subtree, initialized by calling thread */
+            break;
+        }
+        if ((entry->state == SDI_INIT_STATE_IDLE)
+                && ((sdi_init_sched_outstanding == 0) || (sdi_init_sched_current != NULL))) {
+            /* bus initialized in config order, later on. Init threads don't
+               wait for it, the thread initializing it may wait for them */
+            break;
+        }
+        /* being initialized by another thread, ex: the parent bus of a mux
+           channel, or bus initialized by an init thread */
+        pthread_cond_wait(&sdi_init_sched_cond, &sdi_init_sched_lock);
+    }
+
+    std_mutex_unlock(&sdi_init_sched_lock);
+}
+
+/**
+ * sdi_init_sched_wait
+ * Wait for every subtree given to init threads to be initialized
+ * return none
+ */
+void sdi_init_sched_wait(void)
+{
+    sdi_init_subtree_t *entry = NULL;
+
+    std_mutex_lock(&sdi_init_sched_lock);
+
+    while (sdi_init_sched_outstanding != 0) {
+        if ((sdi_init_sched_threads == 0) && (sdi_init_sched_head != NULL)) {
+            /* init threads couldn't be started, do their work */
+            entry = sdi_init_sched_head;
+            sdi_init_sched_head = entry->queue_next;
+            if (sdi_init_sched_head == NULL) {
+                sdi_init_sched_tail = NULL;
+            }
+            if (entry->state == SDI_INIT_STATE_PENDING) {
+                entry->state = SDI_INIT_STATE_RUNNING;
+                sdi_init_sched_run(entry);
+            }
+            continue;
+        }
+        pthread_cond_wait(&sdi_init_sched_cond, &sdi_init_sched_lock);
+    }
+
+    std_mutex_unlock(&sdi_init_sched_lock);
+}
+
+/**
+ * sdi_init_sched_framework_lock
+ * Serialize bus framework lookups of device init between init threads
+ * return none
+ */
+void sdi_init_sched_framework_lock(void)
+{
+    std_mutex_lock(&sdi_init_sched_framework_mutex);
+}
+
+/**
+ * sdi_init_sched_framework_unlock
+ * Unlock the bus framework and resource registry
+ * return none
+ */
+void sdi_init_sched_framework_unlock(void)
+{
+    std_mutex_unlock(&sdi_init_sched_framework_mutex);
+}
+
+/**
+ * sdi_init_sched_stats_get
+ * Get the init scheduler counters
+ * param[out] stats - init scheduler counters
+ * return none
+ */
+void sdi_init_sched_stats_get(sdi_init_sched_stats_t *stats)
+{
+    STD_ASSERT(stats != NULL);
+
+    std_mutex_lock(&sdi_init_sched_lock);
+    *stats = sdi_init_sched_stats;
+    if (sdi_init_sched_outstanding != 0) {
+        stats->ready_ns = 0;
+    }
+    std_mutex_unlock(&sdi_init_sched_lock);
+}
@@ -35,6 +35,7 @@
  *****************************************************************************/
 
 #include "sdi_bus_framework.h"
+#include "sdi_init_sched.h"
 #include "sdi_device_common.h"
 #include "sdi_bus_attr.h"
 #include "sdi_common_attr.h"
@@ -51,7 +52,7 @@ typedef sdi_bus_hdl_t sdi_io_bus_hdl_t;
  */
 static t_std_error sdi_io_driver_init(sdi_bus_hdl_t bus_hdl)
 {
-    sdi_bus_init_device_list(bus_hdl);
+    sdi_init_sched_device_list(bus_hdl);
     return  STD_ERR_OK;
 }
 
@@ -87,6 +88,7 @@ static t_std_error sdi_io_driver_register(std_config_node_t node,
 
     *bus_hdl = (sdi_bus_hdl_t ) io_bus;
 
+    sdi_init_sched_register((sdi_bus_hdl_t) io_bus, node);
     sdi_bus_register_device_list(node, (sdi_bus_hdl_t) io_bus);
 
     return error;
@@ -35,6 +35,7 @@
 #include "sdi_common_attr.h"
 #include "sdi_fan_resource_attr.h"
 #include "sdi_i2c_bus_api.h"
+#include "sdi_i2c_arb.h"
 #include "sdi_device_common.h"
 #include "std_assert.h"
 #include "std_utils.h"
@@ -562,6 +563,7 @@ static t_std_error sdi_max6620_fan_speed_set(void *resource_hdl, uint_t speed)
     sdi_device_hdl_t chip = NULL;
     max6620_device_t *max6620_data = NULL;
     t_std_error rc = STD_ERR_OK;
+    sdi_i2c_prio_t prev_prio = SDI_I2C_PRIO_DEFAULT;
 
     fan_id = ((max6620_resource_hdl_t*)resource_hdl)->fan_id;
 
@@ -587,7 +589,10 @@ static t_std_error sdi_max6620_fan_speed_set(void *resource_hdl, uint_t speed)
             / ( (max6620_data->max6620_fan[fan_id].no_of_tach_pulse) * speed );
     }
 
+    /* fan control must not wait behind bulk reads on the bus */
+    prev_prio = sdi_i2c_priority_set(SDI_I2C_PRIO_CONTROL);
     rc = sdi_max6620_fan_target_tach_count_set(resource_hdl, tgt_tach_count);
+    sdi_i2c_priority_set(prev_prio);
     if(rc != STD_ERR_OK)
     {
         SDI_DEVICE_ERRMSG_LOG("max6620_fan_target_tach_count_set failed. rc: %d\n", rc);
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*
+ * filename: sdi_media_sel.c
+ */
+
+
+/******************************************************************************
+ * Implements the module selection cache of media drivers: one cache per
+ * selection pin group, keeping the value last written on it.
+ *****************************************************************************/
+
+#include "sdi_media_sel.h"
+#include "sdi_device_common.h"
+#include "sdi_pin_group_bus_api.h"
+#include "std_mutex_lock.h"
+#include "std_assert.h"
+
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+
+/* selection caches, list protected by sdi_media_sel_lock */
+static std_mutex_type_t sdi_media_sel_lock = PTHREAD_MUTEX_INITIALIZER;
+static sdi_media_sel_t *sdi_media_sel_list = NULL;
+
+/**
+ * sdi_media_sel_find
+ * Find the selection cache of a pin group, with sdi_media_sel_lock held
+ * param[in] hdl - selection pin group bus
+ * return selection cache of the pin group, NULL if none
+ */
+static sdi_media_sel_t *sdi_media_sel_find(sdi_pin_group_bus_hdl_t hdl)
+{
+    sdi_media_sel_t *sel = NULL;
+
+    for (sel = sdi_media_sel_list; sel != NULL; sel = sel->next) {
+        if (sel->hdl == hdl) {
+            break;
+        }
+    }
+    return sel;
+}
+
+/**
+ * sdi_media_sel_get
+ * Get the selection cache of a pin group, created on first use
+ * param[in] hdl - selection pin group bus
+ * return selection cache of the pin group
+ */
+sdi_media_sel_t *sdi_media_sel_get(sdi_pin_group_bus_hdl_t hdl)
+{
+    sdi_media_sel_t *sel = NULL;
+
+    STD_ASSERT(hdl != NULL);
+
+    std_mutex_lock(&sdi_media_sel_lock);
+    sel = sdi_media_sel_find(hdl);
+    if (sel == NULL) {
+        sel = (sdi_media_sel_t *) calloc(1, sizeof(sdi_media_sel_t));
+        STD_ASSERT(sel != NULL);
+        sel->hdl = hdl;
+        sel->next = sdi_media_sel_list;
+        sdi_media_sel_list = sel;
+    }
+    std_mutex_unlock(&sdi_media_sel_lock);
+
+    return sel;
+}
+
+/**
+ * sdi_media_sel_write
+ * Write a selection value on a pin group, unless already written. Called with
+ * the pin group bus acquired.
+ * param[in] sel - selection cache of the pin group
+ * param[in] value - selection value
+ * param[in] cache - skip writing the value already written
+ * param[out] changed - set to true when the value got written
+ * return STD_ERR_OK on success, error of pin group write otherwise
+ */
+t_std_error sdi_media_sel_write(sdi_media_sel_t *sel, uint_t value, bool cache,
+                                bool *changed)
+{
+    t_std_error rc = STD_ERR_OK;
+
+    STD_ASSERT(sel != NULL);
+    STD_ASSERT(changed != NULL);
+
+    if (cache && sel->valid && (sel->value == value)) {
+        sel->stats.skipped++;
+        return rc;
+    }
+
+    sel->stats.writes++;
+    rc = sdi_pin_group_write_level(sel->hdl, value);
+    if (rc != STD_ERR_OK) {
+        /* pins of the group are unknown */
+        if (sel->valid) {
+            sel->valid = false;
+            sel->stats.invalidations++;
+        }
+        return rc;
+    }
+    sel->value = value;
+    sel->valid = true;
+    *changed = true;
+
+    return rc;
+}
+
+/**
+ * sdi_media_sel_invalidate
+ * Forget the value written on a pin group, under the pin group bus
+ * param[in] sel - selection cache of the pin group
+ * return STD_ERR_OK on success, error of pin group bus acquire otherwise
+ */
+t_std_error sdi_media_sel_invalidate(sdi_media_sel_t *sel)
+{
+    t_std_error rc = STD_ERR_OK;
+
+    STD_ASSERT(sel != NULL);
+
+    rc = sdi_pin_group_acquire_bus(sel->hdl);
+    if (rc != STD_ERR_OK) {
+        return rc;
+    }
+    if (sel->valid) {
+        sel->valid = false;
+        sel->stats.invalidations++;
+    }
+    sdi_pin_group_release_bus(sel->hdl);
+
+    return rc;
+}
+
+/**
+ * sdi_media_sel_stats_get
+ * Get the selection counters of a pin group
+ * param[in] hdl - selection pin group bus
+ * param[out] stats - selection counters
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOENT) when no media
+ * driver selects on the pin group
+ */
+t_std_error sdi_media_sel_stats_get(sdi_pin_group_bus_hdl_t hdl,
+                                    sdi_media_sel_stats_t *stats)
+{
+    sdi_media_sel_t *sel = NULL;
+    t_std_error rc = SDI_DEVICE_ERRCODE(ENOENT);
+
+    STD_ASSERT(stats != NULL);
+
+    std_mutex_lock(&sdi_media_sel_lock);
+    sel = sdi_media_sel_find(hdl);
+    std_mutex_unlock(&sdi_media_sel_lock);
+
+    /* counters are updated under the pin group bus, read them there */
+    if (sel != NULL) {
+        rc = sdi_pin_group_acquire_bus(hdl);
+        if (rc == STD_ERR_OK) {
+            *stats = sel->stats;
+            sdi_pin_group_release_bus(hdl);
+        }
+    }
+
+    return rc;
+}
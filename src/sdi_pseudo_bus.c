@@ -53,6 +53,7 @@
  *
  *****************************************************************************/
 #include "sdi_bus_framework.h"
+#include "sdi_init_sched.h"
 #include "std_assert.h"
 #include "std_config_node.h"
 #include "std_utils.h"
@@ -62,7 +63,7 @@
 
 static t_std_error sdi_pseudo_bus_init(sdi_bus_hdl_t bus)
 {
-    sdi_bus_init_device_list(bus);
+    sdi_init_sched_device_list(bus);
     return STD_ERR_OK;
 }
 
@@ -80,6 +81,7 @@ static t_std_error sdi_pseudo_bus_register (std_config_node_t node,
     bus->bus_init = sdi_pseudo_bus_init;
     safestrncpy(bus->bus_name, std_config_name_get(node), SDI_MAX_NAME_LEN);
     sdi_bus_register(bus);
+    sdi_init_sched_register(bus, node);
     *bus_hdl = bus;
 
     sdi_bus_register_device_list(node, bus);
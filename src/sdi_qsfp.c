@@ -31,6 +31,7 @@
 #include "sdi_pin_group_bus_api.h"
 #include "sdi_media.h"
 #include "sdi_qsfp.h"
+#include "sdi_qsfp_event.h"
 #include "sdi_media_internal.h"
 #include "sdi_media_attr.h"
 #include "std_error_codes.h"
@@ -47,6 +48,42 @@ static t_std_error sdi_qsfp_init (sdi_device_hdl_t device_hdl);
 static t_std_error sdi_qsfp_register (std_config_node_t node, void *bus_handle,
                                       sdi_device_hdl_t* device_hdl);
 
+/**
+ * Forget the module selection of a qsfp, the module has to settle again once
+ * selected after a reset, low power mode or presence transition
+ * resource_hdl[in] - Handle of the qsfp resource
+ * return t_std_error
+ */
+t_std_error sdi_qsfp_module_sel_invalidate(sdi_resource_hdl_t resource_hdl)
+{
+    sdi_device_hdl_t qsfp_device = NULL;
+    qsfp_device_t *qsfp_priv_data = NULL;
+    t_std_error rc = STD_ERR_OK;
+
+    STD_ASSERT(resource_hdl != NULL);
+
+    qsfp_device = (sdi_device_hdl_t)resource_hdl;
+    qsfp_priv_data = (qsfp_device_t *)qsfp_device->private_data;
+    STD_ASSERT(qsfp_priv_data != NULL);
+
+    /* selection is written and waited for on every access anyway */
+    if (!qsfp_priv_data->mod_sel_cache) {
+        return rc;
+    }
+
+    if (qsfp_priv_data->mux_sel != NULL) {
+        rc = sdi_media_sel_invalidate(qsfp_priv_data->mux_sel);
+    }
+    if ((rc == STD_ERR_OK) && (qsfp_priv_data->mod_sel != NULL)) {
+        rc = sdi_media_sel_invalidate(qsfp_priv_data->mod_sel);
+    }
+    if (rc != STD_ERR_OK) {
+        SDI_DEVICE_ERRMSG_LOG("module selection invalidate failed for %s rc : %d",
+                qsfp_device->alias, rc);
+    }
+    return rc;
+}
+
 /**
  * Gets the presence status of qsfp module
  * resource_hdl[in] - Handle of the qsfp resource
@@ -69,6 +106,11 @@ static t_std_error sdi_qsfp_presence_get (sdi_resource_hdl_t resource_hdl, bool
     qsfp_priv_data = (qsfp_device_t *)qsfp_device->private_data;
     STD_ASSERT(qsfp_priv_data != NULL);
 
+    /* watched ports: presence as last seen on the summary interrupt */
+    if (sdi_qsfp_event_presence_get(resource_hdl, pres) == STD_ERR_OK) {
+        return STD_ERR_OK;
+    }
+
     rc = sdi_pin_group_acquire_bus(qsfp_priv_data->mod_pres_hdl);
     if (rc != STD_ERR_OK){
         return rc;
@@ -88,6 +130,12 @@ static t_std_error sdi_qsfp_presence_get (sdi_resource_hdl_t resource_hdl, bool
         } else {
             *pres = true;
         }
+        /* watched ports are invalidated by their watcher on transitions */
+        if ((qsfp_priv_data->pres_valid) && (qsfp_priv_data->pres != *pres)) {
+            sdi_qsfp_module_sel_invalidate(resource_hdl);
+        }
+        qsfp_priv_data->pres = *pres;
+        qsfp_priv_data->pres_valid = true;
     }
 
     return rc;
@@ -179,6 +227,10 @@ static t_std_error sdi_qsfp_module_control(sdi_resource_hdl_t resource_hdl,
             rc = SDI_DEVICE_ERRCODE(EINVAL);
            break;
     }
+
+    if (rc == STD_ERR_OK) {
+        sdi_qsfp_module_sel_invalidate(resource_hdl);
+    }
     return rc;
 }
 
@@ -325,11 +377,16 @@ static t_std_error sdi_qsfp_init (sdi_device_hdl_t device_hdl)
  *  mod_sel_value="<pin value which needs to be wriiten on pin group bus for selecting module>"
  *  mod_pres_bus="<pin group bus name for knowing the presence status of qsfp>"
  *  mod_pres_bitmask="<presence check bit number for this instance of qsfp on mod_pres_bus>"
+ *  mod_int_bus="<pin group bus name for knowing the interrupt status of qsfp, optional>"
+ *  mod_int_bitmask="<interrupt bit number for this instance of qsfp on mod_int_bus>"
+ *  mod_event_pin="<gpio pin bus name of the summary interrupt of mod_pres_bus and
+ *                  mod_int_bus, optional, see sdi_qsfp_event.h>"
  *  mod_reset_bus="<pin group bus name for setting reset mode>"
  *  mod_reset_bitmask="<reset bit number for this instance of qsfp on mod_reset_bus>"
  *  mod_lpmode_bus="<pin group bus name for setting low power mode>"
  *  mod_lpmode_bitmask="<lp mode for this instance of qsfp on mod_lpmode_bus>"
- *  mod_sel_delay="<delay in milli seconds, time to be wait after selecting module" />
+ *  mod_sel_delay="<delay in milli seconds, time to be wait after selecting module"
+ *  mod_sel_cache="<no to select module and wait on every access, optional>" />
  */
 
 /**
@@ -344,6 +401,8 @@ static t_std_error sdi_qsfp_register (std_config_node_t node, void *bus_handle,
 {
     sdi_device_hdl_t dev_hdl = NULL;
     qsfp_device_t *qsfp_data = NULL;
+    sdi_pin_group_bus_hdl_t mod_int_hdl = NULL;
+    uint_t mod_int_bitmask = 0;
     char *node_attr = NULL;
 
     STD_ASSERT(node != NULL);
@@ -372,6 +431,9 @@ static t_std_error sdi_qsfp_register (std_config_node_t node, void *bus_handle,
     node_attr = std_config_attr_get(node, SDI_MEDIA_MUX_SELECTION_BUS);
     if (node_attr != NULL) {
         qsfp_data->mux_sel_hdl = sdi_get_pin_group_bus_handle_by_name(node_attr);
+        if (qsfp_data->mux_sel_hdl != NULL) {
+            qsfp_data->mux_sel = sdi_media_sel_get(qsfp_data->mux_sel_hdl);
+        }
     }
 
     node_attr = std_config_attr_get(node, SDI_MEDIA_MUX_SELECTION_VALUE);
@@ -382,6 +444,9 @@ static t_std_error sdi_qsfp_register (std_config_node_t node, void *bus_handle,
     node_attr = std_config_attr_get(node, SDI_MEDIA_MODULE_SELECTION_BUS);
     STD_ASSERT(node_attr != NULL);
     qsfp_data->mod_sel_hdl = sdi_get_pin_group_bus_handle_by_name(node_attr);
+    if (qsfp_data->mod_sel_hdl != NULL) {
+        qsfp_data->mod_sel = sdi_media_sel_get(qsfp_data->mod_sel_hdl);
+    }
 
     node_attr = std_config_attr_get(node, SDI_MEDIA_MODULE_SELECTION_VALUE);
     STD_ASSERT(node_attr != NULL);
@@ -418,11 +483,36 @@ static t_std_error sdi_qsfp_register (std_config_node_t node, void *bus_handle,
         qsfp_data->delay = SDI_MEDIA_NO_DELAY;
     }
 
+    node_attr = std_config_attr_get(node, SDI_MEDIA_MODULE_SELECTION_CACHE);
+    qsfp_data->mod_sel_cache = ((node_attr == NULL) || (strcmp(node_attr, "no") != 0));
+
     dev_hdl->private_data = (void *)qsfp_data;
 
     sdi_resource_add(SDI_RESOURCE_MEDIA, dev_hdl->alias, (void *)dev_hdl,
                      &qsfp_media);
 
+    node_attr = std_config_attr_get(node, SDI_MEDIA_MODULE_INTERRUPT_BUS);
+    if (node_attr != NULL) {
+        mod_int_hdl = sdi_get_pin_group_bus_handle_by_name(node_attr);
+        if (mod_int_hdl == NULL) {
+            /* port is then watched for presence changes only */
+            SDI_DEVICE_ERRMSG_LOG("%s:%d interrupt pin group %s of %s not found\n",
+                __FUNCTION__, __LINE__, node_attr, dev_hdl->alias);
+        }
+        node_attr = std_config_attr_get(node, SDI_MEDIA_MODULE_INTERRUPT_BITMASK);
+        STD_ASSERT(node_attr != NULL);
+        mod_int_bitmask = strtoul(node_attr, NULL, 0);
+    }
+
+    node_attr = std_config_attr_get(node, SDI_MEDIA_MODULE_EVENT_PIN);
+    if (node_attr != NULL) {
+        /* not watched on failure, presence is then read on every query */
+        sdi_qsfp_event_port_add((sdi_resource_hdl_t)dev_hdl, node_attr,
+                                qsfp_data->mod_pres_hdl,
+                                qsfp_data->mod_pres_bitmask,
+                                mod_int_hdl, mod_int_bitmask);
+    }
+
     *device_hdl = dev_hdl;
 
     return STD_ERR_OK;
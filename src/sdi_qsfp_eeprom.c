@@ -28,6 +28,7 @@
 #include "sdi_pin_group_bus_framework.h"
 #include "sdi_pin_group_bus_api.h"
 #include "sdi_i2c_bus_api.h"
+#include "sdi_i2c_arb.h"
 #include "sdi_media.h"
 #include "sdi_qsfp.h"
 #include "sdi_qsfp_reg.h"
@@ -162,10 +163,13 @@ static sdi_qsfp_reg_info_t threshold_reg_info[] = {
     { 0, 0 },
 };
 
+/* This function selects the module, and waits for the module selection delay
+ * when the selection on mux_sel_bus or mod_sel_bus changed */
 static inline t_std_error sdi_qsfp_module_select (sdi_device_hdl_t qsfp_device)
 {
     t_std_error rc = STD_ERR_OK;
     qsfp_device_t *qsfp_priv_data = NULL;
+    bool changed = false;
 
     STD_ASSERT(qsfp_device != NULL);
     qsfp_priv_data = (qsfp_device_t *) qsfp_device->private_data;
@@ -180,8 +184,9 @@ static inline t_std_error sdi_qsfp_module_select (sdi_device_hdl_t qsfp_device)
             return rc;
         }
 
-        rc = sdi_pin_group_write_level(qsfp_priv_data->mux_sel_hdl,
-                                       qsfp_priv_data->mux_sel_value);
+        rc = sdi_media_sel_write(qsfp_priv_data->mux_sel,
+                                 qsfp_priv_data->mux_sel_value,
+                                 qsfp_priv_data->mod_sel_cache, &changed);
 
         if (rc != STD_ERR_OK){
             /* mux selection failed, hence release the lock.*/
@@ -204,8 +209,9 @@ static inline t_std_error sdi_qsfp_module_select (sdi_device_hdl_t qsfp_device)
             return rc;
         }
 
-        rc = sdi_pin_group_write_level(qsfp_priv_data->mod_sel_hdl,
-                                       qsfp_priv_data->mod_sel_value);
+        rc = sdi_media_sel_write(qsfp_priv_data->mod_sel,
+                                 qsfp_priv_data->mod_sel_value,
+                                 qsfp_priv_data->mod_sel_cache, &changed);
 
         if (rc != STD_ERR_OK){
             /* module selection failed, hence release the lock.*/
@@ -220,6 +226,12 @@ static inline t_std_error sdi_qsfp_module_select (sdi_device_hdl_t qsfp_device)
         }
     }
 
+    /* the module stays selected while the pin group buses are held, it
+     * settled already unless the selection changed */
+    if (changed) {
+        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
+    }
+
     /* If module selection success, releasing the lock taken care by
      * sdi_qsfp_module_deselect api */
 
@@ -435,8 +447,6 @@ t_std_error sdi_qsfp_module_monitor_status_get (sdi_resource_hdl_t resource_hdl,
         return rc;
     }
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         if( (flags) & ( (SDI_MEDIA_STATUS_TEMP_HIGH_ALARM)  |
                     (SDI_MEDIA_STATUS_TEMP_LOW_ALARM)   |
                     (SDI_MEDIA_STATUS_TEMP_HIGH_WARNING)|
@@ -528,8 +538,6 @@ t_std_error sdi_qsfp_channel_monitor_status_get (sdi_resource_hdl_t resource_hdl
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         if( ((flags) & ((SDI_MEDIA_RX_PWR_HIGH_ALARM) | (SDI_MEDIA_RX_PWR_LOW_ALARM) |
                         (SDI_MEDIA_RX_PWR_HIGH_WARNING) | (SDI_MEDIA_RX_PWR_LOW_WARNING))) != 0 )
         {
@@ -636,8 +644,6 @@ t_std_error sdi_qsfp_channel_status_get (sdi_resource_hdl_t resource_hdl, uint_t
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         if( ((flags) & (SDI_MEDIA_STATUS_TXDISABLE)) ) {
             rc = sdi_smbus_read_byte(qsfp_device->bus_hdl, qsfp_device->addr.i2c_addr,
                     QSFP_TX_CONTROL_OFFSET, &buf, SDI_I2C_FLAG_NONE);
@@ -722,8 +728,6 @@ t_std_error sdi_qsfp_tx_control (sdi_resource_hdl_t resource_hdl, uint_t channel
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         rc = sdi_is_tx_control_supported(qsfp_device, &support_status);
         if (rc != STD_ERR_OK){
             break;
@@ -798,8 +802,6 @@ t_std_error sdi_qsfp_tx_control_status_get(sdi_resource_hdl_t resource_hdl,
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         rc = sdi_smbus_read_byte(qsfp_device->bus_hdl, qsfp_device->addr.i2c_addr,
                 QSFP_TX_CONTROL_OFFSET, &buf, SDI_I2C_FLAG_NONE);
         if (rc != STD_ERR_OK){
@@ -866,8 +868,6 @@ t_std_error sdi_qsfp_is_dell_qualified (sdi_resource_hdl_t resource_hdl,
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         rc = sdi_smbus_read_word(qsfp_device->bus_hdl, qsfp_device->addr.i2c_addr,
                 QSFP_DELL_PRODUCT_ID_OFFSET, (uint16_t *)magic_key, SDI_I2C_FLAG_NONE);
         if (rc != STD_ERR_OK){
@@ -940,8 +940,6 @@ t_std_error sdi_qsfp_parameter_get(sdi_resource_hdl_t resource_hdl,
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         offset = param_reg_info[param].offset;
         size =  param_reg_info[param].size;
 
@@ -1029,6 +1027,7 @@ t_std_error sdi_qsfp_vendor_info_get(sdi_resource_hdl_t resource_hdl,
     uint_t offset = 0;
     uint8_t *buf_ptr = NULL;
     uint8_t data_buf[SDI_MAX_NAME_LEN] = { 0 };
+    sdi_i2c_prio_t prev_prio = SDI_I2C_PRIO_DEFAULT;
 
     STD_ASSERT(resource_hdl != NULL);
     STD_ASSERT(vendor_info != NULL);
@@ -1043,16 +1042,17 @@ t_std_error sdi_qsfp_vendor_info_get(sdi_resource_hdl_t resource_hdl,
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         offset = vendor_reg_info[vendor_info_type].offset;
         data_len = vendor_reg_info[vendor_info_type].size;
 
         /* Input buffer size should be greater than or equal to data len*/
         STD_ASSERT(size >= data_len);
 
+        /* vendor info is inventory data, let DOM and control go first */
+        prev_prio = sdi_i2c_priority_set(SDI_I2C_PRIO_INVENTORY);
         rc = sdi_smbus_read_multi_byte(qsfp_device->bus_hdl, qsfp_device->addr.i2c_addr,
                 offset, data_buf, data_len, SDI_I2C_FLAG_NONE);
+        sdi_i2c_priority_set(prev_prio);
         if (rc != STD_ERR_OK) {
             SDI_DEVICE_ERRMSG_LOG("qsfp smbus read failed at addr : %d reg : %d"
                     "rc : %d", qsfp_device->addr, offset, rc);
@@ -1105,8 +1105,6 @@ t_std_error sdi_qsfp_transceiver_code_get(sdi_resource_hdl_t resource_hdl,
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         rc = sdi_smbus_read_multi_byte(qsfp_device->bus_hdl, qsfp_device->addr.i2c_addr,
                 QSFP_COMPLIANCE_CODE_OFFSET, buf, SDI_QSFP_QUAD_WORD_SIZE,
                 SDI_I2C_FLAG_NONE);
@@ -1152,8 +1150,6 @@ t_std_error sdi_qsfp_dell_product_info_get(sdi_resource_hdl_t resource_hdl,
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         rc = sdi_smbus_read_multi_byte(qsfp_device->bus_hdl, qsfp_device->addr.i2c_addr,
                 QSFP_DELL_PRODUCT_ID_OFFSET, (uint8_t *)info,
                 sizeof(sdi_media_dell_product_info_t), SDI_I2C_FLAG_NONE);
@@ -1217,8 +1213,6 @@ t_std_error sdi_qsfp_threshold_get (sdi_resource_hdl_t resource_hdl,
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         /* Select the page-3 of qsfp eeprom where threshold values are located */
         rc = sdi_qsfp_page_select(qsfp_device, SDI_QSFP_PAGE_03);
         if(rc != STD_ERR_OK){
@@ -1332,8 +1326,6 @@ t_std_error sdi_qsfp_module_monitor_get (sdi_resource_hdl_t resource_hdl,
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         switch (monitor)
         {
             case SDI_MEDIA_TEMP:
@@ -1445,8 +1437,6 @@ t_std_error sdi_qsfp_channel_monitor_get (sdi_resource_hdl_t resource_hdl, uint_
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         rc = sdi_smbus_read_word(qsfp_device->bus_hdl, qsfp_device->addr.i2c_addr,
                 reg_offset, (uint16_t *)buf, SDI_I2C_FLAG_NONE);
         if (rc != STD_ERR_OK){
@@ -1497,8 +1487,6 @@ t_std_error sdi_qsfp_feature_support_status_get (sdi_resource_hdl_t resource_hdl
     }
 
     do {
-        std_usleep(MILLI_TO_MICRO(qsfp_priv_data->delay));
-
         rc = sdi_is_tx_control_supported(qsfp_device,
                                         &feature_support->qsfp_features.tx_control_support_status);
         if (rc != STD_ERR_OK){
@@ -0,0 +1,568 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*
+ * filename: sdi_qsfp_event.c
+ */
+
+
+/******************************************************************************
+ * Implements the QSFP presence and fault change notification: one watcher
+ * thread per summary interrupt pin, woken up by the gpio event dispatcher on
+ * an edge of the pin and scanning the presence and interrupt pin groups of
+ * its ports once per wakeup.
+ *****************************************************************************/
+
+#include "sdi_qsfp_event.h"
+#include "sdi_device_common.h"
+#include "sdi_gpio_event.h"
+#include "sdi_cpld.h"
+#include "sdi_qsfp.h"
+#include "sdi_pin_bus_framework.h"
+#include "sdi_pin_bus_api.h"
+#include "sdi_pin_group_bus_framework.h"
+#include "sdi_pin_group_bus_api.h"
+#include "std_mutex_lock.h"
+#include "std_assert.h"
+#include "std_bit_ops.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+/**
+ * @struct sdi_qsfp_event_group_t
+ * @brief pin group scanned by a watcher, read once per scan
+ */
+typedef struct sdi_qsfp_event_group_ {
+    sdi_pin_group_bus_hdl_t hdl; /**< pin group handle */
+    uint_t value; /**< level read on last scan */
+    t_std_error rc; /**< status of last read */
+    struct sdi_qsfp_event_group_ *next; /**< next pin group of the watcher */
+} sdi_qsfp_event_group_t;
+
+/**
+ * @struct sdi_qsfp_event_port_t
+ * @brief watched port
+ */
+typedef struct sdi_qsfp_event_port_ {
+    sdi_resource_hdl_t resource_hdl; /**< qsfp resource handle */
+    sdi_qsfp_event_group_t *pres; /**< presence pin group */
+    uint_t pres_bit; /**< presence bit number */
+    sdi_qsfp_event_group_t *intr; /**< interrupt pin group, NULL if none */
+    uint_t int_bit; /**< interrupt bit number */
+    bool present; /**< presence on last scan */
+    bool fault; /**< interrupt asserted on last scan */
+    struct sdi_qsfp_event_port_ *next; /**< next port of the watcher */
+} sdi_qsfp_event_port_t;
+
+/**
+ * @struct sdi_qsfp_event_watch_t
+ * @brief watcher of the ports of a summary interrupt
+ */
+typedef struct sdi_qsfp_event_watch_ {
+    sdi_pin_bus_hdl_t pin; /**< summary interrupt gpio pin */
+    sdi_qsfp_event_group_t *groups; /**< pin groups of the ports */
+    sdi_qsfp_event_port_t *ports; /**< watched ports */
+    pthread_mutex_t lock; /**< protects port state and counters */
+    pthread_cond_t cond; /**< signalled on summary interrupt */
+    uint_t pending; /**< no. of summary interrupts not scanned yet */
+    pthread_t thread; /**< watcher thread */
+    bool started; /**< watcher thread started, protected by registry lock */
+    bool scanned; /**< port state valid */
+    bool armed; /**< sleeping on summary interrupt */
+    sdi_qsfp_event_stats_t stats; /**< counters of the watcher */
+    struct sdi_qsfp_event_watch_ *next; /**< next watcher */
+} sdi_qsfp_event_watch_t;
+
+/**
+ * @struct sdi_qsfp_event_change_t
+ * @brief event found by a scan, delivered once the watcher lock is released
+ */
+typedef struct sdi_qsfp_event_change_ {
+    sdi_resource_hdl_t resource_hdl; /**< qsfp resource handle */
+    sdi_qsfp_event_t event; /**< event of the port */
+} sdi_qsfp_event_change_t;
+
+/**
+ * Watcher registry and callback. Watchers live as long as the process.
+ */
+static sdi_qsfp_event_watch_t *sdi_qsfp_event_watchers = NULL;
+static sdi_qsfp_event_callback_t sdi_qsfp_event_callback = NULL;
+static void *sdi_qsfp_event_callback_data = NULL;
+static std_mutex_type_t sdi_qsfp_event_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * sdi_qsfp_event_group_get
+ * Get the scan entry of a pin group of a watcher, adding it on first use
+ * param[in] watch - watcher
+ * param[in] hdl - pin group handle
+ * return scan entry of the pin group
+ */
+static sdi_qsfp_event_group_t *sdi_qsfp_event_group_get(
+    sdi_qsfp_event_watch_t *watch, sdi_pin_group_bus_hdl_t hdl)
+{
+    sdi_qsfp_event_group_t *group = NULL;
+
+    for (group = watch->groups; group != NULL; group = group->next) {
+        if (group->hdl == hdl) {
+            return group;
+        }
+    }
+
+    group = (sdi_qsfp_event_group_t *) calloc(sizeof(sdi_qsfp_event_group_t), 1);
+    STD_ASSERT(group != NULL);
+    group->hdl = hdl;
+    group->next = watch->groups;
+    watch->groups = group;
+    return group;
+}
+
+/**
+ * sdi_qsfp_event_scan
+ * Read every pin group of a watcher once and update the state of its ports
+ * param[in] watch - watcher
+ * param[out] changes - events found, one per port at most
+ * param[in] refresh - read the pin groups from the device rather than from a
+ * cpld snapshot, which may predate the interrupt being scanned
+ * return no. of events found
+ */
+static uint_t sdi_qsfp_event_scan(sdi_qsfp_event_watch_t *watch,
+                                  sdi_qsfp_event_change_t *changes,
+                                  bool refresh)
+{
+    sdi_qsfp_event_group_t *group = NULL;
+    sdi_qsfp_event_port_t *port = NULL;
+    bool present = false;
+    bool fault = false;
+    uint_t count = 0;
+
+    for (group = watch->groups; group != NULL; group = group->next) {
+        if (refresh) {
+            /* ENOTSUP for pin groups not on a cpld, read directly anyway */
+            sdi_cpld_pin_group_refresh(group->hdl);
+        }
+        group->rc = sdi_pin_group_acquire_bus(group->hdl);
+        if (group->rc == STD_ERR_OK) {
+            group->rc = sdi_pin_group_read_level(group->hdl, &group->value);
+            sdi_pin_group_release_bus(group->hdl);
+        }
+        if (group->rc != STD_ERR_OK) {
+            SDI_DEVICE_ERRMSG_LOG("%s:%d pin group %s read failed %d\n",
+                __FUNCTION__, __LINE__, group->hdl->bus.bus_name, group->rc);
+        }
+    }
+
+    pthread_mutex_lock(&watch->lock);
+
+    for (group = watch->groups; group != NULL; group = group->next) {
+        watch->stats.group_reads++;
+        if (group->rc != STD_ERR_OK) {
+            watch->stats.read_errors++;
+        }
+    }
+
+    for (port = watch->ports; port != NULL; port = port->next) {
+        /* keep the last known state of a port whose pin group failed */
+        if (port->pres->rc != STD_ERR_OK) {
+            continue;
+        }
+        present = (STD_BIT_TEST(port->pres->value, port->pres_bit) != 0);
+        fault = false;
+        if ((present) && (port->intr != NULL) && (port->intr->rc == STD_ERR_OK)) {
+            fault = (STD_BIT_TEST(port->intr->value, port->int_bit) != 0);
+        } else if ((present) && (port->intr != NULL)) {
+            fault = port->fault;
+        }
+
+        if (watch->scanned) {
+            if (present != port->present) {
+                changes[count].resource_hdl = port->resource_hdl;
+                changes[count].event = (present ? SDI_QSFP_EVENT_INSERT
+                                                : SDI_QSFP_EVENT_REMOVE);
+                if (present) {
+                    watch->stats.inserts++;
+                } else {
+                    watch->stats.removes++;
+                }
+                count++;
+            } else if ((fault) && (!port->fault)) {
+                changes[count].resource_hdl = port->resource_hdl;
+                changes[count].event = SDI_QSFP_EVENT_FAULT;
+                watch->stats.faults++;
+                count++;
+            }
+        }
+        port->present = present;
+        port->fault = fault;
+    }
+    watch->scanned = true;
+
+    pthread_mutex_unlock(&watch->lock);
+
+    return count;
+}
+
+/**
+ * sdi_qsfp_event_summary
+ * Summary interrupt event callback, called from the gpio event dispatcher:
+ * wake up the watcher, which reads the pin groups on its own thread
+ * param[in] event - summary interrupt event
+ * param[in] data - watcher
+ * return none
+ */
+static void sdi_qsfp_event_summary(const sdi_gpio_event_t *event, void *data)
+{
+    sdi_qsfp_event_watch_t *watch = (sdi_qsfp_event_watch_t *) data;
+
+    pthread_mutex_lock(&watch->lock);
+    watch->pending++;
+    watch->stats.wakeups++;
+    pthread_cond_signal(&watch->cond);
+    pthread_mutex_unlock(&watch->lock);
+}
+
+/**
+ * sdi_qsfp_event_wait
+ * Wait for a summary interrupt, or the end of the scan period
+ * param[in] watch - watcher
+ * param[in] timeout - scan period in milli seconds
+ * return true when woken by a summary interrupt, false on end of scan period
+ */
+static bool sdi_qsfp_event_wait(sdi_qsfp_event_watch_t *watch, uint_t timeout)
+{
+    struct timespec deadline;
+    bool interrupted = false;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (long) (timeout % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&watch->lock);
+    while (watch->pending == 0) {
+        if (pthread_cond_timedwait(&watch->cond, &watch->lock,
+                                   &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    if (watch->pending != 0) {
+        /* edges until now are covered by the coming scan */
+        watch->pending = 0;
+        interrupted = true;
+    } else {
+        watch->stats.resyncs++;
+    }
+    pthread_mutex_unlock(&watch->lock);
+    return interrupted;
+}
+
+/**
+ * sdi_qsfp_event_watcher
+ * Watcher thread: scan the ports on every summary interrupt and on resync,
+ * deliver the changes to the callback
+ * param[in] arg - watcher
+ * return none
+ */
+static void *sdi_qsfp_event_watcher(void *arg)
+{
+    sdi_qsfp_event_watch_t *watch = (sdi_qsfp_event_watch_t *) arg;
+    sdi_qsfp_event_change_t *changes = NULL;
+    sdi_qsfp_event_callback_t callback = NULL;
+    sdi_qsfp_event_port_t *port = NULL;
+    void *data = NULL;
+    uint_t nports = 0;
+    uint_t count = 0;
+    uint_t index = 0;
+    uint_t timeout = SDI_QSFP_EVENT_POLL_MS;
+    bool armed = false;
+    bool interrupted = false;
+
+    for (port = watch->ports; port != NULL; port = port->next) {
+        nports++;
+    }
+    changes = (sdi_qsfp_event_change_t *) calloc(nports, sizeof(sdi_qsfp_event_change_t));
+    STD_ASSERT(changes != NULL);
+
+    /* subscribe before the baseline, a change during it fires again */
+    if (sdi_gpio_event_subscribe((sdi_bus_hdl_t) watch->pin, SDI_GPIO_EDGE_BOTH,
+                                 sdi_qsfp_event_summary, watch) == STD_ERR_OK) {
+        timeout = SDI_QSFP_EVENT_RESYNC_MS;
+        armed = true;
+    } else {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d summary interrupt %s can't be armed, "
+            "scanning every %u ms\n", __FUNCTION__, __LINE__,
+            watch->pin->bus.bus_name, SDI_QSFP_EVENT_POLL_MS);
+    }
+
+    /* baseline, events are reported for changes from here on */
+    sdi_qsfp_event_scan(watch, changes, true);
+    pthread_mutex_lock(&watch->lock);
+    watch->armed = armed;
+    pthread_mutex_unlock(&watch->lock);
+
+    for (;;) {
+        interrupted = sdi_qsfp_event_wait(watch, timeout);
+
+        count = sdi_qsfp_event_scan(watch, changes, interrupted);
+        if (count == 0) {
+            continue;
+        }
+
+        /* an inserted or removed module has to settle again once selected */
+        for (index = 0; index < count; index++) {
+            if (changes[index].event != SDI_QSFP_EVENT_FAULT) {
+                sdi_qsfp_module_sel_invalidate(changes[index].resource_hdl);
+            }
+        }
+
+        std_mutex_lock(&sdi_qsfp_event_lock);
+        callback = sdi_qsfp_event_callback;
+        data = sdi_qsfp_event_callback_data;
+        std_mutex_unlock(&sdi_qsfp_event_lock);
+
+        for (index = 0; (callback != NULL) && (index < count); index++) {
+            callback(changes[index].resource_hdl, changes[index].event, data);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * sdi_qsfp_event_watch_start
+ * Start the thread of a watcher, if not started yet. Registry lock held.
+ * param[in] watch - watcher
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE of pthread error otherwise
+ */
+static t_std_error sdi_qsfp_event_watch_start(sdi_qsfp_event_watch_t *watch)
+{
+    pthread_attr_t attr;
+    int rc = 0;
+
+    if (watch->started) {
+        return STD_ERR_OK;
+    }
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    rc = pthread_create(&watch->thread, &attr, sdi_qsfp_event_watcher, watch);
+    pthread_attr_destroy(&attr);
+
+    if (rc != 0) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d watcher of %s create failed %d\n",
+            __FUNCTION__, __LINE__, watch->pin->bus.bus_name, rc);
+        return SDI_DEVICE_ERRCODE(rc);
+    }
+    __atomic_store_n(&watch->started, true, __ATOMIC_RELEASE);
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_qsfp_event_port_add
+ * Watch a qsfp port
+ * param[in] resource_hdl - handle of the qsfp resource
+ * param[in] event_pin - name of gpio pin bus of the summary interrupt
+ * param[in] pres_hdl - presence pin group of the port
+ * param[in] pres_bit - presence bit number of the port
+ * param[in] int_hdl - interrupt pin group of the port, can be NULL
+ * param[in] int_bit - interrupt bit number of the port
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOENT) when event_pin is
+ * not a registered pin bus
+ */
+t_std_error sdi_qsfp_event_port_add(sdi_resource_hdl_t resource_hdl,
+                                    const char *event_pin,
+                                    sdi_pin_group_bus_hdl_t pres_hdl,
+                                    uint_t pres_bit,
+                                    sdi_pin_group_bus_hdl_t int_hdl,
+                                    uint_t int_bit)
+{
+    sdi_qsfp_event_watch_t *watch = NULL;
+    sdi_qsfp_event_port_t *port = NULL;
+    sdi_pin_bus_hdl_t pin = NULL;
+    pthread_condattr_t cond_attr;
+
+    STD_ASSERT(resource_hdl != NULL);
+    STD_ASSERT(event_pin != NULL);
+    STD_ASSERT(pres_hdl != NULL);
+
+    pin = sdi_get_pin_bus_handle_by_name(event_pin);
+    if (pin == NULL) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d summary interrupt %s not found\n",
+            __FUNCTION__, __LINE__, event_pin);
+        return SDI_DEVICE_ERRCODE(ENOENT);
+    }
+
+    std_mutex_lock(&sdi_qsfp_event_lock);
+
+    for (watch = sdi_qsfp_event_watchers; watch != NULL; watch = watch->next) {
+        if (watch->pin == pin) {
+            break;
+        }
+    }
+    if (watch == NULL) {
+        watch = (sdi_qsfp_event_watch_t *) calloc(sizeof(sdi_qsfp_event_watch_t), 1);
+        STD_ASSERT(watch != NULL);
+        watch->pin = pin;
+        pthread_mutex_init(&watch->lock, NULL);
+        pthread_condattr_init(&cond_attr);
+        pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&watch->cond, &cond_attr);
+        pthread_condattr_destroy(&cond_attr);
+        watch->next = sdi_qsfp_event_watchers;
+        __atomic_store_n(&sdi_qsfp_event_watchers, watch, __ATOMIC_RELEASE);
+    }
+    /* ports are fixed once the watcher runs */
+    STD_ASSERT(!watch->started);
+
+    port = (sdi_qsfp_event_port_t *) calloc(sizeof(sdi_qsfp_event_port_t), 1);
+    STD_ASSERT(port != NULL);
+    port->resource_hdl = resource_hdl;
+    port->pres = sdi_qsfp_event_group_get(watch, pres_hdl);
+    port->pres_bit = pres_bit;
+    if (int_hdl != NULL) {
+        port->intr = sdi_qsfp_event_group_get(watch, int_hdl);
+        port->int_bit = int_bit;
+    }
+    port->next = watch->ports;
+    __atomic_store_n(&watch->ports, port, __ATOMIC_RELEASE);
+
+    std_mutex_unlock(&sdi_qsfp_event_lock);
+
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_qsfp_event_register
+ * Register the event callback and start the watchers
+ * param[in] callback - event callback, NULL to stop reporting events
+ * param[in] data - passed to callback
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE of pthread error when a
+ * watcher thread can't be started
+ */
+t_std_error sdi_qsfp_event_register(sdi_qsfp_event_callback_t callback,
+                                    void *data)
+{
+    sdi_qsfp_event_watch_t *watch = NULL;
+    t_std_error rc = STD_ERR_OK;
+    t_std_error first_rc = STD_ERR_OK;
+
+    std_mutex_lock(&sdi_qsfp_event_lock);
+
+    sdi_qsfp_event_callback = callback;
+    sdi_qsfp_event_callback_data = data;
+
+    for (watch = sdi_qsfp_event_watchers; watch != NULL; watch = watch->next) {
+        rc = sdi_qsfp_event_watch_start(watch);
+        if ((rc != STD_ERR_OK) && (first_rc == STD_ERR_OK)) {
+            first_rc = rc;
+        }
+    }
+
+    std_mutex_unlock(&sdi_qsfp_event_lock);
+
+    return first_rc;
+}
+
+/**
+ * sdi_qsfp_event_presence_get
+ * Get the presence of a watched port as last seen by its watcher, starting
+ * the watcher on first query
+ * param[in] resource_hdl - handle of the qsfp resource
+ * param[out] pres - presence status
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when the port
+ * is not watched or its watcher is not armed yet
+ */
+t_std_error sdi_qsfp_event_presence_get(sdi_resource_hdl_t resource_hdl,
+                                        bool *pres)
+{
+    sdi_qsfp_event_watch_t *watch = NULL;
+    sdi_qsfp_event_port_t *port = NULL;
+    t_std_error rc = SDI_DEVICE_ERRCODE(ENOTSUP);
+
+    STD_ASSERT(pres != NULL);
+
+    for (watch = __atomic_load_n(&sdi_qsfp_event_watchers, __ATOMIC_ACQUIRE);
+         watch != NULL; watch = watch->next) {
+        for (port = __atomic_load_n(&watch->ports, __ATOMIC_ACQUIRE);
+             port != NULL; port = port->next) {
+            if (port->resource_hdl == resource_hdl) {
+                break;
+            }
+        }
+        if (port != NULL) {
+            break;
+        }
+    }
+    if (watch == NULL) {
+        return rc;
+    }
+
+    if (!__atomic_load_n(&watch->started, __ATOMIC_ACQUIRE)) {
+        std_mutex_lock(&sdi_qsfp_event_lock);
+        sdi_qsfp_event_watch_start(watch);
+        std_mutex_unlock(&sdi_qsfp_event_lock);
+    }
+
+    pthread_mutex_lock(&watch->lock);
+    /* an unarmed watcher lags the hardware by up to a scan period */
+    if ((watch->armed) && (watch->scanned)) {
+        *pres = port->present;
+        watch->stats.cached_presence++;
+        rc = STD_ERR_OK;
+    }
+    pthread_mutex_unlock(&watch->lock);
+
+    return rc;
+}
+
+/**
+ * sdi_qsfp_event_stats_get
+ * Get the counters of every watcher
+ * param[out] stats - watcher counters
+ * return none
+ */
+void sdi_qsfp_event_stats_get(sdi_qsfp_event_stats_t *stats)
+{
+    sdi_qsfp_event_watch_t *watch = NULL;
+
+    STD_ASSERT(stats != NULL);
+
+    memset(stats, 0, sizeof(*stats));
+
+    std_mutex_lock(&sdi_qsfp_event_lock);
+    for (watch = sdi_qsfp_event_watchers; watch != NULL; watch = watch->next) {
+        pthread_mutex_lock(&watch->lock);
+        stats->watchers += (watch->started ? 1 : 0);
+        stats->armed += (watch->armed ? 1 : 0);
+        stats->wakeups += watch->stats.wakeups;
+        stats->resyncs += watch->stats.resyncs;
+        stats->group_reads += watch->stats.group_reads;
+        stats->read_errors += watch->stats.read_errors;
+        stats->inserts += watch->stats.inserts;
+        stats->removes += watch->stats.removes;
+        stats->faults += watch->stats.faults;
+        stats->cached_presence += watch->stats.cached_presence;
+        pthread_mutex_unlock(&watch->lock);
+    }
+    std_mutex_unlock(&sdi_qsfp_event_lock);
+}
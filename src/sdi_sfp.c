@@ -278,8 +278,12 @@ static t_std_error sdi_sfp_register (std_config_node_t node, void *bus_handle,
         /* Only one module present on the channel */
         sfp_data->mod_sel_hdl = NULL;
         sfp_data->mod_sel_value = 0;
+        sfp_data->mod_sel = NULL;
     } else {
         sfp_data->mod_sel_hdl = sdi_get_pin_group_bus_handle_by_name(node_attr);
+        if (sfp_data->mod_sel_hdl != NULL) {
+            sfp_data->mod_sel = sdi_media_sel_get(sfp_data->mod_sel_hdl);
+        }
 
         node_attr = std_config_attr_get(node, SDI_MEDIA_MODULE_SELECTION_VALUE);
         STD_ASSERT(node_attr != NULL);
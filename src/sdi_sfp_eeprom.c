@@ -33,6 +33,7 @@
 #include "sdi_pin_group_bus_framework.h"
 #include "sdi_pin_group_bus_api.h"
 #include "sdi_i2c_bus_api.h"
+#include "sdi_i2c_arb.h"
 #include "std_error_codes.h"
 #include "std_assert.h"
 #include "std_time_tools.h"
@@ -155,6 +156,7 @@ static inline t_std_error sdi_sfp_module_select(sdi_device_hdl_t sfp_device)
 {
     t_std_error rc = STD_ERR_OK;
     sfp_device_t *sfp_priv_data = NULL;
+    bool changed = false;
 
     STD_ASSERT(sfp_device != NULL);
     sfp_priv_data = (sfp_device_t *)sfp_device->private_data;
@@ -168,8 +170,8 @@ static inline t_std_error sdi_sfp_module_select(sdi_device_hdl_t sfp_device)
             return rc;
         }
 
-        rc = sdi_pin_group_write_level(sfp_priv_data->mod_sel_hdl,
-                                       sfp_priv_data->mod_sel_value);
+        rc = sdi_media_sel_write(sfp_priv_data->mod_sel,
+                                 sfp_priv_data->mod_sel_value, true, &changed);
         if (rc != STD_ERR_OK){
             /* module selection failed, hence release the lock.*/
             sdi_pin_group_release_bus(sfp_priv_data->mod_sel_hdl);
@@ -1058,6 +1060,7 @@ t_std_error sdi_sfp_vendor_info_get(sdi_resource_hdl_t resource_hdl,
     uint_t offset = 0;
     uint8_t *buf_ptr = NULL;
     uint8_t data_buf[SDI_MAX_NAME_LEN] = { 0 };
+    sdi_i2c_prio_t prev_prio = SDI_I2C_PRIO_DEFAULT;
 
     STD_ASSERT(resource_hdl != NULL);
     STD_ASSERT(vendor_info != NULL);
@@ -1077,8 +1080,11 @@ t_std_error sdi_sfp_vendor_info_get(sdi_resource_hdl_t resource_hdl,
         return rc;
     }
 
+    /* vendor info is inventory data, let DOM and control go first */
+    prev_prio = sdi_i2c_priority_set(SDI_I2C_PRIO_INVENTORY);
     rc = sdi_smbus_read_multi_byte(sfp_device->bus_hdl, sfp_device->addr.i2c_addr,
                                    offset, data_buf, data_len, SDI_I2C_FLAG_NONE);
+    sdi_i2c_priority_set(prev_prio);
     if (rc != STD_ERR_OK) {
         SDI_DEVICE_ERRMSG_LOG("sfp smbus read failed at addr : %d reg : %d for %s rc : %d",
                               sfp_device->addr, offset, sfp_device->alias, rc);
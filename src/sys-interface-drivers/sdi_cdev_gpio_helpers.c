@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*
+ * filename: sdi_cdev_gpio_helpers.c
+ */
+
+
+/******************************************************************************
+ * @file sdi_cdev_gpio_helpers.c
+ * @brief implements wrappers for requesting gpio lines and reading/writing
+ * their levels via gpio character device (gpio-cdev v2 uapi). Built against
+ * kernel headers without the v2 uapi, line requests fail with ENOTSUP and
+ * pins are accessed via sysfs.
+ *****************************************************************************/
+
+#include "sdi_cdev_gpio_helpers.h"
+#include "sdi_device_common.h"
+#include "std_assert.h"
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/limits.h>
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+
+#define GPIO_CHIP_DEV_PATH              "/dev/%s"
+#define GPIO_CLASS_PATH                 "%s/class/gpio"
+#define GPIO_CHIP_BASE_FILE_PATH        GPIO_CLASS_PATH"/%s/base"
+#define GPIO_CHIP_DEVICE_PATH           GPIO_CLASS_PATH"/%s/device/%s"
+
+#ifdef GPIO_V2_GET_LINE_IOCTL
+
+/**
+ * sdi_cdev_gpio_lines_mask
+ * Get the mask of every line of a line request
+ * param[in] count - no. of lines
+ * return mask of the lines
+ */
+static inline uint64_t sdi_cdev_gpio_lines_mask(uint_t count)
+{
+    return (count >= SDI_CDEV_GPIO_MAX_LINES) ? ~((uint64_t) 0)
+                                              : ((((uint64_t) 1) << count) - 1);
+}
+
+/**
+ * sdi_cdev_gpio_config_fill
+ * Fill the gpio-cdev line configuration from the line configuration
+ * param[in] count - no. of lines
+ * param[in] line_cfg - configuration of the lines
+ * param[out] config - gpio-cdev line configuration
+ * return none
+ */
+static void sdi_cdev_gpio_config_fill(uint_t count,
+                                      const sdi_gpio_line_cfg_t *line_cfg,
+                                      struct gpio_v2_line_config *config)
+{
+    memset(config, 0, sizeof(*config));
+
+    if (line_cfg->direction == SDI_PIN_BUS_OUTPUT) {
+        config->flags = GPIO_V2_LINE_FLAG_OUTPUT;
+        config->num_attrs = 1;
+        config->attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+        config->attrs[0].attr.values = line_cfg->values;
+        config->attrs[0].mask = sdi_cdev_gpio_lines_mask(count);
+    } else {
+        config->flags = GPIO_V2_LINE_FLAG_INPUT;
+        if ((line_cfg->edge == SDI_GPIO_EDGE_RISING)
+            || (line_cfg->edge == SDI_GPIO_EDGE_BOTH)) {
+            config->flags |= GPIO_V2_LINE_FLAG_EDGE_RISING;
+        }
+        if ((line_cfg->edge == SDI_GPIO_EDGE_FALLING)
+            || (line_cfg->edge == SDI_GPIO_EDGE_BOTH)) {
+            config->flags |= GPIO_V2_LINE_FLAG_EDGE_FALLING;
+        }
+    }
+    if (line_cfg->polarity == SDI_PIN_POLARITY_INVERTED) {
+        config->flags |= GPIO_V2_LINE_FLAG_ACTIVE_LOW;
+    }
+}
+
+/**
+ * sdi_cdev_gpio_line_request
+ * Request lines of a gpio chip with the given configuration
+ * param[in] gpio_chip - gpio chip name
+ * param[in] offsets - line offsets on the chip
+ * param[in] count - no. of lines
+ * param[in] consumer - consumer label of the lines
+ * param[in] line_cfg - configuration of the lines
+ * param[out] line_fd - line request fd
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_cdev_gpio_line_request(const char *gpio_chip,
+                                       const uint_t *offsets, uint_t count,
+                                       const char *consumer,
+                                       const sdi_gpio_line_cfg_t *line_cfg,
+                                       int *line_fd)
+{
+    struct gpio_v2_line_request req;
+    char file[PATH_MAX] = {0};
+    t_std_error err = STD_ERR_OK;
+    uint_t index = 0;
+    int chip_fd = -1;
+
+    STD_ASSERT(gpio_chip != NULL);
+    STD_ASSERT(offsets != NULL);
+    STD_ASSERT((count != 0) && (count <= SDI_CDEV_GPIO_MAX_LINES));
+    STD_ASSERT(line_cfg != NULL);
+    STD_ASSERT(line_fd != NULL);
+
+    memset(&req, 0, sizeof(req));
+    for (index = 0; index < count; index++) {
+        req.offsets[index] = offsets[index];
+    }
+    req.num_lines = count;
+    strncpy(req.consumer, consumer, sizeof(req.consumer) - 1);
+    sdi_cdev_gpio_config_fill(count, line_cfg, &req.config);
+
+    snprintf(file, PATH_MAX, GPIO_CHIP_DEV_PATH, gpio_chip);
+    chip_fd = open(file, O_RDWR | O_CLOEXEC);
+    if (chip_fd < 0) {
+        err = SDI_DEVICE_ERRNO;
+        SDI_DEVICE_ERRMSG_LOG("file %s open failed with %d\n", file, err);
+        return err;
+    }
+
+    if (ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req) < 0) {
+        err = SDI_DEVICE_ERRNO;
+        SDI_DEVICE_ERRMSG_LOG("%s line request of %s failed with %d\n",
+            file, consumer, err);
+    } else {
+        /* events are drained until none is left */
+        fcntl(req.fd, F_SETFL, fcntl(req.fd, F_GETFL) | O_NONBLOCK);
+        *line_fd = req.fd;
+    }
+    close(chip_fd);
+
+    return err;
+}
+
+/**
+ * sdi_cdev_gpio_line_config
+ * Reconfigure the lines of a line request
+ * param[in] line_fd - line request fd
+ * param[in] count - no. of lines of the request
+ * param[in] line_cfg - configuration of the lines
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_cdev_gpio_line_config(int line_fd, uint_t count,
+                                      const sdi_gpio_line_cfg_t *line_cfg)
+{
+    struct gpio_v2_line_config config;
+    t_std_error err = STD_ERR_OK;
+
+    STD_ASSERT(line_cfg != NULL);
+
+    sdi_cdev_gpio_config_fill(count, line_cfg, &config);
+    if (ioctl(line_fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) < 0) {
+        err = SDI_DEVICE_ERRNO;
+        SDI_DEVICE_ERRMSG_LOG("line config failed with %d\n", err);
+    }
+    return err;
+}
+
+/**
+ * sdi_cdev_gpio_values_get
+ * Read the levels of every line of a line request
+ * param[in] line_fd - line request fd
+ * param[in] count - no. of lines of the request
+ * param[out] values - levels, by line index
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_cdev_gpio_values_get(int line_fd, uint_t count,
+                                     uint64_t *values)
+{
+    struct gpio_v2_line_values line_values;
+    t_std_error err = STD_ERR_OK;
+
+    STD_ASSERT(values != NULL);
+
+    memset(&line_values, 0, sizeof(line_values));
+    line_values.mask = sdi_cdev_gpio_lines_mask(count);
+    if (ioctl(line_fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &line_values) < 0) {
+        err = SDI_DEVICE_ERRNO;
+        SDI_DEVICE_ERRMSG_LOG("line values get failed with %d\n", err);
+        return err;
+    }
+    *values = line_values.bits & line_values.mask;
+    return err;
+}
+
+/**
+ * sdi_cdev_gpio_values_set
+ * Write the levels of every line of a line request
+ * param[in] line_fd - line request fd
+ * param[in] count - no. of lines of the request
+ * param[in] values - levels, by line index
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_cdev_gpio_values_set(int line_fd, uint_t count,
+                                     uint64_t values)
+{
+    struct gpio_v2_line_values line_values;
+    t_std_error err = STD_ERR_OK;
+
+    memset(&line_values, 0, sizeof(line_values));
+    line_values.mask = sdi_cdev_gpio_lines_mask(count);
+    line_values.bits = values & line_values.mask;
+    if (ioctl(line_fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &line_values) < 0) {
+        err = SDI_DEVICE_ERRNO;
+        SDI_DEVICE_ERRMSG_LOG("line values set failed with %d\n", err);
+    }
+    return err;
+}
+
+/**
+ * sdi_cdev_gpio_events_drain
+ * Read every pending edge event of a line request
+ * param[in] line_fd - line request fd, non blocking
+ * param[out] timestamp_ns - time of the first event read, can be NULL
+ * return no. of events read
+ */
+uint_t sdi_cdev_gpio_events_drain(int line_fd, uint64_t *timestamp_ns)
+{
+    struct gpio_v2_line_event events[16];
+    ssize_t len = 0;
+    uint_t count = 0;
+
+    do {
+        len = read(line_fd, events, sizeof(events));
+        if (len >= (ssize_t) sizeof(events[0])) {
+            /* lines are requested with the default CLOCK_MONOTONIC stamps */
+            if ((count == 0) && (timestamp_ns != NULL)) {
+                *timestamp_ns = events[0].timestamp_ns;
+            }
+            count += (uint_t) (len / sizeof(events[0]));
+        }
+    } while ((len == (ssize_t) sizeof(events))
+             || ((len < 0) && (errno == EINTR)));
+
+    return count;
+}
+
+#else /* !GPIO_V2_GET_LINE_IOCTL */
+
+/**
+ * sdi_cdev_gpio_line_request
+ * gpio-cdev v2 uapi not available, lines are accessed via sysfs
+ * return SDI_DEVICE_ERRCODE(ENOTSUP)
+ */
+t_std_error sdi_cdev_gpio_line_request(const char *gpio_chip,
+                                       const uint_t *offsets, uint_t count,
+                                       const char *consumer,
+                                       const sdi_gpio_line_cfg_t *line_cfg,
+                                       int *line_fd)
+{
+    SDI_DEVICE_ERRMSG_LOG("%s line request of %s not supported, no gpio-cdev v2 uapi\n",
+        gpio_chip, consumer);
+    return SDI_DEVICE_ERRCODE(ENOTSUP);
+}
+
+/**
+ * sdi_cdev_gpio_line_config
+ * gpio-cdev v2 uapi not available, no line request can exist
+ * return SDI_DEVICE_ERRCODE(ENOTSUP)
+ */
+t_std_error sdi_cdev_gpio_line_config(int line_fd, uint_t count,
+                                      const sdi_gpio_line_cfg_t *line_cfg)
+{
+    return SDI_DEVICE_ERRCODE(ENOTSUP);
+}
+
+/**
+ * sdi_cdev_gpio_values_get
+ * gpio-cdev v2 uapi not available, no line request can exist
+ * return SDI_DEVICE_ERRCODE(ENOTSUP)
+ */
+t_std_error sdi_cdev_gpio_values_get(int line_fd, uint_t count,
+                                     uint64_t *values)
+{
+    return SDI_DEVICE_ERRCODE(ENOTSUP);
+}
+
+/**
+ * sdi_cdev_gpio_values_set
+ * gpio-cdev v2 uapi not available, no line request can exist
+ * return SDI_DEVICE_ERRCODE(ENOTSUP)
+ */
+t_std_error sdi_cdev_gpio_values_set(int line_fd, uint_t count,
+                                     uint64_t values)
+{
+    return SDI_DEVICE_ERRCODE(ENOTSUP);
+}
+
+/**
+ * sdi_cdev_gpio_events_drain
+ * gpio-cdev v2 uapi not available, no line request can exist
+ * return 0
+ */
+uint_t sdi_cdev_gpio_events_drain(int line_fd, uint64_t *timestamp_ns)
+{
+    return 0;
+}
+
+#endif /* GPIO_V2_GET_LINE_IOCTL */
+
+/**
+ * sdi_cdev_gpio_chip_base_get
+ * Get the sysfs gpio number of the first line of a gpio chip, by looking up
+ * the sysfs gpiochip<base> entry whose device holds the chip
+ * param[in] gpio_chip - gpio chip name
+ * param[out] base - sysfs gpio number of line 0
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOENT) when the chip is
+ * not exported via sysfs
+ */
+t_std_error sdi_cdev_gpio_chip_base_get(const char *gpio_chip, uint_t *base)
+{
+    char file[PATH_MAX] = {0};
+    char buf[16] = {0};
+    struct dirent *entry = NULL;
+    DIR *dir = NULL;
+    ssize_t len = 0;
+    int fd = -1;
+    t_std_error err = SDI_DEVICE_ERRCODE(ENOENT);
+
+    STD_ASSERT(gpio_chip != NULL);
+    STD_ASSERT(base != NULL);
+
+    snprintf(file, PATH_MAX, GPIO_CLASS_PATH, SYSFS_PATH);
+    dir = opendir(file);
+    if (dir == NULL) {
+        return err;
+    }
+
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "gpiochip", strlen("gpiochip")) != 0) {
+            continue;
+        }
+        snprintf(file, PATH_MAX, GPIO_CHIP_DEVICE_PATH, SYSFS_PATH,
+                 entry->d_name, gpio_chip);
+        if (access(file, F_OK) != 0) {
+            continue;
+        }
+
+        snprintf(file, PATH_MAX, GPIO_CHIP_BASE_FILE_PATH, SYSFS_PATH,
+                 entry->d_name);
+        fd = open(file, O_RDONLY);
+        if (fd < 0) {
+            break;
+        }
+        len = read(fd, buf, sizeof(buf) - 1);
+        close(fd);
+        if (len > 0) {
+            buf[len] = '\0';
+            *base = (uint_t) strtoul(buf, NULL, 0);
+            err = STD_ERR_OK;
+        }
+        break;
+    }
+    closedir(dir);
+
+    return err;
+}
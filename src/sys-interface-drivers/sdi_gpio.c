@@ -27,8 +27,10 @@
 
 #include "sdi_device_common.h"
 #include "sdi_sysfs_gpio_helpers.h"
+#include "sdi_cdev_gpio_helpers.h"
 #include "sdi_driver_internal.h"
 #include "sdi_gpio.h"
+#include "sdi_init_sched.h"
 #include "sdi_pin_bus_framework.h"
 #include "sdi_pin_group_bus_framework.h"
 #include "std_assert.h"
@@ -41,6 +43,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <poll.h>
 
 /**
  * For every supported gpio chip, Linux exports the gpio pins via sysfs interface
@@ -78,6 +81,10 @@
  * - bus_name : gpio pin name
  * - polarity : default logic level to be configured during init
  * (normal/inverted). When not specified, default polarity is 'normal'
+ * - gpio_chip : gpio chip (ex: gpiochip0) whose character device is used to
+ * access the pin/pingroup, pin numbers are then line offsets on the chip.
+ * When not specified, or when the character device can't be used, pins are
+ * accessed via sysfs.
  *
  */
 
@@ -91,9 +98,56 @@
 /* Pin/PinGroup Bus Registration Failure */
 #define BUS_REGISTRATION_FAILURE          -2
 
+/* Line request fd of a Pin/PinGroup Bus accessed via sysfs */
+#define SDI_GPIO_NO_LINE_FD               -1
+
+/**
+ * Verify a shadowed setting of a gpio pin or pin group against the value
+ * read from sysfs, in shadow verify mode
+ * param[in] bus_name - name of the pin/pin group bus
+ * param[in] setting - name of the setting, for logging
+ * param[in] shadow - shadowed value
+ * param[in] actual - value read from sysfs
+ * param[inout] mismatches - no. of mismatches, incremented on mismatch
+ * return true when the shadow matches sysfs, false otherwise
+ */
+static bool sdi_gpio_shadow_match(const char *bus_name, const char *setting,
+                                  uint64_t shadow, uint64_t actual,
+                                  uint_t *mismatches)
+{
+    if (shadow == actual) {
+        return true;
+    }
+    (*mismatches)++;
+    SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s %s shadow 0x%llx doesn't match sysfs 0x%llx,"
+        " resynced\n", __FUNCTION__, __LINE__, bus_name, setting,
+        (unsigned long long) shadow, (unsigned long long) actual);
+    return false;
+}
+
+/**
+ * Reload the shadowed level of a gpio pin accessed via sysfs from
+ * /sys/class/gpio/gpio<num>/value, once the driven level changed behind the
+ * shadow (direction or polarity change)
+ * param[in] gpio_bus - gpio pin
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+static t_std_error sdi_gpio_shadow_level_load(sdi_gpio_pin_t *gpio_bus)
+{
+    bool level = false;
+    t_std_error err = STD_ERR_OK;
+
+    err = sdi_sysfs_gpio_value_read(gpio_bus->gpio_file_tbl->level_fd, &level);
+    if (err == STD_ERR_OK) {
+        gpio_bus->line_cfg.values = level;
+    }
+    return err;
+}
+
 /**
  * Read gpio pin level thats being currently driven by reading the value from
- * /sys/class/gpio/gpio<num>/value
+ * /sys/class/gpio/gpio<num>/value. Level of an output pin is served from the
+ * shadow.
  * param[in] bus - gpio pin bus
  * param[out] value - gpio level read from gpio pin
  * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
@@ -103,9 +157,38 @@ static t_std_error sdi_gpio_level_read (sdi_pin_bus_hdl_t bus,
 {
     sdi_gpio_pin_t *gpio_bus = (sdi_gpio_pin_t *) bus;
     /* bus is already validated by its caller (sdi_pin_read_level) */
+    uint64_t values = 0;
+    bool level = false;
+    bool shadowed = false;
+    t_std_error err = STD_ERR_OK;
+
+    if (gpio_bus->line_fd >= 0) {
+        err = sdi_cdev_gpio_values_get(gpio_bus->line_fd, 1, &values);
+        if (err == STD_ERR_OK) {
+            *value = (values & 1) ? SDI_PIN_LEVEL_HIGH : SDI_PIN_LEVEL_LOW;
+        }
+        return err;
+    }
 
-    return sdi_sysfs_gpio_value_read(
-            gpio_bus->gpio_file_tbl->level_fd, (bool *)value);
+    shadowed = gpio_bus->shadow_valid &&
+               (gpio_bus->line_cfg.direction == SDI_PIN_BUS_OUTPUT);
+    if (shadowed && !gpio_bus->shadow_verify) {
+        *value = (gpio_bus->line_cfg.values & 1) ?
+                    SDI_PIN_LEVEL_HIGH : SDI_PIN_LEVEL_LOW;
+        return err;
+    }
+
+    err = sdi_sysfs_gpio_value_read(gpio_bus->gpio_file_tbl->level_fd, &level);
+    if (err != STD_ERR_OK) {
+        return err;
+    }
+    if (shadowed && !sdi_gpio_shadow_match(bus->bus.bus_name, "level",
+                        gpio_bus->line_cfg.values, level,
+                        &gpio_bus->shadow_mismatches)) {
+        gpio_bus->line_cfg.values = level;
+    }
+    *value = level ? SDI_PIN_LEVEL_HIGH : SDI_PIN_LEVEL_LOW;
+    return err;
 }
 
 /**
@@ -120,12 +203,22 @@ static t_std_error sdi_gpio_level_write (sdi_pin_bus_hdl_t bus,
 {
     sdi_gpio_pin_t *gpio_bus = (sdi_gpio_pin_t *) bus;
     /* bus is already validated by its caller (sdi_pin_write_level) */
+    t_std_error err = STD_ERR_OK;
 
-    return sdi_sysfs_gpio_value_write(gpio_bus->gpio_file_tbl->level_fd, value);
+    if (gpio_bus->line_fd >= 0) {
+        err = sdi_cdev_gpio_values_set(gpio_bus->line_fd, 1, value);
+    } else {
+        err = sdi_sysfs_gpio_value_write(gpio_bus->gpio_file_tbl->level_fd,
+                                         value);
+    }
+    if (err == STD_ERR_OK) {
+        gpio_bus->line_cfg.values = value;
+    }
+    return err;
 }
 
 /**
- * Read direction of gpio from sysfs gpio absolute file path
+ * Read direction of gpio from the shadow, or sysfs gpio absolute file path
  * param[in] bus - gpio pin bus
  * param[out] direction - gpio direction currently configured on gpio pin.
  * SDI_PIN_BUS_INPUT on input pin, SDI_PIN_BUS_OUTPUT on output pin
@@ -136,9 +229,23 @@ static t_std_error sdi_gpio_direction_get (sdi_pin_bus_hdl_t bus,
 {
     sdi_gpio_pin_t *gpio_bus = (sdi_gpio_pin_t *) bus;
     /* bus is already validated by its caller (sdi_pin_get_direction) */
+    t_std_error err = STD_ERR_OK;
+
+    if ((gpio_bus->line_fd >= 0) ||
+        (gpio_bus->shadow_valid && !gpio_bus->shadow_verify)) {
+        *direction = gpio_bus->line_cfg.direction;
+        return err;
+    }
 
-    return sdi_sysfs_gpio_direction_read(
+    err = sdi_sysfs_gpio_direction_read(
         gpio_bus->gpio_file_tbl->direction_fd, direction);
+    if ((err == STD_ERR_OK) && gpio_bus->shadow_valid &&
+        !sdi_gpio_shadow_match(bus->bus.bus_name, "direction",
+                gpio_bus->line_cfg.direction, *direction,
+                &gpio_bus->shadow_mismatches)) {
+        gpio_bus->line_cfg.direction = *direction;
+    }
+    return err;
 }
 
 /**
@@ -153,13 +260,38 @@ static t_std_error sdi_gpio_direction_set (sdi_pin_bus_hdl_t bus,
 {
     sdi_gpio_pin_t *gpio_bus = (sdi_gpio_pin_t *) bus;
     /* bus is already validated by its caller (sdi_pin_set_direction) */
+    sdi_gpio_line_cfg_t line_cfg;
+    t_std_error err = STD_ERR_OK;
 
-    return sdi_sysfs_gpio_direction_write(
+    if (gpio_bus->line_fd >= 0) {
+        line_cfg = gpio_bus->line_cfg;
+        line_cfg.direction = direction;
+        if (direction == SDI_PIN_BUS_OUTPUT) {
+            line_cfg.edge = SDI_GPIO_EDGE_NONE;
+        }
+        err = sdi_cdev_gpio_line_config(gpio_bus->line_fd, 1, &line_cfg);
+        if (err == STD_ERR_OK) {
+            gpio_bus->line_cfg = line_cfg;
+        }
+        return err;
+    }
+
+    err = sdi_sysfs_gpio_direction_write(
         gpio_bus->gpio_file_tbl->direction_fd, direction);
+    if (err != STD_ERR_OK) {
+        return err;
+    }
+    gpio_bus->line_cfg.direction = direction;
+
+    /* sysfs drives a pin turned output low */
+    if (direction == SDI_PIN_BUS_OUTPUT) {
+        err = sdi_gpio_shadow_level_load(gpio_bus);
+    }
+    return err;
 }
 
 /**
- * Read gpio pin's currently configured polarity
+ * Read gpio pin's currently configured polarity from the shadow, or
  * /sys/class/gpio/gpio<num>/active_low
  * param[in] bus - gpio pin bus
  * param[out] polarity - gpio polarity currently configured on gpio pin, can be
@@ -171,9 +303,28 @@ static t_std_error sdi_gpio_polarity_get(sdi_pin_bus_hdl_t bus,
 {
     sdi_gpio_pin_t *gpio_bus = (sdi_gpio_pin_t *) bus;
     /* bus is already validated by its caller (sdi_pin_get_polarity) */
+    bool active_low = false;
+    t_std_error err = STD_ERR_OK;
 
-    return sdi_sysfs_gpio_value_read(
-            gpio_bus->gpio_file_tbl->polarity_fd, (bool *)polarity);
+    if ((gpio_bus->line_fd >= 0) ||
+        (gpio_bus->shadow_valid && !gpio_bus->shadow_verify)) {
+        *polarity = gpio_bus->line_cfg.polarity;
+        return err;
+    }
+
+    err = sdi_sysfs_gpio_value_read(gpio_bus->gpio_file_tbl->polarity_fd,
+                                    &active_low);
+    if (err != STD_ERR_OK) {
+        return err;
+    }
+    *polarity = active_low ? SDI_PIN_POLARITY_INVERTED : SDI_PIN_POLARITY_NORMAL;
+    if (gpio_bus->shadow_valid &&
+        !sdi_gpio_shadow_match(bus->bus.bus_name, "polarity",
+                gpio_bus->line_cfg.polarity, *polarity,
+                &gpio_bus->shadow_mismatches)) {
+        gpio_bus->line_cfg.polarity = *polarity;
+    }
+    return err;
 }
 
 /**
@@ -189,9 +340,31 @@ static t_std_error sdi_gpio_polarity_set(sdi_pin_bus_hdl_t bus,
 {
     sdi_gpio_pin_t *gpio_bus = (sdi_gpio_pin_t *) bus;
     /* bus is already validated by its caller (sdi_pin_set_polarity) */
+    sdi_gpio_line_cfg_t line_cfg;
+    t_std_error err = STD_ERR_OK;
+
+    if (gpio_bus->line_fd >= 0) {
+        line_cfg = gpio_bus->line_cfg;
+        line_cfg.polarity = polarity;
+        err = sdi_cdev_gpio_line_config(gpio_bus->line_fd, 1, &line_cfg);
+        if (err == STD_ERR_OK) {
+            gpio_bus->line_cfg = line_cfg;
+        }
+        return err;
+    }
 
-    return sdi_sysfs_gpio_value_write(
+    err = sdi_sysfs_gpio_value_write(
             gpio_bus->gpio_file_tbl->polarity_fd, polarity);
+    if (err != STD_ERR_OK) {
+        return err;
+    }
+    gpio_bus->line_cfg.polarity = polarity;
+
+    /* sysfs keeps the physical level of an output pin, its level inverts */
+    if (gpio_bus->line_cfg.direction == SDI_PIN_BUS_OUTPUT) {
+        err = sdi_gpio_shadow_level_load(gpio_bus);
+    }
+    return err;
 }
 
 
@@ -208,6 +381,105 @@ static sdi_pin_bus_ops_t sdi_gpio_ops = {
     .sdi_pin_bus_get_polarity = sdi_gpio_polarity_get,
 };
 
+/**
+ * sdi_gpio_event_enable
+ * Enable edge events on a gpio input pin. sysfs value file of the pin
+ * reports POLLPRI | POLLERR once an edge occurs, until read again. The line
+ * request fd of a pin accessed via character device reports POLLIN until
+ * its events are read.
+ * param[in] bus - gpio pin bus handle
+ * param[in] edge - edges to report
+ * param[out] fd - file descriptor to poll for events
+ * param[out] poll_events - poll events reported by fd on an event
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when bus is not
+ * a gpio pin, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_gpio_event_enable(sdi_pin_bus_hdl_t bus, sdi_gpio_edge_t edge,
+                                  int *fd, short *poll_events)
+{
+    sdi_gpio_pin_t *gpio_bus = (sdi_gpio_pin_t *) bus;
+    sdi_gpio_line_cfg_t line_cfg;
+    t_std_error err = STD_ERR_OK;
+
+    STD_ASSERT(bus != NULL);
+    STD_ASSERT(fd != NULL);
+    STD_ASSERT(poll_events != NULL);
+
+    if (bus->ops != &sdi_gpio_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    if (gpio_bus->line_fd >= 0) {
+        line_cfg = gpio_bus->line_cfg;
+        line_cfg.edge = edge;
+        err = sdi_cdev_gpio_line_config(gpio_bus->line_fd, 1, &line_cfg);
+        if (err != STD_ERR_OK) {
+            return err;
+        }
+        gpio_bus->line_cfg = line_cfg;
+        sdi_cdev_gpio_events_drain(gpio_bus->line_fd, NULL);
+        *fd = gpio_bus->line_fd;
+        *poll_events = POLLIN;
+        return STD_ERR_OK;
+    }
+
+    err = sdi_sysfs_gpio_edge_write(gpio_bus->gpio_num, edge);
+    if (err != STD_ERR_OK) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s GPIO %u edge %d can't be set, err: %d\n",
+            __FUNCTION__, __LINE__, bus->bus.bus_name, gpio_bus->gpio_num,
+            edge, err);
+        return err;
+    }
+
+    /* consume the event pending from before the edge got configured */
+    err = sdi_gpio_event_clear(bus, NULL);
+    if (err != STD_ERR_OK) {
+        return err;
+    }
+
+    *fd = gpio_bus->gpio_file_tbl->level_fd;
+    *poll_events = POLLPRI | POLLERR;
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_gpio_event_clear
+ * Clear the pending event of a gpio pin by reading sysfs value file, or the
+ * events of its line request
+ * param[in] bus - gpio pin bus handle
+ * param[out] event - bus, level, edges and timestamp_ns filled, can be NULL
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when bus is not
+ * a gpio pin, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_gpio_event_clear(sdi_pin_bus_hdl_t bus,
+                                 sdi_gpio_event_t *event)
+{
+    sdi_gpio_pin_t *gpio_bus = (sdi_gpio_pin_t *) bus;
+    sdi_pin_bus_level_t value = SDI_PIN_LEVEL_LOW;
+    uint64_t timestamp_ns = 0;
+    uint_t edges = 0;
+    t_std_error err = STD_ERR_OK;
+
+    STD_ASSERT(bus != NULL);
+
+    if (bus->ops != &sdi_gpio_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    if (gpio_bus->line_fd >= 0) {
+        edges = sdi_cdev_gpio_events_drain(gpio_bus->line_fd, &timestamp_ns);
+    }
+
+    err = sdi_gpio_level_read(bus, &value);
+    if ((err == STD_ERR_OK) && (event != NULL)) {
+        event->bus = (sdi_bus_hdl_t) bus;
+        event->level = value;
+        event->edges = edges;
+        event->timestamp_ns = timestamp_ns;
+    }
+    return err;
+}
+
 /**
  * Configure gpio pin default direction, level and polarity as specified in
  * default configuration
@@ -247,6 +519,64 @@ static t_std_error sdi_gpio_default_configuration_set(
         return err;
     }
 
+    gpio_pin->shadow_valid = true;
+    return err;
+}
+
+/**
+ * Request the gpio pin as a line of its gpio chip, configured with default
+ * direction, level and polarity
+ * param[in] gpio_pin - gpio pin object
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+static t_std_error sdi_gpio_line_request(sdi_gpio_pin_t *gpio_pin)
+{
+    sdi_pin_bus_hdl_t pin_bus = &(gpio_pin->bus);
+
+    gpio_pin->line_cfg.direction = pin_bus->default_direction;
+    gpio_pin->line_cfg.polarity = pin_bus->default_polarity;
+    gpio_pin->line_cfg.edge = SDI_GPIO_EDGE_NONE;
+    gpio_pin->line_cfg.values = (pin_bus->default_level == SDI_PIN_LEVEL_HIGH);
+
+    return sdi_cdev_gpio_line_request(gpio_pin->gpio_chip, &gpio_pin->gpio_num,
+                                      1, pin_bus->bus.bus_name,
+                                      &gpio_pin->line_cfg, &gpio_pin->line_fd);
+}
+
+/**
+ * Switch gpio pins from character device to sysfs access, translating line
+ * offsets on their gpio chip to sysfs gpio numbers
+ * param[in] bus_name - name of the pin/pin group bus
+ * param[inout] gpio_chip - gpio chip of the pins, freed and cleared
+ * param[inout] gpio_nums - line offsets of the pins, sysfs gpio numbers on
+ * return
+ * param[in] count - no. of pins
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOENT) when the chip is
+ * not exported via sysfs
+ */
+static t_std_error sdi_gpio_chip_fallback(const char *bus_name,
+                                          char **gpio_chip, uint_t *gpio_nums,
+                                          uint_t count)
+{
+    t_std_error err = STD_ERR_OK;
+    uint_t base = 0;
+    uint_t index = 0;
+
+    err = sdi_cdev_gpio_chip_base_get(*gpio_chip, &base);
+    if (err != STD_ERR_OK) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s %s can't be accessed, err: %d\n",
+            __FUNCTION__, __LINE__, bus_name, *gpio_chip, err);
+        return err;
+    }
+
+    SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s %s accessed via sysfs, base %u\n",
+        __FUNCTION__, __LINE__, bus_name, *gpio_chip, base);
+
+    for (index = 0; index < count; index++) {
+        gpio_nums[index] += base;
+    }
+    free(*gpio_chip);
+    *gpio_chip = NULL;
     return err;
 }
 
@@ -266,6 +596,19 @@ static t_std_error sdi_gpio_driver_init(sdi_bus_hdl_t bus_hdl)
 
     STD_ASSERT(gpio_pin != NULL);
 
+    if (gpio_pin->gpio_chip != NULL) {
+        err = sdi_gpio_line_request(gpio_pin);
+        if (err == STD_ERR_OK) {
+            sdi_init_sched_device_list(bus_hdl);
+            return err;
+        }
+        err = sdi_gpio_chip_fallback(gpio_pin->bus.bus.bus_name,
+                                     &gpio_pin->gpio_chip, &gpio_pin->gpio_num, 1);
+        if (err != STD_ERR_OK) {
+            return err;
+        }
+    }
+
     gpio_no = gpio_pin->gpio_num;
 
     err = sdi_export_gpio(gpio_no);
@@ -283,7 +626,7 @@ static t_std_error sdi_gpio_driver_init(sdi_bus_hdl_t bus_hdl)
         return err;
     }
 
-    sdi_bus_init_device_list(bus_hdl);
+    sdi_init_sched_device_list(bus_hdl);
 
     return err;
 }
@@ -325,6 +668,17 @@ static t_std_error sdi_gpio_driver_register(std_config_node_t node,
     STD_ASSERT(node_attr != NULL);
     gpio_pin->gpio_num = (uint_t) strtoul (node_attr, NULL, 0);
 
+    gpio_pin->line_fd = SDI_GPIO_NO_LINE_FD;
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_GPIO_CHIP);
+    if (node_attr != NULL) {
+        gpio_pin->gpio_chip = strdup(node_attr);
+        STD_ASSERT(gpio_pin->gpio_chip != NULL);
+    }
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_GPIO_SHADOW_VERIFY);
+    gpio_pin->shadow_verify = ((node_attr != NULL) &&
+                               (strcmp(node_attr, "yes") == 0));
+
     node_attr = std_config_attr_get(node, SDI_DEV_ATTR_PIN_DIRECTION);
     if (node_attr != NULL) {
         if ((strncmp(node_attr, SDI_DEV_ATTR_INPUT_PIN,
@@ -404,6 +758,11 @@ static t_std_error sdi_gpio_driver_register(std_config_node_t node,
 
     if (error == STD_ERR_OK) {
         *bus = (sdi_bus_hdl_t ) gpio_pin;
+        /* exported along with every gpio pin registered before its init */
+        if (gpio_pin->gpio_chip == NULL) {
+            sdi_sysfs_gpio_export_queue(gpio_pin->gpio_num);
+        }
+        sdi_init_sched_register((sdi_bus_hdl_t) gpio_pin, node);
         sdi_bus_register_device_list(node, (sdi_bus_hdl_t) gpio_pin);
     }
     else {
@@ -411,6 +770,7 @@ static t_std_error sdi_gpio_driver_register(std_config_node_t node,
             std_mutex_destroy(&(pin_bus->lock));
             free(gpio_pin->gpio_file_tbl);
         }
+        free(gpio_pin->gpio_chip);
         free(gpio_pin);
     }
 
@@ -437,7 +797,57 @@ const sdi_bus_driver_t * sdi_gpio_entry_callbacks(void)
 }
 
 /**
- * Read value of the GPIO Pin Group
+ * Convert between pin group level and levels of its line request: first pin
+ * of the group is the most significant bit of the level, line 0 of the request
+ * param[in] bits - pin group level or line levels
+ * param[in] count - no. of pins in the group
+ * return line levels or pin group level
+ */
+static uint64_t sdi_gpio_group_bits_reverse(uint64_t bits, uint_t count)
+{
+    uint64_t reversed = 0;
+    uint_t index = 0;
+
+    for (index = 0; index < count; index++) {
+        if (bits & (((uint64_t) 1) << index)) {
+            reversed |= ((uint64_t) 1) << (count - index - 1);
+        }
+    }
+    return reversed;
+}
+
+/**
+ * Reload the shadowed levels of a gpio pin group accessed via sysfs from
+ * /sys/class/gpio/gpio<num>/value of its pins, once the driven levels changed
+ * behind the shadow (direction or polarity change)
+ * param[in] gpio_group_hdl - gpio pin group
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+static t_std_error sdi_gpio_group_shadow_level_load(
+    sdi_gpio_group_t *gpio_group_hdl)
+{
+    uint_t gpio_index = 0;
+    uint64_t values = 0;
+    bool level = false;
+    t_std_error err = STD_ERR_OK;
+
+    for (gpio_index = 0; gpio_index < gpio_group_hdl->gpio_count; gpio_index++) {
+        err = sdi_sysfs_gpio_value_read(
+                gpio_group_hdl->gpio_file_tbl[gpio_index]->level_fd, &level);
+        if (err != STD_ERR_OK) {
+            return err;
+        }
+        if (level) {
+            values |= ((uint64_t) 1) << gpio_index;
+        }
+    }
+    gpio_group_hdl->line_cfg.values = values;
+    return err;
+}
+
+/**
+ * Read value of the GPIO Pin Group. Level of an output pin group is served
+ * from the shadow.
  * param[in] bus_hdl - gpio pin bus handle
  * param[out] value - GPIO pin group level currently configured in pin group
  * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
@@ -451,27 +861,53 @@ static t_std_error sdi_gpio_group_level_read(sdi_pin_group_bus_hdl_t bus_hdl,
     uint_t *gpio_group = gpio_group_hdl->gpio_group;
     uint_t gpio_index = 0;
     uint_t gpio_cnt = gpio_group_hdl->gpio_count;
-    sdi_pin_bus_level_t gpio_level = SDI_PIN_LEVEL_LOW;
+    bool gpio_level = false;
+    bool shadowed = false;
     t_std_error err = STD_ERR_OK;
     sdi_gpio_file_fd_tbl_t *gpio_file_tbl = NULL;
+    uint64_t values = 0;
 
     *value = 0;
 
+    if (gpio_group_hdl->line_fd >= 0) {
+        err = sdi_cdev_gpio_values_get(gpio_group_hdl->line_fd, gpio_cnt, &values);
+        if (err != STD_ERR_OK) {
+            SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s level can't be read, err: %d\n",
+                __FUNCTION__, __LINE__, bus_hdl->bus.bus_name, err);
+            return err;
+        }
+        *value = (uint_t) sdi_gpio_group_bits_reverse(values, gpio_cnt);
+        return err;
+    }
+
+    shadowed = gpio_group_hdl->shadow_valid &&
+               (gpio_group_hdl->line_cfg.direction == SDI_PIN_BUS_OUTPUT);
+    if (shadowed && !gpio_group_hdl->shadow_verify) {
+        *value = (uint_t) sdi_gpio_group_bits_reverse(
+                    gpio_group_hdl->line_cfg.values, gpio_cnt);
+        return err;
+    }
+
     for (gpio_index = 0; gpio_index < gpio_cnt; gpio_index++) {
         gpio_file_tbl = gpio_group_hdl->gpio_file_tbl[gpio_index];
-        err = sdi_sysfs_gpio_value_read(gpio_file_tbl->level_fd,
-                                        (bool *)&gpio_level);
+        err = sdi_sysfs_gpio_value_read(gpio_file_tbl->level_fd, &gpio_level);
         if (err != STD_ERR_OK) {
             SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s GPIO %u level can't be read, err: %d\n",
                 __FUNCTION__, __LINE__, bus_hdl->bus.bus_name,
                 gpio_group[gpio_index], err);
             return err;
         }
-        if (gpio_level == SDI_PIN_LEVEL_HIGH) {
+        if (gpio_level) {
             *value |= (1 << (gpio_cnt - gpio_index - 1));
         }
     }
 
+    values = sdi_gpio_group_bits_reverse(*value, gpio_cnt);
+    if (shadowed && !sdi_gpio_shadow_match(bus_hdl->bus.bus_name, "level",
+                        gpio_group_hdl->line_cfg.values, values,
+                        &gpio_group_hdl->shadow_mismatches)) {
+        gpio_group_hdl->line_cfg.values = values;
+    }
     return err;
 }
 /**
@@ -492,11 +928,24 @@ static t_std_error sdi_gpio_group_level_write(sdi_pin_group_bus_hdl_t bus_hdl,
     sdi_pin_bus_level_t gpio_level = SDI_PIN_LEVEL_LOW;
     t_std_error err = STD_ERR_OK;
     sdi_gpio_file_fd_tbl_t *gpio_file_tbl = NULL;
+    uint64_t values = 0;
 
     STD_ASSERT((value < (1 << gpio_cnt)));
 
+    if (gpio_group_hdl->line_fd >= 0) {
+        values = sdi_gpio_group_bits_reverse(value, gpio_cnt);
+        err = sdi_cdev_gpio_values_set(gpio_group_hdl->line_fd, gpio_cnt, values);
+        if (err != STD_ERR_OK) {
+            SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s level can't be set to %u, err: %d\n",
+                __FUNCTION__, __LINE__, bus_hdl->bus.bus_name, value, err);
+            return err;
+        }
+        gpio_group_hdl->line_cfg.values = values;
+        return err;
+    }
+
     for (gpio_index = 0; gpio_index < gpio_cnt; gpio_index++) {
-        if (value & ((gpio_cnt - gpio_index ))) {
+        if (value & (1 << (gpio_cnt - gpio_index - 1))) {
             gpio_level = SDI_PIN_LEVEL_HIGH;
         } else {
             gpio_level = SDI_PIN_LEVEL_LOW;
@@ -510,6 +959,12 @@ static t_std_error sdi_gpio_group_level_write(sdi_pin_group_bus_hdl_t bus_hdl,
                 gpio_group[gpio_index], gpio_level, err);
             return err;
         }
+        /* shadow follows every pin written, even if a later one fails */
+        if (gpio_level == SDI_PIN_LEVEL_HIGH) {
+            gpio_group_hdl->line_cfg.values |= ((uint64_t) 1) << gpio_index;
+        } else {
+            gpio_group_hdl->line_cfg.values &= ~(((uint64_t) 1) << gpio_index);
+        }
     }
     return err;
 }
@@ -531,6 +986,18 @@ static t_std_error sdi_gpio_group_direction_set(sdi_pin_group_bus_hdl_t bus_hdl,
     uint_t gpio_cnt = gpio_group_hdl->gpio_count;
     t_std_error err = STD_ERR_OK;
     sdi_gpio_file_fd_tbl_t *gpio_file_tbl = NULL;
+    sdi_gpio_line_cfg_t line_cfg;
+
+    if (gpio_group_hdl->line_fd >= 0) {
+        line_cfg = gpio_group_hdl->line_cfg;
+        line_cfg.direction = direction;
+        err = sdi_cdev_gpio_line_config(gpio_group_hdl->line_fd, gpio_cnt,
+                                        &line_cfg);
+        if (err == STD_ERR_OK) {
+            gpio_group_hdl->line_cfg = line_cfg;
+        }
+        return err;
+    }
 
     for (gpio_index = 0; gpio_index < gpio_cnt; gpio_index++) {
         gpio_file_tbl = gpio_group_hdl->gpio_file_tbl[gpio_index];
@@ -540,15 +1007,22 @@ static t_std_error sdi_gpio_group_direction_set(sdi_pin_group_bus_hdl_t bus_hdl,
             SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s GPIO %u direction %d can't be set to %d,"
                 " err: %d\n", __FUNCTION__, __LINE__, bus_hdl->bus.bus_name,
                 gpio_group[gpio_index], direction, err);
+            /* pins of the group may now differ, get them from sysfs */
+            gpio_group_hdl->shadow_valid = false;
             return err;
         }
     }
+    gpio_group_hdl->line_cfg.direction = direction;
 
+    /* sysfs drives pins turned output low */
+    if (direction == SDI_PIN_BUS_OUTPUT) {
+        err = sdi_gpio_group_shadow_level_load(gpio_group_hdl);
+    }
     return err;
 }
 
 /**
- * Get configured pin group direction
+ * Get configured pin group direction, from the shadow or sysfs
  * param[in] bus_hdl - gpio pin bus handle
  * param[out] direction - GPIO pin group direction currently configured in pin group
  * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
@@ -566,6 +1040,12 @@ static t_std_error sdi_gpio_group_direction_get(sdi_pin_group_bus_hdl_t bus_hdl,
     sdi_pin_bus_direction_t first_pin_dir = SDI_PIN_BUS_INPUT;
     sdi_gpio_file_fd_tbl_t *gpio_file_tbl = NULL;
 
+    if ((gpio_group_hdl->line_fd >= 0) ||
+        (gpio_group_hdl->shadow_valid && !gpio_group_hdl->shadow_verify)) {
+        *direction = gpio_group_hdl->line_cfg.direction;
+        return err;
+    }
+
     gpio_file_tbl = gpio_group_hdl->gpio_file_tbl[gpio_index];
     err = sdi_sysfs_gpio_direction_read(gpio_file_tbl->direction_fd,
                                         &first_pin_dir);
@@ -592,7 +1072,14 @@ static t_std_error sdi_gpio_group_direction_get(sdi_pin_group_bus_hdl_t bus_hdl,
             return SDI_DEVICE_ERRNO;
         }
     }
+    *direction = first_pin_dir;
 
+    if (gpio_group_hdl->shadow_valid &&
+        !sdi_gpio_shadow_match(bus_hdl->bus.bus_name, "direction",
+                gpio_group_hdl->line_cfg.direction, *direction,
+                &gpio_group_hdl->shadow_mismatches)) {
+        gpio_group_hdl->line_cfg.direction = *direction;
+    }
     return err;
 }
 
@@ -613,6 +1100,18 @@ static t_std_error sdi_gpio_group_polarity_set(sdi_pin_group_bus_hdl_t bus_hdl,
     uint_t gpio_cnt = gpio_group_hdl->gpio_count;
     t_std_error err = STD_ERR_OK;
     sdi_gpio_file_fd_tbl_t *gpio_file_tbl = NULL;
+    sdi_gpio_line_cfg_t line_cfg;
+
+    if (gpio_group_hdl->line_fd >= 0) {
+        line_cfg = gpio_group_hdl->line_cfg;
+        line_cfg.polarity = polarity;
+        err = sdi_cdev_gpio_line_config(gpio_group_hdl->line_fd, gpio_cnt,
+                                        &line_cfg);
+        if (err == STD_ERR_OK) {
+            gpio_group_hdl->line_cfg = line_cfg;
+        }
+        return err;
+    }
 
     for (gpio_index = 0; gpio_index < gpio_cnt; gpio_index++) {
         gpio_file_tbl = gpio_group_hdl->gpio_file_tbl[gpio_index];
@@ -622,15 +1121,22 @@ static t_std_error sdi_gpio_group_polarity_set(sdi_pin_group_bus_hdl_t bus_hdl,
             SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s GPIO %u polarity %d can't be set to %d,"
                 " err: %d\n", __FUNCTION__, __LINE__, bus_hdl->bus.bus_name,
                 gpio_group[gpio_index], polarity, err);
+            /* pins of the group may now differ, get them from sysfs */
+            gpio_group_hdl->shadow_valid = false;
             return err;
         }
     }
+    gpio_group_hdl->line_cfg.polarity = polarity;
 
+    /* sysfs keeps the physical levels of output pins, their levels invert */
+    if (gpio_group_hdl->line_cfg.direction == SDI_PIN_BUS_OUTPUT) {
+        err = sdi_gpio_group_shadow_level_load(gpio_group_hdl);
+    }
     return err;
 }
 
 /**
- * Get current configured pin group polarity
+ * Get current configured pin group polarity, from the shadow or sysfs
  * param[in] bus_hdl - gpio pin bus handle
  * param[in] polarity - current polarity configuration of the given GPIO pin group
  * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
@@ -645,12 +1151,19 @@ static t_std_error sdi_gpio_group_polarity_get(sdi_pin_group_bus_hdl_t bus_hdl,
     uint_t gpio_index = 0;
     uint_t gpio_cnt = gpio_group_hdl->gpio_count;
     t_std_error err = STD_ERR_OK;
-    sdi_pin_bus_polarity_t first_pin_polarity = SDI_PIN_POLARITY_NORMAL;
+    bool first_pin_active_low = false;
+    bool active_low = false;
     sdi_gpio_file_fd_tbl_t *gpio_file_tbl = NULL;
 
+    if ((gpio_group_hdl->line_fd >= 0) ||
+        (gpio_group_hdl->shadow_valid && !gpio_group_hdl->shadow_verify)) {
+        *polarity = gpio_group_hdl->line_cfg.polarity;
+        return err;
+    }
+
     gpio_file_tbl = gpio_group_hdl->gpio_file_tbl[gpio_index];
     err = sdi_sysfs_gpio_value_read(gpio_file_tbl->polarity_fd,
-                                       (bool *) &first_pin_polarity);
+                                    &first_pin_active_low);
     if (err != STD_ERR_OK) {
         SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s GPIO %u polarity can't be read, err: %d\n",
             __FUNCTION__, __LINE__, bus_hdl->bus.bus_name,
@@ -663,18 +1176,26 @@ static t_std_error sdi_gpio_group_polarity_get(sdi_pin_group_bus_hdl_t bus_hdl,
     for (gpio_index = 1; gpio_index < gpio_cnt; gpio_index++) {
         gpio_file_tbl = gpio_group_hdl->gpio_file_tbl[gpio_index];
         err = sdi_sysfs_gpio_value_read(gpio_file_tbl->polarity_fd,
-                                           (bool *)polarity);
+                                        &active_low);
         if (err != STD_ERR_OK) {
             SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s GPIO %u polarity can't be read, err: %d\n",
                 __FUNCTION__, __LINE__, bus_hdl->bus.bus_name,
                 gpio_group[gpio_index], err);
             return err;
         }
-        if (*polarity != first_pin_polarity) {
+        if (active_low != first_pin_active_low) {
             return SDI_DEVICE_ERRNO;
         }
     }
-
+    *polarity = first_pin_active_low ?
+                    SDI_PIN_POLARITY_INVERTED : SDI_PIN_POLARITY_NORMAL;
+
+    if (gpio_group_hdl->shadow_valid &&
+        !sdi_gpio_shadow_match(bus_hdl->bus.bus_name, "polarity",
+                gpio_group_hdl->line_cfg.polarity, *polarity,
+                &gpio_group_hdl->shadow_mismatches)) {
+        gpio_group_hdl->line_cfg.polarity = *polarity;
+    }
     return err;
 }
 
@@ -690,6 +1211,125 @@ static sdi_pin_group_bus_ops_t sdi_gpio_group_ops = {
     .sdi_pin_group_bus_get_polarity = sdi_gpio_group_polarity_get,
 };
 
+/**
+ * sdi_gpio_group_event_enable
+ * Enable edge events on every pin of a gpio input pin group: sysfs value
+ * files of the pins report POLLPRI | POLLERR, the line request fd of a group
+ * accessed via character device reports POLLIN
+ * param[in] bus - gpio pin group bus handle
+ * param[in] edge - edges to report
+ * param[out] fds - file descriptors to poll for events
+ * param[in] max_fds - size of fds
+ * param[out] count - no. of fds filled
+ * param[out] poll_events - poll events reported by fds on an event
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when bus is not
+ * a gpio pin group, SDI_DEVICE_ERRCODE(EINVAL) when fds is too small,
+ * SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_gpio_group_event_enable(sdi_pin_group_bus_hdl_t bus,
+                                        sdi_gpio_edge_t edge, int *fds,
+                                        uint_t max_fds, uint_t *count,
+                                        short *poll_events)
+{
+    sdi_gpio_group_t *gpio_group_hdl = (sdi_gpio_group_t *) bus;
+    sdi_gpio_line_cfg_t line_cfg;
+    uint_t gpio_index = 0;
+    t_std_error err = STD_ERR_OK;
+
+    STD_ASSERT(bus != NULL);
+    STD_ASSERT(fds != NULL);
+    STD_ASSERT(count != NULL);
+    STD_ASSERT(poll_events != NULL);
+
+    if (bus->ops != &sdi_gpio_group_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    if (gpio_group_hdl->line_fd >= 0) {
+        if (max_fds < 1) {
+            return SDI_DEVICE_ERRCODE(EINVAL);
+        }
+        line_cfg = gpio_group_hdl->line_cfg;
+        line_cfg.edge = edge;
+        err = sdi_cdev_gpio_line_config(gpio_group_hdl->line_fd,
+                                        gpio_group_hdl->gpio_count, &line_cfg);
+        if (err != STD_ERR_OK) {
+            return err;
+        }
+        gpio_group_hdl->line_cfg = line_cfg;
+        sdi_cdev_gpio_events_drain(gpio_group_hdl->line_fd, NULL);
+        fds[0] = gpio_group_hdl->line_fd;
+        *count = 1;
+        *poll_events = POLLIN;
+        return STD_ERR_OK;
+    }
+
+    if (max_fds < gpio_group_hdl->gpio_count) {
+        return SDI_DEVICE_ERRCODE(EINVAL);
+    }
+
+    for (gpio_index = 0; gpio_index < gpio_group_hdl->gpio_count; gpio_index++) {
+        err = sdi_sysfs_gpio_edge_write(gpio_group_hdl->gpio_group[gpio_index],
+                                        edge);
+        if (err != STD_ERR_OK) {
+            SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s GPIO %u edge %d can't be set, err: %d\n",
+                __FUNCTION__, __LINE__, bus->bus.bus_name,
+                gpio_group_hdl->gpio_group[gpio_index], edge, err);
+            return err;
+        }
+        fds[gpio_index] = gpio_group_hdl->gpio_file_tbl[gpio_index]->level_fd;
+    }
+
+    /* consume the events pending from before the edges got configured */
+    err = sdi_gpio_group_event_clear(bus, NULL);
+    if (err != STD_ERR_OK) {
+        return err;
+    }
+
+    *count = gpio_group_hdl->gpio_count;
+    *poll_events = POLLPRI | POLLERR;
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_gpio_group_event_clear
+ * Clear the pending events of a gpio pin group by reading the sysfs value
+ * file of every pin, or the events of its line request
+ * param[in] bus - gpio pin group bus handle
+ * param[out] event - bus, level, edges and timestamp_ns filled, can be NULL
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when bus is not
+ * a gpio pin group, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_gpio_group_event_clear(sdi_pin_group_bus_hdl_t bus,
+                                       sdi_gpio_event_t *event)
+{
+    sdi_gpio_group_t *gpio_group_hdl = (sdi_gpio_group_t *) bus;
+    uint64_t timestamp_ns = 0;
+    uint_t edges = 0;
+    uint_t value = 0;
+    t_std_error err = STD_ERR_OK;
+
+    STD_ASSERT(bus != NULL);
+
+    if (bus->ops != &sdi_gpio_group_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    if (gpio_group_hdl->line_fd >= 0) {
+        edges = sdi_cdev_gpio_events_drain(gpio_group_hdl->line_fd,
+                                           &timestamp_ns);
+    }
+
+    err = sdi_gpio_group_level_read(bus, &value);
+    if ((err == STD_ERR_OK) && (event != NULL)) {
+        event->bus = (sdi_bus_hdl_t) bus;
+        event->level = value;
+        event->edges = edges;
+        event->timestamp_ns = timestamp_ns;
+    }
+    return err;
+}
+
 /**
  * Configure gpio pin group with default level, direction and polarity
  * param[in] gpio_group - gpio pin group object pointer
@@ -720,6 +1360,8 @@ static t_std_error set_gpio_group_default_configuration(
     if (err != STD_ERR_OK) {
         return err;
     }
+
+    gpio_group->shadow_valid = true;
     return err;
 }
 
@@ -789,6 +1431,28 @@ static t_std_error sdi_gpio_group_driver_init(sdi_bus_hdl_t bus_hdl)
 
     pin_group_bus = &(gpio_group->bus);
 
+    if (gpio_group->gpio_chip != NULL) {
+        gpio_group->line_cfg.direction = pin_group_bus->default_direction;
+        gpio_group->line_cfg.polarity = pin_group_bus->default_polarity;
+        gpio_group->line_cfg.edge = SDI_GPIO_EDGE_NONE;
+        gpio_group->line_cfg.values = sdi_gpio_group_bits_reverse(
+            pin_group_bus->default_level, gpio_group->gpio_count);
+
+        err = sdi_cdev_gpio_line_request(gpio_group->gpio_chip,
+                    gpio_group->gpio_group, gpio_group->gpio_count,
+                    pin_group_bus->bus.bus_name, &gpio_group->line_cfg,
+                    &gpio_group->line_fd);
+        if (err == STD_ERR_OK) {
+            return err;
+        }
+        err = sdi_gpio_chip_fallback(pin_group_bus->bus.bus_name,
+                    &gpio_group->gpio_chip, gpio_group->gpio_group,
+                    gpio_group->gpio_count);
+        if (err != STD_ERR_OK) {
+            return err;
+        }
+    }
+
     for (gpio_index = 0; gpio_index < gpio_group->gpio_count;
         gpio_index++) {
         gpio_no = gpio_group->gpio_group[gpio_index];
@@ -798,7 +1462,12 @@ static t_std_error sdi_gpio_group_driver_init(sdi_bus_hdl_t bus_hdl)
                 __FUNCTION__, __LINE__, pin_group_bus->bus.bus_name,
                 gpio_no, pin_group_bus->bus.bus_id);
         }
+    }
 
+    /* pins of the group got exported in one pass, open their files */
+    for (gpio_index = 0; gpio_index < gpio_group->gpio_count;
+        gpio_index++) {
+        gpio_no = gpio_group->gpio_group[gpio_index];
         err = sdi_gpio_file_table_init(gpio_no,
                     gpio_group->gpio_file_tbl[gpio_index]);
         if (err != STD_ERR_OK) {
@@ -807,7 +1476,6 @@ static t_std_error sdi_gpio_group_driver_init(sdi_bus_hdl_t bus_hdl)
                 gpio_no, pin_group_bus->bus.bus_id);
             return err;
         }
-
     }
 
     err = set_gpio_group_default_configuration(gpio_group);
@@ -835,6 +1503,7 @@ static t_std_error sdi_gpio_group_driver_register(std_config_node_t node,
     char *node_attr = NULL;
     sdi_pin_group_bus_hdl_t pin_group_bus = NULL;
     t_std_error error = STD_ERR_OK;
+    uint_t gpio_index = 0;
 
     node_attr = std_config_attr_get(node, SDI_DEV_ATTR_PIN_GROUP);
     STD_ASSERT(node_attr != NULL);
@@ -851,6 +1520,18 @@ static t_std_error sdi_gpio_group_driver_register(std_config_node_t node,
 
     create_gpio_group(gpio_group, node_attr);
 
+    gpio_group->line_fd = SDI_GPIO_NO_LINE_FD;
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_GPIO_CHIP);
+    if (node_attr != NULL) {
+        STD_ASSERT(gpio_group->gpio_count <= SDI_CDEV_GPIO_MAX_LINES);
+        gpio_group->gpio_chip = strdup(node_attr);
+        STD_ASSERT(gpio_group->gpio_chip != NULL);
+    }
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_GPIO_SHADOW_VERIFY);
+    gpio_group->shadow_verify = ((node_attr != NULL) &&
+                                 (strcmp(node_attr, "yes") == 0));
+
     node_attr = std_config_attr_get(node, SDI_DEV_ATTR_PIN_LEVEL);
     if (node_attr != NULL) {
         pin_group_bus->default_level = (uint_t) strtoul (node_attr, NULL, 0);
@@ -921,6 +1602,13 @@ static t_std_error sdi_gpio_group_driver_register(std_config_node_t node,
 
     if (error == STD_ERR_OK) {
         *bus = (sdi_bus_hdl_t ) gpio_group;
+        /* exported along with every gpio pin registered before its init */
+        if (gpio_group->gpio_chip == NULL) {
+            for (gpio_index = 0; gpio_index < gpio_group->gpio_count;
+                gpio_index++) {
+                sdi_sysfs_gpio_export_queue(gpio_group->gpio_group[gpio_index]);
+            }
+        }
         sdi_bus_register_device_list(node, (sdi_bus_hdl_t) pin_group_bus);
     } else {
         if (error == BUS_REGISTRATION_FAILURE) {
@@ -928,6 +1616,7 @@ static t_std_error sdi_gpio_group_driver_register(std_config_node_t node,
             free(gpio_group->gpio_file_tbl);
             std_mutex_destroy(&(pin_group_bus->lock));
         }
+        free(gpio_group->gpio_chip);
         free(pin_group_bus);
     }
 
@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+
+/*
+ * filename: sdi_gpio_event.c
+ */
+
+
+/******************************************************************************
+ * Implements the gpio edge event dispatcher: one epoll set and dispatcher
+ * thread for every subscribed gpio pin and pin group.
+ *****************************************************************************/
+
+#include "sdi_gpio_event.h"
+#include "sdi_cdev_gpio_helpers.h"
+#include "sdi_device_common.h"
+#include "sdi_pin_bus_api.h"
+#include "sdi_pin_group_bus_api.h"
+#include "std_mutex_lock.h"
+#include "std_assert.h"
+#include "std_time_tools.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+
+/**
+ * @struct sdi_gpio_event_sub_t
+ * @brief subscribed gpio pin or pin group
+ */
+typedef struct sdi_gpio_event_sub_ {
+    sdi_bus_hdl_t bus; /**< gpio pin or pin group bus */
+    sdi_gpio_event_callback_t callback; /**< event callback */
+    void *data; /**< passed to callback */
+    int fds[SDI_CDEV_GPIO_MAX_LINES]; /**< fds polled for events */
+    uint_t fd_count; /**< no. of fds */
+    short poll_events; /**< poll events reported by fds on an event */
+    bool ready; /**< already in the current batch */
+    struct sdi_gpio_event_sub_ *next; /**< next subscription */
+} sdi_gpio_event_sub_t;
+
+/**
+ * Dispatcher state. Subscriptions live as long as the process.
+ */
+static sdi_gpio_event_sub_t *sdi_gpio_event_subs = NULL;
+static int sdi_gpio_event_epoll_fd = -1;
+static pthread_t sdi_gpio_event_thread;
+static sdi_gpio_event_stats_t sdi_gpio_event_stats;
+static std_mutex_type_t sdi_gpio_event_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * sdi_gpio_event_sub_clear
+ * Clear the pending event of a subscription under its bus lock
+ * param[in] sub - subscription
+ * param[out] event - level, edges and timestamp filled
+ * return STD_ERR_OK on success, error of the level read otherwise
+ */
+static t_std_error sdi_gpio_event_sub_clear(sdi_gpio_event_sub_t *sub,
+                                            sdi_gpio_event_t *event)
+{
+    t_std_error rc = STD_ERR_OK;
+
+    if (sub->bus->bus_type == SDI_PIN_BUS) {
+        rc = sdi_pin_acquire_bus((sdi_pin_bus_hdl_t) sub->bus);
+        if (rc == STD_ERR_OK) {
+            rc = sdi_gpio_event_clear((sdi_pin_bus_hdl_t) sub->bus, event);
+            sdi_pin_release_bus((sdi_pin_bus_hdl_t) sub->bus);
+        }
+    } else {
+        rc = sdi_pin_group_acquire_bus((sdi_pin_group_bus_hdl_t) sub->bus);
+        if (rc == STD_ERR_OK) {
+            rc = sdi_gpio_group_event_clear((sdi_pin_group_bus_hdl_t) sub->bus,
+                                            event);
+            sdi_pin_group_release_bus((sdi_pin_group_bus_hdl_t) sub->bus);
+        }
+    }
+    return rc;
+}
+
+/**
+ * sdi_gpio_event_sub_drain
+ * Consume the pending event of a subscription whose level can't be read, so
+ * that its fds don't stay ready and spin the dispatcher
+ * param[in] sub - subscription
+ * return none
+ */
+static void sdi_gpio_event_sub_drain(sdi_gpio_event_sub_t *sub)
+{
+    char buf[8];
+    uint_t index = 0;
+
+    for (index = 0; index < sub->fd_count; index++) {
+        if (sub->poll_events & POLLIN) {
+            sdi_cdev_gpio_events_drain(sub->fds[index], NULL);
+        } else {
+            /* a sysfs value file is ready until read from the start */
+            if (pread(sub->fds[index], buf, sizeof(buf), 0) < 0) {
+                continue;
+            }
+        }
+    }
+}
+
+/**
+ * sdi_gpio_event_dispatcher
+ * Dispatcher thread: wait for ready fds, clear every ready subscription once
+ * and deliver the batch
+ * param[in] arg - unused
+ * return none
+ */
+static void *sdi_gpio_event_dispatcher(void *arg)
+{
+    struct epoll_event ready[SDI_GPIO_EVENT_MAX_BATCH];
+    sdi_gpio_event_t events[SDI_GPIO_EVENT_MAX_BATCH];
+    sdi_gpio_event_sub_t *subs[SDI_GPIO_EVENT_MAX_BATCH];
+    sdi_gpio_event_sub_t *sub = NULL;
+    uint64_t wakeup_ns = 0;
+    uint64_t latency_ns = 0;
+    uint64_t edges = 0;
+    uint_t errors = 0;
+    uint_t count = 0;
+    uint_t index = 0;
+    int nready = 0;
+    int err = 0;
+
+    for (;;) {
+        nready = epoll_wait(sdi_gpio_event_epoll_fd, ready,
+                            SDI_GPIO_EVENT_MAX_BATCH, -1);
+        if (nready < 0) {
+            err = errno;
+            if (err == EINTR) {
+                continue;
+            }
+            std_mutex_lock(&sdi_gpio_event_lock);
+            sdi_gpio_event_stats.wait_errors++;
+            std_mutex_unlock(&sdi_gpio_event_lock);
+            SDI_DEVICE_ERRMSG_LOG("%s:%d epoll wait failed %d\n",
+                __FUNCTION__, __LINE__, err);
+            std_usleep(MILLI_TO_MICRO(SDI_GPIO_EVENT_ERROR_BACKOFF_MS));
+            continue;
+        }
+        if (nready == 0) {
+            continue;
+        }
+        wakeup_ns = sdi_device_now_ns();
+
+        /* pins of a sysfs pin group may all be ready, clear the group once */
+        count = 0;
+        for (index = 0; index < (uint_t) nready; index++) {
+            sub = (sdi_gpio_event_sub_t *) ready[index].data.ptr;
+            if (sub->ready) {
+                continue;
+            }
+            sub->ready = true;
+            subs[count++] = sub;
+        }
+
+        errors = 0;
+        edges = 0;
+        for (index = 0; index < count; index++) {
+            sub = subs[index];
+            sub->ready = false;
+            memset(&events[index], 0, sizeof(events[index]));
+            if (sdi_gpio_event_sub_clear(sub, &events[index]) != STD_ERR_OK) {
+                sdi_gpio_event_sub_drain(sub);
+                errors++;
+                events[index].bus = sub->bus;
+            }
+            if (events[index].timestamp_ns == 0) {
+                events[index].timestamp_ns = wakeup_ns;
+            }
+            edges += events[index].edges;
+        }
+
+        for (index = 0; index < count; index++) {
+            events[index].dispatch_ns = sdi_device_now_ns();
+            subs[index]->callback(&events[index], subs[index]->data);
+        }
+
+        std_mutex_lock(&sdi_gpio_event_lock);
+        sdi_gpio_event_stats.wakeups++;
+        sdi_gpio_event_stats.events += count;
+        sdi_gpio_event_stats.edges += edges;
+        sdi_gpio_event_stats.clear_errors += errors;
+        sdi_gpio_event_stats.last_depth = count;
+        if (count > sdi_gpio_event_stats.max_depth) {
+            sdi_gpio_event_stats.max_depth = count;
+        }
+        for (index = 0; index < count; index++) {
+            latency_ns = events[index].dispatch_ns - events[index].timestamp_ns;
+            if (events[index].dispatch_ns < events[index].timestamp_ns) {
+                latency_ns = 0;
+            }
+            sdi_gpio_event_stats.latency_total_ns += latency_ns;
+            if (latency_ns > sdi_gpio_event_stats.latency_max_ns) {
+                sdi_gpio_event_stats.latency_max_ns = latency_ns;
+            }
+            sdi_gpio_event_stats.last_timestamp_ns = events[index].timestamp_ns;
+        }
+        std_mutex_unlock(&sdi_gpio_event_lock);
+    }
+
+    return NULL;
+}
+
+/**
+ * sdi_gpio_event_start
+ * Create the epoll set and start the dispatcher thread, if not done yet.
+ * Dispatcher lock held.
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO or SDI_DEVICE_ERRCODE of
+ * pthread error otherwise
+ */
+static t_std_error sdi_gpio_event_start(void)
+{
+    pthread_attr_t attr;
+    t_std_error err = STD_ERR_OK;
+    int rc = 0;
+
+    if (sdi_gpio_event_epoll_fd >= 0) {
+        return STD_ERR_OK;
+    }
+
+    sdi_gpio_event_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (sdi_gpio_event_epoll_fd < 0) {
+        err = SDI_DEVICE_ERRNO;
+        SDI_DEVICE_ERRMSG_LOG("%s:%d epoll create failed %d\n",
+            __FUNCTION__, __LINE__, err);
+        return err;
+    }
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    rc = pthread_create(&sdi_gpio_event_thread, &attr,
+                        sdi_gpio_event_dispatcher, NULL);
+    pthread_attr_destroy(&attr);
+
+    if (rc != 0) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d dispatcher create failed %d\n",
+            __FUNCTION__, __LINE__, rc);
+        close(sdi_gpio_event_epoll_fd);
+        sdi_gpio_event_epoll_fd = -1;
+        return SDI_DEVICE_ERRCODE(rc);
+    }
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_gpio_event_subscribe
+ * Enable edge events on a gpio input pin or pin group and deliver them to a
+ * callback
+ * param[in] bus - gpio pin or gpio pin group bus handle
+ * param[in] edge - edges to report
+ * param[in] callback - event callback
+ * param[in] data - passed to callback
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when bus is not
+ * a gpio pin or pin group, SDI_DEVICE_ERRNO or SDI_DEVICE_ERRCODE of pthread
+ * error on failure
+ */
+t_std_error sdi_gpio_event_subscribe(sdi_bus_hdl_t bus, sdi_gpio_edge_t edge,
+                                     sdi_gpio_event_callback_t callback,
+                                     void *data)
+{
+    sdi_gpio_event_sub_t *sub = NULL;
+    struct epoll_event ev;
+    int fds[SDI_CDEV_GPIO_MAX_LINES];
+    short poll_events = 0;
+    uint_t count = 0;
+    uint_t index = 0;
+    t_std_error err = STD_ERR_OK;
+
+    STD_ASSERT(bus != NULL);
+    STD_ASSERT(callback != NULL);
+
+    if ((bus->bus_type != SDI_PIN_BUS) && (bus->bus_type != SDI_PIN_GROUP_BUS)) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    std_mutex_lock(&sdi_gpio_event_lock);
+
+    do {
+        err = sdi_gpio_event_start();
+        if (err != STD_ERR_OK) {
+            break;
+        }
+
+        if (bus->bus_type == SDI_PIN_BUS) {
+            err = sdi_pin_acquire_bus((sdi_pin_bus_hdl_t) bus);
+            if (err == STD_ERR_OK) {
+                err = sdi_gpio_event_enable((sdi_pin_bus_hdl_t) bus, edge,
+                                            &fds[0], &poll_events);
+                sdi_pin_release_bus((sdi_pin_bus_hdl_t) bus);
+            }
+            count = 1;
+        } else {
+            err = sdi_pin_group_acquire_bus((sdi_pin_group_bus_hdl_t) bus);
+            if (err == STD_ERR_OK) {
+                err = sdi_gpio_group_event_enable((sdi_pin_group_bus_hdl_t) bus,
+                                                  edge, fds, SDI_CDEV_GPIO_MAX_LINES,
+                                                  &count, &poll_events);
+                sdi_pin_group_release_bus((sdi_pin_group_bus_hdl_t) bus);
+            }
+        }
+        if (err != STD_ERR_OK) {
+            SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s events can't be enabled, err: %d\n",
+                __FUNCTION__, __LINE__, bus->bus_name, err);
+            break;
+        }
+
+        sub = (sdi_gpio_event_sub_t *) calloc(sizeof(sdi_gpio_event_sub_t), 1);
+        STD_ASSERT(sub != NULL);
+        sub->bus = bus;
+        sub->callback = callback;
+        sub->data = data;
+        memcpy(sub->fds, fds, count * sizeof(fds[0]));
+        sub->fd_count = count;
+        sub->poll_events = poll_events;
+
+        memset(&ev, 0, sizeof(ev));
+        ev.data.ptr = sub;
+        ev.events = ((poll_events & POLLIN) ? EPOLLIN : 0)
+                    | ((poll_events & POLLPRI) ? EPOLLPRI : 0)
+                    | ((poll_events & POLLERR) ? EPOLLERR : 0);
+        for (index = 0; index < count; index++) {
+            if (epoll_ctl(sdi_gpio_event_epoll_fd, EPOLL_CTL_ADD, fds[index],
+                          &ev) < 0) {
+                err = SDI_DEVICE_ERRNO;
+                SDI_DEVICE_ERRMSG_LOG("%s:%d Bus %s epoll add failed %d\n",
+                    __FUNCTION__, __LINE__, bus->bus_name, err);
+                break;
+            }
+        }
+        if (err != STD_ERR_OK) {
+            while (index > 0) {
+                index--;
+                epoll_ctl(sdi_gpio_event_epoll_fd, EPOLL_CTL_DEL, fds[index], NULL);
+            }
+            free(sub);
+            break;
+        }
+
+        sub->next = sdi_gpio_event_subs;
+        sdi_gpio_event_subs = sub;
+        sdi_gpio_event_stats.subscriptions++;
+    } while (0);
+
+    std_mutex_unlock(&sdi_gpio_event_lock);
+
+    return err;
+}
+
+/**
+ * sdi_gpio_event_stats_get
+ * Get the dispatcher counters
+ * param[out] stats - dispatcher counters
+ * return none
+ */
+void sdi_gpio_event_stats_get(sdi_gpio_event_stats_t *stats)
+{
+    STD_ASSERT(stats != NULL);
+
+    std_mutex_lock(&sdi_gpio_event_lock);
+    *stats = sdi_gpio_event_stats;
+    std_mutex_unlock(&sdi_gpio_event_lock);
+}
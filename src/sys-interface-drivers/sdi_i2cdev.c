@@ -23,10 +23,6 @@
  * Implements SDI I2C Bus Operations for Kernel driven I2C BUS and
  * Registers i2c bus with SDI I2C Bus Framework and registers devices attached
  * to the i2c bus
- * @todo:
- * Additionally 16bit offset read and write supported, which used smbus protocol.
- * However, need to implement it with i2c protocol.
- * To unblock S3000 activities, these changes are pushed.
  *****************************************************************************/
 
 #include "std_assert.h"
@@ -35,10 +31,13 @@
 #include "std_config_node.h"
 #include "sdi_driver_internal.h"
 #include "sdi_i2cdev.h"
+#include "sdi_i2c_batch.h"
+#include "sdi_init_sched.h"
 #include "sdi_common_attr.h"
 #include "sdi_bus_attr.h"
 #include "std_utils.h"
 #include "std_time_tools.h"
+#include "std_mutex_lock.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -50,25 +49,70 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <errno.h>
+#include <time.h>
 #include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 
-#define SDI_MAX_IIC_RETRY 5
-#define SDI_IIC_WAIT_TIME 1000 /*1ms*/
+#define SDI_IIC_ACK_POLL_INTERVAL 100 /*100us*/
+#define SDI_I2C_RDWR_MAX_LEN 8192 /* i2c-dev limit per message */
+#define SDI_I2C_RDWR_STACK_BUF_LEN 64
+#define SDI_I2C_BATCH_STACK_BUF_LEN 256
+
+/**
+ * Error class of a failed i2c/smbus transaction, decides the retry
+ */
+typedef enum {
+    SDI_I2C_ERR_CLASS_NONE,
+    SDI_I2C_ERR_CLASS_ABSENT, /* no ack, device absent */
+    SDI_I2C_ERR_CLASS_TRANSIENT, /* arbitration lost, timeout, bus busy */
+    SDI_I2C_ERR_CLASS_FATAL, /* invalid request, not supported etc */
+} sdi_i2c_err_class_t;
+
+#ifndef I2C_RDWR_IOCTL_MAX_MSGS
+#define I2C_RDWR_IOCTL_MAX_MSGS 42
+#endif
 
 /**
  * format for i2c node representation in configuration:
  * <sys_i2c instance="0" sysfs_name="SMBus SCH adapter at 0400"
- *            bus_name="smbus0">
+ *            bus_name="smbus0" post_xfer_delay_us="0">
  * <!-- sysfs_name is name of the kernel driven i2c bus as in sysfs i2c name file
  *        bus_name is the name of the i2c bus used during look-up operations
+ *        post_xfer_delay_us is the settle time applied after every transaction
  * -->
  *    <i2c_slave_node(s) attributes=..></i2c_slave_node(s)>
  *    <!-- one ore more i2c slaves like tmp75 sensor, eeprom device -->
+ *    <eeprom addr="0x50" write_settle_us="5000" write_ack_poll="yes" ../>
+ *    <!-- settle time policy of a slave overrides the bus default:
+ *        post_xfer_delay_us : settle time after every transaction
+ *        write_settle_us : settle time after every write transaction
+ *        write_ack_poll : poll the slave for ack upto write_settle_us instead
+ *        of sleeping, used for eeprom write cycle
+ *    -->
+ *    <sfp addr="0x50" max_retries="0" ../>
+ *    <!-- retry policy of a slave overrides the bus default:
+ *        max_retries : max retries of transaction failed with transient error
+ *        (arbitration lost, timeout, bus busy). Transactions with no ack from
+ *        slave (absent device) are never retried.
+ *        retry_backoff_us : back off before first retry, doubles every retry
+ *        retry_backoff_max_us : upper bound of back off
+ *    -->
  * </sys_i2c>
  *
  * bus_name is optional. If bus_name is not specified, it is constructed by
  * appending instance to node name.
+ * Settle time attributes are optional and default to 0, i.e. transactions run
+ * back to back at wire speed.
+ * stats_shm="yes" on sys_i2c node keeps the transaction telemetry of the bus
+ * in shared memory object /sdi_i2c_stats.<bus_name>, see sdi_i2c_stats.h
+ * Retry attributes are optional and default to 4 retries, with back off from
+ * 250us upto 4ms. Like settle time, they can be set on sys_i2c node as bus
+ * default.
+ * adapter_wait_ms on sys_i2c node is the max time to wait for the kernel
+ * adapter named sysfs_name to appear, defaults to 1s. Kernel adapters are
+ * indexed by a single sysfs scan shared by all sys_i2c nodes, rescanned only
+ * while an adapter is missing.
  *
  * @todo pending
  * - generate i2c bus instance internally instead of fetching from config file
@@ -112,40 +156,74 @@ SMBUS receive byte command offset
  */
 #define SDI_SMBUS_16BIT_CMD_DEF_OFFSET    0
 
-static inline t_std_error sdi_smbus_write_byte(int i2cdev_fd,
+static inline t_std_error sdi_smbus_write_byte(sdi_sys_i2c_bus_t *bus,
                                                sdi_smbus_operation_t operation,
                                                sdi_smbus_data_type_t data_type,
                                                uint_t commandbuf,
                                                void *buffer);
 
 /**
- * sdi_get_i2c_device_path_by_sysfs_name
- * When I2C Controller is controlled by kernel driver, kernel exports
- * /dev/i2c-N device interface to facilitate user-space applications to
- * access I2C Controller.
- * In case of more than one I2C Controllers driven by kernel, order of
- * enumeration of I2C Controllers can change from one boot to the next.
- * For ex: When system boots, X I2C Controller could get enumerated as
- * /dev/i2c0 on reboot of the system, the same X I2C Controller can get
- * enumerated as /dev/i2c1. To facilitate user to find the i2c dev path
- * for every i2c controller, kernel exports I2C Controller's name in
- * sysfs path for every enumerated I2C bus.
- * This routine finds the i2c device path based on the I2C Controller name.
- *
- * param[in] bus_name I2C Controller's bus name for which i2c dev path
- *    needs to be found
- * param[out] i2c_dev_path I2c dev path for i2c controller, allocated for
- *    PATH_MAX length by caller. ex: "/dev/i2c-1"
- * ex:
- * root:/sys/bus/i2c/devices/i2c-1# cat name
- *  SMBus iSMT adapter at ff782000
- * bus name : SMBus iSMT adapter at ff782000
- * i2c_dev_path : /dev/i2c-1
- * return STD_ERR_OK on success, SDI_DEVICE_ERR_PARAM when given bus_name
- * doesn't exist, SDI_DEVICE_ERRNO for any other error.
+ * Initial no. of entries of the adapter index, grows as needed
  */
-static t_std_error sdi_get_i2c_device_path_by_sysfs_name(const char *bus_name,
-        char *i2c_dev_path)
+#define SDI_I2C_ADAPTER_INDEX_INIT_SIZE  (32)
+
+/**
+ * Interval between sysfs scans while waiting for an adapter to appear
+ */
+#define SDI_I2C_ADAPTER_POLL_INTERVAL    (20000) /* 20ms */
+
+/**
+ * Kernel i2c adapter, as exported under /sys/class/i2c-dev
+ */
+typedef struct sdi_i2c_adapter_ {
+    char name[NAME_MAX]; /* Adapter name, from device/name */
+    char node[NAME_MAX]; /* i2c-dev node name, ex: i2c-1 */
+} sdi_i2c_adapter_t;
+
+/**
+ * Kernel i2c adapter index, built by the first lookup and shared by all
+ * kernel driven i2c buses. Adapters never get renamed, so the index only
+ * grows: rescans open the name file of adapters not yet indexed.
+ */
+static sdi_i2c_adapter_t *sdi_i2c_adapter_index = NULL;
+static uint_t sdi_i2c_adapter_index_size = 0;
+static sdi_i2c_adapter_index_stats_t sdi_i2c_adapter_index_stats;
+static std_mutex_type_t sdi_i2c_adapter_index_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * sdi_i2c_adapter_index_find
+ * Find an adapter in the index. Called with index locked.
+ * param[in] name - adapter name
+ * param[in] node - i2c-dev node name, used when name is NULL
+ * return adapter if indexed, NULL otherwise
+ */
+static sdi_i2c_adapter_t *sdi_i2c_adapter_index_find(const char *name,
+                                                     const char *node)
+{
+    uint_t index = 0;
+    sdi_i2c_adapter_t *adapter = NULL;
+
+    for (index = 0; index < sdi_i2c_adapter_index_stats.adapters; index++) {
+        adapter = &sdi_i2c_adapter_index[index];
+        if ((name != NULL) && (strncmp(adapter->name, name, NAME_MAX) == 0)) {
+            return adapter;
+        }
+        if ((name == NULL) && (strncmp(adapter->node, node, NAME_MAX) == 0)) {
+            return adapter;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * sdi_i2c_adapter_index_scan
+ * Scan sysfs i2c-dev class once and add the adapters not yet indexed.
+ * Adapters whose name can't be read (ex: still being created) are skipped
+ * and picked up by the next scan. Called with index locked.
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO when sysfs i2c-dev class
+ * can't be read
+ */
+static t_std_error sdi_i2c_adapter_index_scan(void)
 {
     DIR *dir = NULL;
     FILE *fp = NULL;
@@ -155,7 +233,9 @@ static t_std_error sdi_get_i2c_device_path_by_sysfs_name(const char *bus_name,
     char *str = NULL;
     char i2cdev[PATH_MAX] = {0};
     char name[PATH_MAX] = {0};
-    t_std_error rc = SDI_DEVICE_ERR_PARAM;
+    sdi_i2c_adapter_t *adapter = NULL;
+    uint64_t start_ns = sdi_i2c_stats_now_ns();
+    t_std_error rc = STD_ERR_OK;
 
     snprintf(i2cdev, PATH_MAX, "%s/class/i2c-dev", SYSFS_PATH);
     if ((dir = opendir(i2cdev)) == NULL) {
@@ -166,8 +246,7 @@ static t_std_error sdi_get_i2c_device_path_by_sysfs_name(const char *bus_name,
     }
 
     /** /sys/class/i2cdev has a dir for each i2c node created by kernel.
-        Each i2c node directory has bus name under device/name.
-        Find the match for our bus and that is the node/devid of our interest */
+        Each i2c node directory has bus name under device/name. */
     while ((ent = readdir(dir)) != NULL) {
         if (strncmp(ent->d_name, CURRENT_DIRECTORY, CURRENT_DIRECTORY_NAME_LEN) == 0) {
             continue;
@@ -175,12 +254,16 @@ static t_std_error sdi_get_i2c_device_path_by_sysfs_name(const char *bus_name,
         if (strncmp(ent->d_name, PARENT_DIRECTORY, PARENT_DIRECTORY_NAME_LEN) == 0) {
             continue;
         }
+        if (sdi_i2c_adapter_index_find(NULL, ent->d_name) != NULL) {
+            continue;
+        }
 
         snprintf(name, PATH_MAX, "%s/%s/device/name", i2cdev, ent->d_name);
         if ((fp = fopen(name, "r")) == NULL) {
-            rc = SDI_DEVICE_ERRNO;
-            SDI_DEVICE_ERRNO_LOG();
-            break;
+            SDI_DEVICE_TRACEMSG_LOG("%s:%d skipped %s, err %d\n",
+                __FUNCTION__, __LINE__, name, errno);
+            sdi_i2c_adapter_index_stats.skipped++;
+            continue;
         }
         sptr = fgets(dev_name, NAME_MAX, fp);
         dev_name[NAME_MAX-1] = 0;
@@ -188,86 +271,451 @@ static t_std_error sdi_get_i2c_device_path_by_sysfs_name(const char *bus_name,
 
         if (sptr == NULL) {
             SDI_DEVICE_ERRNO_LOG();
+            sdi_i2c_adapter_index_stats.skipped++;
             continue;
         }
         if ((str = strchr(dev_name, (int)'\n')) != NULL) {
             *str = 0;
         }
 
-        if (strncmp(dev_name, (char *)bus_name, NAME_MAX) == 0) {
-            snprintf(i2c_dev_path, PATH_MAX, "/dev/%s", ent->d_name);
-            rc = STD_ERR_OK;
-            break;
+        if (sdi_i2c_adapter_index_stats.adapters == sdi_i2c_adapter_index_size) {
+            sdi_i2c_adapter_index_size = (sdi_i2c_adapter_index_size == 0) ?
+                SDI_I2C_ADAPTER_INDEX_INIT_SIZE : (sdi_i2c_adapter_index_size * 2);
+            sdi_i2c_adapter_index = (sdi_i2c_adapter_t *) realloc(
+                sdi_i2c_adapter_index,
+                sdi_i2c_adapter_index_size * sizeof(sdi_i2c_adapter_t));
+            STD_ASSERT(sdi_i2c_adapter_index != NULL);
         }
+        adapter = &sdi_i2c_adapter_index[sdi_i2c_adapter_index_stats.adapters++];
+        safestrncpy(adapter->name, dev_name, NAME_MAX);
+        safestrncpy(adapter->node, ent->d_name, NAME_MAX);
     }
     closedir(dir);
+
+    sdi_i2c_adapter_index_stats.scans++;
+    sdi_i2c_adapter_index_stats.discovery_ns += sdi_i2c_stats_now_ns() - start_ns;
+
+    SDI_DEVICE_TRACEMSG_LOG("%s:%d scan %u indexed %u adapters in %llu ns\n",
+        __FUNCTION__, __LINE__, sdi_i2c_adapter_index_stats.scans,
+        sdi_i2c_adapter_index_stats.adapters,
+        (unsigned long long) sdi_i2c_adapter_index_stats.discovery_ns);
+    return rc;
+}
+
+/**
+ * sdi_get_i2c_device_path_by_sysfs_name
+ * When I2C Controller is controlled by kernel driver, kernel exports
+ * /dev/i2c-N device interface to facilitate user-space applications to
+ * access I2C Controller.
+ * In case of more than one I2C Controllers driven by kernel, order of
+ * enumeration of I2C Controllers can change from one boot to the next.
+ * For ex: When system boots, X I2C Controller could get enumerated as
+ * /dev/i2c0 on reboot of the system, the same X I2C Controller can get
+ * enumerated as /dev/i2c1. To facilitate user to find the i2c dev path
+ * for every i2c controller, kernel exports I2C Controller's name in
+ * sysfs path for every enumerated I2C bus.
+ * This routine finds the i2c device path based on the I2C Controller name,
+ * using the adapter index. When the name is not indexed, sysfs is rescanned
+ * until the adapter appears or wait_ms expires (ex: adapters created by
+ * i2c mux drivers late during boot).
+ *
+ * param[in] bus_name I2C Controller's bus name for which i2c dev path
+ *    needs to be found
+ * param[in] wait_ms max time to wait for the adapter to appear
+ * param[out] i2c_dev_path I2c dev path for i2c controller, allocated for
+ *    PATH_MAX length by caller. ex: "/dev/i2c-1"
+ * ex:
+ * root:/sys/bus/i2c/devices/i2c-1# cat name
+ *  SMBus iSMT adapter at ff782000
+ * bus name : SMBus iSMT adapter at ff782000
+ * i2c_dev_path : /dev/i2c-1
+ * return STD_ERR_OK on success, SDI_DEVICE_ERR_PARAM when given bus_name
+ * doesn't exist, SDI_DEVICE_ERRNO for any other error.
+ */
+static t_std_error sdi_get_i2c_device_path_by_sysfs_name(const char *bus_name,
+        uint_t wait_ms, char *i2c_dev_path)
+{
+    sdi_i2c_adapter_t *adapter = NULL;
+    uint64_t start_ns = sdi_i2c_stats_now_ns();
+    uint64_t deadline_ns = start_ns + ((uint64_t) wait_ms * 1000000ULL);
+    bool waited = false;
+    t_std_error rc = STD_ERR_OK;
+
+    std_mutex_lock(&sdi_i2c_adapter_index_lock);
+
+    if (sdi_i2c_adapter_index_stats.scans == 0) {
+        rc = sdi_i2c_adapter_index_scan();
+    }
+
+    while (rc == STD_ERR_OK) {
+        adapter = sdi_i2c_adapter_index_find(bus_name, NULL);
+        if (adapter != NULL) {
+            snprintf(i2c_dev_path, PATH_MAX, "/dev/%s", adapter->node);
+            break;
+        }
+        if (waited && (sdi_i2c_stats_now_ns() >= deadline_ns)) {
+            rc = SDI_DEVICE_ERR_PARAM;
+            break;
+        }
+        if (wait_ms != 0) {
+            /* let other buses use the index while this one waits */
+            std_mutex_unlock(&sdi_i2c_adapter_index_lock);
+            std_usleep(SDI_I2C_ADAPTER_POLL_INTERVAL);
+            std_mutex_lock(&sdi_i2c_adapter_index_lock);
+        }
+        waited = true;
+        rc = sdi_i2c_adapter_index_scan();
+    }
+
+    if (waited) {
+        sdi_i2c_adapter_index_stats.wait_ns += sdi_i2c_stats_now_ns() - start_ns;
+    }
+
+    std_mutex_unlock(&sdi_i2c_adapter_index_lock);
     return rc;
 }
 
+/**
+ * sdi_sys_i2c_adapter_index_stats_get
+ * Get the counters of the kernel i2c adapter index
+ * param[out] stats - adapter index counters
+ * return none
+ */
+void sdi_sys_i2c_adapter_index_stats_get(sdi_i2c_adapter_index_stats_t *stats)
+{
+    STD_ASSERT(stats != NULL);
+
+    std_mutex_lock(&sdi_i2c_adapter_index_lock);
+    *stats = sdi_i2c_adapter_index_stats;
+    std_mutex_unlock(&sdi_i2c_adapter_index_lock);
+}
+
 /**
  * sdi_i2cdev_acquire_bus
  * Lock the i2c bus before executing a transaction.
  * When the lock is already acquired, this routine will sleep wait until
- * the lock is released.
+ * the lock is handed over, higher i2c priority classes first.
  * param[in] i2c_bus sdi i2c bus handle
- * return STD_ERR_OK on success, non-zero error code on mutex lock failure
+ * return STD_ERR_OK on success, non-zero error code on lock failure
  */
 static t_std_error sdi_i2cdev_acquire_bus (sdi_i2c_bus_hdl_t i2c_bus)
 {
     t_std_error error = STD_ERR_OK;
+    sdi_i2c_prio_t prio = SDI_I2C_PRIO_DEFAULT;
+    uint64_t wait_ns = 0;
 
     sdi_sys_i2c_bus_t * bus = (sdi_sys_i2c_bus_t *) i2c_bus;
 
-    error = std_mutex_lock (&(bus->lock));
+    sdi_init_sched_bus_ready((sdi_bus_hdl_t) i2c_bus);
+
+    error = sdi_i2c_arb_acquire(&(bus->lock), &prio, &wait_ns);
     if (error != STD_ERR_OK) {
         SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %d acquire lock failed\n",
             __FUNCTION__, __LINE__, i2c_bus->bus.bus_id);
+        return error;
     }
+    sdi_i2c_stats_record_lock_wait(bus->stats, prio, wait_ns);
 
     return error;
 }
 
+/**
+ * sdi_sys_i2c_get_policy
+ * Get the settle time policy of an i2c slave
+ * param[in] bus - sys i2c bus
+ * param[in] address - i2c slave address
+ * return slave specific policy if configured, bus default policy otherwise
+ */
+static inline const sdi_i2c_dev_policy_t *sdi_sys_i2c_get_policy(
+    sdi_sys_i2c_bus_t *bus, sdi_i2c_addr_t address)
+{
+    const sdi_i2c_dev_policy_t *policy = NULL;
+
+    if (address < SDI_I2C_MAX_SLAVE_ADDR) {
+        policy = bus->dev_policy[address];
+    }
+    return (policy != NULL) ? policy : &bus->policy;
+}
+
+/**
+ * sdi_sys_i2c_elapsed_us
+ * Get the micro seconds elapsed since start
+ * param[in] start - start time taken using CLOCK_MONOTONIC
+ * return elapsed time in micro seconds
+ */
+static inline uint64_t sdi_sys_i2c_elapsed_us(const struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (((uint64_t)(now.tv_sec - start->tv_sec)) * 1000000ULL) +
+        (now.tv_nsec / 1000) - (start->tv_nsec / 1000);
+}
+
+/**
+ * sdi_sys_i2c_ack_poll
+ * Poll the currently selected slave until it acknowledges its address, used
+ * to detect the completion of an eeprom write cycle. Slave doesn't ack its
+ * address while the write cycle is in progress.
+ * param[in] bus - sys i2c bus
+ * param[in] max_wait_us - upper bound for the poll
+ * return none
+ */
+static void sdi_sys_i2c_ack_poll(sdi_sys_i2c_bus_t *bus, uint_t max_wait_us)
+{
+    struct timespec start;
+    union i2c_smbus_data data = { .byte = 0 };
+    struct i2c_smbus_ioctl_data cmd = { 0 };
+
+    /* Use quick write when supported, as it doesn't move the eeprom's address
+     * pointer, else fall back to receive byte */
+    if (bus->capability & I2C_FUNC_SMBUS_QUICK) {
+        cmd.read_write = I2C_SMBUS_WRITE;
+        cmd.size = I2C_SMBUS_QUICK;
+        cmd.data = NULL;
+    } else {
+        cmd.read_write = I2C_SMBUS_READ;
+        cmd.size = I2C_SMBUS_BYTE;
+        cmd.data = &data;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+        std_usleep(SDI_IIC_ACK_POLL_INTERVAL);
+        if (ioctl(bus->i2cdev_fd, I2C_SMBUS, &cmd) == STD_ERR_OK) {
+            return;
+        }
+    } while (sdi_sys_i2c_elapsed_us(&start) < max_wait_us);
+}
+
+/**
+ * sdi_sys_i2c_settle
+ * Apply the settle time policy of the i2c slave after a transaction
+ * param[in] bus - sys i2c bus
+ * param[in] address - i2c slave address
+ * param[in] is_write - true if the transaction wrote data to the slave
+ * return none
+ */
+static void sdi_sys_i2c_settle(sdi_sys_i2c_bus_t *bus, sdi_i2c_addr_t address,
+                               bool is_write)
+{
+    const sdi_i2c_dev_policy_t *policy = sdi_sys_i2c_get_policy(bus, address);
+
+    if ((is_write) && (policy->write_settle_us != 0)) {
+        if (policy->write_ack_poll) {
+            sdi_sys_i2c_ack_poll(bus, policy->write_settle_us);
+        } else {
+            std_usleep(policy->write_settle_us);
+        }
+    }
+    if (policy->post_xfer_delay_us != 0) {
+        std_usleep(policy->post_xfer_delay_us);
+    }
+}
+
+/**
+ * sdi_sys_i2c_err_class
+ * Classify the errno of a failed i2c/smbus transaction
+ * param[in] err - errno of failed ioctl
+ * return error class
+ */
+static sdi_i2c_err_class_t sdi_sys_i2c_err_class(int err)
+{
+    switch (err) {
+        case ENXIO:     /* no ack for address, device absent */
+        case EREMOTEIO: /* no ack, reported by some adapters */
+        case ENODEV:
+            return SDI_I2C_ERR_CLASS_ABSENT;
+        case EAGAIN:    /* arbitration lost */
+        case EBUSY:     /* bus busy */
+        case ETIMEDOUT: /* bus/clock stretching timeout */
+        case EIO:       /* generic adapter error */
+        case EPROTO:    /* protocol violation */
+        case EBADMSG:   /* PEC mismatch */
+        case EINTR:
+            return SDI_I2C_ERR_CLASS_TRANSIENT;
+        default:
+            return SDI_I2C_ERR_CLASS_FATAL;
+    }
+}
+
+/**
+ * sdi_sys_i2c_retry_wait
+ * Decide whether to retry a failed transaction, as per error class and
+ * retry policy of the slave in transaction, and back off before the retry.
+ * Device absent and non retriable errors fail fast. Transient errors are
+ * retried with exponential back off, capped at retry_backoff_max_us.
+ * A slave nacks its address during its write cycle, so device absent is
+ * retried every SDI_IIC_ACK_POLL_INTERVAL within write_settle_us of a write
+ * completed to the same slave on the same bus segment. Absent slaves fail on
+ * the first nack.
+ * Must be called with bus acquired.
+ * param[in] bus - sys i2c bus
+ * param[in] address - i2c slave address of failed transaction
+ * param[in] err_class - error class of failed transaction
+ * param[in] retry - no. of retries done so far
+ * return true if transaction has to be retried, false otherwise
+ */
+static bool sdi_sys_i2c_retry_wait(sdi_sys_i2c_bus_t *bus,
+                                   sdi_i2c_addr_t address,
+                                   sdi_i2c_err_class_t err_class, uint_t retry)
+{
+    const sdi_i2c_dev_policy_t *policy =
+        (bus->cur_policy != NULL) ? bus->cur_policy : &bus->policy;
+    uint_t backoff = policy->retry_backoff_us;
+
+    switch (err_class) {
+        case SDI_I2C_ERR_CLASS_ABSENT:
+            if ((address < SDI_I2C_MAX_SLAVE_ADDR) && (bus->write_ns[address] != 0)
+                    && (bus->write_segment[address] == bus->cur_segment)
+                    && ((sdi_i2c_stats_now_ns() - bus->write_ns[address])
+                        < (((uint64_t) policy->write_settle_us) * 1000ULL))) {
+                bus->retry_stats.retries++;
+                bus->retry_stats.retry_wait_us += SDI_IIC_ACK_POLL_INTERVAL;
+                std_usleep(SDI_IIC_ACK_POLL_INTERVAL);
+                return true;
+            }
+            bus->retry_stats.absent_failures++;
+            return false;
+        case SDI_I2C_ERR_CLASS_TRANSIENT:
+            break;
+        default:
+            bus->retry_stats.fatal_failures++;
+            return false;
+    }
+
+    if (retry >= policy->max_retries) {
+        bus->retry_stats.transient_failures++;
+        return false;
+    }
+
+    /* exponential back off: backoff * 2^retry, capped */
+    while ((retry-- != 0) && (backoff < policy->retry_backoff_max_us)) {
+        backoff <<= 1;
+    }
+    if (backoff > policy->retry_backoff_max_us) {
+        backoff = policy->retry_backoff_max_us;
+    }
+
+    bus->retry_stats.retries++;
+    bus->retry_stats.retry_wait_us += backoff;
+    if (backoff != 0) {
+        std_usleep(backoff);
+    }
+    return true;
+}
+
+/**
+ * sdi_sys_i2c_write_done
+ * Record a write completed to an i2c slave on the bus segment of the
+ * transaction in progress, the slave may be in its write cycle from now on.
+ * Must be called with bus acquired.
+ * param[in] bus - sys i2c bus
+ * param[in] address - i2c slave address
+ * return none
+ */
+static inline void sdi_sys_i2c_write_done(sdi_sys_i2c_bus_t *bus,
+                                          sdi_i2c_addr_t address)
+{
+    if (address < SDI_I2C_MAX_SLAVE_ADDR) {
+        bus->write_ns[address] = sdi_i2c_stats_now_ns();
+        bus->write_segment[address] = bus->cur_segment;
+    }
+}
+
+/**
+ * sdi_sys_smbus_data_len
+ * Get the no. of data bytes of a smbus transaction
+ * param[in] data_type - SMBUS Transaction size
+ * param[in] data - SMBUS Transaction data
+ * return no. of data bytes
+ */
+static inline size_t sdi_sys_smbus_data_len(sdi_smbus_data_type_t data_type,
+                                            const union i2c_smbus_data *data)
+{
+    switch ((int) data_type) {
+        case I2C_SMBUS_BYTE:
+        case I2C_SMBUS_BYTE_DATA:
+            return 1;
+        case I2C_SMBUS_WORD_DATA:
+        case I2C_SMBUS_PROC_CALL:
+            return 2;
+        case I2C_SMBUS_BLOCK_DATA:
+        case I2C_SMBUS_BLOCK_PROC_CALL:
+        case I2C_SMBUS_I2C_BLOCK_DATA:
+            return (data != NULL) ? data->block[0] : 0;
+        default:
+            return 0;
+    }
+}
+
 /**
  * sdi_sys_smbus_execute
  * Execute the I2C SMBUS transaction by issuing an ioctl to kernel smbus driver
- * param[in] i2cdev_fd - opened file descriptor for i2c bus
+ * param[in] bus - sys i2c bus
  * param[in] operation - SMBUS Read/Write Operation
  * param[in] data_type - SMBUS Transaction size
  * param[in] commandbuf - Address offset of SMBUS Transaction
  * param[out] data - Holds SMBUS Transaction data read/to write.
  * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
  */
-static t_std_error sdi_sys_smbus_execute(int i2cdev_fd,
+static t_std_error sdi_sys_smbus_execute(sdi_sys_i2c_bus_t *bus,
     sdi_smbus_operation_t operation, sdi_smbus_data_type_t data_type,
     uint_t commandbuf, union i2c_smbus_data *data)
 {
+    int i2cdev_fd = bus->i2cdev_fd;
     t_std_error error = STD_ERR_OK;
-    uint_t retry_count = SDI_MAX_IIC_RETRY;
+    uint_t retry = 0;
+    int err = 0;
+    uint64_t start_ns = 0;
+    sdi_i2c_err_class_t err_class = SDI_I2C_ERR_CLASS_NONE;
     struct i2c_smbus_ioctl_data cmd;
     cmd.read_write = operation;
     cmd.command = (uint8_t) commandbuf;
     cmd.size = data_type;
     cmd.data = data;
 
+    start_ns = sdi_i2c_stats_now_ns();
     do {
         error = ioctl(i2cdev_fd, I2C_SMBUS, &cmd);
-        if (error != STD_ERR_OK) {
-            retry_count--;
-            std_usleep(SDI_IIC_WAIT_TIME);
+        if (error == STD_ERR_OK) {
+            err = 0;
+            if ((operation == SDI_SMBUS_WRITE)
+                    && (data_type != I2C_SMBUS_PROC_CALL)
+                    && (data_type != I2C_SMBUS_BLOCK_PROC_CALL)) {
+                sdi_sys_i2c_write_done(bus, bus->cur_address);
+            }
+            break;
+        }
+        err = errno;
+        error = SDI_DEVICE_ERRNO;
+        err_class = sdi_sys_i2c_err_class(err);
+        if (!sdi_sys_i2c_retry_wait(bus, bus->cur_address, err_class, retry)) {
+            break;
         }
-    } while( (error != STD_ERR_OK) && (retry_count != 0) );
+        sdi_i2c_stats_record_retry(bus->stats, bus->cur_address, err);
+        retry++;
+    } while (true);
 
-    std_usleep(SDI_IIC_WAIT_TIME);
+    sdi_i2c_stats_record(bus->stats, bus->cur_address,
+                         sdi_sys_smbus_data_len(data_type, data),
+                         sdi_i2c_stats_now_ns() - start_ns, err);
 
     if (error != STD_ERR_OK) {
-        error = SDI_DEVICE_ERRNO;
-        SDI_DEVICE_ERRMSG_LOG("%s:%d smbus transaction on i2cdev_fd %d,"
-                "operation %d command %d size %d data %p failed %d\n",
-                __FUNCTION__, __LINE__, i2cdev_fd, operation, commandbuf, data_type,
-                data, error);
-    } else if(retry_count != SDI_MAX_IIC_RETRY) {
+        if (err_class == SDI_I2C_ERR_CLASS_ABSENT) {
+            SDI_DEVICE_TRACEMSG_LOG("%s:%d smbus transaction on i2cdev_fd %d,"
+                    "operation %d command %d size %d no ack %d\n",
+                    __FUNCTION__, __LINE__, i2cdev_fd, operation, commandbuf,
+                    data_type, error);
+        } else {
+            SDI_DEVICE_ERRMSG_LOG("%s:%d smbus transaction on i2cdev_fd %d,"
+                    "operation %d command %d size %d data %p failed %d after %u retries\n",
+                    __FUNCTION__, __LINE__, i2cdev_fd, operation, commandbuf, data_type,
+                    data, error, retry);
+        }
+    } else if(retry != 0) {
         SDI_DEVICE_ERRMSG_LOG("%s:%d smbus transaction on i2cdev_fd %d, operation %d command %d size %d data %p is succeeded after %u retries\n",
-                              __FUNCTION__, __LINE__, i2cdev_fd, operation, commandbuf, data_type, data, (SDI_MAX_IIC_RETRY - retry_count));
+                              __FUNCTION__, __LINE__, i2cdev_fd, operation, commandbuf, data_type, data, retry);
     }
 
     return error;
@@ -276,13 +724,13 @@ static t_std_error sdi_sys_smbus_execute(int i2cdev_fd,
 /**
  * sdi_smbus_recv_byte
  * Read a byte using I2C from I2C Bus File descriptor opened on i2cdev_fd
- * param[in] i2cdev_fd - opened file descriptor for i2c bus
+ * param[in] bus - sys i2c bus
  * param[in] operation - SMBUS Read/Write Operation
  * param[in] data_type - SMBUS Transaction size
  * param[out] buffer - Store the result of I2C SMBUS Byte Read Operation
  * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
  */
-static inline t_std_error sdi_smbus_recv_byte(int i2cdev_fd,
+static inline t_std_error sdi_smbus_recv_byte(sdi_sys_i2c_bus_t *bus,
     sdi_smbus_operation_t operation, sdi_smbus_data_type_t data_type,
     void *buffer)
 
@@ -290,7 +738,7 @@ static inline t_std_error sdi_smbus_recv_byte(int i2cdev_fd,
     t_std_error error = STD_ERR_OK;
     union i2c_smbus_data data = { .byte = 0 };
 
-    error = sdi_sys_smbus_execute(i2cdev_fd, operation, data_type,
+    error = sdi_sys_smbus_execute(bus, operation, data_type,
                 SDI_SMBUS_RECV_BYTE_CMD_OFFSET, &data);
     if (error == STD_ERR_OK) {
         *(uint8_t *)buffer = SDI_MAX_BYTE_VAL & data.byte;
@@ -301,17 +749,17 @@ static inline t_std_error sdi_smbus_recv_byte(int i2cdev_fd,
 /**
  * sdi_smbus_send_byte
  * Write a byte using I2C from I2C Bus File descriptor opened on i2cdev_fd
- * param[in] i2cdev_fd - opened file descriptor for i2c bus
+ * param[in] bus - sys i2c bus
  * param[in] operation - SMBUS Read/Write Operation
  * param[in] data_type - SMBUS Transaction size
  * param[in] commandbuf - Address offset for SMBUS Transaction
  * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
  */
-static inline t_std_error sdi_smbus_send_byte(int i2cdev_fd,
+static inline t_std_error sdi_smbus_send_byte(sdi_sys_i2c_bus_t *bus,
     sdi_smbus_operation_t operation, sdi_smbus_data_type_t data_type,
     uint_t commandbuf)
 {
-    return sdi_sys_smbus_execute(i2cdev_fd, operation, data_type,
+    return sdi_sys_smbus_execute(bus, operation, data_type,
         commandbuf, NULL);
 }
 
@@ -320,14 +768,14 @@ static inline t_std_error sdi_smbus_send_byte(int i2cdev_fd,
  * sdi_smbus_read_byte
  * Read a byte from offset specified by commandbuf using I2C from I2C Bus File
  * descriptor opened on i2cdev_fd
- * param[in] i2cdev_fd - opened file descriptor for i2c bus
+ * param[in] bus - sys i2c bus
  * param[in] operation - SMBUS Read/Write Operation
  * param[in] data_type - SMBUS Transaction size
  * param[in] commandbuf - Address offset for SMBUS Transaction
  * param[out] buffer - Store the result of I2C Read in Buffer
  * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
  */
-static inline t_std_error sdi_smbus_read_byte(int i2cdev_fd,
+static inline t_std_error sdi_smbus_read_byte(sdi_sys_i2c_bus_t *bus,
     sdi_smbus_operation_t operation, sdi_smbus_data_type_t data_type,
     uint_t commandbuf, void *buffer)
 
@@ -335,7 +783,7 @@ static inline t_std_error sdi_smbus_read_byte(int i2cdev_fd,
     union i2c_smbus_data data = { .byte = 0 };
     t_std_error error = STD_ERR_OK;
 
-    error = sdi_sys_smbus_execute(i2cdev_fd, operation, data_type,
+    error = sdi_sys_smbus_execute(bus, operation, data_type,
         commandbuf, &data);
     if (error == STD_ERR_OK) {
         *(uint8_t *)buffer = SDI_MAX_BYTE_VAL & data.byte;
@@ -347,30 +795,109 @@ static inline t_std_error sdi_smbus_read_byte(int i2cdev_fd,
  * sdi_smbus_write_byte
  * Write a byte at offset specified by commandbuf using I2C from I2C Bus File
  * descriptor opened on i2cdev_fd
- * param[in] i2cdev_fd - opened file descriptor for i2c bus
+ * param[in] bus - sys i2c bus
  * param[in] operation - SMBUS Read/Write Operation
  * param[in] data_type - SMBUS Transaction size
  * param[in] commandbuf - Address offset for SMBUS Transaction
  * param[out] buffer - Write the byte in Buffer to I2C Bus
  * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
  */
-static inline t_std_error sdi_smbus_write_byte(int i2cdev_fd,
+static inline t_std_error sdi_smbus_write_byte(sdi_sys_i2c_bus_t *bus,
     sdi_smbus_operation_t operation, sdi_smbus_data_type_t data_type,
     uint_t commandbuf, void *buffer)
 {
     union i2c_smbus_data data = { .byte = (*(uint8_t *)buffer) };
 
-    return sdi_sys_smbus_execute(i2cdev_fd, operation, data_type,
+    return sdi_sys_smbus_execute(bus, operation, data_type,
             commandbuf, &data);
 }
 
+/**
+ * sdi_sys_i2c_rdwr
+ * Execute a combined I2C transaction on the I2C Bus File descriptor opened on
+ * i2cdev_fd. Messages are sent back to back with repeated start in between,
+ * with a single stop at the end.
+ * param[in] bus - sys i2c bus
+ * param[in] msgs - list of i2c messages
+ * param[in] nmsgs - no. of i2c messages
+ * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
+ */
+static t_std_error sdi_sys_i2c_rdwr(sdi_sys_i2c_bus_t *bus,
+                                    struct i2c_msg *msgs, uint_t nmsgs)
+{
+    int i2cdev_fd = bus->i2cdev_fd;
+    t_std_error error = STD_ERR_OK;
+    uint_t retry = 0;
+    uint_t index = 0;
+    int err = 0;
+    uint64_t start_ns = 0;
+    size_t bytes = 0;
+    sdi_i2c_err_class_t err_class = SDI_I2C_ERR_CLASS_NONE;
+    struct i2c_rdwr_ioctl_data rdwr = { .msgs = msgs, .nmsgs = nmsgs };
+
+    start_ns = sdi_i2c_stats_now_ns();
+    do {
+        /* I2C_RDWR returns no. of messages transferred on success */
+        if (ioctl(i2cdev_fd, I2C_RDWR, &rdwr) == (int) nmsgs) {
+            error = STD_ERR_OK;
+            err = 0;
+            /* a write followed by a read of the same slave only sets the
+               offset to read */
+            for (index = 0; index < nmsgs; index++) {
+                if ((msgs[index].flags & I2C_M_RD)
+                        || (((index + 1) < nmsgs)
+                            && (msgs[index + 1].flags & I2C_M_RD)
+                            && (msgs[index + 1].addr == msgs[index].addr))) {
+                    continue;
+                }
+                sdi_sys_i2c_write_done(bus, msgs[index].addr);
+            }
+            break;
+        }
+        err = errno;
+        error = SDI_DEVICE_ERRNO;
+        err_class = sdi_sys_i2c_err_class(err);
+        if (!sdi_sys_i2c_retry_wait(bus, msgs[0].addr, err_class, retry)) {
+            break;
+        }
+        sdi_i2c_stats_record_retry(bus->stats, msgs[0].addr, err);
+        retry++;
+    } while (true);
+
+    for (index = 0; index < nmsgs; index++) {
+        bytes += msgs[index].len;
+    }
+    /* combined transaction is accounted to its first slave */
+    sdi_i2c_stats_record(bus->stats, msgs[0].addr, bytes,
+                         sdi_i2c_stats_now_ns() - start_ns, err);
+
+    if (error != STD_ERR_OK) {
+        if (err_class == SDI_I2C_ERR_CLASS_ABSENT) {
+            SDI_DEVICE_TRACEMSG_LOG("%s:%d i2c transaction on i2cdev_fd %d,"
+                    " slave %2x nmsgs %u no ack %d\n", __FUNCTION__, __LINE__,
+                    i2cdev_fd, msgs[0].addr, nmsgs, error);
+        } else {
+            SDI_DEVICE_ERRMSG_LOG("%s:%d i2c transaction on i2cdev_fd %d, slave %2x"
+                    " nmsgs %u failed %d after %u retries\n", __FUNCTION__,
+                    __LINE__, i2cdev_fd, msgs[0].addr, nmsgs, error, retry);
+        }
+    } else if(retry != 0) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d i2c transaction on i2cdev_fd %d, slave %2x"
+                " nmsgs %u is succeeded after %u retries\n", __FUNCTION__,
+                __LINE__, i2cdev_fd, msgs[0].addr, nmsgs, retry);
+    }
+
+    return error;
+}
+
 /**
  * sdi_i2c_read
- * Read a byte from offset specified by commandbuf using I2C from I2C Bus File
- * descriptor opened on i2cdev_fd
- * Note: This api is used, when cmdlen is 2 or 16bit offset. for other cases,
- * use smbus apis.
- * param[in] i2cdev_fd - opened file descriptor for i2c bus
+ * Read buflen bytes from offset specified by cmd using I2C from I2C Bus File
+ * descriptor opened on i2cdev_fd.
+ * Offset write and data read are done as a single combined transaction, when
+ * the bus supports plain I2C. Else only 16bit offset, single byte read is
+ * emulated using smbus transactions, longer reads fail with EOVERFLOW.
+ * param[in] bus - sys i2c bus
  * param[in] address   - I2C slave Address
  * param[in] cmd : list of read offsets
  * param[in] cmdlen : no. of offsets
@@ -380,22 +907,50 @@ static inline t_std_error sdi_smbus_write_byte(int i2cdev_fd,
  * supported flags
  * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
  */
-static inline t_std_error sdi_i2c_read(int i2cdev_fd, sdi_i2c_addr_t address,
+static inline t_std_error sdi_i2c_read(sdi_sys_i2c_bus_t *bus, sdi_i2c_addr_t address,
                                             const uint8_t *cmd, uint_t cmdlen,
                                             void *buf, uint_t buflen, uint_t flag)
 {
     union i2c_smbus_data data = { .byte = 0 };
     t_std_error error = STD_ERR_OK;
+    struct i2c_msg msgs[2];
+    uint_t nmsgs = 0;
+
+    if (bus->capability & I2C_FUNC_I2C) {
+        if ((buflen == 0) || (buflen > SDI_I2C_RDWR_MAX_LEN)
+                || (cmdlen > SDI_I2C_RDWR_MAX_LEN)) {
+            return SDI_DEVICE_ERR_PARAM;
+        }
+        if (cmdlen != 0) {
+            msgs[nmsgs].addr = address;
+            msgs[nmsgs].flags = 0;
+            msgs[nmsgs].len = cmdlen;
+            msgs[nmsgs].buf = (uint8_t *) cmd;
+            nmsgs++;
+        }
+        msgs[nmsgs].addr = address;
+        msgs[nmsgs].flags = I2C_M_RD;
+        msgs[nmsgs].len = buflen;
+        msgs[nmsgs].buf = (uint8_t *) buf;
+        nmsgs++;
+
+        return sdi_sys_i2c_rdwr(bus, msgs, nmsgs);
+    }
 
     if (cmdlen == 2) {
         uint8_t buffer = *cmd;
 
-        error = sdi_smbus_write_byte(i2cdev_fd, SDI_SMBUS_WRITE, I2C_SMBUS_BYTE_DATA,
+        /* Emulation reads a single byte, don't drop the rest silently */
+        if (buflen != 1) {
+            return SDI_DEVICE_ERRCODE(EOVERFLOW);
+        }
+
+        error = sdi_smbus_write_byte(bus, SDI_SMBUS_WRITE, I2C_SMBUS_BYTE_DATA,
                                     *(cmd++), &buffer);
         if (error != STD_ERR_OK) {
             return error;
         }
-        error = sdi_sys_smbus_execute(i2cdev_fd, SDI_SMBUS_READ, I2C_SMBUS_BYTE,
+        error = sdi_sys_smbus_execute(bus, SDI_SMBUS_READ, I2C_SMBUS_BYTE,
                                       SDI_SMBUS_16BIT_CMD_DEF_OFFSET, &data);
     } else {
         return SDI_DEVICE_ERRCODE(EOPNOTSUPP);
@@ -408,11 +963,12 @@ static inline t_std_error sdi_i2c_read(int i2cdev_fd, sdi_i2c_addr_t address,
 
 /**
  * sdi_i2c_write
- * Write a byte at offset specified by offset using I2C from I2C Bus File
- * descriptor opened on i2cdev_fd
- * Note: This api is used, when cmdlen is 2 or 16bit offset. for other cases,
- * use smbus apis.
- * param[in] i2cdev_fd - opened file descriptor for i2c bus
+ * Write buflen bytes at offset specified by cmd using I2C from I2C Bus File
+ * descriptor opened on i2cdev_fd.
+ * Offset and data are written as a single transaction, when the bus supports
+ * plain I2C. Else only 16bit offset, single byte write is emulated using
+ * smbus transaction, longer writes fail with EINVAL.
+ * param[in] bus - sys i2c bus
  * param[in] address   - I2C device Address
  * param[in] cmd : list of write offsets
  * param[in] cmdlen : no. of offsets
@@ -422,15 +978,54 @@ static inline t_std_error sdi_i2c_read(int i2cdev_fd, sdi_i2c_addr_t address,
  * supported flags
  * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
  */
-static inline t_std_error sdi_i2c_write(int i2cdev_fd, sdi_i2c_addr_t address,
+static inline t_std_error sdi_i2c_write(sdi_sys_i2c_bus_t *bus, sdi_i2c_addr_t address,
                                             const uint8_t *cmd, uint_t cmdlen,
                                             void *buf, uint_t buflen, uint_t flag)
 {
     union i2c_smbus_data data;
+    uint8_t xfer_buf[SDI_I2C_RDWR_STACK_BUF_LEN];
+    uint8_t *wr_buf = xfer_buf;
+    struct i2c_msg msg;
+    t_std_error error = STD_ERR_OK;
+
+    if (bus->capability & I2C_FUNC_I2C) {
+        /* Offset and data have to go out in one message, as the slave would
+         * treat a repeated start in between as a new transaction */
+        if ((cmdlen + buflen) > SDI_I2C_RDWR_MAX_LEN) {
+            return SDI_DEVICE_ERR_PARAM;
+        }
+        if ((cmdlen + buflen) > sizeof(xfer_buf)) {
+            wr_buf = (uint8_t *) malloc(cmdlen + buflen);
+            if (wr_buf == NULL) {
+                return SDI_DEVICE_ERRCODE(ENOMEM);
+            }
+        }
+        if (cmdlen != 0) {
+            memcpy(wr_buf, cmd, cmdlen);
+        }
+        if (buflen != 0) {
+            memcpy(wr_buf + cmdlen, buf, buflen);
+        }
+
+        msg.addr = address;
+        msg.flags = 0;
+        msg.len = cmdlen + buflen;
+        msg.buf = wr_buf;
+
+        error = sdi_sys_i2c_rdwr(bus, &msg, 1);
+
+        if (wr_buf != xfer_buf) {
+            free(wr_buf);
+        }
+        return error;
+    }
 
     if (cmdlen == 2) {
+        if (buflen != 1) {
+            return SDI_DEVICE_ERRCODE(EINVAL);
+        }
         data.word = (*cmd | ((*(uint8_t *)buf) << BITS_PER_BYTE));
-        return sdi_sys_smbus_execute(i2cdev_fd, SDI_SMBUS_WRITE, I2C_SMBUS_WORD_DATA,
+        return sdi_sys_smbus_execute(bus, SDI_SMBUS_WRITE, I2C_SMBUS_WORD_DATA,
                                      *(cmd++), &data);
     } else {
         return SDI_DEVICE_ERRCODE(EOPNOTSUPP);
@@ -441,14 +1036,14 @@ static inline t_std_error sdi_i2c_write(int i2cdev_fd, sdi_i2c_addr_t address,
  * sdi_smbus_read_word
  * Read a word from offset specified by commandbuf using I2C from I2C Bus File
  * descriptor opened on i2cdev_fd
- * param[in] i2cdev_fd - opened file descriptor for i2c bus
+ * param[in] bus - sys i2c bus
  * param[in] operation - SMBUS Read/Write Operation
  * param[in] data_type - SMBUS Transaction size
  * param[in] commandbuf - Address offset for SMBUS Transaction
  * param[out] buffer - Store the result of I2C Read in Buffer
  * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
  */
-static inline t_std_error sdi_smbus_read_word(int i2cdev_fd,
+static inline t_std_error sdi_smbus_read_word(sdi_sys_i2c_bus_t *bus,
     sdi_smbus_operation_t operation, sdi_smbus_data_type_t data_type,
     uint_t commandbuf, void *buffer)
 
@@ -456,7 +1051,7 @@ static inline t_std_error sdi_smbus_read_word(int i2cdev_fd,
     t_std_error error = STD_ERR_OK;
     union i2c_smbus_data data = { .word = 0 };
 
-    error = sdi_sys_smbus_execute(i2cdev_fd, operation, data_type,
+    error = sdi_sys_smbus_execute(bus, operation, data_type,
             commandbuf, &data);
     if (error == STD_ERR_OK) {
         *(uint16_t *)buffer = SDI_MAX_WORD_VAL & data.word;
@@ -468,60 +1063,348 @@ static inline t_std_error sdi_smbus_read_word(int i2cdev_fd,
  * sdi_smbus_write_word
  * Write a word at offset specified by commandbuf using I2C from I2C Bus File
  * descriptor opened on i2cdev_fd
- * param[in] i2cdev_fd - opened file descriptor for i2c bus
+ * param[in] bus - sys i2c bus
  * param[in] operation - SMBUS Read/Write Operation
  * param[in] data_type - SMBUS Transaction size
  * param[in] commandbuf - Address offset for SMBUS Transaction
  * param[out] buffer - Write the byte in Buffer to I2C Bus
  * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
  */
-static inline t_std_error sdi_smbus_write_word(int i2cdev_fd,
+static inline t_std_error sdi_smbus_write_word(sdi_sys_i2c_bus_t *bus,
     sdi_smbus_operation_t operation, sdi_smbus_data_type_t data_type,
     uint_t commandbuf, void *buffer)
 {
     union i2c_smbus_data data = { .word = (*(uint16_t *)buffer) };
 
-    return sdi_sys_smbus_execute(i2cdev_fd, operation, data_type,
+    return sdi_sys_smbus_execute(bus, operation, data_type,
             commandbuf, &data);
 }
 
 /**
- * sdi_i2cdev_i2c_execute
- * Execute I2C transaction
- * param[in] i2c_bus - I2C Bus handle
- * param[in] address - I2C Slave Address
- * param[in] operation - I2C Read/Write Operation
- * @param[in] cmd : list of read/write offsets
- * @param[in] cmdlen : no. of offsets
- * @param[out] buffer - data read from/written to slave
- * @param[in] buflen : no.of bytes to read/write
- * param[in] flags - options if any to be send to i2c execute
+ * sdi_smbus_read_i2c_block
+ * Read block_len bytes from offset specified by commandbuf. Uses smbus i2c
+ * block read of upto I2C_SMBUS_BLOCK_MAX bytes per transaction, or a single
+ * combined i2c transaction when the bus doesn't support smbus i2c block read.
+ * param[in] bus - sys i2c bus
+ * param[in] address - I2C slave Address
+ * param[in] commandbuf - Address offset for SMBUS Transaction
+ * param[out] buffer - Store the result of I2C Read in Buffer
+ * param[in] block_len - no. of bytes to read
  * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure,
- * SDI_DEVICE_ERRCODE(ENOTSUP) on unsupported operation
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when bus supports neither
  */
-static t_std_error sdi_i2cdev_i2c_execute(sdi_i2c_bus_hdl_t i2c_bus,
-                   sdi_i2c_addr_t address, sdi_i2c_operation_t operation,
-                   const uint8_t *cmd, uint_t cmdlen, void *buffer, uint_t buflen,
-                   uint_t flags)
+static t_std_error sdi_smbus_read_i2c_block(sdi_sys_i2c_bus_t *bus,
+    sdi_i2c_addr_t address, uint_t commandbuf, void *buffer, size_t block_len)
+{
+    union i2c_smbus_data data;
+    t_std_error error = STD_ERR_OK;
+    uint8_t *buf = (uint8_t *) buffer;
+    uint8_t offset = (uint8_t) commandbuf;
+    size_t len = 0;
+
+    if ((block_len == 0) || ((commandbuf + block_len) > (SDI_MAX_BYTE_VAL + 1))) {
+        return SDI_DEVICE_ERR_PARAM;
+    }
+
+    if (!(bus->capability & I2C_FUNC_SMBUS_READ_I2C_BLOCK)) {
+        if (bus->capability & I2C_FUNC_I2C) {
+            return sdi_i2c_read(bus, address, &offset, sizeof(offset), buffer,
+                                block_len, SDI_I2C_FLAG_NONE);
+        }
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    while (block_len != 0) {
+        len = (block_len > I2C_SMBUS_BLOCK_MAX) ? I2C_SMBUS_BLOCK_MAX : block_len;
+        data.block[0] = len;
+        error = sdi_sys_smbus_execute(bus, SDI_SMBUS_READ,
+                    I2C_SMBUS_I2C_BLOCK_DATA, offset, &data);
+        if (error != STD_ERR_OK) {
+            return error;
+        }
+        memcpy(buf, &data.block[1], len);
+        buf += len;
+        offset += len;
+        block_len -= len;
+    }
+    return error;
+}
+
+/**
+ * sdi_smbus_write_i2c_block
+ * Write block_len bytes at offset specified by commandbuf. Uses smbus i2c
+ * block write of upto I2C_SMBUS_BLOCK_MAX bytes per transaction, or plain i2c
+ * transactions when the bus doesn't support smbus i2c block write. Writes
+ * longer than a block are split on the write page boundaries of the slave,
+ * with the write settle time of the slave applied between the pages.
+ * param[in] bus - sys i2c bus
+ * param[in] address - I2C slave Address
+ * param[in] commandbuf - Address offset for SMBUS Transaction
+ * param[in] buffer - data to be written to slave
+ * param[in] block_len - no. of bytes to write
+ * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when bus supports neither,
+ * SDI_DEVICE_ERRCODE(EINVAL) when block_len is longer than I2C_SMBUS_BLOCK_MAX
+ * and slave has no write page size configured
+ */
+static t_std_error sdi_smbus_write_i2c_block(sdi_sys_i2c_bus_t *bus,
+    sdi_i2c_addr_t address, uint_t commandbuf, void *buffer, size_t block_len)
+{
+    union i2c_smbus_data data;
+    t_std_error error = STD_ERR_OK;
+    const sdi_i2c_dev_policy_t *policy = sdi_sys_i2c_get_policy(bus, address);
+    uint8_t *buf = (uint8_t *) buffer;
+    uint8_t offset = (uint8_t) commandbuf;
+    size_t page_size = I2C_SMBUS_BLOCK_MAX;
+    size_t len = 0;
+    bool use_i2c = false;
+
+    if ((block_len == 0) || ((commandbuf + block_len) > (SDI_MAX_BYTE_VAL + 1))) {
+        return SDI_DEVICE_ERR_PARAM;
+    }
+
+    /* Slave wraps around with in its write page, so a write can't be
+     * split without knowing the page size */
+    if (policy->write_page_size == 0) {
+        if (block_len > I2C_SMBUS_BLOCK_MAX) {
+            return SDI_DEVICE_ERRCODE(EINVAL);
+        }
+    } else if (policy->write_page_size < page_size) {
+        page_size = policy->write_page_size;
+    }
+
+    if (!(bus->capability & I2C_FUNC_SMBUS_WRITE_I2C_BLOCK)) {
+        if (!(bus->capability & I2C_FUNC_I2C)) {
+            return SDI_DEVICE_ERRCODE(ENOTSUP);
+        }
+        use_i2c = true;
+    }
+
+    while (block_len != 0) {
+        len = page_size - (offset % page_size);
+        if (len > block_len) {
+            len = block_len;
+        }
+        if (use_i2c) {
+            error = sdi_i2c_write(bus, address, &offset, sizeof(offset), buf,
+                                  len, SDI_I2C_FLAG_NONE);
+        } else {
+            data.block[0] = len;
+            memcpy(&data.block[1], buf, len);
+            error = sdi_sys_smbus_execute(bus, SDI_SMBUS_WRITE,
+                        I2C_SMBUS_I2C_BLOCK_DATA, offset, &data);
+        }
+        if (error != STD_ERR_OK) {
+            return error;
+        }
+        buf += len;
+        offset += len;
+        block_len -= len;
+        /* Settle after the last page is applied by the caller */
+        if (block_len != 0) {
+            sdi_sys_i2c_settle(bus, address, true);
+        }
+    }
+    return error;
+}
+
+/**
+ * sdi_smbus_read_block
+ * Read a smbus block from command specified by commandbuf. Slave sends the
+ * byte count followed by the data.
+ * param[in] bus - sys i2c bus
+ * param[in] commandbuf - Command for SMBUS Transaction
+ * param[out] buffer - Store the result of block read in Buffer
+ * param[inout] block_len - in: size of buffer, out: no. of bytes read
+ * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when bus doesn't support smbus block read,
+ * SDI_DEVICE_ERRCODE(EOVERFLOW) when slave sends more than buffer size
+ */
+static t_std_error sdi_smbus_read_block(sdi_sys_i2c_bus_t *bus,
+    uint_t commandbuf, void *buffer, size_t *block_len)
+{
+    union i2c_smbus_data data;
+    t_std_error error = STD_ERR_OK;
+
+    if (!(bus->capability & I2C_FUNC_SMBUS_READ_BLOCK_DATA)) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    data.block[0] = 0;
+    error = sdi_sys_smbus_execute(bus, SDI_SMBUS_READ, I2C_SMBUS_BLOCK_DATA,
+                commandbuf, &data);
+    if (error != STD_ERR_OK) {
+        return error;
+    }
+    if (data.block[0] > *block_len) {
+        return SDI_DEVICE_ERRCODE(EOVERFLOW);
+    }
+    memcpy(buffer, &data.block[1], data.block[0]);
+    *block_len = data.block[0];
+    return error;
+}
+
+/**
+ * sdi_smbus_write_block
+ * Write a smbus block at command specified by commandbuf. Byte count is sent
+ * ahead of the data.
+ * param[in] bus - sys i2c bus
+ * param[in] commandbuf - Command for SMBUS Transaction
+ * param[in] buffer - data to be written to slave
+ * param[in] block_len - no. of bytes to write, upto I2C_SMBUS_BLOCK_MAX
+ * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when bus doesn't support smbus block write
+ */
+static t_std_error sdi_smbus_write_block(sdi_sys_i2c_bus_t *bus,
+    uint_t commandbuf, void *buffer, size_t block_len)
+{
+    union i2c_smbus_data data;
+
+    if (!(bus->capability & I2C_FUNC_SMBUS_WRITE_BLOCK_DATA)) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    if ((block_len == 0) || (block_len > I2C_SMBUS_BLOCK_MAX)) {
+        return SDI_DEVICE_ERR_PARAM;
+    }
+
+    data.block[0] = block_len;
+    memcpy(&data.block[1], buffer, block_len);
+    return sdi_sys_smbus_execute(bus, SDI_SMBUS_WRITE, I2C_SMBUS_BLOCK_DATA,
+                commandbuf, &data);
+}
+
+/**
+ * sdi_smbus_block_proc_call
+ * Write a smbus block at command specified by commandbuf and read back the
+ * block sent by slave, in a single transaction.
+ * param[in] bus - sys i2c bus
+ * param[in] commandbuf - Command for SMBUS Transaction
+ * param[inout] buffer - in: data to be written, out: data read from slave.
+ * Must be able to hold I2C_SMBUS_BLOCK_MAX bytes
+ * param[inout] block_len - in: no. of bytes to write, out: no. of bytes read
+ * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) when bus doesn't support block process call
+ */
+static t_std_error sdi_smbus_block_proc_call(sdi_sys_i2c_bus_t *bus,
+    uint_t commandbuf, void *buffer, size_t *block_len)
+{
+    union i2c_smbus_data data;
+    t_std_error error = STD_ERR_OK;
+
+    if (!(bus->capability & I2C_FUNC_SMBUS_BLOCK_PROC_CALL)) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    if ((*block_len == 0) || (*block_len > I2C_SMBUS_BLOCK_MAX)) {
+        return SDI_DEVICE_ERR_PARAM;
+    }
+
+    data.block[0] = *block_len;
+    memcpy(&data.block[1], buffer, *block_len);
+    /* process call is a write from kernel's point of view */
+    error = sdi_sys_smbus_execute(bus, SDI_SMBUS_WRITE,
+                I2C_SMBUS_BLOCK_PROC_CALL, commandbuf, &data);
+    if (error != STD_ERR_OK) {
+        return error;
+    }
+    memcpy(buffer, &data.block[1], data.block[0]);
+    *block_len = data.block[0];
+    return error;
+}
+
+/**
+ * sdi_sys_i2c_client_set
+ * Program the slave address and PEC mode of the next transaction on the
+ * i2c-dev file descriptor of the bus. i2c-dev keeps both until changed, so
+ * ioctls are only issued when they differ from the programmed ones. Called
+ * with bus acquired.
+ * param[in] bus - sys i2c bus
+ * param[in] address - i2c slave address
+ * param[in] pec - true to enable PEC
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+static t_std_error sdi_sys_i2c_client_set(sdi_sys_i2c_bus_t *bus,
+                                          sdi_i2c_addr_t address, bool pec)
 {
-    sdi_sys_i2c_bus_t * bus = (sdi_sys_i2c_bus_t *) i2c_bus;
-    int i2cdev_fd = bus->i2cdev_fd;
     t_std_error error = STD_ERR_OK;
 
-    if (ioctl(i2cdev_fd, I2C_SLAVE, address) != STD_ERR_OK) {
+    if (bus->client_valid && (bus->client_address == address)) {
+        bus->client_stats.slave_skipped++;
+    } else {
+        bus->client_stats.slave_set++;
+        if (ioctl(bus->i2cdev_fd, I2C_SLAVE, address) != STD_ERR_OK) {
+            error = SDI_DEVICE_ERRNO;
+            /* address programmed is unknown, set it on next transaction */
+            bus->client_valid = false;
+            SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %d set slave %2x failed %d\n",
+                __FUNCTION__, __LINE__, bus->bus.bus.bus_id, address, error);
+            return error;
+        }
+        if (!bus->client_valid) {
+            /* PEC mode of the descriptor isn't known either */
+            bus->client_pec = !pec;
+        }
+        bus->client_address = address;
+        bus->client_valid = true;
+    }
+
+    if (bus->client_pec == pec) {
+        bus->client_stats.pec_skipped++;
+        return STD_ERR_OK;
+    }
+
+    bus->client_stats.pec_set++;
+    if (ioctl(bus->i2cdev_fd, I2C_PEC, (pec ? 1 : 0)) != STD_ERR_OK) {
         error = SDI_DEVICE_ERRNO;
-        SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %d set slave %2x failed %d",
-            __FUNCTION__, __LINE__, i2c_bus->bus.bus_id, address, error);
+        bus->client_valid = false;
+        SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %d set PEC failed %d\n",
+            __FUNCTION__, __LINE__, bus->bus.bus.bus_id, error);
+        return error;
+    }
+    bus->client_pec = pec;
+
+    return error;
+}
+
+/**
+ * sdi_i2cdev_i2c_execute
+ * Execute I2C transaction
+ * param[in] i2c_bus - I2C Bus handle
+ * param[in] address - I2C Slave Address
+ * param[in] operation - I2C Read/Write Operation
+ * @param[in] cmd : list of read/write offsets
+ * @param[in] cmdlen : no. of offsets
+ * @param[out] buffer - data read from/written to slave
+ * @param[in] buflen : no.of bytes to read/write
+ * param[in] flags - options if any to be send to i2c execute
+ * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure,
+ * SDI_DEVICE_ERRCODE(ENOTSUP) on unsupported operation
+ */
+static t_std_error sdi_i2cdev_i2c_execute(sdi_i2c_bus_hdl_t i2c_bus,
+                   sdi_i2c_addr_t address, sdi_i2c_operation_t operation,
+                   const uint8_t *cmd, uint_t cmdlen, void *buffer, uint_t buflen,
+                   uint_t flags)
+{
+    sdi_sys_i2c_bus_t * bus = (sdi_sys_i2c_bus_t *) i2c_bus;
+    t_std_error error = STD_ERR_OK;
+
+    bus->cur_policy = sdi_sys_i2c_get_policy(bus, address);
+    bus->cur_address = address;
+
+    /* PEC doesn't apply to plain i2c messages, keep the programmed mode.
+       The smbus emulation without plain i2c would send it, turn it off */
+    error = sdi_sys_i2c_client_set(bus, address,
+        ((bus->capability & I2C_FUNC_I2C) ? bus->client_pec : false));
+    if (error != STD_ERR_OK) {
         return error;
     }
 
     switch (operation) {
         case SDI_I2C_WRITE:
-             error = sdi_i2c_write(i2cdev_fd, address, cmd, cmdlen, buffer,
+             error = sdi_i2c_write(bus, address, cmd, cmdlen, buffer,
 buflen, flags);
              break;
         case SDI_I2C_READ:
-             error = sdi_i2c_read(i2cdev_fd, address, cmd, cmdlen, buffer,
+             error = sdi_i2c_read(bus, address, cmd, cmdlen, buffer,
 buflen, flags);
              break;
         default:
@@ -534,6 +1417,8 @@ buflen, flags);
     if (error != STD_ERR_OK) {
         SDI_DEVICE_ERRMSG_LOG("i2c bus %d operation:%d failed %d",
                                i2c_bus->bus.bus_id, operation, error);
+    } else {
+        sdi_sys_i2c_settle(bus, address, (operation == SDI_I2C_WRITE));
     }
 
     return error;
@@ -549,13 +1434,13 @@ buflen, flags);
  * param[in] data_type - SMBUS Transaction size
  * param[in] commandbuf - Address offset for SMBUS Transaction
  * param[out] block_len - Length of block data read from/written to I2C Slave
- * only for SDI_SMBUS_BLOCK_DATA SMBUS Transaction. Though BLOCK transfer is not
- * supported now, block_len is added in order to avoid changing the signature of
- * this function when its supported later. For Read BLOCK operation, number of
- * bytes actually read is filled in block_len on successful return of this
- * function. For Write BLOCK operation, number of bytes to be written as part of
- * BLOCK operation is specified.
- * in : Number of bytes to read as input; On return,
+ * only for block SMBUS Transactions:
+ * SDI_SMBUS_I2C_BLOCK_DATA : number of bytes to read/write. Transfers longer
+ * than I2C_SMBUS_BLOCK_MAX are split in to multiple transactions.
+ * SDI_SMBUS_BLOCK_DATA : for Write, number of bytes to be written. For Read,
+ * in : size of buffer; On return,
+ * out: store the number of bytes read from I2C Bus
+ * SDI_SYS_SMBUS_BLOCK_PROC_CALL : in : number of bytes to write; On return,
  * out: store the number of bytes read from I2C Bus
  * param[out] buffer - Data Read From/Written to I2C Bus
  * param[in] flags - Supported flags: PEC
@@ -569,55 +1454,71 @@ static t_std_error sdi_i2cdev_smbus_execute(sdi_i2c_bus_hdl_t i2c_bus,
     uint_t flags)
 {
     sdi_sys_i2c_bus_t * bus = (sdi_sys_i2c_bus_t *) i2c_bus;
-    int i2cdev_fd = bus->i2cdev_fd;
     t_std_error error = STD_ERR_OK;
 
-    if (ioctl(i2cdev_fd, I2C_SLAVE, address) != STD_ERR_OK) {
-        error = SDI_DEVICE_ERRNO;
-        SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %d set slave %2x failed %d\n",
-            __FUNCTION__, __LINE__, i2c_bus->bus.bus_id, address, error);
-        return error;
-    }
+    bus->cur_policy = sdi_sys_i2c_get_policy(bus, address);
+    bus->cur_address = address;
 
-    /*Enabling the SMBUS PEC */
-    if(flags == SDI_I2C_FLAG_PEC)
-    {
-        if (ioctl(i2cdev_fd, I2C_PEC, 1) != STD_ERR_OK) {
-            error = SDI_DEVICE_ERRNO;
-            SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %d set PEC failed %d\n",
-                __FUNCTION__, __LINE__, i2c_bus->bus.bus_id, error);
-            return error;
-        }
+    /* PEC stays enabled after the transaction, so a PEC sweep (ex: PMBus
+       telemetry) sets it once */
+    error = sdi_sys_i2c_client_set(bus, address, (flags == SDI_I2C_FLAG_PEC));
+    if (error != STD_ERR_OK) {
+        return error;
     }
 
-    switch (data_type) {
+    switch ((int) data_type) {
+        case I2C_SMBUS_BLOCK_PROC_CALL:
+            STD_ASSERT(block_len != NULL);
+            error = sdi_smbus_block_proc_call(bus, commandbuf, buffer,
+                block_len);
+            break;
         case SDI_SMBUS_BYTE:
             if (operation == SDI_SMBUS_WRITE) {
-                error = sdi_smbus_send_byte(i2cdev_fd, operation,
+                error = sdi_smbus_send_byte(bus, operation,
                     I2C_SMBUS_BYTE, commandbuf);
             } else {
-                error = sdi_smbus_recv_byte(i2cdev_fd, operation,
+                error = sdi_smbus_recv_byte(bus, operation,
                     I2C_SMBUS_BYTE, buffer);
             }
             break;
         case SDI_SMBUS_BYTE_DATA:
             if (operation == SDI_SMBUS_WRITE) {
-                error = sdi_smbus_write_byte(i2cdev_fd,
+                error = sdi_smbus_write_byte(bus,
                     operation, I2C_SMBUS_BYTE_DATA, commandbuf, buffer);
             } else {
-                error = sdi_smbus_read_byte(i2cdev_fd,
+                error = sdi_smbus_read_byte(bus,
                     operation, I2C_SMBUS_BYTE_DATA, commandbuf, buffer);
             }
             break;
         case SDI_SMBUS_WORD_DATA:
             if (operation == SDI_SMBUS_WRITE) {
-                error = sdi_smbus_write_word(i2cdev_fd,
+                error = sdi_smbus_write_word(bus,
                     operation, I2C_SMBUS_WORD_DATA, commandbuf, buffer);
             } else {
-                error = sdi_smbus_read_word(i2cdev_fd,
+                error = sdi_smbus_read_word(bus,
                     operation, I2C_SMBUS_WORD_DATA, commandbuf, buffer);
             }
             break;
+        case SDI_SMBUS_I2C_BLOCK_DATA:
+            STD_ASSERT(block_len != NULL);
+            if (operation == SDI_SMBUS_WRITE) {
+                error = sdi_smbus_write_i2c_block(bus, address, commandbuf,
+                    buffer, *block_len);
+            } else {
+                error = sdi_smbus_read_i2c_block(bus, address, commandbuf,
+                    buffer, *block_len);
+            }
+            break;
+        case SDI_SMBUS_BLOCK_DATA:
+            STD_ASSERT(block_len != NULL);
+            if (operation == SDI_SMBUS_WRITE) {
+                error = sdi_smbus_write_block(bus, commandbuf, buffer,
+                    *block_len);
+            } else {
+                error = sdi_smbus_read_block(bus, commandbuf, buffer,
+                    block_len);
+            }
+            break;
         default:
             error = SDI_DEVICE_ERRCODE(ENOTSUP);
             SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %d unsupported data type %d\n",
@@ -628,16 +1529,8 @@ static t_std_error sdi_i2cdev_smbus_execute(sdi_i2c_bus_hdl_t i2c_bus,
     if (error != STD_ERR_OK) {
         SDI_DEVICE_ERRMSG_LOG("i2c bus %d operation:%d datatype:%d failed %d\n",
                                i2c_bus->bus.bus_id, operation, data_type, error);
-    }
-
-    /*Disabling the PEC after the operation is completed*/
-    if(flags == SDI_I2C_FLAG_PEC)
-    {
-        if (ioctl(i2cdev_fd, I2C_PEC, 0) != STD_ERR_OK) {
-            error = SDI_DEVICE_ERRNO;
-            SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %d set PEC failed %d\n",
-                __FUNCTION__, __LINE__, i2c_bus->bus.bus_id, error);
-        }
+    } else {
+        sdi_sys_i2c_settle(bus, address, (operation == SDI_SMBUS_WRITE));
     }
 
     return error;
@@ -653,7 +1546,9 @@ static void sdi_i2cdev_release_bus (sdi_i2c_bus_hdl_t i2c_bus)
 {
     sdi_sys_i2c_bus_t * bus = (sdi_sys_i2c_bus_t *) i2c_bus;
 
-    std_mutex_unlock (&(bus->lock));
+    /* next holder addresses the bus itself, unless it sets its segment */
+    bus->cur_segment = NULL;
+    sdi_i2c_stats_record_lock_hold(bus->stats, sdi_i2c_arb_release(&(bus->lock)));
 }
 
 /**
@@ -682,6 +1577,445 @@ static sdi_i2c_bus_ops_t sdi_i2cdev_bus_ops = {
     .sdi_i2c_get_capability = sdi_sys_i2c_get_capability,
 };
 
+/**
+ * sdi_i2cdev_batch_op_is_mergeable
+ * Check if a batch operation can be sent as part of a combined I2C_RDWR
+ * transaction. Operations of slaves with a settle time policy and operations
+ * exceeding per message limits are executed individually.
+ * param[in] bus - sys i2c bus
+ * param[in] op - batch operation
+ * return true if operation can be merged, false otherwise
+ */
+static bool sdi_i2cdev_batch_op_is_mergeable(sdi_sys_i2c_bus_t *bus,
+                                             const sdi_i2c_batch_op_t *op)
+{
+    const sdi_i2c_dev_policy_t *policy = sdi_sys_i2c_get_policy(bus, op->address);
+
+    if ((policy->post_xfer_delay_us != 0)
+            || ((op->operation == SDI_I2C_WRITE) && (policy->write_settle_us != 0))) {
+        return false;
+    }
+    if (op->operation == SDI_I2C_READ) {
+        return ((op->buflen != 0) && (op->buflen <= SDI_I2C_RDWR_MAX_LEN));
+    }
+    return (op->operation == SDI_I2C_WRITE)
+            && ((op->cmdlen + op->buflen) != 0)
+            && ((op->cmdlen + op->buflen) <= SDI_I2C_RDWR_MAX_LEN);
+}
+
+/**
+ * sdi_i2cdev_batch_execute
+ * Execute a batch of i2c operations on an acquired i2c bus. Consecutive
+ * operations are sent as a single I2C_RDWR transaction of upto
+ * I2C_RDWR_IOCTL_MAX_MSGS messages. When a combined transaction of reads
+ * fails, its operations are executed again individually to get per operation
+ * status. Writes are not replayed, as the messages before the failed one
+ * already reached the slaves, every operation of a failed combined
+ * transaction with writes fails with the error of the transaction.
+ * param[in] i2c_bus - I2C Bus handle
+ * param[inout] ops - list of batch operations, status filled on return
+ * param[in] count - no. of batch operations
+ * return STD_ERR_OK when every operation succeeded, error of the first
+ * failed operation otherwise
+ */
+static t_std_error sdi_i2cdev_batch_execute(sdi_i2c_bus_hdl_t i2c_bus,
+                                            sdi_i2c_batch_op_t *ops, uint_t count)
+{
+    sdi_sys_i2c_bus_t *bus = (sdi_sys_i2c_bus_t *) i2c_bus;
+    struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    uint8_t xfer_buf[SDI_I2C_BATCH_STACK_BUF_LEN];
+    uint8_t *wr_buf = NULL;
+    t_std_error error = STD_ERR_OK;
+    t_std_error rc = STD_ERR_OK;
+    uint_t index = 0;
+    uint_t start = 0;
+    uint_t op_index = 0;
+    uint_t nmsgs = 0;
+    uint_t nmsgs_op = 0;
+    size_t wr_len = 0;
+    size_t wr_offset = 0;
+    bool has_write = false;
+    sdi_i2c_batch_op_t *op = NULL;
+
+    while (index < count) {
+        /* collect consecutive operations fitting in one I2C_RDWR transaction */
+        start = index;
+        nmsgs = 0;
+        wr_len = 0;
+        has_write = false;
+        while ((index < count) && (bus->capability & I2C_FUNC_I2C)
+                && (sdi_i2cdev_batch_op_is_mergeable(bus, &ops[index]))) {
+            op = &ops[index];
+            nmsgs_op = ((op->operation == SDI_I2C_READ) && (op->cmdlen != 0)) ? 2 : 1;
+            if ((nmsgs + nmsgs_op) > I2C_RDWR_IOCTL_MAX_MSGS) {
+                break;
+            }
+            nmsgs += nmsgs_op;
+            if (op->operation == SDI_I2C_WRITE) {
+                wr_len += (op->cmdlen + op->buflen);
+                has_write = true;
+            }
+            index++;
+        }
+
+        if (index == start) {
+            op = &ops[index++];
+            op->status = sdi_i2cdev_i2c_execute(i2c_bus, op->address,
+                            op->operation, op->cmd, op->cmdlen, op->buffer,
+                            op->buflen, SDI_I2C_FLAG_NONE);
+            if ((op->status != STD_ERR_OK) && (error == STD_ERR_OK)) {
+                error = op->status;
+            }
+            continue;
+        }
+
+        wr_buf = xfer_buf;
+        if (wr_len > sizeof(xfer_buf)) {
+            wr_buf = (uint8_t *) malloc(wr_len);
+        }
+
+        if (wr_buf != NULL) {
+            nmsgs = 0;
+            wr_offset = 0;
+            for (op_index = start; op_index < index; op_index++) {
+                op = &ops[op_index];
+                if (op->operation == SDI_I2C_WRITE) {
+                    /* offset and data go out in one message */
+                    memcpy(wr_buf + wr_offset, op->cmd, op->cmdlen);
+                    memcpy(wr_buf + wr_offset + op->cmdlen, op->buffer, op->buflen);
+                    msgs[nmsgs].addr = op->address;
+                    msgs[nmsgs].flags = 0;
+                    msgs[nmsgs].len = op->cmdlen + op->buflen;
+                    msgs[nmsgs].buf = wr_buf + wr_offset;
+                    wr_offset += msgs[nmsgs].len;
+                    nmsgs++;
+                    continue;
+                }
+                if (op->cmdlen != 0) {
+                    msgs[nmsgs].addr = op->address;
+                    msgs[nmsgs].flags = 0;
+                    msgs[nmsgs].len = op->cmdlen;
+                    msgs[nmsgs].buf = op->cmd;
+                    nmsgs++;
+                }
+                msgs[nmsgs].addr = op->address;
+                msgs[nmsgs].flags = I2C_M_RD;
+                msgs[nmsgs].len = op->buflen;
+                msgs[nmsgs].buf = (uint8_t *) op->buffer;
+                nmsgs++;
+            }
+            /* slaves in a combined transaction follow bus retry policy */
+            bus->cur_policy = &bus->policy;
+            rc = sdi_sys_i2c_rdwr(bus, msgs, nmsgs);
+            if (wr_buf != xfer_buf) {
+                free(wr_buf);
+            }
+        } else {
+            rc = SDI_DEVICE_ERRCODE(ENOMEM);
+        }
+
+        for (op_index = start; op_index < index; op_index++) {
+            op = &ops[op_index];
+            if (rc == STD_ERR_OK) {
+                op->status = STD_ERR_OK;
+                continue;
+            }
+            if ((has_write) && (rc != SDI_DEVICE_ERRCODE(ENOMEM))) {
+                op->status = rc;
+                if (error == STD_ERR_OK) {
+                    error = rc;
+                }
+                continue;
+            }
+            /* kernel doesn't report the failed message, retry one by one */
+            op->status = sdi_i2cdev_i2c_execute(i2c_bus, op->address,
+                            op->operation, op->cmd, op->cmdlen, op->buffer,
+                            op->buflen, SDI_I2C_FLAG_NONE);
+            if ((op->status != STD_ERR_OK) && (error == STD_ERR_OK)) {
+                error = op->status;
+            }
+        }
+    }
+
+    return error;
+}
+
+/**
+ * sdi_sys_i2c_device_policy_init
+ * Initialize an i2c slave policy with default settle time and retry policy
+ * param[out] policy - policy to be initialized
+ * return none
+ */
+void sdi_sys_i2c_device_policy_init(sdi_i2c_dev_policy_t *policy)
+{
+    memset(policy, 0, sizeof(*policy));
+    policy->max_retries = SDI_I2C_DEF_MAX_RETRIES;
+    policy->retry_backoff_us = SDI_I2C_DEF_RETRY_BACKOFF;
+    policy->retry_backoff_max_us = SDI_I2C_DEF_RETRY_BACKOFF_MAX;
+}
+
+/**
+ * sdi_sys_i2c_device_policy_parse
+ * Parse settle time and retry policy attributes of an i2c slave device node
+ * param[in] node - i2c slave device config node
+ * param[out] policy - filled with parsed policy, attributes not present in
+ * node are left unmodified
+ * return true if node has any policy attribute, false otherwise
+ */
+bool sdi_sys_i2c_device_policy_parse(std_config_node_t node,
+                                     sdi_i2c_dev_policy_t *policy)
+{
+    char *node_attr = NULL;
+    bool is_configured = false;
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_POST_XFER_DELAY);
+    if (node_attr != NULL) {
+        policy->post_xfer_delay_us = (uint_t) strtoul(node_attr, NULL, 0);
+        is_configured = true;
+    }
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_WRITE_SETTLE);
+    if (node_attr != NULL) {
+        policy->write_settle_us = (uint_t) strtoul(node_attr, NULL, 0);
+        is_configured = true;
+    }
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_WRITE_ACK_POLL);
+    if (node_attr != NULL) {
+        policy->write_ack_poll = (strcmp(node_attr, "yes") == 0);
+        is_configured = true;
+    }
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_WRITE_PAGE_SIZE);
+    if (node_attr != NULL) {
+        policy->write_page_size = (uint_t) strtoul(node_attr, NULL, 0);
+        is_configured = true;
+    }
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_MAX_RETRIES);
+    if (node_attr != NULL) {
+        policy->max_retries = (uint_t) strtoul(node_attr, NULL, 0);
+        is_configured = true;
+    }
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_RETRY_BACKOFF);
+    if (node_attr != NULL) {
+        policy->retry_backoff_us = (uint_t) strtoul(node_attr, NULL, 0);
+        is_configured = true;
+    }
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_RETRY_BACKOFF_MAX);
+    if (node_attr != NULL) {
+        policy->retry_backoff_max_us = (uint_t) strtoul(node_attr, NULL, 0);
+        is_configured = true;
+    }
+
+    return is_configured;
+}
+
+/**
+ * sdi_sys_i2c_device_policy_merge
+ * Merge two policies of the same i2c slave, the larger of both settle times
+ * and retry budgets is retained. ACK polling is used only when both ask for it,
+ * as fixed settle time is the safer of both. The smaller write page size is
+ * retained for the same reason.
+ * param[inout] policy - policy to be updated
+ * param[in] other - policy merged in to policy
+ * return none
+ */
+void sdi_sys_i2c_device_policy_merge(sdi_i2c_dev_policy_t *policy,
+                                     const sdi_i2c_dev_policy_t *other)
+{
+    if (other->post_xfer_delay_us > policy->post_xfer_delay_us) {
+        policy->post_xfer_delay_us = other->post_xfer_delay_us;
+    }
+    if (other->write_settle_us > policy->write_settle_us) {
+        policy->write_settle_us = other->write_settle_us;
+    }
+    policy->write_ack_poll = (policy->write_ack_poll && other->write_ack_poll);
+    if ((other->write_page_size != 0) && ((policy->write_page_size == 0)
+            || (other->write_page_size < policy->write_page_size))) {
+        policy->write_page_size = other->write_page_size;
+    }
+    if (other->max_retries > policy->max_retries) {
+        policy->max_retries = other->max_retries;
+    }
+    if (other->retry_backoff_us > policy->retry_backoff_us) {
+        policy->retry_backoff_us = other->retry_backoff_us;
+    }
+    if (other->retry_backoff_max_us > policy->retry_backoff_max_us) {
+        policy->retry_backoff_max_us = other->retry_backoff_max_us;
+    }
+}
+
+/**
+ * sdi_sys_i2c_bus_policy_get
+ * Get the default settle time and retry policy of a kernel driven i2c bus
+ * param[in] i2c_bus - i2c bus handle
+ * param[out] policy - default policy of the bus
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a kernel driven i2c bus
+ */
+t_std_error sdi_sys_i2c_bus_policy_get(sdi_i2c_bus_hdl_t i2c_bus,
+                                       sdi_i2c_dev_policy_t *policy)
+{
+    STD_ASSERT(i2c_bus != NULL);
+    STD_ASSERT(policy != NULL);
+
+    if (i2c_bus->ops != &sdi_i2cdev_bus_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    *policy = ((sdi_sys_i2c_bus_t *) i2c_bus)->policy;
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_sys_i2c_segment_set
+ * Set the bus segment of the slaves addressed on a kernel driven i2c bus,
+ * with bus acquired
+ * param[in] i2c_bus - i2c bus handle
+ * param[in] segment - bus segment, NULL for the bus itself
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a kernel driven i2c bus
+ */
+t_std_error sdi_sys_i2c_segment_set(sdi_i2c_bus_hdl_t i2c_bus,
+                                    const void *segment)
+{
+    STD_ASSERT(i2c_bus != NULL);
+
+    if (i2c_bus->ops != &sdi_i2cdev_bus_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    ((sdi_sys_i2c_bus_t *) i2c_bus)->cur_segment = segment;
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_sys_i2c_device_policy_set
+ * Set the settle time policy of an i2c slave attached to a kernel driven i2c
+ * bus. When the slave already has a policy, the larger of both settle times
+ * is retained.
+ * param[in] i2c_bus - i2c bus handle
+ * param[in] address - i2c slave address
+ * param[in] policy - settle time policy for the slave
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a kernel driven i2c bus, SDI_DEVICE_ERR_PARAM on invalid address
+ */
+t_std_error sdi_sys_i2c_device_policy_set(sdi_i2c_bus_hdl_t i2c_bus,
+                                          sdi_i2c_addr_t address,
+                                          const sdi_i2c_dev_policy_t *policy)
+{
+    sdi_sys_i2c_bus_t *bus = (sdi_sys_i2c_bus_t *) i2c_bus;
+    sdi_i2c_dev_policy_t *dev_policy = NULL;
+
+    STD_ASSERT(i2c_bus != NULL);
+    STD_ASSERT(policy != NULL);
+
+    if (i2c_bus->ops != &sdi_i2cdev_bus_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    if (address >= SDI_I2C_MAX_SLAVE_ADDR) {
+        return SDI_DEVICE_ERR_PARAM;
+    }
+
+    dev_policy = bus->dev_policy[address];
+    if (dev_policy == NULL) {
+        dev_policy = (sdi_i2c_dev_policy_t *) calloc(sizeof(sdi_i2c_dev_policy_t), 1);
+        STD_ASSERT(dev_policy != NULL);
+        *dev_policy = *policy;
+        bus->dev_policy[address] = dev_policy;
+        return STD_ERR_OK;
+    }
+
+    sdi_sys_i2c_device_policy_merge(dev_policy, policy);
+
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_sys_i2c_retry_stats_get
+ * Get the retry counters of a kernel driven i2c bus. Counters are updated
+ * with bus acquired, read without it.
+ * param[in] i2c_bus - i2c bus handle
+ * param[out] stats - retry counters
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a kernel driven i2c bus
+ */
+t_std_error sdi_sys_i2c_retry_stats_get(sdi_i2c_bus_hdl_t i2c_bus,
+                                        sdi_i2c_retry_stats_t *stats)
+{
+    sdi_sys_i2c_bus_t *bus = (sdi_sys_i2c_bus_t *) i2c_bus;
+
+    STD_ASSERT(i2c_bus != NULL);
+    STD_ASSERT(stats != NULL);
+
+    if (i2c_bus->ops != &sdi_i2cdev_bus_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    *stats = bus->retry_stats;
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_sys_i2c_client_stats_get
+ * Get the client setup ioctl counters of a kernel driven i2c bus. Counters
+ * are updated with bus acquired, read without it.
+ * param[in] i2c_bus - i2c bus handle
+ * param[out] stats - client setup ioctl counters
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a kernel driven i2c bus
+ */
+t_std_error sdi_sys_i2c_client_stats_get(sdi_i2c_bus_hdl_t i2c_bus,
+                                         sdi_i2c_client_stats_t *stats)
+{
+    sdi_sys_i2c_bus_t *bus = (sdi_sys_i2c_bus_t *) i2c_bus;
+
+    STD_ASSERT(i2c_bus != NULL);
+    STD_ASSERT(stats != NULL);
+
+    if (i2c_bus->ops != &sdi_i2cdev_bus_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    *stats = bus->client_stats;
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_sys_i2c_device_policy_register
+ * Register settle time policy of every i2c slave configured on this bus
+ * param[in] node - i2c bus config node
+ * param[in] sys_i2c_bus - sys i2c bus
+ * return none
+ */
+static void sdi_sys_i2c_device_policy_register(std_config_node_t node,
+                                               sdi_sys_i2c_bus_t *sys_i2c_bus)
+{
+    std_config_node_t cur_node = NULL;
+    char *node_attr = NULL;
+    sdi_i2c_dev_policy_t policy;
+    sdi_i2c_addr_t address = 0;
+
+    for (cur_node = std_config_get_child(node); cur_node != NULL;
+            cur_node = std_config_next_node(cur_node)) {
+        node_attr = std_config_attr_get(cur_node, SDI_DEV_ATTR_ADDRESS);
+        if (node_attr == NULL) {
+            continue;
+        }
+        address = (sdi_i2c_addr_t) strtoul(node_attr, NULL, 0);
+
+        /* Attributes not configured on device are inherited from bus */
+        policy = sys_i2c_bus->policy;
+        if (!sdi_sys_i2c_device_policy_parse(cur_node, &policy)) {
+            continue;
+        }
+        if (sdi_sys_i2c_device_policy_set(&sys_i2c_bus->bus, address, &policy)
+                != STD_ERR_OK) {
+            SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %u invalid slave address %s\n",
+                __FUNCTION__, __LINE__, sys_i2c_bus->bus.bus.bus_id, node_attr);
+        }
+    }
+}
+
 /**
  * sdi_i2cdev_driver_init
  * SDI I2C kernel interface driver Initialization Function
@@ -710,6 +2044,7 @@ static t_std_error sdi_i2cdev_driver_init(sdi_bus_hdl_t bus)
         /*Get the dev name from sysfs name if it is not passed via config*/
         error = sdi_get_i2c_device_path_by_sysfs_name(
                                                       sys_i2c_bus->kernel_sysfs_name,
+                                                      sys_i2c_bus->adapter_wait_ms,
                                                       sys_i2c_bus->kernel_i2cdev_name);
         if (error != STD_ERR_OK) {
             SDI_DEVICE_ERRMSG_LOG("%s:%d i2c bus %d get device path failed %d\n",
@@ -735,7 +2070,7 @@ static t_std_error sdi_i2cdev_driver_init(sdi_bus_hdl_t bus)
         return error;
     }
 
-    sdi_bus_init_device_list(bus);
+    sdi_init_sched_device_list(bus);
 
     return error;
 }
@@ -781,7 +2116,7 @@ static t_std_error sdi_i2cdev_driver_register(std_config_node_t node,
 
     i2c_bus->ops = &sdi_i2cdev_bus_ops;
 
-    error = std_mutex_lock_init_non_recursive(&(sys_i2c_bus->lock));
+    error = sdi_i2c_arb_init(&(sys_i2c_bus->lock));
     if (error != STD_ERR_OK) {
         error = SDI_DEVICE_ERRNO;
         free(sys_i2c_bus);
@@ -800,10 +2135,27 @@ static t_std_error sdi_i2cdev_driver_register(std_config_node_t node,
         safestrncpy(sys_i2c_bus->kernel_i2cdev_name, str, PATH_MAX);
     }
 
+    str = std_config_attr_get(node, SDI_DEV_ATTR_ADAPTER_WAIT);
+    sys_i2c_bus->adapter_wait_ms = (str != NULL) ?
+        (uint_t) strtoul(str, NULL, 0) : SDI_I2C_DEF_ADAPTER_WAIT_MS;
+
     sys_i2c_bus->i2cdev_fd = INVALID_FILE_FD;
 
+    sdi_sys_i2c_device_policy_init(&sys_i2c_bus->policy);
+    sdi_sys_i2c_device_policy_parse(node, &sys_i2c_bus->policy);
+    sdi_sys_i2c_device_policy_register(node, sys_i2c_bus);
+
     sdi_bus_register((sdi_bus_hdl_t) sys_i2c_bus);
 
+    sdi_init_sched_register((sdi_bus_hdl_t) sys_i2c_bus, node);
+
+    sdi_i2c_batch_register(i2c_bus, sdi_i2cdev_batch_execute);
+    sdi_i2c_batch_arb_register(i2c_bus, &(sys_i2c_bus->lock));
+
+    str = std_config_attr_get(node, SDI_DEV_ATTR_STATS_SHM);
+    sys_i2c_bus->stats = sdi_i2c_stats_create(i2c_bus,
+                            ((str != NULL) && (strcmp(str, "yes") == 0)));
+
     *bus = (sdi_bus_hdl_t) sys_i2c_bus;
 
     sdi_bus_register_device_list(node, (sdi_bus_hdl_t) sys_i2c_bus);
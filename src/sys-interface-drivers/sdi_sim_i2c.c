@@ -0,0 +1,1082 @@
+/*
+ * Copyright (c) 2016 Dell Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ * CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *  LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ * FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ */
+
+/*
+ * filename: sdi_sim_i2c.c
+ */
+
+
+/******************************************************************************
+ * Implements SDI I2C Bus Operations for a simulated I2C BUS backed by
+ * in-memory register files, and registers the i2c bus with SDI I2C Bus
+ * Framework and registers devices attached to the i2c bus.
+ * Used to exercise, benchmark and regression test device drivers on a
+ * system without the hardware.
+ *****************************************************************************/
+
+#include "std_assert.h"
+#include "sdi_device_common.h"
+#include "std_error_codes.h"
+#include "std_config_node.h"
+#include "sdi_driver_internal.h"
+#include "sdi_sim_i2c.h"
+#include "sdi_init_sched.h"
+#include "sdi_i2c_batch.h"
+#include "sdi_common_attr.h"
+#include "sdi_bus_attr.h"
+#include "std_utils.h"
+#include "std_time_tools.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <limits.h>
+#include <linux/i2c.h>
+
+/**
+ * format for simulated i2c node representation in configuration:
+ * <sim_i2c instance="0" bus_name="smbus0" sim_latency_us="100"
+ *          sim_error_every="0" sim_error_errno="5" sim_regmap_dir="/etc/sdi/sim">
+ *    <tmp75 instance="0" addr="0x48" sim_regmap="tmp75.map" ../>
+ *    <!-- one or more i2c slaves, each backed by a register map file. Slaves
+ *        without sim_regmap are absent, i.e. don't ack their address.
+ *        Relative sim_regmap paths are resolved against sim_regmap_dir,
+ *        or against $SDI_SIM_REGMAP_DIR when set.
+ *        sim_aux_addr and sim_aux_regmap on a slave node back a second
+ *        address of the same device, ex: SFP diagnostics at 0x51.
+ *        sim_latency_us, sim_error_every and sim_error_errno on a slave node
+ *        override the bus injection for that slave.
+ *    -->
+ * </sim_i2c>
+ *
+ * Slaves of i2c mux channels on a simulated bus share one register file per
+ * address, as mux channel selection is not simulated.
+ */
+
+/**
+ * Max length of a line in register map file
+ */
+#define SDI_SIM_I2C_MAX_LINE_LEN       (1024)
+
+/**
+ * Default size of byte memory of a simulated slave
+ */
+#define SDI_SIM_I2C_DEF_SIZE           (256)
+
+/**
+ * Functionality of a simulated i2c bus
+ */
+#define SDI_SIM_I2C_FUNCS   (I2C_FUNC_I2C | I2C_FUNC_SMBUS_QUICK \
+                             | I2C_FUNC_SMBUS_BYTE | I2C_FUNC_SMBUS_BYTE_DATA \
+                             | I2C_FUNC_SMBUS_WORD_DATA | I2C_FUNC_SMBUS_BLOCK_DATA \
+                             | I2C_FUNC_SMBUS_I2C_BLOCK)
+
+static sdi_i2c_bus_ops_t sdi_sim_i2c_bus_ops;
+
+/**
+ * sdi_sim_i2c_mem_read
+ * Read a byte of slave memory at offset, as per page selection
+ * param[in] slave - simulated slave
+ * param[in] offset - byte offset
+ * return byte at offset, 0xff for unpopulated memory
+ */
+static uint8_t sdi_sim_i2c_mem_read(sdi_sim_i2c_slave_t *slave, uint_t offset)
+{
+    uint8_t *page = NULL;
+
+    if ((slave->page_select >= 0) && (offset >= SDI_SIM_I2C_PAGE_SIZE)
+            && (offset < (2 * SDI_SIM_I2C_PAGE_SIZE))) {
+        page = slave->pages[slave->cur_page];
+        return (page != NULL) ? page[offset - SDI_SIM_I2C_PAGE_SIZE] : SDI_MAX_BYTE_VAL;
+    }
+    return (offset < slave->size) ? slave->mem[offset] : SDI_MAX_BYTE_VAL;
+}
+
+/**
+ * sdi_sim_i2c_mem_write
+ * Write a byte of slave memory at offset, as per page selection. A write to
+ * page select register selects the page.
+ * param[in] slave - simulated slave
+ * param[in] offset - byte offset
+ * param[in] value - byte to write
+ * return none
+ */
+static void sdi_sim_i2c_mem_write(sdi_sim_i2c_slave_t *slave, uint_t offset,
+                                  uint8_t value)
+{
+    uint8_t *page = NULL;
+
+    if ((slave->page_select >= 0) && (offset >= SDI_SIM_I2C_PAGE_SIZE)
+            && (offset < (2 * SDI_SIM_I2C_PAGE_SIZE))) {
+        page = slave->pages[slave->cur_page];
+        if (page != NULL) {
+            page[offset - SDI_SIM_I2C_PAGE_SIZE] = value;
+        }
+        return;
+    }
+    if ((slave->page_select >= 0) && (offset == (uint_t) slave->page_select)) {
+        slave->cur_page = value;
+    }
+    if (offset < slave->size) {
+        slave->mem[offset] = value;
+    }
+}
+
+/**
+ * sdi_sim_i2c_slave_alloc
+ * Allocate a simulated slave with default layout
+ * return simulated slave
+ */
+static sdi_sim_i2c_slave_t *sdi_sim_i2c_slave_alloc(void)
+{
+    sdi_sim_i2c_slave_t *slave = (sdi_sim_i2c_slave_t *)
+        calloc(sizeof(sdi_sim_i2c_slave_t), 1);
+
+    STD_ASSERT(slave != NULL);
+    slave->width = SDI_SIM_I2C_WIDTH_BYTE;
+    slave->page_select = -1;
+    return slave;
+}
+
+/**
+ * sdi_sim_i2c_slave_free
+ * Free a simulated slave
+ * param[in] slave - simulated slave
+ * return none
+ */
+static void sdi_sim_i2c_slave_free(sdi_sim_i2c_slave_t *slave)
+{
+    uint_t index = 0;
+
+    if (slave == NULL) {
+        return;
+    }
+    for (index = 0; index < SDI_SIM_I2C_MAX_PAGES; index++) {
+        free(slave->pages[index]);
+    }
+    for (index = 0; index < SDI_SIM_I2C_MAX_REGS; index++) {
+        free(slave->blocks[index]);
+    }
+    free(slave->mem);
+    free(slave);
+}
+
+/**
+ * sdi_sim_i2c_regmap_parse_line
+ * Parse a line of register map file in to simulated slave
+ * param[in] slave - simulated slave
+ * param[in] line - line of register map file, modified
+ * param[inout] page - page being filled, -1 for base memory
+ * return true on success, false on invalid line
+ */
+static bool sdi_sim_i2c_regmap_parse_line(sdi_sim_i2c_slave_t *slave,
+                                          char *line, int *page)
+{
+    char *save = NULL;
+    char *token = NULL;
+    char *end = NULL;
+    uint_t offset = 0;
+    uint_t value = 0;
+    sdi_sim_i2c_block_t *block = NULL;
+
+    if ((end = strchr(line, '#')) != NULL) {
+        *end = '\0';
+    }
+    token = strtok_r(line, " \t\r\n", &save);
+    if (token == NULL) {
+        return true;
+    }
+
+    if (strcmp(token, "width") == 0) {
+        token = strtok_r(NULL, " \t\r\n", &save);
+        if (token == NULL) {
+            return false;
+        } else if (strcmp(token, "word") == 0) {
+            slave->width = SDI_SIM_I2C_WIDTH_WORD;
+        } else if (strcmp(token, "addr16") == 0) {
+            slave->width = SDI_SIM_I2C_WIDTH_ADDR16;
+        } else {
+            slave->width = SDI_SIM_I2C_WIDTH_BYTE;
+        }
+        return true;
+    }
+    if (strcmp(token, "size") == 0) {
+        token = strtok_r(NULL, " \t\r\n", &save);
+        if ((token == NULL) || (slave->mem != NULL)) {
+            /* size must precede data */
+            return false;
+        }
+        slave->size = strtoul(token, NULL, 0);
+        return (slave->size != 0);
+    }
+    if (strcmp(token, "page_select") == 0) {
+        token = strtok_r(NULL, " \t\r\n", &save);
+        if (token == NULL) {
+            return false;
+        }
+        slave->page_select = (int) strtoul(token, NULL, 0);
+        return true;
+    }
+    if (strcmp(token, "page") == 0) {
+        token = strtok_r(NULL, " \t\r\n", &save);
+        if ((token == NULL) || (slave->page_select < 0)) {
+            return false;
+        }
+        *page = (int) strtoul(token, NULL, 0);
+        if (*page >= SDI_SIM_I2C_MAX_PAGES) {
+            return false;
+        }
+        if (slave->pages[*page] == NULL) {
+            slave->pages[*page] = (uint8_t *) malloc(SDI_SIM_I2C_PAGE_SIZE);
+            STD_ASSERT(slave->pages[*page] != NULL);
+            memset(slave->pages[*page], SDI_MAX_BYTE_VAL, SDI_SIM_I2C_PAGE_SIZE);
+        }
+        return true;
+    }
+    if (strcmp(token, "block") == 0) {
+        token = strtok_r(NULL, ": \t\r\n", &save);
+        if (token == NULL) {
+            return false;
+        }
+        offset = strtoul(token, NULL, 0);
+        if (offset >= SDI_SIM_I2C_MAX_REGS) {
+            return false;
+        }
+        if (slave->blocks[offset] == NULL) {
+            slave->blocks[offset] = (sdi_sim_i2c_block_t *)
+                calloc(sizeof(sdi_sim_i2c_block_t), 1);
+            STD_ASSERT(slave->blocks[offset] != NULL);
+        }
+        block = slave->blocks[offset];
+        block->len = 0;
+        while (((token = strtok_r(NULL, " \t\r\n", &save)) != NULL)
+                && (block->len < I2C_SMBUS_BLOCK_MAX)) {
+            block->data[block->len++] = (uint8_t) strtoul(token, NULL, 0);
+        }
+        return true;
+    }
+
+    /* data line: <offset>: <value> ... */
+    offset = strtoul(token, &end, 0);
+    if ((end == token) || ((*end != ':') && (*end != '\0'))) {
+        return false;
+    }
+    if ((slave->mem == NULL) && (slave->width != SDI_SIM_I2C_WIDTH_WORD)) {
+        if (slave->size == 0) {
+            slave->size = SDI_SIM_I2C_DEF_SIZE;
+        }
+        slave->mem = (uint8_t *) malloc(slave->size);
+        STD_ASSERT(slave->mem != NULL);
+        memset(slave->mem, SDI_MAX_BYTE_VAL, slave->size);
+    }
+
+    while ((token = strtok_r(NULL, ": \t\r\n", &save)) != NULL) {
+        value = strtoul(token, NULL, 0);
+        if (slave->width == SDI_SIM_I2C_WIDTH_WORD) {
+            if (offset >= SDI_SIM_I2C_MAX_REGS) {
+                return false;
+            }
+            slave->regs[offset++] = (uint16_t) value;
+        } else if (*page >= 0) {
+            if ((offset < SDI_SIM_I2C_PAGE_SIZE) || (offset >= (2 * SDI_SIM_I2C_PAGE_SIZE))) {
+                return false;
+            }
+            slave->pages[*page][offset++ - SDI_SIM_I2C_PAGE_SIZE] = (uint8_t) value;
+        } else {
+            if (offset >= slave->size) {
+                return false;
+            }
+            slave->mem[offset++] = (uint8_t) value;
+        }
+    }
+    return true;
+}
+
+/**
+ * sdi_sim_i2c_bus_is_sim
+ * Check whether an i2c bus is a simulated bus
+ * param[in] i2c_bus - i2c bus handle
+ * return true for a sim_i2c bus, false otherwise
+ */
+bool sdi_sim_i2c_bus_is_sim(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    STD_ASSERT(i2c_bus != NULL);
+
+    return (i2c_bus->ops == &sdi_sim_i2c_bus_ops);
+}
+
+/**
+ * sdi_sim_i2c_regmap_load
+ * Load the register map file of a simulated i2c slave, replacing the slave
+ * if already present
+ * param[in] i2c_bus - simulated i2c bus handle
+ * param[in] address - i2c slave address
+ * param[in] path - register map file
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a simulated bus, SDI_DEVICE_ERRNO on file errors,
+ * SDI_DEVICE_ERR_PARAM on invalid address or file contents
+ */
+t_std_error sdi_sim_i2c_regmap_load(sdi_i2c_bus_hdl_t i2c_bus,
+                                    sdi_i2c_addr_t address, const char *path)
+{
+    sdi_sim_i2c_bus_t *bus = (sdi_sim_i2c_bus_t *) i2c_bus;
+    sdi_sim_i2c_slave_t *slave = NULL;
+    sdi_sim_i2c_slave_t *old_slave = NULL;
+    char line[SDI_SIM_I2C_MAX_LINE_LEN];
+    uint_t line_no = 0;
+    int page = -1;
+    FILE *fp = NULL;
+
+    STD_ASSERT(i2c_bus != NULL);
+    STD_ASSERT(path != NULL);
+
+    if (i2c_bus->ops != &sdi_sim_i2c_bus_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    if (address >= SDI_I2C_MAX_SLAVE_ADDR) {
+        return SDI_DEVICE_ERR_PARAM;
+    }
+
+    fp = fopen(path, "r");
+    if (fp == NULL) {
+        SDI_DEVICE_ERRMSG_LOG("%s:%d sim i2c bus %u open %s failed %d\n",
+            __FUNCTION__, __LINE__, i2c_bus->bus.bus_id, path, errno);
+        return SDI_DEVICE_ERRNO;
+    }
+
+    slave = sdi_sim_i2c_slave_alloc();
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        line_no++;
+        if (!sdi_sim_i2c_regmap_parse_line(slave, line, &page)) {
+            SDI_DEVICE_ERRMSG_LOG("%s:%d sim i2c bus %u %s:%u invalid line\n",
+                __FUNCTION__, __LINE__, i2c_bus->bus.bus_id, path, line_no);
+            fclose(fp);
+            sdi_sim_i2c_slave_free(slave);
+            return SDI_DEVICE_ERR_PARAM;
+        }
+    }
+    fclose(fp);
+
+    if ((slave->mem == NULL) && (slave->width != SDI_SIM_I2C_WIDTH_WORD)) {
+        /* no data lines, blank memory */
+        if (slave->size == 0) {
+            slave->size = SDI_SIM_I2C_DEF_SIZE;
+        }
+        slave->mem = (uint8_t *) malloc(slave->size);
+        STD_ASSERT(slave->mem != NULL);
+        memset(slave->mem, SDI_MAX_BYTE_VAL, slave->size);
+    }
+
+    sdi_i2c_arb_acquire(&bus->lock, NULL, NULL);
+    old_slave = bus->slave[address];
+    if (old_slave != NULL) {
+        slave->has_fault = old_slave->has_fault;
+        slave->fault = old_slave->fault;
+    }
+    bus->slave[address] = slave;
+    sdi_i2c_arb_release(&bus->lock);
+
+    sdi_sim_i2c_slave_free(old_slave);
+
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_sim_i2c_fault_set
+ * Set latency and error injection of a simulated bus or slave
+ * param[in] i2c_bus - simulated i2c bus handle
+ * param[in] address - i2c slave address, SDI_SIM_I2C_ALL_SLAVES for bus
+ * param[in] latency_us - latency added to every transaction
+ * param[in] error_every - fail every Nth transaction, 0 to disable
+ * param[in] error_errno - errno of injected failure
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a simulated bus, SDI_DEVICE_ERR_PARAM when slave is not present
+ */
+t_std_error sdi_sim_i2c_fault_set(sdi_i2c_bus_hdl_t i2c_bus, uint_t address,
+                                  uint_t latency_us, uint_t error_every,
+                                  int error_errno)
+{
+    sdi_sim_i2c_bus_t *bus = (sdi_sim_i2c_bus_t *) i2c_bus;
+    sdi_sim_i2c_fault_t *fault = NULL;
+    t_std_error error = STD_ERR_OK;
+
+    STD_ASSERT(i2c_bus != NULL);
+
+    if (i2c_bus->ops != &sdi_sim_i2c_bus_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+
+    sdi_i2c_arb_acquire(&bus->lock, NULL, NULL);
+    if (address == SDI_SIM_I2C_ALL_SLAVES) {
+        fault = &bus->fault;
+    } else if ((address < SDI_I2C_MAX_SLAVE_ADDR) && (bus->slave[address] != NULL)) {
+        bus->slave[address]->has_fault = true;
+        fault = &bus->slave[address]->fault;
+    } else {
+        error = SDI_DEVICE_ERR_PARAM;
+    }
+    if (fault != NULL) {
+        fault->latency_us = latency_us;
+        fault->error_every = error_every;
+        fault->error_errno = (error_errno != 0) ? error_errno : EIO;
+        fault->count = 0;
+    }
+    sdi_i2c_arb_release(&bus->lock);
+
+    return error;
+}
+
+/**
+ * sdi_sim_i2c_poke
+ * Write bytes in to the register file of a simulated slave, bypassing the bus
+ * param[in] i2c_bus - simulated i2c bus handle
+ * param[in] address - i2c slave address
+ * param[in] offset - offset in register file
+ * param[in] buf - data
+ * param[in] len - no. of bytes
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a simulated bus, SDI_DEVICE_ERR_PARAM when slave is not present
+ */
+t_std_error sdi_sim_i2c_poke(sdi_i2c_bus_hdl_t i2c_bus, sdi_i2c_addr_t address,
+                             uint_t offset, const uint8_t *buf, size_t len)
+{
+    sdi_sim_i2c_bus_t *bus = (sdi_sim_i2c_bus_t *) i2c_bus;
+    sdi_sim_i2c_slave_t *slave = NULL;
+    size_t index = 0;
+
+    STD_ASSERT(i2c_bus != NULL);
+    STD_ASSERT(buf != NULL);
+
+    if (i2c_bus->ops != &sdi_sim_i2c_bus_ops) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    if (address >= SDI_I2C_MAX_SLAVE_ADDR) {
+        return SDI_DEVICE_ERR_PARAM;
+    }
+
+    sdi_i2c_arb_acquire(&bus->lock, NULL, NULL);
+    slave = bus->slave[address];
+    if (slave == NULL) {
+        sdi_i2c_arb_release(&bus->lock);
+        return SDI_DEVICE_ERR_PARAM;
+    }
+    for (index = 0; index < len; index++) {
+        if (slave->width == SDI_SIM_I2C_WIDTH_WORD) {
+            /* little endian, as returned by smbus read word */
+            uint_t reg = offset + (index / 2);
+            if (reg >= SDI_SIM_I2C_MAX_REGS) {
+                break;
+            }
+            if (index & 1) {
+                slave->regs[reg] = (slave->regs[reg] & 0x00ff) | (buf[index] << BITS_PER_BYTE);
+            } else {
+                slave->regs[reg] = (slave->regs[reg] & 0xff00) | buf[index];
+            }
+        } else if ((offset + index) < slave->size) {
+            slave->mem[offset + index] = buf[index];
+        }
+    }
+    sdi_i2c_arb_release(&bus->lock);
+
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_sim_i2c_inject
+ * Apply latency and error injection for a transaction. Called with bus
+ * acquired.
+ * param[in] bus - simulated i2c bus
+ * param[in] slave - addressed slave
+ * return 0 if transaction has to proceed, errno of injected failure otherwise
+ */
+static int sdi_sim_i2c_inject(sdi_sim_i2c_bus_t *bus, sdi_sim_i2c_slave_t *slave)
+{
+    sdi_sim_i2c_fault_t *fault = slave->has_fault ? &slave->fault : &bus->fault;
+
+    fault->count++;
+    if (fault->latency_us != 0) {
+        std_usleep(fault->latency_us);
+    }
+    if ((fault->error_every != 0) && ((fault->count % fault->error_every) == 0)) {
+        return fault->error_errno;
+    }
+    return 0;
+}
+
+/**
+ * sdi_sim_i2c_begin
+ * Start a transaction: look up the addressed slave and apply injection.
+ * Called with bus acquired.
+ * param[in] bus - simulated i2c bus
+ * param[in] address - i2c slave address
+ * param[out] slave - addressed slave
+ * return 0 on success, ENXIO when no slave at address, errno of injected
+ * failure otherwise
+ */
+static int sdi_sim_i2c_begin(sdi_sim_i2c_bus_t *bus, sdi_i2c_addr_t address,
+                             sdi_sim_i2c_slave_t **slave)
+{
+    *slave = (address < SDI_I2C_MAX_SLAVE_ADDR) ? bus->slave[address] : NULL;
+    if (*slave == NULL) {
+        if (bus->fault.latency_us != 0) {
+            std_usleep(bus->fault.latency_us);
+        }
+        return ENXIO;
+    }
+    return sdi_sim_i2c_inject(bus, *slave);
+}
+
+/**
+ * sdi_sim_i2c_end
+ * End a transaction: record telemetry and map errno to return code
+ * param[in] bus - simulated i2c bus
+ * param[in] address - i2c slave address
+ * param[in] bytes - no. of data bytes transferred
+ * param[in] start_ns - start time of transaction
+ * param[in] err - errno of failed transaction, 0 on success
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+static t_std_error sdi_sim_i2c_end(sdi_sim_i2c_bus_t *bus, sdi_i2c_addr_t address,
+                                   size_t bytes, uint64_t start_ns, int err)
+{
+    sdi_i2c_stats_record(bus->stats, address, bytes,
+                         sdi_i2c_stats_now_ns() - start_ns, err);
+    if (err != 0) {
+        errno = err;
+        return SDI_DEVICE_ERRNO;
+    }
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_sim_i2c_acquire_bus
+ * Lock the simulated i2c bus before executing a transaction, with the i2c
+ * priority class of calling thread
+ * param[in] i2c_bus - sdi i2c bus handle
+ * return STD_ERR_OK on success, non-zero error code on lock failure
+ */
+static t_std_error sdi_sim_i2c_acquire_bus(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    sdi_sim_i2c_bus_t *bus = (sdi_sim_i2c_bus_t *) i2c_bus;
+    sdi_i2c_prio_t prio = SDI_I2C_PRIO_DEFAULT;
+    uint64_t wait_ns = 0;
+    t_std_error error = STD_ERR_OK;
+
+    sdi_init_sched_bus_ready((sdi_bus_hdl_t) i2c_bus);
+
+    error = sdi_i2c_arb_acquire(&bus->lock, &prio, &wait_ns);
+    if (error == STD_ERR_OK) {
+        sdi_i2c_stats_record_lock_wait(bus->stats, prio, wait_ns);
+    }
+    return error;
+}
+
+/**
+ * sdi_sim_i2c_release_bus
+ * UnLock the simulated i2c bus after executing a transaction
+ * param[in] i2c_bus - i2c bus handle
+ * return none
+ */
+static void sdi_sim_i2c_release_bus(sdi_i2c_bus_hdl_t i2c_bus)
+{
+    sdi_sim_i2c_bus_t *bus = (sdi_sim_i2c_bus_t *) i2c_bus;
+
+    sdi_i2c_stats_record_lock_hold(bus->stats, sdi_i2c_arb_release(&bus->lock));
+}
+
+/**
+ * sdi_sim_i2c_get_capability
+ * Get the capability of simulated i2c bus
+ * param[in] i2c_bus - i2c bus handle
+ * param[out] capability - filled with functionality of simulated bus
+ * return none
+ */
+static void sdi_sim_i2c_get_capability(sdi_i2c_bus_hdl_t i2c_bus,
+                                       sdi_i2c_bus_capability_t *capability)
+{
+    *capability = SDI_SIM_I2C_FUNCS;
+}
+
+/**
+ * sdi_sim_i2c_smbus_execute
+ * Execute a SMBUS transaction on simulated slave register file
+ * param[in] i2c_bus - I2C Bus handle
+ * param[in] address - I2C Slave Address
+ * param[in] operation - SMBUS Read/Write Operation
+ * param[in] data_type - SMBUS Transaction size
+ * param[in] commandbuf - Address offset for SMBUS Transaction
+ * param[inout] buffer - Data Read From/Written to I2C Bus
+ * param[inout] block_len - Length of block data, as in sys_i2c bus
+ * param[in] flags - ignored, PEC is always good on simulated bus
+ * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
+ */
+static t_std_error sdi_sim_i2c_smbus_execute(sdi_i2c_bus_hdl_t i2c_bus,
+    sdi_i2c_addr_t address, sdi_smbus_operation_t operation,
+    sdi_smbus_data_type_t data_type, uint_t commandbuf,
+    void *buffer, size_t *block_len, uint_t flags)
+{
+    sdi_sim_i2c_bus_t *bus = (sdi_sim_i2c_bus_t *) i2c_bus;
+    sdi_sim_i2c_slave_t *slave = NULL;
+    sdi_sim_i2c_block_t *block = NULL;
+    uint64_t start_ns = sdi_i2c_stats_now_ns();
+    uint8_t *buf = (uint8_t *) buffer;
+    uint_t offset = commandbuf & SDI_MAX_BYTE_VAL;
+    size_t bytes = 0;
+    size_t index = 0;
+    int err = 0;
+
+    err = sdi_sim_i2c_begin(bus, address, &slave);
+    if (err != 0) {
+        return sdi_sim_i2c_end(bus, address, 0, start_ns, err);
+    }
+
+    switch (data_type) {
+        case SDI_SMBUS_BYTE:
+            bytes = 1;
+            if (operation == SDI_SMBUS_WRITE) {
+                /* send byte moves address pointer */
+                slave->pointer = offset;
+            } else if (slave->width == SDI_SIM_I2C_WIDTH_WORD) {
+                *buf = slave->regs[slave->pointer % SDI_SIM_I2C_MAX_REGS] & SDI_MAX_BYTE_VAL;
+            } else {
+                *buf = sdi_sim_i2c_mem_read(slave, slave->pointer++);
+            }
+            break;
+        case SDI_SMBUS_BYTE_DATA:
+            bytes = 1;
+            if (slave->width == SDI_SIM_I2C_WIDTH_WORD) {
+                if (operation == SDI_SMBUS_WRITE) {
+                    slave->regs[offset] = *buf;
+                } else {
+                    *buf = slave->regs[offset] & SDI_MAX_BYTE_VAL;
+                }
+            } else if (slave->width == SDI_SIM_I2C_WIDTH_ADDR16) {
+                if (operation == SDI_SMBUS_WRITE) {
+                    /* 16bit address set, high byte in command */
+                    slave->pointer = ((offset << BITS_PER_BYTE) | *buf) % slave->size;
+                } else {
+                    /* command is an incomplete address, slave reads at its
+                     * address pointer */
+                    *buf = sdi_sim_i2c_mem_read(slave, slave->pointer);
+                    slave->pointer = (slave->pointer + 1) % slave->size;
+                }
+            } else if (operation == SDI_SMBUS_WRITE) {
+                sdi_sim_i2c_mem_write(slave, offset, *buf);
+                slave->pointer = offset + 1;
+            } else {
+                *buf = sdi_sim_i2c_mem_read(slave, offset);
+                slave->pointer = offset + 1;
+            }
+            break;
+        case SDI_SMBUS_WORD_DATA:
+            bytes = 2;
+            if (slave->width == SDI_SIM_I2C_WIDTH_WORD) {
+                if (operation == SDI_SMBUS_WRITE) {
+                    slave->regs[offset] = *(uint16_t *) buffer;
+                } else {
+                    *(uint16_t *) buffer = slave->regs[offset];
+                }
+            } else if (operation == SDI_SMBUS_WRITE) {
+                sdi_sim_i2c_mem_write(slave, offset, *(uint16_t *) buffer & SDI_MAX_BYTE_VAL);
+                sdi_sim_i2c_mem_write(slave, offset + 1, *(uint16_t *) buffer >> BITS_PER_BYTE);
+            } else {
+                *(uint16_t *) buffer = sdi_sim_i2c_mem_read(slave, offset)
+                    | (sdi_sim_i2c_mem_read(slave, offset + 1) << BITS_PER_BYTE);
+            }
+            break;
+        case SDI_SMBUS_BLOCK_DATA:
+            STD_ASSERT(block_len != NULL);
+            if (operation == SDI_SMBUS_WRITE) {
+                if ((*block_len == 0) || (*block_len > I2C_SMBUS_BLOCK_MAX)) {
+                    err = EINVAL;
+                    break;
+                }
+                if (slave->blocks[offset] == NULL) {
+                    slave->blocks[offset] = (sdi_sim_i2c_block_t *)
+                        calloc(sizeof(sdi_sim_i2c_block_t), 1);
+                    STD_ASSERT(slave->blocks[offset] != NULL);
+                }
+                block = slave->blocks[offset];
+                block->len = *block_len;
+                memcpy(block->data, buffer, *block_len);
+                bytes = *block_len;
+                break;
+            }
+            block = slave->blocks[offset];
+            if (block == NULL) {
+                /* slave doesn't support the command, no ack on command */
+                err = ENXIO;
+            } else if (block->len > *block_len) {
+                err = EOVERFLOW;
+            } else {
+                memcpy(buffer, block->data, block->len);
+                *block_len = block->len;
+                bytes = block->len;
+            }
+            break;
+        case SDI_SMBUS_I2C_BLOCK_DATA:
+            STD_ASSERT(block_len != NULL);
+            if (slave->width == SDI_SIM_I2C_WIDTH_WORD) {
+                err = EOPNOTSUPP;
+                break;
+            }
+            if (slave->width == SDI_SIM_I2C_WIDTH_ADDR16) {
+                /* write: command and first data byte are the 16bit offset.
+                 * read: command is an incomplete address, slave reads at its
+                 * address pointer */
+                if (operation == SDI_SMBUS_WRITE) {
+                    if (*block_len == 0) {
+                        err = EINVAL;
+                        break;
+                    }
+                    slave->pointer = ((offset << BITS_PER_BYTE) | buf[0]) % slave->size;
+                    index = 1;
+                }
+                for (; index < *block_len; index++) {
+                    if (operation == SDI_SMBUS_WRITE) {
+                        sdi_sim_i2c_mem_write(slave, slave->pointer, buf[index]);
+                    } else {
+                        buf[index] = sdi_sim_i2c_mem_read(slave, slave->pointer);
+                    }
+                    slave->pointer = (slave->pointer + 1) % slave->size;
+                }
+                bytes = *block_len;
+                break;
+            }
+            for (index = 0; index < *block_len; index++) {
+                if (operation == SDI_SMBUS_WRITE) {
+                    sdi_sim_i2c_mem_write(slave, offset + index, buf[index]);
+                } else {
+                    buf[index] = sdi_sim_i2c_mem_read(slave, offset + index);
+                }
+            }
+            slave->pointer = offset + index;
+            bytes = *block_len;
+            break;
+        default:
+            err = EOPNOTSUPP;
+            break;
+    }
+
+    return sdi_sim_i2c_end(bus, address, bytes, start_ns, err);
+}
+
+/**
+ * sdi_sim_i2c_i2c_execute
+ * Execute an I2C transaction on simulated slave register file: offset write
+ * followed by read/write of buflen bytes with auto increment
+ * param[in] i2c_bus - I2C Bus handle
+ * param[in] address - I2C Slave Address
+ * param[in] operation - I2C Read/Write Operation
+ * param[in] cmd - offset, msb first
+ * param[in] cmdlen - no. of offset bytes
+ * param[inout] buffer - data read from/written to slave
+ * param[in] buflen - no. of bytes to read/write
+ * param[in] flags - ignored
+ * return STD_ERR_OK on Success, SDI_DEVICE_ERRNO on Failure
+ */
+static t_std_error sdi_sim_i2c_i2c_execute(sdi_i2c_bus_hdl_t i2c_bus,
+                   sdi_i2c_addr_t address, sdi_i2c_operation_t operation,
+                   const uint8_t *cmd, uint_t cmdlen, void *buffer, uint_t buflen,
+                   uint_t flags)
+{
+    sdi_sim_i2c_bus_t *bus = (sdi_sim_i2c_bus_t *) i2c_bus;
+    sdi_sim_i2c_slave_t *slave = NULL;
+    uint64_t start_ns = sdi_i2c_stats_now_ns();
+    uint8_t *buf = (uint8_t *) buffer;
+    uint_t index = 0;
+    uint_t pointer = 0;
+    int err = 0;
+
+    err = sdi_sim_i2c_begin(bus, address, &slave);
+    if (err != 0) {
+        return sdi_sim_i2c_end(bus, address, 0, start_ns, err);
+    }
+
+    if (cmdlen != 0) {
+        for (index = 0; index < cmdlen; index++) {
+            pointer = (pointer << BITS_PER_BYTE) | cmd[index];
+        }
+        slave->pointer = pointer;
+    }
+
+    for (index = 0; index < buflen; index++) {
+        if (slave->width == SDI_SIM_I2C_WIDTH_WORD) {
+            /* register value msb first, as on the wire */
+            uint_t reg = (slave->pointer + (index / 2)) % SDI_SIM_I2C_MAX_REGS;
+            if (operation == SDI_I2C_WRITE) {
+                slave->regs[reg] = (index & 1) ?
+                    ((slave->regs[reg] & 0xff00) | buf[index]) :
+                    ((slave->regs[reg] & 0x00ff) | (buf[index] << BITS_PER_BYTE));
+            } else {
+                buf[index] = (index & 1) ? (slave->regs[reg] & SDI_MAX_BYTE_VAL)
+                    : (slave->regs[reg] >> BITS_PER_BYTE);
+            }
+        } else if (operation == SDI_I2C_WRITE) {
+            sdi_sim_i2c_mem_write(slave, slave->pointer + index, buf[index]);
+        } else {
+            buf[index] = sdi_sim_i2c_mem_read(slave, slave->pointer + index);
+        }
+    }
+    if (slave->width != SDI_SIM_I2C_WIDTH_WORD) {
+        slave->pointer += buflen;
+    }
+
+    return sdi_sim_i2c_end(bus, address, cmdlen + buflen, start_ns, err);
+}
+
+/**
+ * sdi_sim_i2c_bus_ops
+ * SDI I2C Bus Operations for simulated i2c bus
+ */
+static sdi_i2c_bus_ops_t sdi_sim_i2c_bus_ops = {
+    .sdi_i2c_acquire_bus = sdi_sim_i2c_acquire_bus,
+    .sdi_smbus_execute = sdi_sim_i2c_smbus_execute,
+    .sdi_i2c_execute = sdi_sim_i2c_i2c_execute,
+    .sdi_i2c_release_bus = sdi_sim_i2c_release_bus,
+    .sdi_i2c_get_capability = sdi_sim_i2c_get_capability,
+};
+
+/**
+ * sdi_sim_i2c_fault_parse
+ * Parse fault injection attributes of a config node
+ * param[in] node - sim_i2c or i2c slave config node
+ * param[out] fault - filled with parsed attributes
+ * return true if node has any fault injection attribute, false otherwise
+ */
+static bool sdi_sim_i2c_fault_parse(std_config_node_t node,
+                                    sdi_sim_i2c_fault_t *fault)
+{
+    char *node_attr = NULL;
+    bool is_configured = false;
+
+    fault->error_errno = EIO;
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_SIM_LATENCY);
+    if (node_attr != NULL) {
+        fault->latency_us = (uint_t) strtoul(node_attr, NULL, 0);
+        is_configured = true;
+    }
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_SIM_ERROR_EVERY);
+    if (node_attr != NULL) {
+        fault->error_every = (uint_t) strtoul(node_attr, NULL, 0);
+        is_configured = true;
+    }
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_SIM_ERROR_ERRNO);
+    if (node_attr != NULL) {
+        fault->error_errno = (int) strtoul(node_attr, NULL, 0);
+        is_configured = true;
+    }
+
+    return is_configured;
+}
+
+/**
+ * sdi_sim_i2c_regmap_path
+ * Resolve a register map file name against the register map directory
+ * param[in] regmap_dir - register map directory, NULL if not configured
+ * param[in] regmap - register map file name from configuration
+ * param[out] path - buffer for resolved path
+ * param[in] len - size of path buffer
+ * return resolved path, regmap itself when absolute or no directory
+ */
+static const char *sdi_sim_i2c_regmap_path(const char *regmap_dir,
+                                           const char *regmap, char *path,
+                                           size_t len)
+{
+    if ((regmap_dir == NULL) || (regmap[0] == '/')) {
+        return regmap;
+    }
+    snprintf(path, len, "%s/%s", regmap_dir, regmap);
+    return path;
+}
+
+/**
+ * sdi_sim_i2c_slave_register
+ * Load register map of every i2c slave configured under a node, and of its
+ * auxiliary address if any. Relative register map paths are resolved
+ * against the register map directory of the bus.
+ * param[in] node - sim_i2c bus config node, or i2c mux channel config node
+ * param[in] bus - simulated i2c bus
+ * return none
+ */
+static void sdi_sim_i2c_slave_register(std_config_node_t node,
+                                       sdi_sim_i2c_bus_t *bus)
+{
+    std_config_node_t cur_node = NULL;
+    char *node_attr = NULL;
+    char *regmap = NULL;
+    const char *regmap_dir = bus->regmap_dir;
+    char path[PATH_MAX];
+    sdi_i2c_addr_t address = 0;
+
+    for (cur_node = std_config_get_child(node); cur_node != NULL;
+            cur_node = std_config_next_node(cur_node)) {
+        node_attr = std_config_attr_get(cur_node, SDI_DEV_ATTR_ADDRESS);
+        regmap = std_config_attr_get(cur_node, SDI_DEV_ATTR_SIM_REGMAP);
+        if ((node_attr == NULL) || (regmap == NULL)) {
+            continue;
+        }
+        address = (sdi_i2c_addr_t) strtoul(node_attr, NULL, 0);
+        if (sdi_sim_i2c_regmap_load(&bus->bus, address,
+                sdi_sim_i2c_regmap_path(regmap_dir, regmap, path, sizeof(path)))
+                != STD_ERR_OK) {
+            continue;
+        }
+        if (sdi_sim_i2c_fault_parse(cur_node, &bus->slave[address]->fault)) {
+            bus->slave[address]->has_fault = true;
+        }
+
+        /* second address of the same device, ex: SFP diagnostics at 0x51 */
+        node_attr = std_config_attr_get(cur_node, SDI_DEV_ATTR_SIM_AUX_ADDRESS);
+        regmap = std_config_attr_get(cur_node, SDI_DEV_ATTR_SIM_AUX_REGMAP);
+        if ((node_attr == NULL) || (regmap == NULL)) {
+            continue;
+        }
+        address = (sdi_i2c_addr_t) strtoul(node_attr, NULL, 0);
+        sdi_sim_i2c_regmap_load(&bus->bus, address,
+            sdi_sim_i2c_regmap_path(regmap_dir, regmap, path, sizeof(path)));
+    }
+}
+
+/**
+ * sdi_sim_i2c_slaves_load
+ * Load the register maps of the i2c slaves configured under a config node
+ * on a simulated bus
+ * param[in] i2c_bus - simulated i2c bus handle
+ * param[in] node - config node of the slaves, ex: i2c mux channel node
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOTSUP) when i2c_bus
+ * is not a simulated bus
+ */
+t_std_error sdi_sim_i2c_slaves_load(sdi_i2c_bus_hdl_t i2c_bus,
+                                    std_config_node_t node)
+{
+    STD_ASSERT(node != NULL);
+
+    if (!sdi_sim_i2c_bus_is_sim(i2c_bus)) {
+        return SDI_DEVICE_ERRCODE(ENOTSUP);
+    }
+    sdi_sim_i2c_slave_register(node, (sdi_sim_i2c_bus_t *) i2c_bus);
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_sim_i2c_driver_init
+ * Initialize simulated i2c bus and devices attached to it
+ * param[in] bus - (i2c) bus handle
+ * return STD_ERR_OK on success
+ */
+static t_std_error sdi_sim_i2c_driver_init(sdi_bus_hdl_t bus)
+{
+    STD_ASSERT(bus != NULL);
+
+    sdi_init_sched_device_list(bus);
+
+    return STD_ERR_OK;
+}
+
+/**
+ * sdi_sim_i2c_driver_register
+ * SDI simulated I2C bus driver registration with bus framework
+ * param[in] node - sim_i2c bus node handle obtained by parsing configuration
+ * param[out] bus - i2c bus handle populated after successful registration
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+static t_std_error sdi_sim_i2c_driver_register(std_config_node_t node,
+        sdi_bus_hdl_t *bus)
+{
+    char *node_attr = NULL;
+    t_std_error error = STD_ERR_OK;
+    sdi_i2c_bus_hdl_t i2c_bus = NULL;
+
+    sdi_sim_i2c_bus_t *sim_i2c_bus = (sdi_sim_i2c_bus_t *)
+        calloc (sizeof (sdi_sim_i2c_bus_t), 1);
+
+    STD_ASSERT(sim_i2c_bus != NULL);
+
+    i2c_bus = &(sim_i2c_bus->bus);
+    i2c_bus->bus.bus_type = SDI_I2C_BUS;
+    i2c_bus->bus.bus_init = sdi_sim_i2c_driver_init;
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_INSTANCE);
+    STD_ASSERT(node_attr != NULL);
+    i2c_bus->bus.bus_id = (uint_t) strtoul (node_attr, NULL, 0);
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_BUS_NAME);
+    if (node_attr == NULL) {
+        snprintf(i2c_bus->bus.bus_name, SDI_MAX_NAME_LEN, "%s-%d",
+            std_config_name_get(node), i2c_bus->bus.bus_id);
+    } else {
+        safestrncpy(i2c_bus->bus.bus_name, node_attr, SDI_MAX_NAME_LEN);
+    }
+
+    i2c_bus->ops = &sdi_sim_i2c_bus_ops;
+
+    error = sdi_i2c_arb_init(&(sim_i2c_bus->lock));
+    if (error != STD_ERR_OK) {
+        error = SDI_DEVICE_ERRNO;
+        free(sim_i2c_bus);
+        SDI_DEVICE_ERRMSG_LOG("%s:%d sim i2c bus %u lock init failed %d\n",
+            __FUNCTION__, __LINE__, i2c_bus->bus.bus_id, error);
+        return error;
+    }
+
+    node_attr = getenv(SDI_SIM_I2C_REGMAP_DIR_ENV);
+    if (node_attr == NULL) {
+        node_attr = std_config_attr_get(node, SDI_DEV_ATTR_SIM_REGMAP_DIR);
+    }
+    if (node_attr != NULL) {
+        sim_i2c_bus->regmap_dir = strdup(node_attr);
+        STD_ASSERT(sim_i2c_bus->regmap_dir != NULL);
+    }
+
+    sdi_sim_i2c_fault_parse(node, &sim_i2c_bus->fault);
+    sdi_sim_i2c_slave_register(node, sim_i2c_bus);
+
+    sdi_bus_register((sdi_bus_hdl_t) sim_i2c_bus);
+
+    sdi_init_sched_register((sdi_bus_hdl_t) sim_i2c_bus, node);
+
+    sdi_i2c_batch_arb_register(i2c_bus, &(sim_i2c_bus->lock));
+
+    node_attr = std_config_attr_get(node, SDI_DEV_ATTR_STATS_SHM);
+    sim_i2c_bus->stats = sdi_i2c_stats_create(i2c_bus,
+                            ((node_attr != NULL) && (strcmp(node_attr, "yes") == 0)));
+
+    *bus = (sdi_bus_hdl_t) sim_i2c_bus;
+
+    sdi_bus_register_device_list(node, (sdi_bus_hdl_t) sim_i2c_bus);
+
+    return error;
+}
+
+/**
+ * sim_i2c_entry_callbacks
+ * SDI Bus Driver Object to hold this driver's registration and initialization
+ * function
+ */
+const sdi_bus_driver_t * sim_i2c_entry_callbacks(void)
+{
+     /*Export Bus Driver table*/
+     static const sdi_bus_driver_t sim_i2c_entry = {
+        .bus_register = sdi_sim_i2c_driver_register,
+        .bus_init = sdi_sim_i2c_driver_init
+     };
+     return &sim_i2c_entry;
+}
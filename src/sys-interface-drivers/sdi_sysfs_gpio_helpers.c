@@ -27,24 +27,44 @@
 #include "sdi_sysfs_gpio_helpers.h"
 #include "sdi_device_common.h"
 #include "sdi_pin_bus_attr.h"
+#include "std_mutex_lock.h"
+#include "std_assert.h"
 
 #include <errno.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
 #include <linux/limits.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/inotify.h>
 #include <fcntl.h>
 
-#define GPIO_EXPORT_PATH                "%s/class/gpio/export"
+#define GPIO_CLASS_PATH                 "%s/class/gpio"
+#define GPIO_EXPORT_PATH                GPIO_CLASS_PATH"/export"
 #define GPIO_PATH                       "%s/class/gpio/gpio%u"
 #define GPIO_DIRECTION_FILE_PATH        GPIO_PATH"/direction"
 #define GPIO_POLARITY_FILE_PATH         GPIO_PATH"/active_low"
 #define GPIO_LEVEL_FILE_PATH            GPIO_PATH"/value"
+#define GPIO_EDGE_FILE_PATH             GPIO_PATH"/edge"
 /**
  * Invalid file descriptor
  */
 #define SDI_INVALID_FILE_FD             -1
+/**
+ * Initial size of the export queue
+ */
+#define SDI_GPIO_EXPORT_TBL_SIZE        64
+/**
+ * gpio number string maximum length written to export file
+ */
+#define SDI_GPIO_EXPORT_STR_LEN         16
+/**
+ * inotify event buffer length
+ */
+#define SDI_GPIO_EXPORT_EVENT_BUF_LEN   1024
 
 /**
  * sdi_gpio_is_exported
@@ -108,36 +128,331 @@ t_std_error sdi_sysfs_gpio_export(uint_t gpio_no)
     return err;
 }
 
+/**
+ * @struct sdi_gpio_export_entry_t
+ * gpio pin queued for export
+ */
+typedef struct sdi_gpio_export_entry_ {
+    uint_t gpio_no; /**< gpio number */
+    bool done; /**< export pass done for the pin */
+    bool written; /**< pin number written to export file, its pass waiting */
+    t_std_error status; /**< export status, valid once done */
+    uint64_t export_ns; /**< time from start of export pass until gpio<num>
+                             showed up, 0 when already exported */
+} sdi_gpio_export_entry_t;
+
+/* gpio pins queued for export, protected by sdi_gpio_export_lock */
+static std_mutex_type_t sdi_gpio_export_lock = PTHREAD_MUTEX_INITIALIZER;
+/* signalled once pins written by a pass are done */
+static pthread_cond_t sdi_gpio_export_cond = PTHREAD_COND_INITIALIZER;
+static sdi_gpio_export_entry_t *sdi_gpio_export_tbl = NULL;
+static uint_t sdi_gpio_export_count = 0;
+static uint_t sdi_gpio_export_size = 0;
+static sdi_sysfs_gpio_export_stats_t sdi_gpio_export_stats;
+
+/**
+ * sdi_gpio_export_entry_get
+ * Get the export queue entry of a gpio pin, queued if not yet, with
+ * sdi_gpio_export_lock held
+ * param[in] gpio_no - gpio number
+ * return export queue entry of the pin
+ */
+static sdi_gpio_export_entry_t *sdi_gpio_export_entry_get(uint_t gpio_no)
+{
+    sdi_gpio_export_entry_t *entry = NULL;
+    uint_t index = 0;
+
+    for (index = 0; index < sdi_gpio_export_count; index++) {
+        if (sdi_gpio_export_tbl[index].gpio_no == gpio_no) {
+            return &sdi_gpio_export_tbl[index];
+        }
+    }
+
+    if (sdi_gpio_export_count == sdi_gpio_export_size) {
+        sdi_gpio_export_size = (sdi_gpio_export_size == 0) ?
+                                SDI_GPIO_EXPORT_TBL_SIZE :
+                                (2 * sdi_gpio_export_size);
+        sdi_gpio_export_tbl = (sdi_gpio_export_entry_t *)
+            realloc(sdi_gpio_export_tbl,
+                    sdi_gpio_export_size * sizeof(sdi_gpio_export_entry_t));
+        STD_ASSERT(sdi_gpio_export_tbl != NULL);
+    }
+
+    entry = &sdi_gpio_export_tbl[sdi_gpio_export_count++];
+    memset(entry, 0, sizeof(*entry));
+    entry->gpio_no = gpio_no;
+    return entry;
+}
+
+/**
+ * sdi_gpio_export_wait
+ * Wait for the gpio<num> directories of the pins written to export file in a
+ * pass to show up. Called without sdi_gpio_export_lock, pins queued and
+ * exported by other threads meanwhile don't wait for the pass. sysfs doesn't
+ * report every directory created by the kernel to inotify, the directories
+ * are checked again every SDI_GPIO_EXPORT_RECHECK_MS anyway.
+ * param[in] start_ns - time the pass started writing to export file
+ * param[in] written - export queue indexes of the pins written in the pass,
+ * reordered
+ * param[in] gpio_nos - gpio numbers of the pins written in the pass, reordered
+ * param[in] pending - no. of pins written in the pass
+ * return none
+ */
+static void sdi_gpio_export_wait(uint64_t start_ns, uint_t *written,
+                                 uint_t *gpio_nos, uint_t pending)
+{
+    char file[PATH_MAX] = {0};
+    char events[SDI_GPIO_EXPORT_EVENT_BUF_LEN];
+    struct pollfd pfd = {.fd = -1, .events = POLLIN};
+    sdi_gpio_export_entry_t *entry = NULL;
+    uint64_t deadline_ns = start_ns +
+                           (((uint64_t) SDI_GPIO_EXPORT_TIMEOUT_MS) * 1000000ULL);
+    uint64_t now_ns = 0;
+    uint_t index = 0;
+
+    snprintf(file, PATH_MAX, GPIO_CLASS_PATH, SYSFS_PATH);
+    pfd.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if ((pfd.fd >= 0) && (inotify_add_watch(pfd.fd, file, IN_CREATE) < 0)) {
+        close(pfd.fd);
+        pfd.fd = -1;
+    }
+
+    while (pending != 0) {
+        now_ns = sdi_device_now_ns();
+        index = 0;
+        while (index < pending) {
+            if (!sdi_gpio_is_exported(gpio_nos[index])) {
+                index++;
+                continue;
+            }
+            std_mutex_lock(&sdi_gpio_export_lock);
+            entry = &sdi_gpio_export_tbl[written[index]];
+            entry->written = false;
+            entry->done = true;
+            entry->export_ns = now_ns - start_ns;
+            sdi_gpio_export_stats.exported++;
+            sdi_gpio_export_stats.export_ns_total += entry->export_ns;
+            if (entry->export_ns > sdi_gpio_export_stats.export_ns_max) {
+                sdi_gpio_export_stats.export_ns_max = entry->export_ns;
+            }
+            pthread_cond_broadcast(&sdi_gpio_export_cond);
+            std_mutex_unlock(&sdi_gpio_export_lock);
+
+            pending--;
+            written[index] = written[pending];
+            gpio_nos[index] = gpio_nos[pending];
+        }
+        if ((pending == 0) || (now_ns >= deadline_ns)) {
+            break;
+        }
+        /* poll() without fd only sleeps */
+        if (poll(&pfd, 1, SDI_GPIO_EXPORT_RECHECK_MS) > 0) {
+            while (read(pfd.fd, events, sizeof(events)) > 0) {
+            }
+        }
+    }
+
+    if (pending != 0) {
+        std_mutex_lock(&sdi_gpio_export_lock);
+        for (index = 0; index < pending; index++) {
+            SDI_DEVICE_ERRMSG_LOG("GPIO %u not exported within %u ms\n",
+                gpio_nos[index], SDI_GPIO_EXPORT_TIMEOUT_MS);
+            entry = &sdi_gpio_export_tbl[written[index]];
+            entry->written = false;
+            entry->done = true;
+            entry->status = SDI_DEVICE_ERRCODE(ETIMEDOUT);
+            sdi_gpio_export_stats.timeouts++;
+        }
+        pthread_cond_broadcast(&sdi_gpio_export_cond);
+        std_mutex_unlock(&sdi_gpio_export_lock);
+    }
+
+    if (pfd.fd >= 0) {
+        close(pfd.fd);
+    }
+}
+
+/**
+ * sdi_gpio_export_pass
+ * Export every queued gpio pin not exported yet and not being exported by
+ * another pass through one export file descriptor, then wait for all of them
+ * to show up. Called with sdi_gpio_export_lock held, the lock is released
+ * while waiting.
+ * return none
+ */
+static void sdi_gpio_export_pass(void)
+{
+    char file[PATH_MAX] = {0};
+    char gpio[SDI_GPIO_EXPORT_STR_LEN] = {0};
+    sdi_gpio_export_entry_t *entry = NULL;
+    t_std_error err = STD_ERR_OK;
+    uint64_t start_ns = sdi_device_now_ns();
+    uint_t *written = NULL;
+    uint_t *gpio_nos = NULL;
+    uint_t pending = 0;
+    uint_t index = 0;
+    int fd = SDI_INVALID_FILE_FD, write_len = 0;
+
+    written = (uint_t *) calloc(sdi_gpio_export_count, sizeof(uint_t));
+    STD_ASSERT(written != NULL);
+    gpio_nos = (uint_t *) calloc(sdi_gpio_export_count, sizeof(uint_t));
+    STD_ASSERT(gpio_nos != NULL);
+
+    snprintf(file, PATH_MAX, GPIO_EXPORT_PATH, SYSFS_PATH);
+    fd = open(file, O_WRONLY);
+    if (fd < 0) {
+        err = SDI_DEVICE_ERRNO;
+        SDI_DEVICE_ERRMSG_LOG("file %s open failed with %d\n", file, err);
+    }
+
+    for (index = 0; index < sdi_gpio_export_count; index++) {
+        entry = &sdi_gpio_export_tbl[index];
+        if (entry->done || entry->written) {
+            continue;
+        }
+        if (sdi_gpio_is_exported(entry->gpio_no)) {
+            entry->done = true;
+            continue;
+        }
+        if (fd < 0) {
+            entry->done = true;
+            entry->status = err;
+            continue;
+        }
+
+        snprintf(gpio, SDI_GPIO_EXPORT_STR_LEN, "%u\n", entry->gpio_no);
+        write_len = strlen(gpio);
+        /* EBUSY: exported by someone else meanwhile, waited for as well */
+        if ((write(fd, gpio, write_len) < write_len) && (errno != EBUSY)) {
+            entry->done = true;
+            entry->status = SDI_DEVICE_ERRNO;
+            SDI_DEVICE_ERRMSG_LOG("GPIO %u can't be exported, err : %d\n",
+                entry->gpio_no, entry->status);
+            continue;
+        }
+        entry->written = true;
+        written[pending] = index;
+        gpio_nos[pending] = entry->gpio_no;
+        pending++;
+    }
+
+    if (fd >= 0) {
+        close(fd);
+    }
+    sdi_gpio_export_stats.passes++;
+
+    if (pending != 0) {
+        std_mutex_unlock(&sdi_gpio_export_lock);
+        sdi_gpio_export_wait(start_ns, written, gpio_nos, pending);
+        std_mutex_lock(&sdi_gpio_export_lock);
+    }
+
+    free(gpio_nos);
+    free(written);
+}
+
+/**
+ * sdi_sysfs_gpio_export_queue
+ * Queue a gpio pin for export. Queued pins are exported at once, by the
+ * first sdi_export_gpio call following their registration.
+ * param[in] gpio_no - gpio number
+ * return none
+ */
+void sdi_sysfs_gpio_export_queue(uint_t gpio_no)
+{
+    std_mutex_lock(&sdi_gpio_export_lock);
+    sdi_gpio_export_entry_get(gpio_no);
+    std_mutex_unlock(&sdi_gpio_export_lock);
+}
+
 /**
  * sdi_export_gpio
- * Export a gpio pin if not already exported.
+ * Export a gpio pin if not already exported, along with every gpio pin
+ * queued for export, and wait for /sys/class/gpio/gpio<num> to show up. A pin
+ * whose export failed or timed out earlier is exported again.
  * param[in] gpio_no - gpio number
- * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(ETIMEDOUT) when the pin doesn't show up within
+ * SDI_GPIO_EXPORT_TIMEOUT_MS
  */
 t_std_error sdi_export_gpio(uint_t gpio_no)
 {
+    sdi_gpio_export_entry_t *entry = NULL;
     t_std_error err = STD_ERR_OK;
+    uint_t index = 0;
+
+    std_mutex_lock(&sdi_gpio_export_lock);
+    entry = sdi_gpio_export_entry_get(gpio_no);
+    /* the table may be reallocated while the lock is released */
+    index = (uint_t) (entry - sdi_gpio_export_tbl);
+    if (entry->done && (entry->status != STD_ERR_OK)) {
+        entry->done = false;
+        entry->status = STD_ERR_OK;
+        entry->export_ns = 0;
+    }
 
-    /** Checks whether the gpio pin already got populated **/
-    if (sdi_gpio_is_exported(gpio_no)) {
-        SDI_DEVICE_ERRMSG_LOG("GPIO %u was already initialized\n", gpio_no);
-    } else {
-       /** Else expose gpio pin to the user space **/
-        err = sdi_sysfs_gpio_export(gpio_no);
-        if (err != STD_ERR_OK) {
-            SDI_DEVICE_ERRMSG_LOG("GPIO %u can't be exported, err : %d\n",
-                gpio_no, err);
-            return err;
+    for (;;) {
+        entry = &sdi_gpio_export_tbl[index];
+        if (entry->written) {
+            /* written by the pass of another thread, wait for its outcome */
+            pthread_cond_wait(&sdi_gpio_export_cond, &sdi_gpio_export_lock);
+        } else if (!entry->done) {
+            sdi_gpio_export_pass();
+        } else {
+            break;
         }
-        if (!sdi_gpio_is_exported(gpio_no)) {
-            /** If gpio pin doesn't get created after exporting,its an error **/
-            SDI_DEVICE_ERRMSG_LOG("GPIO %u is not be exported\n", gpio_no);
-            return SDI_DEVICE_ERRNO;
+    }
+    err = entry->status;
+    std_mutex_unlock(&sdi_gpio_export_lock);
+
+    return err;
+}
+
+/**
+ * sdi_sysfs_gpio_export_time_get
+ * Get the time a gpio pin took to show up once exported
+ * param[in] gpio_no - gpio number
+ * param[out] export_ns - time from start of its export pass until
+ * /sys/class/gpio/gpio<num> showed up, 0 when it was already exported
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRCODE(ENOENT) when the pin was
+ * not exported by this driver, export status when export failed
+ */
+t_std_error sdi_sysfs_gpio_export_time_get(uint_t gpio_no, uint64_t *export_ns)
+{
+    t_std_error err = SDI_DEVICE_ERRCODE(ENOENT);
+    uint_t index = 0;
+
+    STD_ASSERT(export_ns != NULL);
+
+    std_mutex_lock(&sdi_gpio_export_lock);
+    for (index = 0; index < sdi_gpio_export_count; index++) {
+        if ((sdi_gpio_export_tbl[index].gpio_no == gpio_no) &&
+            sdi_gpio_export_tbl[index].done) {
+            err = sdi_gpio_export_tbl[index].status;
+            *export_ns = sdi_gpio_export_tbl[index].export_ns;
+            break;
         }
     }
+    std_mutex_unlock(&sdi_gpio_export_lock);
+
     return err;
 }
 
+/**
+ * sdi_sysfs_gpio_export_stats_get
+ * Get the gpio export counters
+ * param[out] stats - gpio export counters
+ * return none
+ */
+void sdi_sysfs_gpio_export_stats_get(sdi_sysfs_gpio_export_stats_t *stats)
+{
+    STD_ASSERT(stats != NULL);
+
+    std_mutex_lock(&sdi_gpio_export_lock);
+    *stats = sdi_gpio_export_stats;
+    std_mutex_unlock(&sdi_gpio_export_lock);
+}
+
 /**
  * sdi_gpio_file_table_init
  * Initialize file table with file pointers for gpio sysfs direction, polarity
@@ -202,20 +517,28 @@ t_std_error sdi_gpio_file_table_init(uint_t gpio_num,
  * param[in] gpio_file_fd - sysfs gpio file descriptor
  * ex: /sys/class/gpio/gpio0/value or /sys/class/gpio/gpio0/active_low
  * param[out] value - value read from given file path
- * return STD_ERR_OK on successful read, SDI_DEVICE_ERRNO on failure
+ * return STD_ERR_OK on successful read, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(EIO) when nothing is read
  */
 t_std_error sdi_sysfs_gpio_value_read(int gpio_file_fd, bool *value)
 {
     uint8_t ch = 0;
+    ssize_t len = 0;
+    t_std_error error = STD_ERR_OK;
 
-    lseek(gpio_file_fd,0, SEEK_SET);
-    read(gpio_file_fd, &ch, 1);
-    if ((ch - '0') != 0) {
-         *value = true;
-    } else {
-         *value = false;
+    len = pread(gpio_file_fd, &ch, 1, 0);
+    if (len < 0) {
+        error = SDI_DEVICE_ERRNO;
+        SDI_DEVICE_ERRMSG_LOG("file read failed with %d\n", error);
+        return error;
     }
-    return STD_ERR_OK;
+    if (len == 0) {
+        SDI_DEVICE_ERRMSG_LOG("file read returned %zd bytes\n", len);
+        return SDI_DEVICE_ERRCODE(EIO);
+    }
+
+    *value = ((ch - '0') != 0);
+    return error;
 }
 
 
@@ -225,21 +548,22 @@ t_std_error sdi_sysfs_gpio_value_read(int gpio_file_fd, bool *value)
  * param[in] gpio_file_fd - sysfs gpio file descriptor
  * ex: /sys/class/gpio/gpio0/value or /sys/class/gpio/gpio0/active_low
  * param[in] value - value to be written to gpio sysfs file path
- * return STD_ERR_OK on successful write, SDI_DEVICE_ERRNO on failure
+ * return STD_ERR_OK on successful write, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(EIO) on a short write
  */
 t_std_error sdi_sysfs_gpio_value_write(int gpio_file_fd, bool value)
 {
-    char buf[MAX_VALUE_STR_LEN] = {0};
+    char ch = value ? '1' : '0';
+    ssize_t len = 0;
     t_std_error error = STD_ERR_OK;
 
-    snprintf(buf, MAX_VALUE_STR_LEN, "%d\n", value);
-    lseek(gpio_file_fd, 0, SEEK_SET);
-    error = write(gpio_file_fd, buf, 1);
-    if(error < 1){
+    len = pwrite(gpio_file_fd, &ch, 1, 0);
+    if (len < 0) {
         error = SDI_DEVICE_ERRNO;
         SDI_DEVICE_ERRMSG_LOG("file write failed with %d\n", error);
-    } else {
-        error = STD_ERR_OK;
+    } else if (len != 1) {
+        error = SDI_DEVICE_ERRCODE(EIO);
+        SDI_DEVICE_ERRMSG_LOG("file write incomplete, %zd bytes\n", len);
     }
     return error;
 }
@@ -257,9 +581,15 @@ t_std_error sdi_sysfs_gpio_direction_read(int gpio_file_fd,
     sdi_pin_bus_direction_t *direction)
 {
     char buf[MAX_DIRECTION_LEN] = {0};
+    ssize_t len = 0;
+    t_std_error error = STD_ERR_OK;
 
-    lseek(gpio_file_fd,0, SEEK_SET);
-    read(gpio_file_fd, buf, MAX_DIRECTION_LEN);
+    len = pread(gpio_file_fd, buf, MAX_DIRECTION_LEN - 1, 0);
+    if (len < 0) {
+        error = SDI_DEVICE_ERRNO;
+        SDI_DEVICE_ERRMSG_LOG("file read failed with %d\n", error);
+        return error;
+    }
 
     if (!strncmp(buf, SDI_DEV_ATTR_INPUT_PIN, SDI_DEV_ATTR_INPUT_PIN_LEN)) {
         *direction = SDI_PIN_BUS_INPUT;
@@ -269,7 +599,7 @@ t_std_error sdi_sysfs_gpio_direction_read(int gpio_file_fd,
     } else {
         return SDI_DEVICE_ERRCODE(EINVAL);
     }
-    return STD_ERR_OK;
+    return error;
 }
 
 /**
@@ -278,12 +608,15 @@ t_std_error sdi_sysfs_gpio_direction_read(int gpio_file_fd,
  * param[in] gpio_file_fd - sysfs gpio file descriptor
  * param[in] direction - SDI_PIN_BUS_INPUT on input pin, SDI_PIN_BUS_OUTPUT on
  * output pin
- * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure,
+ * SDI_DEVICE_ERRCODE(EIO) on a short write
  */
 t_std_error sdi_sysfs_gpio_direction_write(int gpio_file_fd,
     sdi_pin_bus_direction_t direction)
 {
     char buf[MAX_DIRECTION_LEN] = {0};
+    ssize_t len = 0;
+    size_t write_len = 0;
     t_std_error error = STD_ERR_OK;
 
     if (direction == SDI_PIN_BUS_INPUT) {
@@ -293,14 +626,57 @@ t_std_error sdi_sysfs_gpio_direction_write(int gpio_file_fd,
     } else {
         return SDI_DEVICE_ERRCODE(EINVAL);
     }
+    write_len = strlen(buf);
 
-    lseek(gpio_file_fd,0, SEEK_SET);
-    error = write(gpio_file_fd, buf, MAX_DIRECTION_LEN);
-    if(error < 0){
+    len = pwrite(gpio_file_fd, buf, write_len, 0);
+    if (len < 0) {
         error = SDI_DEVICE_ERRNO;
         SDI_DEVICE_ERRMSG_LOG("file write failed with %d\n", error);
-    } else {
-        error = STD_ERR_OK;
+    } else if ((size_t) len != write_len) {
+        error = SDI_DEVICE_ERRCODE(EIO);
+        SDI_DEVICE_ERRMSG_LOG("file write incomplete, %zd bytes\n", len);
+    }
+    return error;
+}
+
+/**
+ * sdi_sysfs_gpio_edge_write
+ * Write edges reported as events to sysfs gpio edge file
+ * param[in] gpio_num - gpio number
+ * param[in] edge - edges to report
+ * return STD_ERR_OK on success, SDI_DEVICE_ERRNO on failure
+ */
+t_std_error sdi_sysfs_gpio_edge_write(uint_t gpio_num, sdi_gpio_edge_t edge)
+{
+    static const char *edge_str[] = {
+        [SDI_GPIO_EDGE_NONE] = "none",
+        [SDI_GPIO_EDGE_RISING] = "rising",
+        [SDI_GPIO_EDGE_FALLING] = "falling",
+        [SDI_GPIO_EDGE_BOTH] = "both",
+    };
+    char file[PATH_MAX] = {0};
+    char buf[MAX_EDGE_STR_LEN] = {0};
+    t_std_error error = STD_ERR_OK;
+    int fd = SDI_INVALID_FILE_FD, write_len = 0;
+
+    if ((uint_t) edge > SDI_GPIO_EDGE_BOTH) {
+        return SDI_DEVICE_ERRCODE(EINVAL);
+    }
+
+    snprintf(file, PATH_MAX, GPIO_EDGE_FILE_PATH, SYSFS_PATH, gpio_num);
+    snprintf(buf, MAX_EDGE_STR_LEN, "%s\n", edge_str[edge]);
+    write_len = strlen(buf);
+
+    fd = open(file, O_WRONLY);
+    if (fd < 0) {
+        error = SDI_DEVICE_ERRNO;
+        SDI_DEVICE_ERRMSG_LOG("file %s open failed with %d\n", file, error);
+        return error;
+    }
+    if (write(fd, buf, write_len) < write_len) {
+        error = SDI_DEVICE_ERRNO;
+        SDI_DEVICE_ERRMSG_LOG("file %s write failed with %d\n", file, error);
     }
+    close(fd);
     return error;
 }